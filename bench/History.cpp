@@ -0,0 +1,233 @@
+#include "History.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <map>
+
+namespace Bench
+{
+    //-------------------------------------------------------------------------
+    // Git
+    //-------------------------------------------------------------------------
+
+    // Output lines of `git -C source_dir <args>`; empty when git fails.
+    static std::vector<std::string> Git(const char* source_dir, const std::string& args)
+    {
+        std::vector<std::string> lines;
+        std::string command = "git -C '" + std::string(source_dir) + "' " + args + " 2>/dev/null";
+        FILE* p = popen(command.c_str(), "r");
+        if (p == nullptr)
+            return lines;
+        char line[256];
+        while (fgets(line, sizeof(line), p) != nullptr)
+        {
+            line[strcspn(line, "\r\n")] = '\0';
+            lines.emplace_back(line);
+        }
+        if (pclose(p) != 0)
+            lines.clear();
+        return lines;
+    }
+
+    std::string CurrentRevision(const char* source_dir)
+    {
+        std::vector<std::string> head = Git(source_dir, "rev-parse HEAD");
+        if (head.empty())
+            return "";
+        // Untracked files (build directories, the history itself) don't count.
+        bool dirty = !Git(source_dir, "status --porcelain --untracked-files=no").empty();
+        return dirty ? head[0] + "+dirty" : head[0];
+    }
+
+    std::string ResolveRevision(const char* source_dir, const char* rev)
+    {
+        std::vector<std::string> lines = Git(source_dir, "rev-parse --verify --quiet '" + std::string(rev) + "^{commit}'");
+        return lines.empty() ? "" : lines[0];
+    }
+
+    std::vector<std::string> Ancestors(const char* source_dir, size_t max)
+    {
+        return Git(source_dir, "rev-list --max-count=" + std::to_string(max) + " HEAD");
+    }
+
+    //-------------------------------------------------------------------------
+    // History file
+    //-------------------------------------------------------------------------
+
+    static const char* history_header = "# revision\ttime\tmetric\ttrials\tmean_ns\tstddev_ns\tmedian_ns\tdrift\tstable\tvalues_ns\n";
+
+    static std::vector<std::string> Split(const std::string& s, char separator)
+    {
+        std::vector<std::string> fields;
+        size_t start = 0;
+        while (true)
+        {
+            size_t end = s.find(separator, start);
+            fields.push_back(s.substr(start, end - start));
+            if (end == std::string::npos)
+                return fields;
+            start = end + 1;
+        }
+    }
+
+    std::vector<HistoryEntry> LoadHistory(const char* path)
+    {
+        std::vector<HistoryEntry> history;
+        FILE* f = fopen(path, "r");
+        if (f == nullptr)
+            return history;
+        std::string line;
+        char chunk[4096];
+        while (fgets(chunk, sizeof(chunk), f) != nullptr)
+        {
+            line += chunk;
+            if (line.back() != '\n' && !feof(f))
+                continue;
+            line.erase(line.find_last_not_of("\r\n") + 1);
+            std::vector<std::string> fields = Split(line, '\t');
+            line.clear();
+            if (fields.size() != 10 || fields[0].empty() || fields[0][0] == '#')
+                continue;
+            HistoryEntry e;
+            e.revision = fields[0];
+            e.time = std::strtoll(fields[1].c_str(), nullptr, 10);
+            e.result.metric = fields[2];
+            e.result.drift = std::strtod(fields[7].c_str(), nullptr);
+            e.result.stable = fields[8] == "1";
+            for (const std::string& v : Split(fields[9], ','))
+                if (!v.empty())
+                    e.result.trials.push_back(std::strtod(v.c_str(), nullptr));
+            Summarize(e.result);
+            history.push_back(std::move(e));
+        }
+        fclose(f);
+        return history;
+    }
+
+    bool AppendHistory(const char* path, const std::string& revision, const std::deque<Result>& results)
+    {
+        FILE* existing = fopen(path, "r");
+        bool fresh = existing == nullptr;
+        if (existing != nullptr)
+            fclose(existing);
+        FILE* f = fopen(path, "a");
+        if (f == nullptr)
+            return false;
+        if (fresh)
+            fputs(history_header, f);
+        long long now = (long long)std::time(nullptr);
+        for (const Result& r : results)
+        {
+            fprintf(f, "%s\t%lld\t%s\t%zu\t%.6g\t%.6g\t%.6g\t%.4f\t%d\t", revision.c_str(), now, r.metric.c_str(), r.trials.size(),
+                    r.mean, r.stddev, r.median, r.drift, r.stable ? 1 : 0);
+            for (size_t i = 0; i < r.trials.size(); i++)
+                fprintf(f, i == 0 ? "%.6g" : ",%.6g", r.trials[i]);
+            fputc('\n', f);
+        }
+        return fclose(f) == 0;
+    }
+
+    std::vector<Result> ResultsOf(const std::vector<HistoryEntry>& history, const std::string& revision, size_t max_runs)
+    {
+        std::map<std::string, std::vector<const Result*>> runs;
+        std::vector<std::string> order;
+        for (const HistoryEntry& e : history)
+        {
+            if (e.revision != revision)
+                continue;
+            std::vector<const Result*>& list = runs[e.result.metric];
+            if (list.empty())
+                order.push_back(e.result.metric);
+            list.push_back(&e.result);
+        }
+        // Trials of the latest runs are pooled, so the spread includes the
+        // run-to-run variation (process layout, other load) and not only the
+        // variation within one run.
+        std::vector<Result> results;
+        for (const std::string& metric : order)
+        {
+            const std::vector<const Result*>& list = runs[metric];
+            Result pooled;
+            pooled.metric = metric;
+            for (size_t i = list.size() > max_runs ? list.size() - max_runs : 0; i < list.size(); i++)
+            {
+                pooled.trials.insert(pooled.trials.end(), list[i]->trials.begin(), list[i]->trials.end());
+                pooled.drift = std::max(pooled.drift, list[i]->drift);
+                pooled.stable = pooled.stable && list[i]->stable;
+            }
+            Summarize(pooled);
+            results.push_back(std::move(pooled));
+        }
+        return results;
+    }
+
+    std::string FindBaseline(const std::vector<HistoryEntry>& history, const std::vector<std::string>& candidates, const std::string& exclude)
+    {
+        for (const std::string& c : candidates)
+        {
+            if (c == exclude)
+                continue;
+            for (const HistoryEntry& e : history)
+                if (e.revision == c)
+                    return c;
+        }
+        return "";
+    }
+
+    //-------------------------------------------------------------------------
+    // Comparison
+    //-------------------------------------------------------------------------
+
+    size_t Compare(FILE* f, const std::vector<Result>& baseline, const std::deque<Result>& current, const CompareSettings& settings)
+    {
+        size_t slower = 0, faster = 0, same = 0, unstable = 0, compared = 0;
+        bool header = false;
+        for (const Result& now : current)
+        {
+            auto it = std::find_if(baseline.begin(), baseline.end(), [&](const Result& b) { return b.metric == now.metric; });
+            if (it == baseline.end() || it->trials.size() < 2 || now.trials.size() < 2)
+                continue;
+            const Result& base = *it;
+            compared++;
+
+            // Welch's t-test: unequal variances, Welch-Satterthwaite degrees of freedom.
+            double n1 = (double)base.trials.size(), n2 = (double)now.trials.size();
+            double v1 = base.stddev * base.stddev / n1, v2 = now.stddev * now.stddev / n2;
+            double se = std::sqrt(v1 + v2);
+            double change = now.mean / base.mean - 1.0;
+            double t = (se > 0.0) ? (now.mean - base.mean) / se : 0.0;
+            double df = (v1 + v2 > 0.0) ? (v1 + v2) * (v1 + v2) / (v1 * v1 / (n1 - 1.0) + v2 * v2 / (n2 - 1.0)) : n1 + n2 - 2.0;
+            double critical = StudentQuantile(settings.confidence, std::max(df, 1.0));
+
+            if (!base.stable || !now.stable)
+            {
+                unstable++;
+                continue;
+            }
+            if (std::fabs(change) < settings.min_change || std::fabs(t) < critical)
+            {
+                same++;
+                continue;
+            }
+            bool regression = change > 0.0;
+            (regression ? slower : faster)++;
+
+            if (!header)
+            {
+                fprintf(f, "%-36s %14s %14s %9s %7s\n", "metric", "base ns", "now ns", "change", "t");
+                header = true;
+            }
+            char base_text[32], now_text[32];
+            snprintf(base_text, sizeof(base_text), "%.0f +-%.1f%%", base.mean, 100.0 * base.ci95 / base.mean);
+            snprintf(now_text, sizeof(now_text), "%.0f +-%.1f%%", now.mean, 100.0 * now.ci95 / now.mean);
+            fprintf(f, "%-36s %14s %14s %+8.1f%% %7.1f  %s\n", now.metric.c_str(), base_text, now_text, 100.0 * change, t,
+                    regression ? "REGRESSION" : "faster");
+        }
+        fprintf(f, "%zu metrics compared: %zu slower, %zu faster, %zu unchanged, %zu skipped as unstable\n",
+                compared, slower, faster, same, unstable);
+        return slower;
+    }
+}
@@ -0,0 +1,55 @@
+// Benchmark history and regression detection.
+//
+// Every run appends one line per metric to a tab-separated history file,
+// keyed by the git commit the sources were at (suffixed "+dirty" when
+// tracked files were modified). A run is compared with the recent results
+// of a baseline commit in the same file: a metric is flagged when a one-sided
+// Welch t-test on the trials is significant and the mean moved by more than
+// a minimum relative change. Only the local repository and file are used.
+
+#pragma once
+
+#include "Measure.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace Bench
+{
+    // Full hash of HEAD, "+dirty" appended when tracked files differ from it;
+    // empty without git.
+    std::string CurrentRevision(const char* source_dir);
+    // Full hash of a revision expression ("HEAD~3", a branch, a short hash).
+    std::string ResolveRevision(const char* source_dir, const char* rev);
+    // HEAD and its ancestors, newest first.
+    std::vector<std::string> Ancestors(const char* source_dir, size_t max);
+
+    struct HistoryEntry
+    {
+        std::string revision;
+        int64_t time = 0;           // Unix seconds
+        Result result;
+    };
+
+    std::vector<HistoryEntry> LoadHistory(const char* path);
+    bool AppendHistory(const char* path, const std::string& revision, const std::deque<Result>& results);
+
+    // Results of every metric recorded for `revision`, with the trials of
+    // its last max_runs runs pooled.
+    std::vector<Result> ResultsOf(const std::vector<HistoryEntry>& history, const std::string& revision, size_t max_runs = 5);
+    // First candidate with results in the history, other than `exclude`.
+    std::string FindBaseline(const std::vector<HistoryEntry>& history, const std::vector<std::string>& candidates, const std::string& exclude);
+
+    struct CompareSettings
+    {
+        double confidence = 0.999;  // One-sided; high because ~100 metrics are tested per run
+        double min_change = 0.03;   // Relative change of the mean below which nothing is flagged
+    };
+
+    // Prints the significant changes and a summary; returns the number of
+    // regressions.
+    size_t Compare(FILE* f, const std::vector<Result>& baseline, const std::deque<Result>& current, const CompareSettings& settings);
+}
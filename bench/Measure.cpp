@@ -0,0 +1,163 @@
+#include "Measure.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <sched.h>
+#endif
+
+namespace Bench
+{
+    static Settings settings;
+    static std::deque<Result> results;
+    static std::string group;
+
+    Settings& GetSettings()
+    {
+        return settings;
+    }
+
+    //-------------------------------------------------------------------------
+    // Statistics
+    //-------------------------------------------------------------------------
+
+    // Standard normal quantile for p in (0.5, 1) (Abramowitz & Stegun 26.2.23,
+    // absolute error below 4.5e-4).
+    static double NormalQuantile(double p)
+    {
+        double t = std::sqrt(-2.0 * std::log(1.0 - p));
+        return t - (2.515517 + 0.802853 * t + 0.010328 * t * t) / (1.0 + 1.432788 * t + 0.189269 * t * t + 0.001308 * t * t * t);
+    }
+
+    double StudentQuantile(double p, double df)
+    {
+        double z = NormalQuantile(p);
+        double z2 = z * z;
+        double g1 = (z2 + 1.0) * z / 4.0;
+        double g2 = ((5.0 * z2 + 16.0) * z2 + 3.0) * z / 96.0;
+        double g3 = (((3.0 * z2 + 19.0) * z2 + 17.0) * z2 - 15.0) * z / 384.0;
+        return z + g1 / df + g2 / (df * df) + g3 / (df * df * df);
+    }
+
+    void Summarize(Result& r)
+    {
+        size_t n = r.trials.size();
+        if (n == 0)
+            return;
+        double sum = 0.0;
+        for (double v : r.trials)
+            sum += v;
+        r.mean = sum / (double)n;
+        double squares = 0.0;
+        for (double v : r.trials)
+            squares += (v - r.mean) * (v - r.mean);
+        r.stddev = (n > 1) ? std::sqrt(squares / (double)(n - 1)) : 0.0;
+
+        std::vector<double> sorted = r.trials;
+        std::sort(sorted.begin(), sorted.end());
+        r.median = (n % 2 == 1) ? sorted[n / 2] : 0.5 * (sorted[n / 2 - 1] + sorted[n / 2]);
+        r.ci95 = (n > 1) ? StudentQuantile(0.975, (double)(n - 1)) * r.stddev / std::sqrt((double)n) : 0.0;
+    }
+
+    //-------------------------------------------------------------------------
+    // Recording
+    //-------------------------------------------------------------------------
+
+    void SetGroup(const char* name)
+    {
+        group = name;
+    }
+
+    const std::deque<Result>& Results()
+    {
+        return results;
+    }
+
+    const Result& Record(Result r)
+    {
+        r.metric = group + "/" + r.metric;
+        results.push_back(std::move(r));
+        return results.back();
+    }
+
+    //-------------------------------------------------------------------------
+    // Environment
+    //-------------------------------------------------------------------------
+
+    int PinThread(int cpu, char* error, size_t size)
+    {
+#if defined(__linux__)
+        if (cpu < 0)
+            cpu = sched_getcpu();
+        if (cpu < 0)
+        {
+            snprintf(error, size, "sched_getcpu: %s", strerror(errno));
+            return -1;
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) != 0)
+        {
+            snprintf(error, size, "sched_setaffinity(%d): %s", cpu, strerror(errno));
+            return -1;
+        }
+        return cpu;
+#else
+        (void)cpu;
+        snprintf(error, size, "pinning needs Linux sched_setaffinity");
+        return -1;
+#endif
+    }
+
+    // First line of a sysfs file, without the newline; empty if unreadable.
+    static std::string ReadLine(const char* path)
+    {
+        char line[128] = "";
+        if (FILE* f = fopen(path, "r"))
+        {
+            if (fgets(line, sizeof(line), f) == nullptr)
+                line[0] = '\0';
+            fclose(f);
+        }
+        line[strcspn(line, "\r\n")] = '\0';
+        return line;
+    }
+
+    void PrintEnvironment(FILE* f, int cpu)
+    {
+        char path[128];
+        snprintf(path, sizeof(path), "/sys/devices/system/cpu/cpu%d/cpufreq/scaling_governor", cpu < 0 ? 0 : cpu);
+        std::string governor = ReadLine(path);
+        if (governor.empty())
+            fprintf(f, "cpufreq: not exposed (VM or non-Linux); relying on the reference loop for drift\n");
+        else if (governor != "performance")
+            fprintf(f, "cpufreq: governor '%s' may change the clock during the run (use 'performance')\n", governor.c_str());
+        if (ReadLine("/sys/devices/system/cpu/intel_pstate/no_turbo") == "0" || ReadLine("/sys/devices/system/cpu/cpufreq/boost") == "1")
+            fprintf(f, "cpufreq: turbo / boost is enabled; results depend on temperature and load\n");
+    }
+
+    double ReferenceNs()
+    {
+        // A dependent multiply-add chain: one result per cycle-bound step,
+        // insensitive to memory. Best of five to skip interrupts.
+        double best = 0.0;
+        for (int repeat = 0; repeat < 5; repeat++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            volatile uint64_t seed = 1;
+            uint64_t x = seed;
+            for (int i = 0; i < 1000000; i++)
+                x = x * 6364136223846793005ull + 1442695040888963407ull;
+            seed = x;
+            double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+            if (repeat == 0 || ns < best)
+                best = ns;
+        }
+        return best;
+    }
+}
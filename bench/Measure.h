@@ -0,0 +1,117 @@
+// Repeated-trial timing for the benchmarks.
+//
+// A metric is warmed up, calibrated so each trial lasts long enough for the
+// clock, and then timed over several trials. The spread of the trials gives
+// a confidence interval on the mean. A fixed reference loop is timed before
+// and after the trials; if its speed moved by more than the allowed drift
+// (frequency scaling, thermal throttling, a noisy neighbour) the trials are
+// repeated, and the metric is marked unstable if they keep drifting.
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <deque>
+#include <string>
+#include <vector>
+
+namespace Bench
+{
+    struct Settings
+    {
+        unsigned trials = 10;
+        unsigned min_trials = 3;        // Slow metrics drop trials down to this to fit max_seconds
+        double max_seconds = 2.0;       // Budget of the timed trials of one metric
+        double warmup_seconds = 0.02;
+        double max_drift = 0.03;        // Allowed relative change of the reference loop across a metric
+        unsigned retries = 1;           // Extra attempts when it drifts
+    };
+
+    Settings& GetSettings();
+
+    struct Result
+    {
+        std::string metric;             // "<benchmark>/<label>"
+        std::vector<double> trials;     // ns per call
+        double mean = 0.0;
+        double stddev = 0.0;
+        double median = 0.0;
+        double ci95 = 0.0;              // Half width of the 95% interval of the mean
+        double drift = 0.0;
+        bool stable = true;
+    };
+
+    // Fills the statistics of r from r.trials.
+    void Summarize(Result& r);
+
+    // Quantile of Student's t distribution with df degrees of freedom at
+    // p in (0.5, 1), e.g. 0.975 for a 95% interval (Cornish-Fisher expansion,
+    // within 1% for df >= 3).
+    double StudentQuantile(double p, double df);
+
+    // Prefix of the metrics recorded from now on.
+    void SetGroup(const char* name);
+    const std::deque<Result>& Results();
+
+    // Pins the calling thread to `cpu` (-1: the one it is running on).
+    // Returns the CPU, or -1 with a reason in `error`.
+    int PinThread(int cpu, char* error, size_t size);
+    // Governor / turbo settings that make timings drift, one line each.
+    void PrintEnvironment(FILE* f, int cpu);
+
+    // ns of a fixed dependent integer chain; tracks the effective clock.
+    double ReferenceNs();
+
+    // Internal: stores a finished metric.
+    const Result& Record(Result r);
+
+    // Times fn and records it under the current group. Each trial runs at
+    // least min_seconds / trials (and at least one call); metrics whose
+    // calls are too slow for all trials within max_seconds run fewer.
+    template <typename Fn>
+    const Result& Measure(const std::string& label, Fn&& fn, double min_seconds)
+    {
+        using Clock = std::chrono::steady_clock;
+        const Settings& settings = GetSettings();
+        auto seconds_since = [](Clock::time_point t0) { return std::chrono::duration<double>(Clock::now() - t0).count(); };
+
+        // Warm caches, thread_local scratch and branch predictors.
+        size_t warm_calls = 0;
+        auto t0 = Clock::now();
+        do
+        {
+            fn();
+            warm_calls++;
+        } while (seconds_since(t0) < settings.warmup_seconds);
+        double per_call = seconds_since(t0) / (double)warm_calls;
+        unsigned trials = settings.trials;
+        if (per_call * (double)trials > settings.max_seconds)
+            trials = std::max(settings.min_trials, (unsigned)(settings.max_seconds / per_call));
+        double trial_seconds = min_seconds / (double)trials;
+        size_t iters = (per_call > 0.0 && trial_seconds > per_call) ? (size_t)(trial_seconds / per_call) + 1 : 1;
+
+        Result r;
+        r.metric = label;
+        for (unsigned attempt = 0; attempt <= settings.retries; attempt++)
+        {
+            r.trials.clear();
+            double before = ReferenceNs();
+            for (unsigned t = 0; t < trials; t++)
+            {
+                auto start = Clock::now();
+                for (size_t i = 0; i < iters; i++)
+                    fn();
+                r.trials.push_back(seconds_since(start) * 1e9 / (double)iters);
+            }
+            double after = ReferenceNs();
+            r.drift = (after > before ? after - before : before - after) / before;
+            r.stable = r.drift <= settings.max_drift;
+            if (r.stable)
+                break;
+        }
+        Summarize(r);
+        return Record(std::move(r));
+    }
+}
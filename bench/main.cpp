@@ -0,0 +1,710 @@
+// Headless benchmarks for the math core.
+// Run with `meson test --benchmark` or directly: fourier-bench [options] [filter]
+// Only benchmarks whose name contains the filter string are run. Every timed
+// metric is measured over repeated trials on a pinned core, appended to the
+// history file and compared with the latest results of a baseline commit
+// (see Measure.h and History.h); the exit status is 1 when a metric regressed.
+
+#include "History.h"
+#include "Measure.h"
+
+#include "Core/PerfCounters.h"
+#include "Core/ThreadPool.h"
+#include "Dsp/BatchFft.h"
+#include "Dsp/Basis.h"
+#include "Dsp/Convergence.h"
+#include "Dsp/Cwt.h"
+#include "Dsp/Dct.h"
+#include "Dsp/Epicycles.h"
+#include "Dsp/Filter.h"
+#include "Dsp/FixedFft.h"
+#include "Dsp/Hilbert.h"
+#include "Dsp/OscillatorBank.h"
+#include "Dsp/Resampler.h"
+#include "Dsp/Series.h"
+#include "Dsp/SpectralBank.h"
+#include "Dsp/Summation.h"
+#include "Dsp/Fft.h"
+#include "Dsp/Wavelet.h"
+#include "Raster/Rasterizer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numbers>
+#include <random>
+#include <string>
+#include <vector>
+
+// Times fn over repeated trials (see Measure.h), records it as
+// "<benchmark>/<label>" and returns the mean time per call in ns.
+template <typename Fn>
+static double TimeNs(const std::string& label, Fn&& fn, double min_seconds = 0.05)
+{
+    return Bench::Measure(label, fn, min_seconds).mean;
+}
+
+// printf-style metric label.
+template <typename... Args>
+static std::string Label(const char* format, Args... args)
+{
+    char buffer[96];
+    snprintf(buffer, sizeof(buffer), format, args...);
+    return buffer;
+}
+
+static std::vector<float> RandomSignal(size_t n, unsigned seed = 1)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-1.0f, 1.0f);
+    std::vector<float> x(n);
+    for (float& v : x)
+        v = dist(rng);
+    return x;
+}
+
+static const char* dct_names[] = { "DCT-I", "DCT-II", "DCT-III", "DCT-IV", "DST-I", "DST-II", "DST-III", "DST-IV" };
+
+// Time of the FFT a DCT/DST plan of this type and size runs internally.
+static double UnderlyingFftNs(Dsp::DctType type, size_t n)
+{
+    std::string label = Label("%s/fft/%zu", dct_names[(int)type], n);
+    size_t m = n;
+    if (type == Dsp::DctType::DctI)
+        m = 2 * (n - 1);
+    else if (type == Dsp::DctType::DstI)
+        m = 2 * (n + 1);
+
+    if (type == Dsp::DctType::DctIV || type == Dsp::DctType::DstIV)
+    {
+        size_t cn = (n % 2 == 0) ? n / 2 : 2 * n;
+        Dsp::FftPlan plan(cn);
+        std::vector<Dsp::Complex> src(cn, Dsp::Complex(0.5f, -0.25f));
+        std::vector<Dsp::Complex> c(cn);
+        return TimeNs(label, [&] { c = src; plan.Forward(c.data()); });
+    }
+    Dsp::RealFftPlan plan(m);
+    std::vector<float> x = RandomSignal(m);
+    std::vector<Dsp::Complex> c(plan.SpectrumSize());
+    return TimeNs(label, [&] { plan.Forward(x.data(), c.data()); });
+}
+
+// Every DCT/DST type against the FFT it is built on.
+static void BenchDct()
+{
+    printf("%-8s %8s %12s %12s %8s\n", "type", "n", "fft ns", "dct ns", "ratio");
+    for (size_t n : { 64, 1000, 1024, 4096, 65536 })
+    {
+        std::vector<float> x = RandomSignal(n);
+        std::vector<float> y(n);
+        for (int t = 0; t < 8; t++)
+        {
+            Dsp::DctType type = (Dsp::DctType)t;
+            Dsp::DctPlan plan(type, n);
+            double fft_ns = UnderlyingFftNs(type, n);
+            double ns = TimeNs(Label("%s/%zu", dct_names[t], n), [&] { plan.Execute(x.data(), y.data()); });
+            printf("%-8s %8zu %12.0f %12.0f %8.2f\n", dct_names[t], n, fft_ns, ns, ns / fft_ns);
+        }
+    }
+
+    Dsp::MdctPlan mdct(1024);
+    std::vector<float> x = RandomSignal(2048);
+    std::vector<float> y(1024);
+    printf("%-8s %8d %12s %12.0f\n", "MDCT", 1024, "", TimeNs("MDCT/1024", [&] { mdct.Forward(x.data(), y.data()); }));
+
+    Dsp::Dct2dPlan block(Dsp::DctType::DctII, 8, 8);
+    std::vector<float> b = RandomSignal(64);
+    std::vector<float> bo(64);
+    printf("%-8s %8s %12s %12.0f\n", "DCT2D", "8x8", "", TimeNs("DCT2D/8x8", [&] { block.Execute(b.data(), bo.data()); }));
+}
+
+// Throughput of 1024-point batches: one FftPlan per signal against the
+// batch-interleaved kernel, single-threaded and on the pool.
+static void BenchBatchFft()
+{
+    const size_t n = 1024;
+    const size_t batch = 2048;
+    std::vector<float> re = RandomSignal(n * batch, 1), im = RandomSignal(n * batch, 2);
+    std::vector<Dsp::Complex> src(n * batch), x(n * batch);
+    for (size_t i = 0; i < src.size(); i++)
+        src[i] = Dsp::Complex(re[i], im[i]);
+
+    Dsp::FftPlan single(n);
+    Dsp::BatchFftPlan plan(n);
+    Core::ThreadPool& pool = Core::ThreadPool::Global();
+    // Each run restores the input first so values stay bounded; the copy is timed separately.
+    double copy_ns = TimeNs("copy", [&] { x = src; });
+    double loop_ns = TimeNs("per-signal", [&] { x = src; for (size_t b = 0; b < batch; b++) single.Forward(x.data() + b * n); }) - copy_ns;
+    double contiguous_ns = TimeNs("contiguous", [&] { x = src; plan.TransformContiguous(x.data(), batch, Dsp::FftDirection::Forward); }) - copy_ns;
+    double interleaved_ns = TimeNs("interleaved", [&] { x = src; plan.Forward(x.data(), batch); }) - copy_ns;
+    double pooled_ns = TimeNs("pooled", [&] { x = src; plan.Forward(x.data(), batch, &pool); }) - copy_ns;
+
+    printf("%-26s %14s\n", "1024-point, 2048 signals", "transforms/s");
+    printf("%-26s %14.0f\n", "FftPlan per signal", batch * 1e9 / loop_ns);
+    printf("%-26s %14.0f\n", "batched contiguous", batch * 1e9 / contiguous_ns);
+    printf("%-26s %14.0f\n", "batched interleaved", batch * 1e9 / interleaved_ns);
+    printf("%-18s %2u thr %14.0f\n", "batched interleaved", pool.ThreadCount(), batch * 1e9 / pooled_ns);
+}
+
+// Q15 / Q31 block-floating-point FFTs and the integer epicycle chain against float.
+static void BenchFixed()
+{
+    printf("%-20s %8s %12s\n", "transform", "n", "ns");
+    for (size_t n : { 256, 1024, 4096 })
+    {
+        std::vector<float> a = RandomSignal(n, 1), b = RandomSignal(n, 2);
+        std::vector<Dsp::Complex> src(n), x(n);
+        std::vector<int16_t> re15(n), im15(n), r15(n), i15(n);
+        std::vector<int32_t> re31(n), im31(n), r31(n), i31(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            src[i] = Dsp::Complex(a[i], b[i]);
+            re15[i] = (int16_t)(a[i] * 32000.0f);
+            im15[i] = (int16_t)(b[i] * 32000.0f);
+            re31[i] = (int32_t)(a[i] * 2.1e9f);
+            im31[i] = (int32_t)(b[i] * 2.1e9f);
+        }
+        Dsp::FftPlan plan(n);
+        Dsp::FixedFftQ15 q15(n);
+        Dsp::FixedFftQ31 q31(n);
+        printf("%-20s %8zu %12.0f\n", "float", n, TimeNs(Label("float/%zu", n), [&] { x = src; plan.Forward(x.data()); }));
+        printf("%-20s %8zu %12.0f\n", "Q15", n, TimeNs(Label("q15/%zu", n), [&] { r15 = re15; i15 = im15; q15.Forward(r15.data(), i15.data()); }));
+        printf("%-20s %8zu %12.0f\n", "Q31", n, TimeNs(Label("q31/%zu", n), [&] { r31 = re31; i31 = im31; q31.Forward(r31.data(), i31.data()); }));
+    }
+
+    const size_t count = 360;
+    std::vector<Dsp::FixedEpicycle> circles(count);
+    std::vector<int32_t> fx(count), fy(count);
+    std::vector<float> radii(count), px(count), py(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        float n = (float)(2 * i + 1);
+        radii[i] = 60.0f * 4.0f / (n * 3.14159f);
+        circles[i].radius_q16 = (int32_t)(radii[i] * 65536.0f);
+        circles[i].harmonic = -(int32_t)(2 * i + 1);
+    }
+    uint32_t turn = 0;
+    float time = 0.0f;
+    double float_ns = TimeNs("epicycles-float", [&]
+    {
+        time += 0.01f;
+        float x = 0.0f, y = 0.0f;
+        for (size_t i = 0; i < count; i++)
+        {
+            float angle = -time * (float)(2 * i + 1);
+            x += radii[i] * std::cos(angle);
+            y += radii[i] * std::sin(angle);
+            px[i] = x;
+            py[i] = y;
+        }
+    });
+    double fixed_ns = TimeNs("epicycles-fixed", [&] { turn += 6835; Dsp::EvaluateEpicyclesFixed(circles.data(), count, turn, fx.data(), fy.data()); });
+    printf("%-20s %8zu %12.0f\n", "epicycles float", count, float_ns);
+    printf("%-20s %8zu %12.0f\n", "epicycles fixed", count, fixed_ns);
+}
+
+// Relative error of the three summation orders against a long double sum of
+// the same float terms, and the cost of the accurate orders relative to naive.
+static void BenchSummation()
+{
+    const Dsp::Summation modes[] = { Dsp::Summation::Naive, Dsp::Summation::Compensated, Dsp::Summation::Pairwise };
+    static const char* mode_names[] = { "naive", "compensated", "pairwise" };
+    printf("%-10s %8s %12s %12s %12s\n", "sum", "n", "naive err", "comp err", "pair err");
+    for (size_t n : { 1000, 65536, 1 << 20 })
+    {
+        // Uniform positive terms: the worst case for naive error growth.
+        std::vector<float> x = RandomSignal(n, 3);
+        for (float& v : x)
+            v = std::fabs(v) + 0.1f;
+        long double reference = 0.0L;
+        for (float v : x)
+            reference += v;
+        printf("%-10s %8zu", "random", n);
+        for (Dsp::Summation mode : modes)
+            printf(" %12.2e", (double)std::fabs(((long double)Dsp::Sum(x.data(), n, mode) - reference) / reference));
+        printf("\n");
+        printf("%-10s %8s", "  ns", "");
+        for (Dsp::Summation mode : modes)
+            printf(" %12.0f", TimeNs(Label("sum-%s/%zu", mode_names[(int)mode], n), [&] { volatile float s = Dsp::Sum(x.data(), n, mode); (void)s; }));
+        printf("\n");
+    }
+
+    // Error vs terms of the square-wave chain tip (|error| / total radius),
+    // against the same float terms summed in long double.
+    const double two_pi = 2.0 * std::numbers::pi;
+    printf("\n%-10s %8s %12s %12s %12s %10s %10s\n", "chain", "terms", "naive err", "comp err", "pair err", "comp cost", "pair cost");
+    for (size_t count : { 16, 64, 360, 1024, 4096, 16384, 65536 })
+    {
+        std::vector<Dsp::Epicycle> circles(count);
+        double extent = 0.0;
+        for (size_t i = 0; i < count; i++)
+        {
+            float n = (float)(2 * i + 1);
+            circles[i].radius = 60.0f * 4.0f / (n * 3.14159f);
+            circles[i].harmonic = -(int32_t)(2 * i + 1);
+            extent += circles[i].radius;
+        }
+        double errors[3] = {};
+        std::vector<float> jx(count), jy(count);
+        for (int sample = 0; sample < 16; sample++)
+        {
+            double time = 0.37 + 0.61 * sample;
+            // The same float terms EvaluateEpicycles builds.
+            long double rx = 0.0L, ry = 0.0L;
+            for (size_t i = 0; i < count; i++)
+            {
+                double angle = (double)circles[i].harmonic * time;
+                float reduced = (float)(angle - two_pi * std::nearbyint(angle / two_pi));
+                rx += circles[i].radius * std::cos(reduced);
+                ry += circles[i].radius * std::sin(reduced);
+            }
+            for (int m = 0; m < 3; m++)
+            {
+                Dsp::EvaluateEpicycles(circles.data(), count, time, jx.data(), jy.data(), modes[m]);
+                long double ex = (long double)jx[count - 1] - rx, ey = (long double)jy[count - 1] - ry;
+                errors[m] = std::max(errors[m], (double)std::sqrt(ex * ex + ey * ey) / extent);
+            }
+        }
+        double ns[3];
+        double time = 0.0;
+        for (int m = 0; m < 3; m++)
+            ns[m] = TimeNs(Label("chain-%s/%zu", mode_names[m], count), [&] { time += 0.01; Dsp::EvaluateEpicycles(circles.data(), count, time, jx.data(), jy.data(), modes[m]); });
+        printf("%-10s %8zu %12.2e %12.2e %12.2e %10.2f %10.2f\n", "square", count, errors[0], errors[1], errors[2], ns[1] / ns[0], ns[2] / ns[0]);
+    }
+}
+
+// Block DWT throughput on a long signal and per-sample cost of the streaming cascade.
+static void BenchDwt()
+{
+    static const char* names[] = { "Haar", "D4", "Db6", "CDF9/7" };
+    const Dsp::Wavelet wavelets[] = { { Dsp::WaveletType::Haar, 1 }, { Dsp::WaveletType::Daubechies, 2 }, { Dsp::WaveletType::Daubechies, 6 }, { Dsp::WaveletType::Cdf97, 0 } };
+    size_t n = 1 << 20;
+    std::vector<float> x = RandomSignal(n);
+    printf("%-8s %14s %14s\n", "wavelet", "block ns/smp", "stream ns/smp");
+    for (int w = 0; w < 4; w++)
+    {
+        Dsp::DwtPlan plan(wavelets[w], n, 8);
+        double block_ns = TimeNs(Label("%s/block", names[w]), [&] { plan.Forward(x.data()); plan.Inverse(x.data()); }) / (2.0 * (double)n);
+        Dsp::StreamingDwt stream(wavelets[w], 8, 4096);
+        double stream_ns = TimeNs(Label("%s/stream", names[w]), [&] { for (size_t i = 0; i < 4096; i++) stream.Push(x[i]); }) / 4096.0;
+        printf("%-8s %14.2f %14.2f\n", names[w], block_ns, stream_ns);
+    }
+}
+
+// Scalogram of a 1M-sample chirp over hundreds of scales, single thread vs the global pool.
+static void BenchCwt()
+{
+    size_t n = 1 << 20;
+    std::vector<float> x(n);
+    for (size_t i = 0; i < n; i++)
+        x[i] = std::sin(0.001f * (float)i * (1.0f + 1e-6f * (float)i));
+
+    Core::ThreadPool& pool = Core::ThreadPool::Global();
+    printf("%-10s %8s %8s %12s %12s\n", "wavelet", "scales", "threads", "1 thread ms", "pool ms");
+    for (size_t scales : { 64, 256 })
+    {
+        for (Dsp::CwtWavelet w : { Dsp::CwtWavelet::Morlet, Dsp::CwtWavelet::MexicanHat })
+        {
+            Dsp::CwtPlan plan(w, n, Dsp::CwtPlan::LogScales(2.0f, 8192.0f, scales));
+            std::vector<float> image(scales * 1024);
+            const char* name = (w == Dsp::CwtWavelet::Morlet) ? "Morlet" : "MexHat";
+            double single = TimeNs(Label("%s/%zu/single", name, scales), [&] { plan.Scalogram(x.data(), image.data(), 1024, nullptr); }, 0.0) * 1e-6;
+            double pooled = TimeNs(Label("%s/%zu/pool", name, scales), [&] { plan.Scalogram(x.data(), image.data(), 1024, &pool); }, 0.0) * 1e-6;
+            printf("%-10s %8zu %8u %12.1f %12.1f\n", name, scales, pool.ThreadCount(), single, pooled);
+        }
+    }
+}
+
+// One second of 64-channel 192 kHz audio through an 8th-order elliptic
+// cascade and a 64-tap decimate-by-4 FIR, reported as a fraction of one core.
+static void BenchFilter()
+{
+    const size_t channels = 64;
+    const size_t rate = 192000;
+    const size_t block = 512;
+    std::vector<float> x = RandomSignal(block * channels);
+    std::vector<float> y(block * channels);
+
+    Dsp::FilterSpec spec;
+    spec.family = Dsp::FilterFamily::Elliptic;
+    spec.order = 8;
+    spec.cutoff = 0.1;
+    Dsp::BiquadCascade iir(Dsp::DesignIir(spec), channels);
+    double iir_ns = TimeNs("iir", [&] { iir.Process(x.data(), y.data(), block); });
+
+    Dsp::FirFilter fir(Dsp::DesignFirLowpass(64, 0.1), channels, 4);
+    double fir_ns = TimeNs("fir", [&] { fir.Process(x.data(), block, y.data()); });
+
+    double blocks_per_second = (double)rate / (double)block;
+    printf("%-28s %10.2f %% of a core\n", "iir 8th order x64 @192k", iir_ns * blocks_per_second * 1e-7);
+    printf("%-28s %10.2f %% of a core\n", "fir 64 taps /4 x64 @192k", fir_ns * blocks_per_second * 1e-7);
+}
+
+static void BenchHilbert()
+{
+    printf("%-10s %8s %14s\n", "mode", "size", "ns/sample");
+    for (size_t n : { 1024, 4096, 3000 })
+    {
+        std::vector<float> x = RandomSignal(n);
+        std::vector<Dsp::Complex> z(n);
+        Dsp::HilbertPlan plan(n);
+        double ns = TimeNs(Label("block/%zu", n), [&] { plan.Analytic(x.data(), z.data()); });
+        printf("%-10s %8zu %14.2f\n", "block", n, ns / (double)n);
+    }
+    std::vector<float> x = RandomSignal(4096);
+    for (size_t taps : { 63, 255 })
+    {
+        Dsp::StreamingHilbert stream(taps);
+        float sink = 0.0f;
+        double ns = TimeNs(Label("fir/%zu", taps), [&] { for (float v : x) sink += stream.Push(v).imag(); });
+        printf("%-10s %8zu %14.2f\n", "fir", taps, ns / (double)x.size() + sink * 0.0f);
+    }
+}
+
+// Stereo conversions in 4800-frame blocks, as ns per input frame.
+static void BenchResample()
+{
+    const size_t frames = 4800;
+    std::vector<float> x = RandomSignal(2 * frames);
+    printf("%-24s %12s\n", "conversion", "ns/frame");
+    struct Case { const char* name; Dsp::Resampler resampler; };
+    Case cases[] = {
+        { "48000 -> 44100", Dsp::Resampler(441, 480, 2) },
+        { "44100 -> 48000", Dsp::Resampler(480, 441, 2) },
+        { "48000 -> 44100.3", Dsp::Resampler(44100.3 / 48000.0, 2) },
+        { "48000 -> 60 (display)", Dsp::Resampler(60.0 / 48000.0, 2) },
+    };
+    for (Case& c : cases)
+    {
+        std::vector<float> y(2 * c.resampler.MaxOutput(frames));
+        double ns = TimeNs(c.name, [&] { c.resampler.Process(x.data(), frames, y.data()); });
+        printf("%-24s %12.2f\n", c.name, ns / (double)frames);
+    }
+}
+
+// Codelet leaves against the generic radix-2 / Bluestein paths.
+static void BenchFft()
+{
+    printf("%8s %12s %12s %8s\n", "n", "generic ns", "codelet ns", "speedup");
+    for (size_t n : { 4, 8, 16, 32, 64, 256, 1024, 4096, 65536, 3, 5, 7, 13, 48, 320, 768, 1792, 3072, 6656 })
+    {
+        std::vector<float> re = RandomSignal(n, 1), im = RandomSignal(n, 2);
+        std::vector<Dsp::Complex> src(n), x(n);
+        for (size_t i = 0; i < n; i++)
+            src[i] = Dsp::Complex(re[i], im[i]);
+        Dsp::FftPlan generic(n, false), codelet(n);
+        double generic_ns = TimeNs(Label("generic/%zu", n), [&] { x = src; generic.Forward(x.data()); });
+        double codelet_ns = TimeNs(Label("codelet/%zu", n), [&] { x = src; codelet.Forward(x.data()); });
+        printf("%8zu %12.0f %12.0f %8.2f\n", n, generic_ns, codelet_ns, generic_ns / codelet_ns);
+    }
+}
+
+// One 128-frame audio block of the direct oscillator bank and the inverse-FFT
+// spectral bank, each with its share of the real-time budget at 48 kHz, and
+// the partial count above which the spectral bank is faster.
+static void BenchOscillators()
+{
+    const size_t frames = 128;
+    const double sample_rate = 48000.0;
+    printf("%-10s %-10s %10s %14s %10s\n", "bank", "partials", "ns/block", "ns/partial", "load");
+    for (size_t partials : { 64, 256, 2048, 8192 })
+    {
+        std::vector<Dsp::Epicycle> circles(partials);
+        Dsp::MakeSeries(Dsp::SeriesType::Sawtooth, partials, 0.5f, circles.data());
+        // Low enough that every partial is below Nyquist
+        Dsp::OscillatorBank bank(partials, sample_rate);
+        bank.SetSeries(circles.data(), partials, 2.0, 1.0f);
+        bank.Reset();
+        Dsp::SpectralBank spectral(partials, sample_rate);
+        spectral.SetSeries(circles.data(), partials, 2.0, 1.0f);
+        spectral.Reset();
+        std::vector<float> out(frames);
+        double direct_ns = TimeNs(Label("direct/%zu", partials), [&] { bank.Render(out.data(), frames); });
+        double spectral_ns = TimeNs(Label("spectral/%zu", partials), [&] { spectral.Render(out.data(), frames); });
+        for (auto [name, ns] : { std::pair{ "direct", direct_ns }, std::pair{ "spectral", spectral_ns } })
+            printf("%-10s %-10zu %10.0f %14.3f %9.1f%%\n", name, partials, ns, ns / (double)partials,
+                   100.0 * ns / (1e9 * (double)frames / sample_rate));
+    }
+    // What AudioOutput uses to pick a bank
+    size_t crossover = Dsp::MeasureSpectralCrossover(sample_rate, frames);
+    if (crossover == (size_t)-1)
+        printf("crossover: direct is faster up to 8192 partials\n");
+    else
+        printf("crossover: spectral is faster above ~%zu partials\n", crossover);
+}
+
+static void BenchConvergence()
+{
+    const size_t terms = 360, points = 1024;
+    std::vector<Dsp::Epicycle> circles(terms);
+    Dsp::MakeSeries(Dsp::SeriesType::Square, terms, 1.0f, circles.data());
+    printf("%10s %12s %12s %14s\n", "budget", "levels", "ms", "additions");
+    for (size_t budget_kb : { 4096, 256 })
+    {
+        Dsp::ConvergenceCache cache(budget_kb << 10);
+        cache.Configure(circles.data(), terms, points);
+        // Every level in order, then the slider dragged back down to one
+        double ms = TimeNs(Label("sweep/%zuk", budget_kb), [&]
+        {
+            cache.Clear();
+            cache.Precompute();
+            for (size_t n = terms; n >= 1; n--)
+                cache.Get(n);
+        }) * 1e-6;
+        printf("%9zuk %12zu %12.3f %14llu\n", budget_kb, cache.CachedLevels(), ms, (unsigned long long)cache.Additions());
+    }
+}
+
+static void BenchBasis()
+{
+    const size_t points = 1024;
+    const double step = -1.0 / 60.0;
+    Core::ThreadPool& pool = Core::ThreadPool::Global();
+    printf("%8s %12s %12s %12s %12s\n", "circles", "direct ms", "cached ms", "pool ms", "generated ms");
+    for (size_t terms : { 64, 360, 2048 })
+    {
+        std::vector<Dsp::Epicycle> circles(terms);
+        Dsp::MakeSeries(Dsp::SeriesType::Square, terms, 1.0f, circles.data());
+        std::vector<float> x(points), y(points), joint_x(terms), joint_y(terms);
+        double time = 0.0;
+        // One chain evaluation per point, as without the basis
+        double direct = TimeNs(Label("direct/%zu", terms), [&]
+        {
+            for (size_t j = 0; j < points; j++)
+            {
+                Dsp::EvaluateEpicycles(circles.data(), terms, time + (double)j * step, joint_x.data(), joint_y.data());
+                x[j] = joint_x[terms - 1];
+                y[j] = joint_y[terms - 1];
+            }
+        }) * 1e-6;
+        Dsp::BasisCache cached;
+        cached.Synthesize(circles.data(), terms, time, points, step, x.data(), y.data());
+        double single = TimeNs(Label("cached/%zu", terms), [&] { cached.Synthesize(circles.data(), terms, time += 0.01, points, step, x.data(), y.data()); }) * 1e-6;
+        double pooled = TimeNs(Label("pool/%zu", terms), [&] { cached.Synthesize(circles.data(), terms, time += 0.01, points, step, x.data(), y.data(), &pool); }) * 1e-6;
+        Dsp::BasisCache generated(0);
+        double generating = TimeNs(Label("generated/%zu", terms), [&] { generated.Synthesize(circles.data(), terms, time += 0.01, points, step, x.data(), y.data()); }) * 1e-6;
+        printf("%8zu %12.3f %12.3f %12.3f %12.3f\n", terms, direct, single, pooled, generating);
+    }
+}
+
+// The Circle Window's scene (square-wave chain, joints, 1000-sample trace)
+// on a 1280x400 target, single thread vs the global pool, as ms per frame.
+static void BenchRaster()
+{
+    const int width = 1280, height = 400;
+    std::vector<uint32_t> pixels((size_t)width * height);
+    Raster::Target target{ pixels.data(), width, height, width, 0, 0 };
+    Raster::Rasterizer rasterizer;
+    Core::ThreadPool& pool = Core::ThreadPool::Global();
+    printf("%8s %8s %12s %12s\n", "circles", "threads", "1 thread ms", "pool ms");
+    for (size_t circles : { 16, 64, 360 })
+    {
+        std::vector<Dsp::Epicycle> chain(circles);
+        for (size_t i = 0; i < circles; i++)
+        {
+            float n = (float)(2 * i + 1);
+            chain[i].radius = 60.0f * 4.0f / (n * std::numbers::pi_v<float>);
+            chain[i].harmonic = -(int32_t)(2 * i + 1);
+        }
+        std::vector<float> x(circles), y(circles);
+        Dsp::EvaluateEpicycles(chain.data(), circles, 0.7, x.data(), y.data());
+
+        Raster::Scene scene;
+        float cx = 100.0f, cy = 200.0f, px = cx, py = cy;
+        for (size_t i = 0; i < circles; i++)
+        {
+            scene.AddCircle(px, py, chain[i].radius, Raster::MakeColor(255, 255, 255, 100));
+            scene.AddLine(px, py, cx + x[i], cy + y[i], Raster::MakeColor(255, 255, 255, 100));
+            px = cx + x[i];
+            py = cy + y[i];
+        }
+        for (int i = 0; i < 1000; i++)
+            scene.AddLine(1270.0f - (float)i, cy + 80.0f * std::sin(0.05f * (float)i), 1269.0f - (float)i, cy + 80.0f * std::sin(0.05f * (float)(i + 1)),
+                          Raster::MakeColor(255, 0, 0), 1.5f);
+        auto frame = [&](Core::ThreadPool* p)
+        {
+            Raster::Fill(target, Raster::MakeColor(15, 15, 15), p);
+            rasterizer.Draw(scene, target, p);
+        };
+        double single = TimeNs(Label("%zu/single", circles), [&] { frame(nullptr); }) * 1e-6;
+        double pooled = TimeNs(Label("%zu/pool", circles), [&] { frame(&pool); }) * 1e-6;
+        printf("%8zu %8u %12.2f %12.2f\n", circles, pool.ThreadCount(), single, pooled);
+    }
+}
+
+struct Benchmark
+{
+    const char* name;
+    void (*fn)();
+};
+
+static const Benchmark benchmarks[] =
+{
+    { "fft", BenchFft },
+    { "batchfft", BenchBatchFft },
+    { "fixed", BenchFixed },
+    { "summation", BenchSummation },
+    { "dct", BenchDct },
+    { "dwt", BenchDwt },
+    { "cwt", BenchCwt },
+    { "filter", BenchFilter },
+    { "resample", BenchResample },
+    { "hilbert", BenchHilbert },
+    { "raster", BenchRaster },
+    { "oscillators", BenchOscillators },
+    { "convergence", BenchConvergence },
+    { "basis", BenchBasis },
+};
+
+#ifndef FOURIER_SOURCE_DIR
+#define FOURIER_SOURCE_DIR "."
+#endif
+
+static void PrintUsage()
+{
+    printf("usage: fourier-bench [options] [filter]\n"
+           "  --trials N        timed trials per metric (default %u)\n"
+           "  --cpu N           pin to CPU N (default: the current one)\n"
+           "  --no-pin          leave the scheduler free to migrate the thread\n"
+           "  --history FILE    history file (default %s/bench/history.tsv)\n"
+           "  --no-history      don't append this run\n"
+           "  --baseline REV    compare with this commit (default: nearest ancestor with results)\n"
+           "  --threshold PCT   smallest change flagged (default 3)\n",
+           Bench::GetSettings().trials, FOURIER_SOURCE_DIR);
+}
+
+static std::string ShortRevision(const std::string& revision)
+{
+    size_t dirty = revision.find('+');
+    return revision.substr(0, std::min<size_t>(12, dirty)) + (dirty != std::string::npos ? revision.substr(dirty) : "");
+}
+
+// Spread of the confidence intervals and the metrics whose clock drifted.
+static void PrintTrialSummary()
+{
+    const auto& results = Bench::Results();
+    if (results.empty())
+        return;
+    std::vector<double> widths;
+    const Bench::Result* widest = &results.front();
+    for (const Bench::Result& r : results)
+    {
+        widths.push_back(r.ci95 / r.mean);
+        if (r.ci95 / r.mean > widest->ci95 / widest->mean)
+            widest = &r;
+    }
+    std::sort(widths.begin(), widths.end());
+    printf("%zu metrics, up to %u trials each; 95%% CI of the mean: median +-%.1f%%, widest +-%.1f%% (%s)\n", results.size(),
+           Bench::GetSettings().trials, 100.0 * widths[widths.size() / 2], 100.0 * widths.back(), widest->metric.c_str());
+    for (const Bench::Result& r : results)
+        if (!r.stable)
+            printf("unstable: %s (reference loop drifted %.1f%%)\n", r.metric.c_str(), 100.0 * r.drift);
+}
+
+int main(int argc, char** argv)
+{
+    const char* filter = "";
+    std::string history_path = FOURIER_SOURCE_DIR "/bench/history.tsv";
+    const char* baseline_rev = nullptr;
+    bool record = true;
+    bool pin = true;
+    int cpu = -1;
+    Bench::Settings& settings = Bench::GetSettings();
+    Bench::CompareSettings compare;
+    for (int i = 1; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool value = i + 1 < argc;
+        if (arg == "--trials" && value)
+            settings.trials = (unsigned)std::max(2, atoi(argv[++i]));
+        else if (arg == "--cpu" && value)
+            cpu = atoi(argv[++i]);
+        else if (arg == "--no-pin")
+            pin = false;
+        else if (arg == "--history" && value)
+            history_path = argv[++i];
+        else if (arg == "--no-history")
+            record = false;
+        else if (arg == "--baseline" && value)
+            baseline_rev = argv[++i];
+        else if (arg == "--threshold" && value)
+            compare.min_change = atof(argv[++i]) / 100.0;
+        else if (arg[0] == '-')
+        {
+            PrintUsage();
+            return 2;
+        }
+        else
+            filter = argv[i];
+    }
+
+    // Start the pool workers before pinning so they keep the full CPU mask.
+    Core::ThreadPool::Global();
+    if (pin)
+    {
+        char error[128];
+        cpu = Bench::PinThread(cpu, error, sizeof(error));
+        if (cpu >= 0)
+            printf("pinned to cpu %d\n", cpu);
+        else
+            printf("not pinned: %s\n", error);
+    }
+    Bench::PrintEnvironment(stdout, cpu);
+    printf("\n");
+
+    for (const Benchmark& b : benchmarks)
+    {
+        if (strstr(b.name, filter) == nullptr)
+            continue;
+        printf("== %s ==\n", b.name);
+        Bench::SetGroup(b.name);
+        {
+            Core::PerfScope scope(b.name);
+            b.fn();
+        }
+        printf("\n");
+    }
+
+    // Hardware counters of the calling thread over each whole benchmark
+    // (pool workers are not counted).
+    printf("== counters ==\n");
+    Core::PerfRegistry::Print(stdout);
+
+    printf("\n== trials ==\n");
+    PrintTrialSummary();
+
+    printf("\n== history ==\n");
+    std::string revision = Bench::CurrentRevision(FOURIER_SOURCE_DIR);
+    if (revision.empty())
+        revision = "unknown";
+    std::vector<Bench::HistoryEntry> history = Bench::LoadHistory(history_path.c_str());
+    std::string baseline;
+    if (baseline_rev != nullptr)
+    {
+        baseline = Bench::ResolveRevision(FOURIER_SOURCE_DIR, baseline_rev);
+        if (baseline.empty())
+            printf("unknown baseline revision '%s'\n", baseline_rev);
+    }
+    else
+        baseline = Bench::FindBaseline(history, Bench::Ancestors(FOURIER_SOURCE_DIR, 1000), revision);
+
+    size_t regressions = 0;
+    std::vector<Bench::Result> base = Bench::ResultsOf(history, baseline);
+    if (baseline.empty() || base.empty())
+        printf("no baseline results in %s\n", history_path.c_str());
+    else
+    {
+        printf("%s against baseline %s\n", ShortRevision(revision).c_str(), ShortRevision(baseline).c_str());
+        regressions = Bench::Compare(stdout, base, Bench::Results(), compare);
+    }
+    if (record)
+    {
+        if (Bench::AppendHistory(history_path.c_str(), revision, Bench::Results()))
+            printf("appended %zu metrics to %s\n", Bench::Results().size(), history_path.c_str());
+        else
+            printf("cannot write %s\n", history_path.c_str());
+    }
+    return regressions > 0 ? 1 : 0;
+}
@@ -0,0 +1,384 @@
+#include "SignalFile.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+static bool HasExtension(const char* path, const char* ext)
+{
+    size_t n = strlen(path), e = strlen(ext);
+    if (n < e)
+        return false;
+    for (size_t i = 0; i < e; i++)
+        if (tolower((unsigned char)path[n - e + i]) != ext[i])
+            return false;
+    return true;
+}
+
+SignalFormat SignalFormatFromPath(const char* path)
+{
+    if (HasExtension(path, ".wav"))
+        return SignalFormat::Wav;
+    if (HasExtension(path, ".csv"))
+        return SignalFormat::Csv;
+    return SignalFormat::Raw;
+}
+
+static void Put16(uint8_t* p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static void Put32(uint8_t* p, uint32_t v)
+{
+    Put16(p, v);
+    Put16(p + 2, v >> 16);
+}
+
+//-----------------------------------------------------------------------------
+// Writer
+//-----------------------------------------------------------------------------
+
+SignalWriter::~SignalWriter()
+{
+    if (file_ != nullptr)
+        fclose(file_);
+}
+
+bool SignalWriter::Fail(const char* what)
+{
+    if (error_[0] == '\0')
+        snprintf(error_, sizeof(error_), "%s: %s", what, strerror(errno));
+    return false;
+}
+
+// RIFF header; the fact chunk is required for non-PCM data.
+static size_t WavHeader(const SignalLayout& layout, uint64_t data_bytes, uint8_t* h)
+{
+    uint32_t sample_bytes = layout.float_samples ? 4 : 2;
+    uint32_t fmt_size = layout.float_samples ? 18 : 16;
+    size_t size = 12 + 8 + fmt_size + (layout.float_samples ? 12 : 0) + 8;
+    uint32_t frame_bytes = sample_bytes * (uint32_t)layout.channels;
+    memcpy(h, "RIFF", 4);
+    Put32(h + 4, (uint32_t)(size - 8 + data_bytes));
+    memcpy(h + 8, "WAVEfmt ", 8);
+    Put32(h + 16, fmt_size);
+    Put16(h + 20, layout.float_samples ? 3 : 1);
+    Put16(h + 22, (uint32_t)layout.channels);
+    Put32(h + 24, (uint32_t)std::lround(layout.sample_rate));
+    Put32(h + 28, (uint32_t)std::lround(layout.sample_rate) * frame_bytes);
+    Put16(h + 32, frame_bytes);
+    Put16(h + 34, sample_bytes * 8);
+    uint8_t* p = h + 36;
+    if (layout.float_samples)
+    {
+        Put16(p, 0);
+        memcpy(p + 2, "fact", 4);
+        Put32(p + 6, 4);
+        Put32(p + 10, (uint32_t)(data_bytes / frame_bytes));
+        p += 14;
+    }
+    memcpy(p, "data", 4);
+    Put32(p + 4, (uint32_t)data_bytes);
+    return size;
+}
+
+bool SignalWriter::Open(const char* path, const SignalLayout& layout, uint64_t frames)
+{
+    layout_ = layout;
+    layout_.channels = std::max(layout.channels, 1);
+    bytes_ = 0;
+    error_[0] = '\0';
+    uint64_t data_bytes = frames * (uint64_t)layout_.channels * (layout_.float_samples ? 4 : 2);
+    if (layout_.format == SignalFormat::Wav && data_bytes > 0xFFFFFFFFull - 64)
+    {
+        snprintf(error_, sizeof(error_), "%s: WAV files are limited to 4 GiB; use a .f32 or .csv output", path);
+        return false;
+    }
+    file_ = fopen(path, "wb");
+    if (file_ == nullptr)
+        return Fail(path);
+    // Large buffer: the writes come in chunks of megabytes anyway
+    setvbuf(file_, nullptr, _IOFBF, 1 << 20);
+
+    std::string header;
+    if (layout_.format == SignalFormat::Wav)
+    {
+        uint8_t h[64];
+        header_size_ = WavHeader(layout_, data_bytes, h);
+        header.assign((const char*)h, header_size_);
+    }
+    else if (layout_.format == SignalFormat::Csv)
+    {
+        header = "time";
+        for (int c = 0; c < layout_.channels; c++)
+        {
+            if (layout_.channels == 1)
+                header += ",value";
+            else if (layout_.channels == 2)
+                header += (c == 0) ? ",x" : ",y";
+            else
+                header += ",c" + std::to_string(c);
+        }
+        header += '\n';
+        header_size_ = header.size();
+    }
+    return Write(header);
+}
+
+void SignalWriter::Encode(const float* frames, size_t count, uint64_t first, std::string& out) const
+{
+    size_t values = count * (size_t)layout_.channels;
+    switch (layout_.format)
+    {
+        case SignalFormat::Wav:
+        {
+            size_t at = out.size();
+            if (layout_.float_samples)
+            {
+                out.resize(at + values * 4);
+                for (size_t i = 0; i < values; i++)
+                {
+                    uint32_t bits;
+                    memcpy(&bits, &frames[i], 4);
+                    Put32((uint8_t*)&out[at + 4 * i], bits);
+                }
+            }
+            else
+            {
+                out.resize(at + values * 2);
+                for (size_t i = 0; i < values; i++)
+                {
+                    float v = std::clamp(frames[i], -1.0f, 1.0f) * 32767.0f;
+                    Put16((uint8_t*)&out[at + 2 * i], (uint32_t)(int32_t)std::lrint(v));
+                }
+            }
+            break;
+        }
+        case SignalFormat::Csv:
+        {
+            // Shortest text that reads back to the same value, any number
+            // of channels per line
+            char field[32];
+            char* end = field + sizeof(field);
+            for (size_t f = 0; f < count; f++)
+            {
+                out.append(field, std::to_chars(field, end, (double)(first + f) / layout_.sample_rate).ptr);
+                for (int c = 0; c < layout_.channels; c++)
+                {
+                    out.push_back(',');
+                    out.append(field, std::to_chars(field, end, frames[f * (size_t)layout_.channels + (size_t)c]).ptr);
+                }
+                out.push_back('\n');
+            }
+            break;
+        }
+        case SignalFormat::Raw:
+            out.append((const char*)frames, values * sizeof(float));
+            break;
+    }
+}
+
+bool SignalWriter::Write(const std::string& bytes)
+{
+    if (file_ == nullptr)
+        return false;
+    if (fwrite(bytes.data(), 1, bytes.size(), file_) != bytes.size())
+        return Fail("write");
+    bytes_ += bytes.size();
+    return true;
+}
+
+bool SignalWriter::Finish()
+{
+    if (file_ == nullptr)
+        return false;
+    bool ok = true;
+    if (layout_.format == SignalFormat::Wav)
+    {
+        // Rewrite the header with what was actually written
+        uint8_t h[64];
+        WavHeader(layout_, bytes_ - header_size_, h);
+        ok = fseek(file_, 0, SEEK_SET) == 0 && fwrite(h, 1, header_size_, file_) == header_size_;
+        if (!ok)
+            Fail("header");
+    }
+    if (fclose(file_) != 0 && ok)
+        ok = Fail("close");
+    file_ = nullptr;
+    return ok;
+}
+
+//-----------------------------------------------------------------------------
+// Reader
+//-----------------------------------------------------------------------------
+
+static uint32_t Get16(const uint8_t* p) { return (uint32_t)p[0] | ((uint32_t)p[1] << 8); }
+static uint32_t Get32(const uint8_t* p) { return Get16(p) | (Get16(p + 2) << 16); }
+
+static bool ReadFile(const char* path, std::vector<uint8_t>& data)
+{
+    FILE* f = fopen(path, "rb");
+    if (f == nullptr)
+        return false;
+    uint8_t buffer[1 << 16];
+    size_t got;
+    while ((got = fread(buffer, 1, sizeof(buffer), f)) > 0)
+        data.insert(data.end(), buffer, buffer + got);
+    bool ok = !ferror(f);
+    fclose(f);
+    return ok;
+}
+
+static bool ParseWav(const std::vector<uint8_t>& data, Signal& out, char* error, size_t error_size)
+{
+    if (data.size() < 12 || memcmp(data.data(), "RIFF", 4) != 0 || memcmp(data.data() + 8, "WAVE", 4) != 0)
+    {
+        snprintf(error, error_size, "not a RIFF/WAVE file");
+        return false;
+    }
+    uint32_t format = 0, bits = 0;
+    const uint8_t* samples = nullptr;
+    size_t sample_bytes = 0;
+    for (size_t at = 12; at + 8 <= data.size();)
+    {
+        const uint8_t* chunk = data.data() + at;
+        size_t size = std::min<size_t>(Get32(chunk + 4), data.size() - at - 8);
+        if (memcmp(chunk, "fmt ", 4) == 0 && size >= 16)
+        {
+            format = Get16(chunk + 8);
+            out.channels = (int)Get16(chunk + 10);
+            out.sample_rate = (double)Get32(chunk + 12);
+            bits = Get16(chunk + 22);
+            // WAVE_FORMAT_EXTENSIBLE: the real format opens the sub-format GUID
+            if (format == 0xFFFE && size >= 26)
+                format = Get16(chunk + 32);
+        }
+        else if (memcmp(chunk, "data", 4) == 0)
+        {
+            samples = chunk + 8;
+            sample_bytes = size;
+        }
+        at += 8 + size + (size & 1);
+    }
+    bool pcm = format == 1 && (bits == 8 || bits == 16 || bits == 24 || bits == 32);
+    bool ieee = format == 3 && bits == 32;
+    if (samples == nullptr || out.channels < 1 || (!pcm && !ieee))
+    {
+        snprintf(error, error_size, "unsupported WAV (format %u, %u bits)", format, bits);
+        return false;
+    }
+    size_t width = bits / 8;
+    size_t count = sample_bytes / width / (size_t)out.channels * (size_t)out.channels;
+    out.samples.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        const uint8_t* p = samples + i * width;
+        float v;
+        if (ieee)
+            memcpy(&v, p, 4);
+        else if (bits == 8)
+            v = ((float)p[0] - 128.0f) / 128.0f;
+        else if (bits == 16)
+            v = (float)(int16_t)Get16(p) / 32768.0f;
+        else if (bits == 24)
+            v = (float)((int32_t)(Get16(p) << 8 | (uint32_t)p[2] << 24) >> 8) / 8388608.0f;
+        else
+            v = (float)((double)(int32_t)Get32(p) / 2147483648.0);
+        out.samples[i] = v;
+    }
+    return true;
+}
+
+static bool ParseCsv(const std::vector<uint8_t>& data, Signal& out, char* error, size_t error_size)
+{
+    std::string text(data.begin(), data.end());
+    std::vector<float> row;
+    int columns = 0;
+    bool skip_first = false;
+    size_t line_number = 0;
+    for (size_t at = 0; at < text.size();)
+    {
+        size_t end = text.find('\n', at);
+        if (end == std::string::npos)
+            end = text.size();
+        std::string line = text.substr(at, end - at);
+        at = end + 1;
+        line_number++;
+        if (line.empty() || line[0] == '#' || line.find_first_not_of(" \t\r") == std::string::npos)
+            continue;
+
+        row.clear();
+        const char* p = line.c_str();
+        bool numeric = true;
+        while (*p != '\0')
+        {
+            while (*p == ' ' || *p == '\t' || *p == ',' || *p == '\r')
+                p++;
+            if (*p == '\0')
+                break;
+            char* next;
+            double v = strtod(p, &next);
+            if (next == p)
+            {
+                numeric = false;
+                break;
+            }
+            row.push_back((float)v);
+            p = next;
+        }
+        if (!numeric)
+        {
+            // A header before any data
+            if (columns != 0)
+            {
+                snprintf(error, error_size, "line %zu: not a number", line_number);
+                return false;
+            }
+            skip_first = line.compare(0, 4, "time") == 0;
+            continue;
+        }
+        size_t first = skip_first ? 1 : 0;
+        if (row.size() <= first)
+            continue;
+        if (columns == 0)
+            columns = (int)(row.size() - first);
+        if (row.size() - first != (size_t)columns)
+        {
+            snprintf(error, error_size, "line %zu: %zu columns, expected %d", line_number, row.size() - first, columns);
+            return false;
+        }
+        out.samples.insert(out.samples.end(), row.begin() + (ptrdiff_t)first, row.end());
+    }
+    out.channels = std::max(columns, 1);
+    return true;
+}
+
+bool ReadSignal(const char* path, int raw_channels, Signal& out, char* error, size_t error_size)
+{
+    out = Signal();
+    std::vector<uint8_t> data;
+    if (!ReadFile(path, data))
+    {
+        snprintf(error, error_size, "%s: %s", path, strerror(errno));
+        return false;
+    }
+    switch (SignalFormatFromPath(path))
+    {
+        case SignalFormat::Wav:
+            return ParseWav(data, out, error, error_size);
+        case SignalFormat::Csv:
+            return ParseCsv(data, out, error, error_size);
+        case SignalFormat::Raw:
+            out.channels = std::max(raw_channels, 1);
+            out.samples.resize(data.size() / sizeof(float) / (size_t)out.channels * (size_t)out.channels);
+            memcpy(out.samples.data(), data.data(), out.samples.size() * sizeof(float));
+            return true;
+    }
+    return false;
+}
@@ -0,0 +1,76 @@
+// Sample files for fourier-cli: WAV, CSV and raw float32.
+//
+// Writing is split in two so it can run on many threads: Encode turns frames
+// into the bytes of the file and touches no shared state, Write appends those
+// bytes in order. Reading loads the whole file as float frames.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+enum class SignalFormat
+{
+    Wav,        // 16-bit PCM or 32-bit float
+    Csv,        // time, then one column per channel
+    Raw,        // Interleaved float32 in host byte order
+};
+
+// From the extension of `path` (.wav, .csv); raw otherwise.
+SignalFormat SignalFormatFromPath(const char* path);
+
+struct SignalLayout
+{
+    SignalFormat format = SignalFormat::Wav;
+    int channels = 1;
+    double sample_rate = 48000.0;
+    bool float_samples = false;     // WAV only
+};
+
+class SignalWriter
+{
+public:
+    SignalWriter() = default;
+    ~SignalWriter();
+
+    SignalWriter(const SignalWriter&) = delete;
+    SignalWriter& operator=(const SignalWriter&) = delete;
+
+    // Creates the file and writes the header for `frames` frames.
+    bool Open(const char* path, const SignalLayout& layout, uint64_t frames);
+    // Appends the encoding of `count` interleaved frames, the first of which
+    // is frame `first` of the file, to `out`. Safe to call concurrently.
+    void Encode(const float* frames, size_t count, uint64_t first, std::string& out) const;
+    bool Write(const std::string& bytes);
+    // Fixes the sizes in the header and closes the file.
+    bool Finish();
+
+    uint64_t BytesWritten() const { return bytes_; }
+    const char* Error() const { return error_; }
+
+private:
+    bool Fail(const char* what);
+
+    FILE* file_ = nullptr;
+    SignalLayout layout_;
+    uint64_t bytes_ = 0;
+    size_t header_size_ = 0;
+    char error_[160] = "";
+};
+
+struct Signal
+{
+    std::vector<float> samples;     // Interleaved
+    int channels = 1;
+    double sample_rate = 0.0;       // 0 when the file does not say
+
+    size_t Frames() const { return samples.size() / (size_t)channels; }
+};
+
+// Loads a whole file. CSV columns are split on commas or spaces; a header row
+// is skipped, and so is a first column named "time". Raw files are read as
+// `raw_channels` channels.
+bool ReadSignal(const char* path, int raw_channels, Signal& out, char* error, size_t error_size);
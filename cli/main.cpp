@@ -0,0 +1,542 @@
+// fourier-cli: the series of the Circle Window without the window.
+//
+//   synth         a series (built-in waveform or coefficient file) to WAV, CSV or raw float32
+//   coefficients  the epicycles of a signal or a closed curve, as CSV
+//   render        epicycle reconstructions of a contour to PNG / TIFF frames
+
+#include "Core/ThreadPool.h"
+#include "Dsp/Epicycles.h"
+#include "Dsp/Series.h"
+#include "Raster/Export.h"
+#include "Raster/ImageWriter.h"
+#include "Raster/Rasterizer.h"
+
+#include "SignalFile.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <future>
+#include <numbers>
+#include <string>
+#include <vector>
+
+static double Seconds(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// Circles from a CSV of harmonic, radius, phase rows (what `coefficients` writes).
+static bool LoadSeries(const char* path, std::vector<Dsp::Epicycle>& circles)
+{
+    Signal table;
+    char error[256];
+    if (!ReadSignal(path, 3, table, error, sizeof(error)))
+    {
+        fprintf(stderr, "%s\n", error);
+        return false;
+    }
+    if (table.channels != 3)
+    {
+        fprintf(stderr, "%s: expected harmonic,radius,phase columns\n", path);
+        return false;
+    }
+    circles.resize(table.Frames());
+    for (size_t i = 0; i < circles.size(); i++)
+    {
+        circles[i].harmonic = (int32_t)std::lround(table.samples[3 * i]);
+        circles[i].radius = table.samples[3 * i + 1];
+        circles[i].phase = table.samples[3 * i + 2];
+    }
+    return true;
+}
+
+//-----------------------------------------------------------------------------
+// synth
+//-----------------------------------------------------------------------------
+
+static void PrintSynthUsage()
+{
+    printf("usage: fourier-cli synth [options] -o FILE(.wav|.csv|.f32)\n"
+           "  --type NAME       square, sawtooth or triangle (default square)\n"
+           "  --series FILE     circles from a coefficient CSV instead\n"
+           "  --terms N         circles of --type (default 100)\n"
+           "  --frequency HZ    fundamental (default 220)\n"
+           "  --duration S      length (default 10)\n"
+           "  --rate HZ         sample rate (default 48000)\n"
+           "  --channels 1|2    1: y of the tip (the waveform), 2: x and y (default 1)\n"
+           "  --gain G          scale of the output (default 1; waveforms peak near 0.5)\n"
+           "  --float           32-bit float WAV instead of 16-bit PCM\n"
+           "  --alias           keep the partials above Nyquist\n"
+           "  --threads N       worker threads (default: all cores)\n");
+}
+
+// The chain repeats after rate.period samples, so one period is synthesized
+// exactly and the output is that period tiled. Tiles are encoded in blocks on
+// the pool while the previous chunk is written.
+static int Synth(int argc, char** argv)
+{
+    Dsp::SeriesType type = Dsp::SeriesType::Square;
+    const char* series_path = nullptr;
+    const char* output = nullptr;
+    size_t terms = 100;
+    double frequency = 220.0, duration = 10.0, sample_rate = 48000.0, gain = 1.0;
+    int channels = 1;
+    bool float_samples = false, band_limit = true;
+    unsigned threads = 0;
+    for (int i = 0; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool value = i + 1 < argc;
+        if (arg == "--type" && value)
+        {
+            if (!Dsp::SeriesTypeFromName(argv[++i], type))
+            {
+                fprintf(stderr, "unknown type '%s'\n", argv[i]);
+                return 2;
+            }
+        }
+        else if (arg == "--series" && value)
+            series_path = argv[++i];
+        else if (arg == "--terms" && value)
+            terms = (size_t)std::max(1, atoi(argv[++i]));
+        else if (arg == "--frequency" && value)
+            frequency = atof(argv[++i]);
+        else if (arg == "--duration" && value)
+            duration = atof(argv[++i]);
+        else if (arg == "--rate" && value)
+            sample_rate = atof(argv[++i]);
+        else if (arg == "--channels" && value)
+            channels = std::clamp(atoi(argv[++i]), 1, 2);
+        else if (arg == "--gain" && value)
+            gain = atof(argv[++i]);
+        else if (arg == "--float")
+            float_samples = true;
+        else if (arg == "--alias")
+            band_limit = false;
+        else if (arg == "--threads" && value)
+            threads = (unsigned)std::max(1, atoi(argv[++i]));
+        else if ((arg == "-o" || arg == "--output") && value)
+            output = argv[++i];
+        else
+        {
+            PrintSynthUsage();
+            return 2;
+        }
+    }
+    if (output == nullptr || !(sample_rate >= 1.0) || !(duration >= 0.0) || !(frequency >= 0.0))
+    {
+        PrintSynthUsage();
+        return 2;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<Dsp::Epicycle> circles;
+    if (series_path != nullptr)
+    {
+        if (!LoadSeries(series_path, circles))
+            return 1;
+    }
+    else
+    {
+        circles.resize(terms);
+        Dsp::MakeSeries(type, terms, 0.5f, circles.data());
+    }
+
+    Dsp::PeriodicRate rate = Dsp::ApproximateRate(frequency, sample_rate);
+    std::vector<Dsp::Complex> period((size_t)rate.period);
+    Dsp::SynthesizePeriod(circles.data(), circles.size(), rate, period.data(), band_limit);
+    // Interleaved, gain applied, repeated once so a block of up to a period
+    // can be copied without wrapping
+    std::vector<float> tile(2 * period.size() * (size_t)channels);
+    for (size_t j = 0; j < tile.size() / (size_t)channels; j++)
+    {
+        Dsp::Complex z = period[j % period.size()] * (float)gain;
+        if (channels == 1)
+            tile[j] = z.imag();
+        else
+        {
+            tile[2 * j] = z.real();
+            tile[2 * j + 1] = z.imag();
+        }
+    }
+    double actual = Dsp::Frequency(rate, sample_rate);
+    if (std::fabs(actual - frequency) > 1e-9 * std::max(frequency, 1.0))
+        fprintf(stderr, "fundamental %.9g Hz (nearest with a period of at most %llu samples)\n", actual, (unsigned long long)rate.period);
+
+    SignalLayout layout;
+    layout.format = SignalFormatFromPath(output);
+    layout.channels = channels;
+    layout.sample_rate = sample_rate;
+    layout.float_samples = float_samples;
+    uint64_t frames = (uint64_t)std::llround(duration * sample_rate);
+    SignalWriter writer;
+    if (!writer.Open(output, layout, frames))
+    {
+        fprintf(stderr, "%s\n", writer.Error());
+        return 1;
+    }
+
+    Core::ThreadPool pool(threads);
+    const size_t block_frames = 1 << 15;
+    const size_t chunk_blocks = 4 * pool.ThreadCount();
+    std::vector<std::string> chunks[2] = { std::vector<std::string>(chunk_blocks), std::vector<std::string>(chunk_blocks) };
+    std::future<bool> pending;
+    bool ok = true;
+    size_t period_frames = period.size();
+    for (uint64_t chunk_start = 0, slot = 0; chunk_start < frames && ok; chunk_start += block_frames * chunk_blocks, slot ^= 1)
+    {
+        std::vector<std::string>& blocks = chunks[slot];
+        pool.ParallelFor(chunk_blocks, [&](size_t begin, size_t end)
+        {
+            for (size_t b = begin; b < end; b++)
+            {
+                blocks[b].clear();
+                uint64_t first = chunk_start + (uint64_t)b * block_frames;
+                if (first >= frames)
+                    continue;
+                size_t count = (size_t)std::min<uint64_t>(block_frames, frames - first);
+                // Runs of at most one period out of the doubled tile
+                for (size_t done = 0; done < count;)
+                {
+                    size_t phase = (size_t)((first + done) % period_frames);
+                    size_t run = std::min(count - done, period_frames);
+                    writer.Encode(&tile[phase * (size_t)channels], run, first + done, blocks[b]);
+                    done += run;
+                }
+            }
+        });
+        // The other slot is still being written until its future is done
+        if (pending.valid())
+            ok = pending.get();
+        if (!ok)
+            break;
+        pending = std::async(std::launch::async, [&writer, &blocks]
+        {
+            for (const std::string& block : blocks)
+                if (!writer.Write(block))
+                    return false;
+            return true;
+        });
+    }
+    if (pending.valid())
+        ok = pending.get() && ok;
+    ok = writer.Finish() && ok;
+    if (!ok)
+    {
+        fprintf(stderr, "%s: %s\n", output, writer.Error());
+        return 1;
+    }
+    double seconds = Seconds(start);
+    printf("%s: %llu frames of %zu circles, %.1f MB in %.2f s (%.0f MB/s), period %llu samples\n", output,
+           (unsigned long long)frames, circles.size(), (double)writer.BytesWritten() / 1e6, seconds,
+           (double)writer.BytesWritten() / 1e6 / std::max(seconds, 1e-9), (unsigned long long)rate.period);
+    return 0;
+}
+
+//-----------------------------------------------------------------------------
+// coefficients
+//-----------------------------------------------------------------------------
+
+static void PrintCoefficientsUsage()
+{
+    printf("usage: fourier-cli coefficients [options] INPUT(.wav|.csv|.f32)\n"
+           "  -o FILE           output CSV (default: standard output)\n"
+           "  --terms N         largest N circles only (default: all)\n"
+           "  --channels N      channels of a raw input (default 1)\n"
+           "One channel is a periodic signal (the y of the tip); two or more are the\n"
+           "x and y of a closed curve. The whole input is one period.\n");
+}
+
+static int Coefficients(int argc, char** argv)
+{
+    const char* input = nullptr;
+    const char* output = nullptr;
+    size_t terms = 0;
+    int raw_channels = 1;
+    for (int i = 0; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool value = i + 1 < argc;
+        if ((arg == "-o" || arg == "--output") && value)
+            output = argv[++i];
+        else if (arg == "--terms" && value)
+            terms = (size_t)std::max(0, atoi(argv[++i]));
+        else if (arg == "--channels" && value)
+            raw_channels = std::max(1, atoi(argv[++i]));
+        else if (arg[0] != '-' && input == nullptr)
+            input = argv[i];
+        else
+        {
+            PrintCoefficientsUsage();
+            return 2;
+        }
+    }
+    if (input == nullptr)
+    {
+        PrintCoefficientsUsage();
+        return 2;
+    }
+
+    Signal signal;
+    char error[256];
+    if (!ReadSignal(input, raw_channels, signal, error, sizeof(error)))
+    {
+        fprintf(stderr, "%s\n", error);
+        return 1;
+    }
+    size_t n = signal.Frames();
+    if (n == 0)
+    {
+        fprintf(stderr, "%s: no samples\n", input);
+        return 1;
+    }
+    std::vector<Dsp::Epicycle> circles;
+    if (signal.channels == 1)
+        circles = Dsp::SignalSeries(signal.samples.data(), n, terms);
+    else
+    {
+        std::vector<Dsp::Complex> points(n);
+        for (size_t i = 0; i < n; i++)
+            points[i] = Dsp::Complex(signal.samples[i * (size_t)signal.channels], signal.samples[i * (size_t)signal.channels + 1]);
+        circles = Dsp::CurveSeries(points.data(), n, terms);
+    }
+
+    FILE* f = (output != nullptr) ? fopen(output, "w") : stdout;
+    if (f == nullptr)
+    {
+        fprintf(stderr, "%s: %s\n", output, strerror(errno));
+        return 1;
+    }
+    fprintf(f, "# %zu %s of %s", n, signal.channels == 1 ? "samples" : "points", input);
+    if (signal.sample_rate > 0.0)
+        fprintf(f, ", fundamental %.9g Hz", signal.sample_rate / (double)n);
+    fprintf(f, "\nharmonic,radius,phase\n");
+    for (const Dsp::Epicycle& c : circles)
+        fprintf(f, "%d,%.9g,%.9g\n", c.harmonic, c.radius, c.phase);
+    bool ok = !ferror(f);
+    if (f != stdout)
+        ok = fclose(f) == 0 && ok;
+    return ok ? 0 : 1;
+}
+
+//-----------------------------------------------------------------------------
+// render
+//-----------------------------------------------------------------------------
+
+static void PrintRenderUsage()
+{
+    printf("usage: fourier-cli render [options] INPUT -o FILE(.png|.tif)\n"
+           "  --terms N         circles of the reconstruction (default 100)\n"
+           "  --width W         image width (default 1024)\n"
+           "  --height H        image height (default 1024)\n"
+           "  --frames K        frames of one revolution (default 1); FILE may hold a\n"
+           "                    printf pattern such as frame%%04d.png\n"
+           "  --channels N      channels of a raw input (default 2)\n"
+           "  --threads N       worker threads (default: all cores)\n"
+           "INPUT is a closed curve: x,y rows of a CSV, a stereo WAV or raw pairs.\n");
+}
+
+// Path of frame `index`: the pattern itself when it has a % conversion,
+// otherwise _NNNN before the extension.
+static std::string FramePath(const char* pattern, int index, int frames)
+{
+    if (frames == 1)
+        return pattern;
+    char buffer[1024];
+    if (strchr(pattern, '%') != nullptr)
+        snprintf(buffer, sizeof(buffer), pattern, index);
+    else
+    {
+        std::string path = pattern;
+        size_t dot = path.find_last_of('.');
+        size_t slash = path.find_last_of("/\\");
+        if (dot == std::string::npos || (slash != std::string::npos && dot < slash))
+            dot = path.size();
+        snprintf(buffer, sizeof(buffer), "%s_%04d%s", path.substr(0, dot).c_str(), index, path.substr(dot).c_str());
+    }
+    return buffer;
+}
+
+static int Render(int argc, char** argv)
+{
+    const char* input = nullptr;
+    const char* output = nullptr;
+    size_t terms = 100;
+    int width = 1024, height = 1024, frames = 1, raw_channels = 2;
+    unsigned threads = 0;
+    for (int i = 0; i < argc; i++)
+    {
+        std::string arg = argv[i];
+        bool value = i + 1 < argc;
+        if ((arg == "-o" || arg == "--output") && value)
+            output = argv[++i];
+        else if (arg == "--terms" && value)
+            terms = (size_t)std::max(1, atoi(argv[++i]));
+        else if (arg == "--width" && value)
+            width = std::clamp(atoi(argv[++i]), 16, 65536);
+        else if (arg == "--height" && value)
+            height = std::clamp(atoi(argv[++i]), 16, 65536);
+        else if (arg == "--frames" && value)
+            frames = std::max(1, atoi(argv[++i]));
+        else if (arg == "--channels" && value)
+            raw_channels = std::max(2, atoi(argv[++i]));
+        else if (arg == "--threads" && value)
+            threads = (unsigned)std::max(1, atoi(argv[++i]));
+        else if (arg[0] != '-' && input == nullptr)
+            input = argv[i];
+        else
+        {
+            PrintRenderUsage();
+            return 2;
+        }
+    }
+    if (input == nullptr || output == nullptr)
+    {
+        PrintRenderUsage();
+        return 2;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    Signal contour;
+    char error[256];
+    if (!ReadSignal(input, raw_channels, contour, error, sizeof(error)))
+    {
+        fprintf(stderr, "%s\n", error);
+        return 1;
+    }
+    size_t n = contour.Frames();
+    if (contour.channels < 2 || n < 2)
+    {
+        fprintf(stderr, "%s: need at least two x,y points\n", input);
+        return 1;
+    }
+    std::vector<Dsp::Complex> points(n);
+    for (size_t i = 0; i < n; i++)
+        points[i] = Dsp::Complex(contour.samples[i * (size_t)contour.channels], contour.samples[i * (size_t)contour.channels + 1]);
+    std::vector<Dsp::Epicycle> circles = Dsp::CurveSeries(points.data(), n, terms);
+
+    // The reconstructed curve, sampled finely enough for its highest harmonic
+    int32_t highest = 0;
+    for (const Dsp::Epicycle& c : circles)
+        highest = std::max(highest, std::abs(c.harmonic));
+    size_t curve_points = std::max<size_t>(2048, 4 * (size_t)highest);
+    std::vector<Dsp::Complex> curve(curve_points);
+    Dsp::SynthesizePeriod(circles.data(), circles.size(), Dsp::PeriodicRate{ 1, curve_points }, curve.data(), false);
+
+    // Fit the contour and the circles' reach into the image
+    float min_x = points[0].real(), max_x = min_x, min_y = points[0].imag(), max_y = min_y;
+    for (const Dsp::Complex& p : points)
+    {
+        min_x = std::min(min_x, p.real()); max_x = std::max(max_x, p.real());
+        min_y = std::min(min_y, p.imag()); max_y = std::max(max_y, p.imag());
+    }
+    float margin = 0.05f * (float)std::min(width, height);
+    float extent = std::max(std::max(max_x - min_x, max_y - min_y), 1e-6f);
+    float scale = std::min((float)width - 2.0f * margin, (float)height - 2.0f * margin) / extent;
+    float offset_x = 0.5f * (float)width - scale * 0.5f * (min_x + max_x);
+    float offset_y = 0.5f * (float)height - scale * 0.5f * (min_y + max_y);
+
+    Raster::Scene base;
+    for (size_t i = 0; i < n; i++)
+    {
+        const Dsp::Complex& a = points[i];
+        const Dsp::Complex& b = points[(i + 1) % n];
+        base.AddLine(a.real(), a.imag(), b.real(), b.imag(), Raster::MakeColor(90, 90, 90), 1.0f / scale);
+    }
+
+    // Frames are independent: each is built and streamed by one pool job.
+    // A single image is banded across the pool instead.
+    Core::ThreadPool pool(threads);
+    std::atomic<int> failed{ 0 };
+    std::atomic<int> written{ 0 };
+    auto render_frame = [&](size_t f)
+    {
+        thread_local std::vector<float> x, y;
+        x.resize(circles.size());
+        y.resize(circles.size());
+        double t = 2.0 * std::numbers::pi * (double)f / (double)frames;
+        Raster::Scene scene = base;
+        // Traced so far (all of it in a still image)
+        size_t traced = (frames == 1) ? curve_points : curve_points * f / (size_t)frames;
+        for (size_t i = 0; i < traced; i++)
+        {
+            const Dsp::Complex& a = curve[i];
+            const Dsp::Complex& b = curve[(i + 1) % curve_points];
+            scene.AddLine(a.real(), a.imag(), b.real(), b.imag(), Raster::MakeColor(255, 200, 0), 2.0f / scale);
+        }
+        Dsp::EvaluateEpicycles(circles.data(), circles.size(), t, x.data(), y.data(), Dsp::Summation::Pairwise);
+        float cx = 0.0f, cy = 0.0f;
+        for (size_t i = 0; i < circles.size(); i++)
+        {
+            if (circles[i].harmonic != 0)
+            {
+                scene.AddCircle(cx, cy, circles[i].radius, Raster::MakeColor(255, 255, 255, 70), 1.0f / scale);
+                scene.AddLine(cx, cy, x[i], y[i], Raster::MakeColor(255, 255, 255, 200), 1.0f / scale);
+            }
+            cx = x[i];
+            cy = y[i];
+        }
+        scene.AddDisc(cx, cy, 4.0f / scale, Raster::MakeColor(255, 0, 0));
+        scene.Transform(scale, offset_x, offset_y);
+
+        std::string path = FramePath(output, (int)f, frames);
+        Raster::ImageWriter writer;
+        Raster::ExportSettings settings;
+        settings.width = width;
+        settings.height = height;
+        settings.background = Raster::MakeColor(20, 20, 24);
+        if (!writer.Open(path.c_str(), Raster::FormatFromPath(path.c_str()), width, height) ||
+            !Raster::ExportScene(scene, settings, writer, &pool))
+        {
+            if (failed.fetch_add(1) == 0)
+                fprintf(stderr, "%s: %s\n", path.c_str(), writer.Error());
+            return;
+        }
+        written++;
+    };
+    if (frames == 1)
+        render_frame(0);
+    else
+        pool.ParallelFor((size_t)frames, [&](size_t begin, size_t end)
+        {
+            for (size_t f = begin; f < end; f++)
+                render_frame(f);
+        });
+    printf("%d of %d frames, %zu circles of %zu points, in %.2f s\n", written.load(), frames, circles.size(), n, Seconds(start));
+    return failed.load() == 0 ? 0 : 1;
+}
+
+//-----------------------------------------------------------------------------
+
+static void PrintUsage()
+{
+    printf("usage: fourier-cli COMMAND [options]\n"
+           "  synth          synthesize a series to WAV, CSV or raw float32\n"
+           "  coefficients   epicycles of a signal or closed curve, as CSV\n"
+           "  render         epicycle reconstructions of a contour to PNG / TIFF\n"
+           "Run a command with --help for its options.\n");
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        PrintUsage();
+        return 2;
+    }
+    std::string command = argv[1];
+    if (command == "synth")
+        return Synth(argc - 2, argv + 2);
+    if (command == "coefficients")
+        return Coefficients(argc - 2, argv + 2);
+    if (command == "render")
+        return Render(argc - 2, argv + 2);
+    PrintUsage();
+    return 2;
+}
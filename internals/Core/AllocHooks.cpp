@@ -0,0 +1,90 @@
+// Replacement global operator new / delete feeding Core::AllocTracker.
+//
+// Linked (whole-archive) only when the build enables `alloc_tracking`. Each
+// block carries a small header in front of the user pointer holding its size
+// and tag, so frees are charged to the subsystem that allocated.
+
+#include "Core/AllocTracker.h"
+
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    struct Header
+    {
+        size_t size;            // User bytes
+        uint32_t offset;        // Distance from the raw block to the user pointer
+        Core::AllocTag tag;
+    };
+
+    constexpr size_t min_offset = (sizeof(Header) + alignof(std::max_align_t) - 1) / alignof(std::max_align_t) * alignof(std::max_align_t);
+
+    void* Allocate(size_t size, size_t alignment) noexcept
+    {
+        // Over-aligned requests over-allocate and align by hand (portable,
+        // and every block is released with the same std::free).
+        size_t slack = alignment > alignof(std::max_align_t) ? alignment : 0;
+        char* raw = static_cast<char*>(std::malloc(min_offset + slack + size));
+        if (raw == nullptr)
+            return nullptr;
+        uintptr_t first = reinterpret_cast<uintptr_t>(raw) + min_offset;
+        size_t offset = min_offset + (slack != 0 ? (alignment - first % alignment) % alignment : 0);
+        char* user = raw + offset;
+        Core::AllocTag tag = Core::AllocTracker::CurrentTag();
+        ::new (user - sizeof(Header)) Header{ size, (uint32_t)offset, tag };
+        Core::AllocTracker::RecordAllocation(tag, size);
+        return user;
+    }
+
+    void Free(void* p) noexcept
+    {
+        if (p == nullptr)
+            return;
+        char* user = static_cast<char*>(p);
+        const Header* header = reinterpret_cast<const Header*>(user - sizeof(Header));
+        Core::AllocTracker::RecordFree(header->tag, header->size);
+        std::free(user - header->offset);
+    }
+
+    void* AllocateOrThrow(size_t size, size_t alignment)
+    {
+        while (true)
+        {
+            if (void* p = Allocate(size, alignment))
+                return p;
+            std::new_handler handler = std::get_new_handler();
+            if (handler == nullptr)
+                throw std::bad_alloc();
+            handler();
+        }
+    }
+
+    struct Install
+    {
+        Install() { Core::AllocTracker::MarkInstalled(); }
+    } install;
+}
+
+void* operator new(size_t size) { return AllocateOrThrow(size, alignof(std::max_align_t)); }
+void* operator new[](size_t size) { return AllocateOrThrow(size, alignof(std::max_align_t)); }
+void* operator new(size_t size, std::align_val_t alignment) { return AllocateOrThrow(size, (size_t)alignment); }
+void* operator new[](size_t size, std::align_val_t alignment) { return AllocateOrThrow(size, (size_t)alignment); }
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return Allocate(size, alignof(std::max_align_t)); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return Allocate(size, alignof(std::max_align_t)); }
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return Allocate(size, (size_t)alignment); }
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return Allocate(size, (size_t)alignment); }
+
+void operator delete(void* p) noexcept { Free(p); }
+void operator delete[](void* p) noexcept { Free(p); }
+void operator delete(void* p, size_t) noexcept { Free(p); }
+void operator delete[](void* p, size_t) noexcept { Free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { Free(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { Free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { Free(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { Free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { Free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { Free(p); }
+void operator delete(void* p, std::align_val_t, const std::nothrow_t&) noexcept { Free(p); }
+void operator delete[](void* p, std::align_val_t, const std::nothrow_t&) noexcept { Free(p); }
@@ -0,0 +1,181 @@
+#include "Core/AllocTracker.h"
+
+#include <algorithm>
+#include <atomic>
+
+namespace Core
+{
+    static constexpr size_t tag_count = (size_t)AllocTag::Count;
+
+    // Counters are constant-initialized, so the hooks may use them before
+    // any static constructor has run.
+    struct TagCounters
+    {
+        std::atomic<uint64_t> allocations{ 0 };
+        std::atomic<uint64_t> frees{ 0 };
+        std::atomic<uint64_t> bytes{ 0 };
+        std::atomic<int64_t> live_bytes{ 0 };
+        std::atomic<int64_t> peak_bytes{ 0 };
+    };
+
+    static TagCounters counters[tag_count];
+    static std::atomic<bool> installed{ false };
+    static thread_local AllocTag current_tag = AllocTag::Other;
+
+    // Main-thread frame bookkeeping.
+    static AllocStats frame_start[tag_count];
+    static AllocStats frame_delta[tag_count];
+    static float history[AllocTracker::history_frames];
+    static size_t history_next = 0;
+    static size_t history_count = 0;
+
+    const char* AllocTagName(AllocTag tag)
+    {
+        static const char* names[] = { "Other", "UI", "DSP", "Trace", "Render" };
+        return (size_t)tag < tag_count ? names[(size_t)tag] : "?";
+    }
+
+    AllocScope::AllocScope(AllocTag tag)
+        : previous_(current_tag)
+    {
+        current_tag = tag;
+    }
+
+    AllocScope::~AllocScope()
+    {
+        current_tag = previous_;
+    }
+
+    static AllocStats Add(AllocStats a, const AllocStats& b)
+    {
+        a.allocations += b.allocations;
+        a.frees += b.frees;
+        a.bytes += b.bytes;
+        a.live_bytes += b.live_bytes;
+        a.peak_bytes += b.peak_bytes;
+        return a;
+    }
+
+    namespace AllocTracker
+    {
+        bool Installed()
+        {
+            return installed.load(std::memory_order_relaxed);
+        }
+
+        void MarkInstalled()
+        {
+            installed.store(true, std::memory_order_relaxed);
+        }
+
+        AllocTag CurrentTag()
+        {
+            return current_tag;
+        }
+
+        void RecordAllocation(AllocTag tag, size_t bytes)
+        {
+            TagCounters& c = counters[(size_t)tag];
+            c.allocations.fetch_add(1, std::memory_order_relaxed);
+            c.bytes.fetch_add(bytes, std::memory_order_relaxed);
+            int64_t live = c.live_bytes.fetch_add((int64_t)bytes, std::memory_order_relaxed) + (int64_t)bytes;
+            int64_t peak = c.peak_bytes.load(std::memory_order_relaxed);
+            while (live > peak && !c.peak_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed))
+            {
+            }
+        }
+
+        void RecordFree(AllocTag tag, size_t bytes)
+        {
+            TagCounters& c = counters[(size_t)tag];
+            c.frees.fetch_add(1, std::memory_order_relaxed);
+            c.live_bytes.fetch_sub((int64_t)bytes, std::memory_order_relaxed);
+        }
+
+        AllocStats Stats(AllocTag tag)
+        {
+            const TagCounters& c = counters[(size_t)tag];
+            AllocStats s;
+            s.allocations = c.allocations.load(std::memory_order_relaxed);
+            s.frees = c.frees.load(std::memory_order_relaxed);
+            s.bytes = c.bytes.load(std::memory_order_relaxed);
+            s.live_bytes = c.live_bytes.load(std::memory_order_relaxed);
+            s.peak_bytes = c.peak_bytes.load(std::memory_order_relaxed);
+            return s;
+        }
+
+        // The sum of per-tag peaks bounds the overall peak from above.
+        AllocStats Total()
+        {
+            AllocStats total;
+            for (size_t t = 0; t < tag_count; t++)
+                total = Add(total, Stats((AllocTag)t));
+            return total;
+        }
+
+        void NextFrame()
+        {
+            uint64_t frame_allocations = 0;
+            for (size_t t = 0; t < tag_count; t++)
+            {
+                AllocStats now = Stats((AllocTag)t);
+                AllocStats& start = frame_start[t];
+                AllocStats& delta = frame_delta[t];
+                delta.allocations = now.allocations - start.allocations;
+                delta.frees = now.frees - start.frees;
+                delta.bytes = now.bytes - start.bytes;
+                delta.live_bytes = now.live_bytes - start.live_bytes;
+                delta.peak_bytes = now.peak_bytes;
+                start = now;
+                frame_allocations += delta.allocations;
+            }
+            history[history_next] = (float)frame_allocations;
+            history_next = (history_next + 1) % history_frames;
+            history_count = std::min(history_count + 1, history_frames);
+        }
+
+        AllocStats FrameDelta(AllocTag tag)
+        {
+            return frame_delta[(size_t)tag];
+        }
+
+        AllocStats FrameDeltaTotal()
+        {
+            AllocStats total;
+            for (size_t t = 0; t < tag_count; t++)
+                total = Add(total, frame_delta[t]);
+            return total;
+        }
+
+        size_t History(float* allocations_out)
+        {
+            size_t first = (history_next + history_frames - history_count) % history_frames;
+            for (size_t i = 0; i < history_count; i++)
+                allocations_out[i] = history[(first + i) % history_frames];
+            return history_count;
+        }
+
+        bool ExportCsv(const char* path)
+        {
+            FILE* f = fopen(path, "w");
+            if (f == nullptr)
+                return false;
+            fprintf(f, "tag,allocations,frees,bytes,live_bytes,peak_bytes,frame_allocations,frame_bytes\n");
+            for (size_t t = 0; t < tag_count; t++)
+            {
+                AllocStats s = Stats((AllocTag)t);
+                AllocStats d = frame_delta[t];
+                fprintf(f, "%s,%llu,%llu,%llu,%lld,%lld,%llu,%llu\n", AllocTagName((AllocTag)t),
+                        (unsigned long long)s.allocations, (unsigned long long)s.frees, (unsigned long long)s.bytes,
+                        (long long)s.live_bytes, (long long)s.peak_bytes,
+                        (unsigned long long)d.allocations, (unsigned long long)d.bytes);
+            }
+            float frames[history_frames];
+            size_t count = History(frames);
+            fprintf(f, "\nframe,allocations\n");
+            for (size_t i = 0; i < count; i++)
+                fprintf(f, "%zu,%.0f\n", i, frames[i]);
+            return fclose(f) == 0;
+        }
+    }
+}
@@ -0,0 +1,83 @@
+// Heap accounting by subsystem.
+//
+// When the build enables `alloc_tracking`, global operator new / delete are
+// replaced (Core/AllocHooks.cpp) and every allocation is charged to the tag of
+// the innermost AllocScope on the allocating thread. Frees are charged back to
+// the tag that made the allocation. Without the hooks the API still works but
+// all counters stay zero and Installed() is false.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace Core
+{
+    enum class AllocTag : uint8_t
+    {
+        Other,      // Anything outside a scope
+        Ui,         // Dear ImGui buffers and widgets
+        Dsp,        // Plans, filter banks, scratch
+        Trace,      // Plotted histories and overlays
+        Render,     // Images and textures
+        Count,
+    };
+
+    const char* AllocTagName(AllocTag tag);
+
+    struct AllocStats
+    {
+        uint64_t allocations = 0;
+        uint64_t frees = 0;
+        uint64_t bytes = 0;         // Total ever allocated
+        int64_t live_bytes = 0;
+        int64_t peak_bytes = 0;     // Highest live_bytes
+    };
+
+    // Charges allocations made on this thread to `tag` until destroyed.
+    class AllocScope
+    {
+    public:
+        explicit AllocScope(AllocTag tag);
+        ~AllocScope();
+
+        AllocScope(const AllocScope&) = delete;
+        AllocScope& operator=(const AllocScope&) = delete;
+
+    private:
+        AllocTag previous_;
+    };
+
+    namespace AllocTracker
+    {
+        static constexpr size_t history_frames = 240;
+
+        bool Installed();
+
+        // Lifetime totals of one tag (or all of them).
+        AllocStats Stats(AllocTag tag);
+        AllocStats Total();
+
+        // Closes the current frame: the counters since the previous call
+        // become the frame delta and are appended to the history. Call once
+        // per frame from the main loop.
+        void NextFrame();
+        // Allocations / bytes of the last closed frame.
+        AllocStats FrameDelta(AllocTag tag);
+        AllocStats FrameDeltaTotal();
+        // Allocations per frame over the last history_frames frames, oldest
+        // first; returns how many entries are valid.
+        size_t History(float* allocations_out);
+
+        // CSV: one row per tag with lifetime totals and the last frame delta,
+        // followed by the per-frame allocation history.
+        bool ExportCsv(const char* path);
+
+        // Called by the hooks only.
+        AllocTag CurrentTag();
+        void RecordAllocation(AllocTag tag, size_t bytes);
+        void RecordFree(AllocTag tag, size_t bytes);
+        void MarkInstalled();
+    }
+}
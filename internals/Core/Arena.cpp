@@ -0,0 +1,67 @@
+#include "Core/Arena.h"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace Core
+{
+    static constexpr size_t block_alignment = alignof(std::max_align_t);
+
+    static std::byte* AlignUp(std::byte* p, size_t alignment)
+    {
+        uintptr_t v = reinterpret_cast<uintptr_t>(p);
+        return p + ((alignment - v % alignment) % alignment);
+    }
+
+    FrameArena::FrameArena(size_t capacity, std::pmr::memory_resource* upstream)
+        : upstream_(upstream), capacity_(std::max<size_t>(capacity, 64))
+    {
+        base_ = static_cast<std::byte*>(upstream_->allocate(capacity_, block_alignment));
+        cursor_ = base_;
+        end_ = base_ + capacity_;
+        overflow_.reserve(16);
+    }
+
+    FrameArena::~FrameArena()
+    {
+        for (const Block& block : overflow_)
+            upstream_->deallocate(block.data, block.size, block_alignment);
+        upstream_->deallocate(base_, capacity_, block_alignment);
+    }
+
+    void* FrameArena::do_allocate(size_t bytes, size_t alignment)
+    {
+        std::byte* p = AlignUp(cursor_, alignment);
+        if (p > end_ || (size_t)(end_ - p) < bytes)
+        {
+            size_t size = std::max(bytes + alignment, capacity_);
+            std::byte* data = static_cast<std::byte*>(upstream_->allocate(size, block_alignment));
+            overflow_.push_back({ data, size });
+            spilled_ += size;
+            cursor_ = data;
+            end_ = data + size;
+            p = AlignUp(cursor_, alignment);
+        }
+        used_ += (size_t)(p + bytes - cursor_);
+        cursor_ = p + bytes;
+        return p;
+    }
+
+    void FrameArena::Reset()
+    {
+        peak_ = std::max(peak_, used_);
+        if (!overflow_.empty())
+        {
+            for (const Block& block : overflow_)
+                upstream_->deallocate(block.data, block.size, block_alignment);
+            upstream_->deallocate(base_, capacity_, block_alignment);
+            capacity_ += spilled_;
+            base_ = static_cast<std::byte*>(upstream_->allocate(capacity_, block_alignment));
+            overflow_.clear();
+            spilled_ = 0;
+        }
+        cursor_ = base_;
+        end_ = base_ + capacity_;
+        used_ = 0;
+    }
+}
@@ -0,0 +1,60 @@
+// Bump allocation for data that lives for one frame.
+//
+// Allocation is a pointer increment and deallocation is free: everything is
+// released at once by Reset(), called at the top of every frame. The arena is
+// a std::pmr::memory_resource, so std::pmr containers can use it directly.
+
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <vector>
+
+namespace Core
+{
+    class FrameArena : public std::pmr::memory_resource
+    {
+    public:
+        explicit FrameArena(size_t capacity = (size_t)1 << 20, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+        ~FrameArena() override;
+
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        // Releases everything allocated since the last reset. A frame that
+        // outgrew the block spilled into extra upstream blocks; they are merged
+        // here into one block big enough for that frame, so a steady workload
+        // stops touching the upstream resource after its first frames.
+        void Reset();
+
+        // Uninitialized storage for `count` objects. Destructors never run,
+        // so use it for trivially destructible types.
+        template<typename T>
+        T* Allocate(size_t count) { return static_cast<T*>(allocate(count * sizeof(T), alignof(T))); }
+
+        size_t Used() const { return used_; }           // Bytes handed out this frame, including padding
+        size_t Peak() const { return peak_; }           // Largest Used() at any reset
+        size_t Capacity() const { return capacity_; }   // Size of the main block
+
+    private:
+        struct Block
+        {
+            std::byte* data;
+            size_t size;
+        };
+
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void*, size_t, size_t) override {}
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+        std::pmr::memory_resource* upstream_;
+        std::byte* base_ = nullptr;
+        size_t capacity_ = 0;
+        std::byte* cursor_ = nullptr;
+        std::byte* end_ = nullptr;
+        std::vector<Block> overflow_;   // Spill blocks of the current frame
+        size_t spilled_ = 0;            // Total size of overflow_
+        size_t used_ = 0;
+        size_t peak_ = 0;
+    };
+}
@@ -0,0 +1,256 @@
+#include "Core/PerfCounters.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <mutex>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace Core
+{
+    static uint64_t NowNs()
+    {
+        return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    const char* PerfEventName(PerfEvent event)
+    {
+        static const char* names[] = { "cycles", "instructions", "cache-references", "cache-misses", "branches", "branch-misses" };
+        return (size_t)event < perf_event_count ? names[(size_t)event] : "?";
+    }
+
+    //-------------------------------------------------------------------------
+    // Counts
+    //-------------------------------------------------------------------------
+
+    void PerfCounts::Accumulate(const PerfCounts& other)
+    {
+        for (size_t e = 0; e < perf_event_count; e++)
+        {
+            value[e] += other.value[e];
+            valid[e] = valid[e] && other.valid[e];
+        }
+        ns += other.ns;
+    }
+
+    static double Ratio(const PerfCounts& c, PerfEvent num, PerfEvent den, double scale = 1.0)
+    {
+        if (!c.Has(num) || !c.Has(den) || c[den] == 0)
+            return std::nan("");
+        return scale * (double)c[num] / (double)c[den];
+    }
+
+    double PerfCounts::Ipc() const { return Ratio(*this, PerfEvent::Instructions, PerfEvent::Cycles); }
+    double PerfCounts::CacheMissRate() const { return Ratio(*this, PerfEvent::CacheMisses, PerfEvent::CacheReferences); }
+    double PerfCounts::BranchMissRate() const { return Ratio(*this, PerfEvent::BranchMisses, PerfEvent::Branches); }
+    double PerfCounts::CacheMpki() const { return Ratio(*this, PerfEvent::CacheMisses, PerfEvent::Instructions, 1000.0); }
+
+    //-------------------------------------------------------------------------
+    // Counter group
+    //-------------------------------------------------------------------------
+
+    PerfCounters::PerfCounters()
+    {
+        for (size_t e = 0; e < perf_event_count; e++)
+        {
+            fds_[e] = -1;
+            slot_[e] = -1;
+        }
+#if defined(__linux__)
+        static const uint64_t configs[] =
+        {
+            PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_REFERENCES, PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_INSTRUCTIONS, PERF_COUNT_HW_BRANCH_MISSES,
+        };
+        // One group, read with a single syscall. Members the kernel rejects
+        // are left out; the rest keep working.
+        for (size_t e = 0; e < perf_event_count; e++)
+        {
+            perf_event_attr attr;
+            memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[e];
+            attr.disabled = (leader_ < 0) ? 1 : 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+            int fd = (int)syscall(SYS_perf_event_open, &attr, 0, -1, leader_, 0);
+            if (fd < 0)
+            {
+                if (error_[0] == '\0')
+                    snprintf(error_, sizeof(error_), "%s: %s", PerfEventName((PerfEvent)e), strerror(errno));
+                continue;
+            }
+            if (leader_ < 0)
+                leader_ = fd;
+            fds_[e] = fd;
+            slot_[e] = opened_++;
+        }
+        if (leader_ >= 0)
+        {
+            ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#else
+        snprintf(error_, sizeof(error_), "hardware counters need Linux perf_event_open");
+#endif
+    }
+
+    PerfCounters::~PerfCounters()
+    {
+#if defined(__linux__)
+        for (size_t e = 0; e < perf_event_count; e++)
+            if (fds_[e] >= 0 && fds_[e] != leader_)
+                close(fds_[e]);
+        if (leader_ >= 0)
+            close(leader_);
+#endif
+    }
+
+    PerfCounters& PerfCounters::ThisThread()
+    {
+        thread_local PerfCounters counters;
+        return counters;
+    }
+
+    PerfCounters::Snapshot PerfCounters::Read() const
+    {
+        Snapshot s;
+#if defined(__linux__)
+        if (leader_ >= 0)
+        {
+            // nr, time_enabled, time_running, values[nr]
+            uint64_t buffer[3 + perf_event_count];
+            ssize_t got = read(leader_, buffer, sizeof(buffer));
+            if (got >= (ssize_t)(3 * sizeof(uint64_t)))
+            {
+                s.enabled = buffer[1];
+                s.running = buffer[2];
+                for (size_t e = 0; e < perf_event_count; e++)
+                    if (slot_[e] >= 0 && (uint64_t)slot_[e] < buffer[0])
+                        s.raw[e] = buffer[3 + slot_[e]];
+            }
+        }
+#endif
+        s.ns = NowNs();
+        return s;
+    }
+
+    PerfCounts PerfCounters::Since(const Snapshot& start) const
+    {
+        Snapshot now = Read();
+        PerfCounts c;
+        c.ns = now.ns - start.ns;
+        uint64_t enabled = now.enabled - start.enabled;
+        uint64_t running = now.running - start.running;
+        // The group is scheduled as a whole; when multiplexed out part of
+        // the time, extrapolate by enabled / running.
+        bool scheduled = running > 0 || enabled == 0;
+        double scale = (running > 0) ? (double)enabled / (double)running : 1.0;
+        for (size_t e = 0; e < perf_event_count; e++)
+        {
+            c.valid[e] = slot_[e] >= 0 && scheduled;
+            if (c.valid[e])
+                c.value[e] = (uint64_t)std::llround((double)(now.raw[e] - start.raw[e]) * scale);
+        }
+        return c;
+    }
+
+    //-------------------------------------------------------------------------
+    // Scopes
+    //-------------------------------------------------------------------------
+
+    static std::mutex registry_mutex;
+    static PerfScopeStats registry[PerfRegistry::max_scopes];
+    static size_t registry_count = 0;
+
+    PerfScope::PerfScope(const char* name)
+        : name_(name), counters_(PerfCounters::ThisThread()), start_(counters_.Read())
+    {
+    }
+
+    PerfScope::~PerfScope()
+    {
+        PerfCounts counts = counters_.Since(start_);
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        size_t i = 0;
+        while (i < registry_count && strcmp(registry[i].name, name_) != 0)
+            i++;
+        if (i == registry_count)
+        {
+            if (registry_count == PerfRegistry::max_scopes)
+                return;
+            registry[registry_count++] = PerfScopeStats{ name_, 0, {} };
+            for (bool& valid : registry[i].counts.valid)
+                valid = true;
+        }
+        registry[i].calls++;
+        registry[i].counts.Accumulate(counts);
+    }
+
+    namespace PerfRegistry
+    {
+        size_t Snapshot(PerfScopeStats* out, size_t max)
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex);
+            size_t count = registry_count < max ? registry_count : max;
+            for (size_t i = 0; i < count; i++)
+                out[i] = registry[i];
+            return count;
+        }
+
+        bool Find(const char* name, PerfScopeStats& out)
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex);
+            for (size_t i = 0; i < registry_count; i++)
+                if (strcmp(registry[i].name, name) == 0)
+                {
+                    out = registry[i];
+                    return true;
+                }
+            return false;
+        }
+
+        void Reset()
+        {
+            std::lock_guard<std::mutex> lock(registry_mutex);
+            registry_count = 0;
+        }
+
+        void Print(FILE* f)
+        {
+            PerfScopeStats stats[max_scopes];
+            size_t count = Snapshot(stats, max_scopes);
+            // Unavailable ratios print as n/a.
+            auto column = [](char* buffer, size_t size, double v, double scale, const char* suffix)
+            {
+                if (std::isnan(v))
+                    snprintf(buffer, size, "n/a");
+                else
+                    snprintf(buffer, size, "%.2f%s", v * scale, suffix);
+                return buffer;
+            };
+            fprintf(f, "%-16s %8s %12s %8s %10s %10s %8s\n", "scope", "calls", "ns/call", "IPC", "cache miss", "br miss", "MPKI");
+            for (size_t i = 0; i < count; i++)
+            {
+                const PerfCounts& c = stats[i].counts;
+                char ipc[32], cache[32], branch[32], mpki[32];
+                fprintf(f, "%-16s %8llu %12.0f %8s %10s %10s %8s\n", stats[i].name, (unsigned long long)stats[i].calls,
+                        (double)c.ns / (double)stats[i].calls, column(ipc, sizeof(ipc), c.Ipc(), 1.0, ""),
+                        column(cache, sizeof(cache), c.CacheMissRate(), 100.0, "%"), column(branch, sizeof(branch), c.BranchMissRate(), 100.0, "%"),
+                        column(mpki, sizeof(mpki), c.CacheMpki(), 1.0, ""));
+            }
+            if (!PerfCounters::ThisThread().Available())
+                fprintf(f, "(hardware counters unavailable: %s)\n", PerfCounters::ThisThread().Error());
+        }
+    }
+}
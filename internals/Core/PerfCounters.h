@@ -0,0 +1,126 @@
+// Hardware performance counters (Linux perf_event_open) around named scopes.
+//
+// Each thread that opens a PerfScope gets its own counter group: cycles,
+// instructions, cache references / misses and branches / misses, counted in
+// user space for that thread only (pool workers are not included). When the
+// kernel refuses (no PMU in a VM, perf_event_paranoid, other platforms) or
+// the PMU cannot fit an event, those events are reported as unavailable and
+// scopes still record call counts and wall time.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace Core
+{
+    enum class PerfEvent
+    {
+        Cycles,
+        Instructions,
+        CacheReferences,
+        CacheMisses,
+        Branches,
+        BranchMisses,
+        Count,
+    };
+
+    static constexpr size_t perf_event_count = (size_t)PerfEvent::Count;
+
+    const char* PerfEventName(PerfEvent event);
+
+    // Counter deltas, scaled for multiplexing. valid[e] is false when the
+    // event could not be counted.
+    struct PerfCounts
+    {
+        uint64_t value[perf_event_count] = {};
+        bool valid[perf_event_count] = {};
+        uint64_t ns = 0;
+
+        uint64_t operator[](PerfEvent e) const { return value[(size_t)e]; }
+        bool Has(PerfEvent e) const { return valid[(size_t)e]; }
+        // Sums values; an event stays valid only if it was valid in both.
+        void Accumulate(const PerfCounts& other);
+
+        // NaN when an input is unavailable.
+        double Ipc() const;
+        double CacheMissRate() const;       // Misses / references
+        double BranchMissRate() const;      // Misses / branches
+        double CacheMpki() const;           // Cache misses per 1000 instructions
+    };
+
+    class PerfCounters
+    {
+    public:
+        PerfCounters();
+        ~PerfCounters();
+
+        PerfCounters(const PerfCounters&) = delete;
+        PerfCounters& operator=(const PerfCounters&) = delete;
+
+        // True when at least one hardware event is being counted.
+        bool Available() const { return leader_ >= 0; }
+        bool Has(PerfEvent e) const { return slot_[(size_t)e] >= 0; }
+        // Why counters are unavailable (empty when they all work).
+        const char* Error() const { return error_; }
+
+        struct Snapshot
+        {
+            uint64_t raw[perf_event_count] = {};
+            uint64_t enabled = 0;
+            uint64_t running = 0;
+            uint64_t ns = 0;
+        };
+
+        Snapshot Read() const;
+        PerfCounts Since(const Snapshot& start) const;
+
+        // Counters of the calling thread, opened on first use.
+        static PerfCounters& ThisThread();
+
+    private:
+        int leader_ = -1;
+        int fds_[perf_event_count];
+        int slot_[perf_event_count];        // Position of each event in the group read, -1 if absent
+        int opened_ = 0;
+        char error_[128] = "";
+    };
+
+    // Times the enclosing block on the calling thread's counters and adds the
+    // result to the named entry of the process-wide table. `name` must outlive
+    // the program (a string literal).
+    class PerfScope
+    {
+    public:
+        explicit PerfScope(const char* name);
+        ~PerfScope();
+
+        PerfScope(const PerfScope&) = delete;
+        PerfScope& operator=(const PerfScope&) = delete;
+
+    private:
+        const char* name_;
+        PerfCounters& counters_;
+        PerfCounters::Snapshot start_;
+    };
+
+    struct PerfScopeStats
+    {
+        const char* name = nullptr;
+        uint64_t calls = 0;
+        PerfCounts counts;
+    };
+
+    namespace PerfRegistry
+    {
+        static constexpr size_t max_scopes = 64;
+
+        // Copies up to `max` entries in first-use order; returns how many.
+        size_t Snapshot(PerfScopeStats* out, size_t max);
+        bool Find(const char* name, PerfScopeStats& out);
+        void Reset();
+        // One line per scope: calls, time per call, IPC and miss rates.
+        void Print(FILE* f);
+    }
+}
@@ -0,0 +1,50 @@
+#include "Core/Pool.h"
+
+#include <algorithm>
+
+namespace Core
+{
+    static constexpr size_t block_alignment = alignof(std::max_align_t);
+
+    PoolResource::PoolResource(size_t block_size, size_t blocks_per_chunk, std::pmr::memory_resource* upstream)
+        : upstream_(upstream),
+          block_size_((std::max(block_size, sizeof(FreeBlock)) + block_alignment - 1) / block_alignment * block_alignment),
+          blocks_per_chunk_(std::max<size_t>(blocks_per_chunk, 1))
+    {
+    }
+
+    PoolResource::~PoolResource()
+    {
+        for (void* chunk : chunks_)
+            upstream_->deallocate(chunk, block_size_ * blocks_per_chunk_, block_alignment);
+    }
+
+    void* PoolResource::do_allocate(size_t bytes, size_t alignment)
+    {
+        if (bytes > block_size_ || alignment > block_alignment)
+            return upstream_->allocate(bytes, alignment);
+        if (free_ == nullptr)
+        {
+            std::byte* chunk = static_cast<std::byte*>(upstream_->allocate(block_size_ * blocks_per_chunk_, block_alignment));
+            chunks_.push_back(chunk);
+            // Thread the new blocks onto the free list in address order.
+            for (size_t i = blocks_per_chunk_; i-- > 0;)
+                free_ = ::new (chunk + i * block_size_) FreeBlock{ free_ };
+        }
+        FreeBlock* block = free_;
+        free_ = block->next;
+        live_++;
+        return block;
+    }
+
+    void PoolResource::do_deallocate(void* p, size_t bytes, size_t alignment)
+    {
+        if (bytes > block_size_ || alignment > block_alignment)
+        {
+            upstream_->deallocate(p, bytes, alignment);
+            return;
+        }
+        free_ = ::new (p) FreeBlock{ free_ };
+        live_--;
+    }
+}
@@ -0,0 +1,93 @@
+// Fixed-size block pools for long-lived objects that are created and
+// destroyed individually (plans, per-stream state).
+//
+// Blocks are carved from chunks taken from the upstream resource and recycled
+// through a free list, so once a pool has reached its working size, creating
+// and destroying objects never reaches the heap. Chunks go back upstream only
+// when the pool is destroyed.
+
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace Core
+{
+    class PoolResource : public std::pmr::memory_resource
+    {
+    public:
+        // Requests larger than block_size (or more aligned than
+        // max_align_t) are passed straight to the upstream resource.
+        explicit PoolResource(size_t block_size, size_t blocks_per_chunk = 64,
+                              std::pmr::memory_resource* upstream = std::pmr::new_delete_resource());
+        ~PoolResource() override;
+
+        PoolResource(const PoolResource&) = delete;
+        PoolResource& operator=(const PoolResource&) = delete;
+
+        size_t BlockSize() const { return block_size_; }
+        size_t Live() const { return live_; }                       // Blocks currently handed out
+        size_t Reserved() const { return chunks_.size() * blocks_per_chunk_; }
+
+    private:
+        struct FreeBlock
+        {
+            FreeBlock* next;
+        };
+
+        void* do_allocate(size_t bytes, size_t alignment) override;
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+        std::pmr::memory_resource* upstream_;
+        size_t block_size_;
+        size_t blocks_per_chunk_;
+        std::vector<void*> chunks_;
+        FreeBlock* free_ = nullptr;
+        size_t live_ = 0;
+    };
+
+    // Typed front end: Create constructs in a pool block, Destroy runs the
+    // destructor and recycles the block.
+    template<typename T>
+    class ObjectPool
+    {
+    public:
+        explicit ObjectPool(size_t objects_per_chunk = 64, std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+            : pool_(sizeof(T), objects_per_chunk, upstream)
+        {
+        }
+
+        template<typename... Args>
+        T* Create(Args&&... args)
+        {
+            void* p = pool_.allocate(sizeof(T), alignof(T));
+            try
+            {
+                return ::new (p) T(std::forward<Args>(args)...);
+            }
+            catch (...)
+            {
+                pool_.deallocate(p, sizeof(T), alignof(T));
+                throw;
+            }
+        }
+
+        void Destroy(T* object)
+        {
+            if (object == nullptr)
+                return;
+            object->~T();
+            pool_.deallocate(object, sizeof(T), alignof(T));
+        }
+
+        size_t Live() const { return pool_.Live(); }
+        std::pmr::memory_resource* Resource() { return &pool_; }
+
+    private:
+        PoolResource pool_;
+    };
+}
@@ -0,0 +1,284 @@
+#include "Core/SampleRing.h"
+
+#include <cstdio>
+#include <cstring>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <cerrno>
+#include <fcntl.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SAMPLE_RING_POSIX 1
+#endif
+
+namespace Core
+{
+    static constexpr size_t sample_words = sizeof(RingSample) / sizeof(uint64_t);
+    static constexpr uint32_t max_capacity = 1u << 24;
+
+    static size_t MappedSize(uint32_t capacity)
+    {
+        return ring_slots_offset + (size_t)capacity * sizeof(RingSlot);
+    }
+
+#if defined(SAMPLE_RING_POSIX)
+    // Whether the existing object `name` was left behind by a writer that
+    // died: its recorded process is gone, or it is not a ring at all (a
+    // crash before the header was written). `owner` gets the recorded pid.
+    static bool IsStale(const char* name, uint64_t& owner)
+    {
+        int fd = shm_open(name, O_RDONLY, 0);
+        if (fd < 0)
+            return errno == ENOENT;
+        struct stat info;
+        void* memory = MAP_FAILED;
+        if (fstat(fd, &info) == 0 && (size_t)info.st_size >= ring_slots_offset)
+            memory = mmap(nullptr, ring_slots_offset, PROT_READ, MAP_SHARED, fd, 0);
+        close(fd);
+        if (memory == MAP_FAILED)
+            return true;
+        const RingHeader* header = (const RingHeader*)memory;
+        bool ring = header->magic == ring_magic;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        owner = header->writer_pid;
+        munmap(memory, ring_slots_offset);
+        if (!ring)
+            return true;
+        return owner == 0 || (kill((pid_t)owner, 0) != 0 && errno == ESRCH);
+    }
+#endif
+
+    //-------------------------------------------------------------------------
+    // Writer
+    //-------------------------------------------------------------------------
+
+    SampleRingWriter::~SampleRingWriter()
+    {
+        Close();
+    }
+
+    bool SampleRingWriter::Create(const char* name, uint32_t capacity)
+    {
+        Close();
+        error_[0] = '\0';
+        if (name == nullptr || name[0] != '/' || strchr(name + 1, '/') != nullptr || strlen(name) >= sizeof(name_))
+        {
+            snprintf(error_, sizeof(error_), "invalid name (one leading '/', under %zu characters)", sizeof(name_));
+            return false;
+        }
+        uint32_t slots = 1;
+        while (slots < capacity && slots < max_capacity)
+            slots <<= 1;
+#if defined(SAMPLE_RING_POSIX)
+        int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0 && errno == EEXIST)
+        {
+            uint64_t owner = 0;
+            if (!IsStale(name, owner))
+            {
+                snprintf(error_, sizeof(error_), "%s is in use by process %llu", name, (unsigned long long)owner);
+                return false;
+            }
+            // Left by a writer that crashed, possibly with another layout
+            shm_unlink(name);
+            fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+        }
+        if (fd < 0)
+        {
+            snprintf(error_, sizeof(error_), "shm_open %s: %s", name, strerror(errno));
+            return false;
+        }
+        size_t size = MappedSize(slots);
+        void* memory = MAP_FAILED;
+        if (ftruncate(fd, (off_t)size) == 0)
+            memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (memory == MAP_FAILED)
+            snprintf(error_, sizeof(error_), "map %s: %s", name, strerror(errno));
+        close(fd);
+        if (memory == MAP_FAILED)
+        {
+            shm_unlink(name);
+            return false;
+        }
+
+        // ftruncate zero-filled the object, which is a valid empty ring: head
+        // 0 and no slot holding a completed sequence. The magic goes last.
+        header_ = (RingHeader*)memory;
+        slots_ = (RingSlot*)((char*)memory + ring_slots_offset);
+        size_ = size;
+        snprintf(name_, sizeof(name_), "%s", name);
+        header_->version = ring_version;
+        header_->slot_size = (uint32_t)sizeof(RingSlot);
+        header_->capacity = slots;
+        header_->writer_pid = (uint64_t)getpid();
+        std::atomic_thread_fence(std::memory_order_release);
+        header_->magic = ring_magic;
+        return true;
+#else
+        (void)slots;
+        snprintf(error_, sizeof(error_), "shared-memory rings need POSIX shm_open");
+        return false;
+#endif
+    }
+
+    void SampleRingWriter::Close()
+    {
+#if defined(SAMPLE_RING_POSIX)
+        if (header_ != nullptr)
+        {
+            munmap(header_, size_);
+            shm_unlink(name_);
+        }
+#endif
+        header_ = nullptr;
+        slots_ = nullptr;
+        size_ = 0;
+    }
+
+    void SampleRingWriter::Publish(const RingSample& sample)
+    {
+        if (header_ == nullptr)
+            return;
+        uint64_t words[sample_words];
+        memcpy(words, &sample, sizeof(words));
+
+        uint64_t index = header_->head.load(std::memory_order_relaxed);
+        RingSlot& slot = slots_[index & (header_->capacity - 1)];
+        // Odd while writing: a reader that sees this, or sees it change
+        // under its loads, discards what it read.
+        slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t w = 0; w < sample_words; w++)
+            slot.words[w].store(words[w], std::memory_order_relaxed);
+        slot.sequence.store(2 * index + 2, std::memory_order_release);
+        header_->head.store(index + 1, std::memory_order_release);
+    }
+
+    uint64_t SampleRingWriter::Published() const
+    {
+        return header_ != nullptr ? header_->head.load(std::memory_order_relaxed) : 0;
+    }
+
+    //-------------------------------------------------------------------------
+    // Reader
+    //-------------------------------------------------------------------------
+
+    SampleRingReader::~SampleRingReader()
+    {
+        Close();
+    }
+
+    bool SampleRingReader::Open(const char* name)
+    {
+        Close();
+        error_[0] = '\0';
+#if defined(SAMPLE_RING_POSIX)
+        int fd = shm_open(name, O_RDONLY, 0);
+        if (fd < 0)
+        {
+            snprintf(error_, sizeof(error_), "shm_open %s: %s", name, strerror(errno));
+            return false;
+        }
+        struct stat info;
+        void* memory = MAP_FAILED;
+        size_t size = 0;
+        if (fstat(fd, &info) == 0 && (size_t)info.st_size >= ring_slots_offset)
+        {
+            size = (size_t)info.st_size;
+            memory = mmap(nullptr, size, PROT_READ, MAP_SHARED, fd, 0);
+        }
+        close(fd);
+        if (memory == MAP_FAILED)
+        {
+            snprintf(error_, sizeof(error_), "map %s: %s", name, size == 0 ? "object too small" : strerror(errno));
+            return false;
+        }
+
+        // A writer still initializing, or one built with another layout
+        const RingHeader* header = (const RingHeader*)memory;
+        bool valid = header->magic == ring_magic;
+        std::atomic_thread_fence(std::memory_order_acquire);
+        valid = valid && header->version == ring_version && header->slot_size == sizeof(RingSlot) && header->capacity != 0 &&
+                (header->capacity & (header->capacity - 1)) == 0 && header->capacity <= max_capacity && MappedSize(header->capacity) <= size;
+        if (!valid)
+        {
+            munmap(memory, size);
+            snprintf(error_, sizeof(error_), "%s is not a sample ring of version %u", name, ring_version);
+            return false;
+        }
+        header_ = header;
+        slots_ = (const RingSlot*)((const char*)memory + ring_slots_offset);
+        size_ = size;
+        return true;
+#else
+        (void)name;
+        snprintf(error_, sizeof(error_), "shared-memory rings need POSIX shm_open");
+        return false;
+#endif
+    }
+
+    void SampleRingReader::Close()
+    {
+#if defined(SAMPLE_RING_POSIX)
+        if (header_ != nullptr)
+            munmap((void*)header_, size_);
+#endif
+        header_ = nullptr;
+        slots_ = nullptr;
+        size_ = 0;
+    }
+
+    uint32_t SampleRingReader::Capacity() const
+    {
+        return header_ != nullptr ? header_->capacity : 0;
+    }
+
+    uint64_t SampleRingReader::Head() const
+    {
+        return header_ != nullptr ? header_->head.load(std::memory_order_acquire) : 0;
+    }
+
+    bool SampleRingReader::Read(uint64_t index, RingSample& out) const
+    {
+        if (header_ == nullptr || index >= Head())
+            return false;
+        const RingSlot& slot = slots_[index & (header_->capacity - 1)];
+        uint64_t expected = 2 * index + 2;
+        if (slot.sequence.load(std::memory_order_acquire) != expected)
+            return false;
+        uint64_t words[sample_words];
+        for (size_t w = 0; w < sample_words; w++)
+            words[w] = slot.words[w].load(std::memory_order_relaxed);
+        // The sequence is unchanged only if no write overlapped the loads
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.sequence.load(std::memory_order_relaxed) != expected)
+            return false;
+        memcpy(&out, words, sizeof(words));
+        return true;
+    }
+
+    size_t SampleRingReader::Poll(uint64_t& cursor, RingSample* out, size_t max, uint64_t* dropped) const
+    {
+        uint64_t head = Head();
+        uint64_t lost = 0;
+        if (header_ != nullptr && head - cursor > header_->capacity && cursor < head)
+        {
+            lost = head - header_->capacity - cursor;
+            cursor = head - header_->capacity;
+        }
+        size_t count = 0;
+        while (cursor < head && count < max)
+        {
+            if (Read(cursor, out[count]))
+                count++;
+            else
+                lost++;
+            cursor++;
+        }
+        if (dropped != nullptr)
+            *dropped += lost;
+        return count;
+    }
+}
@@ -0,0 +1,127 @@
+// Shared-memory ring of per-tick samples for other local processes.
+//
+// The writer creates a named POSIX shared-memory object (shm_open) holding a
+// small header and a power-of-two array of fixed-size slots; readers map the
+// same object read-only and load samples straight out of it, so there are no
+// sockets, pipes or kernel copies between the two. Each slot is guarded by its
+// own sequence number (a seqlock): the writer makes it odd while it fills the
+// slot and stores 2 * (index + 1) when done, so a reader can tell a finished
+// slot from one being written or one already overwritten by a later lap,
+// without ever blocking the writer. One writer per ring; any number of readers.
+//
+// This file and SampleRing.cpp depend only on the C++ library and POSIX
+// (link -lrt on old glibc), so external tools can build them on their own.
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace Core
+{
+    // One tick of the epicycle scene. Positions are relative to the centre of
+    // the first circle, in unscaled pixels with y down.
+    struct RingSample
+    {
+        uint64_t tick = 0;          // Frame number of the writer
+        double time = 0.0;          // Seconds since the writer started
+        float plot_y = 0.0f;        // Value plotted in the graph
+        float tip_x = 0.0f;         // Tip of the chain
+        float tip_y = 0.0f;
+        uint32_t reserved = 0;
+    };
+
+    static_assert(sizeof(RingSample) == 32, "RingSample layout is shared with other processes");
+
+    // Layout of the shared object: a header, then `capacity` slots.
+    struct RingHeader
+    {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t slot_size;
+        uint32_t capacity;              // Power of two
+        uint64_t writer_pid;
+        std::atomic<uint64_t> head;     // Samples published so far
+    };
+
+    struct alignas(64) RingSlot
+    {
+        std::atomic<uint64_t> sequence;     // 2 * (index + 1) when complete, odd while being written
+        std::atomic<uint64_t> words[sizeof(RingSample) / sizeof(uint64_t)];
+    };
+
+    static_assert(std::atomic<uint64_t>::is_always_lock_free, "shared-memory atomics must be lock-free");
+
+    static constexpr size_t ring_slots_offset = 64;         // Header, padded to a cache line
+    static constexpr uint32_t ring_magic = 0x474e5246;     // "FRNG"
+    static constexpr uint32_t ring_version = 1;
+    static constexpr const char* ring_default_name = "/fourier-samples";
+
+    class SampleRingWriter
+    {
+    public:
+        SampleRingWriter() = default;
+        ~SampleRingWriter();
+
+        SampleRingWriter(const SampleRingWriter&) = delete;
+        SampleRingWriter& operator=(const SampleRingWriter&) = delete;
+
+        // Creates the named object with room for `capacity` samples, rounded
+        // up to a power of two. The name follows shm_open: a leading slash
+        // and no others. An existing object is only replaced when the writer
+        // that created it has exited; otherwise Create fails.
+        bool Create(const char* name = ring_default_name, uint32_t capacity = 4096);
+        // Unmaps and unlinks the object; readers that still have it mapped
+        // keep their view until they close.
+        void Close();
+        bool IsOpen() const { return header_ != nullptr; }
+
+        // Wait-free; overwrites the oldest sample once the ring is full.
+        void Publish(const RingSample& sample);
+
+        uint64_t Published() const;
+        const char* Error() const { return error_; }
+
+    private:
+        RingHeader* header_ = nullptr;
+        RingSlot* slots_ = nullptr;
+        size_t size_ = 0;
+        char name_[64] = "";
+        char error_[128] = "";
+    };
+
+    class SampleRingReader
+    {
+    public:
+        SampleRingReader() = default;
+        ~SampleRingReader();
+
+        SampleRingReader(const SampleRingReader&) = delete;
+        SampleRingReader& operator=(const SampleRingReader&) = delete;
+
+        bool Open(const char* name = ring_default_name);
+        void Close();
+        bool IsOpen() const { return header_ != nullptr; }
+
+        uint32_t Capacity() const;
+        // Samples published so far; the newest has index Head() - 1.
+        uint64_t Head() const;
+
+        // Copies sample `index` into `out`. False when it has not been
+        // published yet, or was overwritten before or during the read.
+        bool Read(uint64_t index, RingSample& out) const;
+        // Reads the samples from `cursor` on, up to `max`, and advances the
+        // cursor past them. Samples the writer lapped are skipped and counted
+        // in `dropped`. Start with cursor = Head() to see only new samples.
+        size_t Poll(uint64_t& cursor, RingSample* out, size_t max, uint64_t* dropped = nullptr) const;
+
+        const char* Error() const { return error_; }
+
+    private:
+        const RingHeader* header_ = nullptr;
+        const RingSlot* slots_ = nullptr;
+        size_t size_ = 0;
+        char error_[128] = "";
+    };
+}
@@ -0,0 +1,112 @@
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+
+namespace Core
+{
+    // Set while a thread executes pool work, so nested ParallelFor calls run inline.
+    static thread_local bool inside_job = false;
+
+    ThreadPool::ThreadPool(unsigned threads)
+    {
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned i = 1; i < threads; i++)
+            workers_.emplace_back([this] { WorkerLoop(); });
+    }
+
+    ThreadPool::~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (std::thread& t : workers_)
+            t.join();
+    }
+
+    ThreadPool& ThreadPool::Global()
+    {
+        static ThreadPool pool;
+        return pool;
+    }
+
+    void ThreadPool::RunChunks(Job& job)
+    {
+        bool was_inside = inside_job;
+        inside_job = true;
+        while (true)
+        {
+            size_t begin = job.next.fetch_add(job.grain);
+            if (begin >= job.count)
+                break;
+            size_t end = std::min(begin + job.grain, job.count);
+            job.fn->call(job.fn->object, begin, end);
+            job.done.fetch_add(end - begin);
+        }
+        inside_job = was_inside;
+    }
+
+    void ThreadPool::WorkerLoop()
+    {
+        unsigned seen = 0;
+        while (true)
+        {
+            Job* job;
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                wake_.wait(lock, [&] { return stop_ || generation_ != seen; });
+                if (stop_)
+                    return;
+                seen = generation_;
+                job = job_;
+                if (job == nullptr)
+                    continue;
+                active_++;
+            }
+            RunChunks(*job);
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                active_--;
+            }
+            finished_.notify_all();
+        }
+    }
+
+    void ThreadPool::Run(size_t count, const Chunk& fn, size_t grain)
+    {
+        if (count == 0)
+            return;
+        grain = std::max<size_t>(1, grain);
+        if (workers_.empty() || inside_job || count <= grain)
+        {
+            bool was_inside = inside_job;
+            inside_job = true;
+            for (size_t begin = 0; begin < count; begin += grain)
+                fn.call(fn.object, begin, std::min(begin + grain, count));
+            inside_job = was_inside;
+            return;
+        }
+
+        std::lock_guard<std::mutex> submit(submit_mutex_);
+        Job job;
+        job.fn = &fn;
+        job.count = count;
+        job.grain = grain;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            job_ = &job;
+            generation_++;
+        }
+        wake_.notify_all();
+
+        RunChunks(job);
+
+        // Wait for every chunk to finish and for every worker to leave the job
+        // before it goes out of scope.
+        std::unique_lock<std::mutex> lock(mutex_);
+        finished_.wait(lock, [&] { return job.done.load() == count && active_ == 0; });
+        job_ = nullptr;
+    }
+}
@@ -0,0 +1,76 @@
+// Fixed-size worker pool for data-parallel loops.
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace Core
+{
+    class ThreadPool
+    {
+    public:
+        // threads == 0 uses std::thread::hardware_concurrency().
+        // The calling thread always takes part in ParallelFor, so a pool of
+        // N threads starts N - 1 workers.
+        explicit ThreadPool(unsigned threads = 0);
+        ~ThreadPool();
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        unsigned ThreadCount() const { return (unsigned)workers_.size() + 1; }
+
+        // Calls fn(begin, end) over chunks of [0, count) of at most `grain`
+        // items and blocks until all of them are done. Calls made from inside
+        // a running job execute inline on the calling thread. fn is only
+        // referenced, never copied, so no call allocates.
+        template <typename Fn>
+        void ParallelFor(size_t count, Fn&& fn, size_t grain = 1)
+        {
+            using Callable = std::remove_reference_t<Fn>;
+            Chunk chunk{ (void*)std::addressof(fn), [](void* object, size_t begin, size_t end) { (*(Callable*)object)(begin, end); } };
+            Run(count, chunk, grain);
+        }
+
+        // Process-wide pool sized to the machine.
+        static ThreadPool& Global();
+
+    private:
+        // Non-owning reference to the caller's callable
+        struct Chunk
+        {
+            void* object;
+            void (*call)(void* object, size_t begin, size_t end);
+        };
+
+        struct Job
+        {
+            const Chunk* fn = nullptr;
+            size_t count = 0;
+            size_t grain = 1;
+            std::atomic<size_t> next{ 0 };
+            std::atomic<size_t> done{ 0 };
+        };
+
+        void Run(size_t count, const Chunk& fn, size_t grain);
+        void WorkerLoop();
+        void RunChunks(Job& job);
+
+        std::vector<std::thread> workers_;
+        std::mutex submit_mutex_;           // One ParallelFor at a time
+        std::mutex mutex_;
+        std::condition_variable wake_;
+        std::condition_variable finished_;
+        Job* job_ = nullptr;
+        unsigned generation_ = 0;
+        unsigned active_ = 0;               // Workers currently inside RunChunks
+        bool stop_ = false;
+    };
+}
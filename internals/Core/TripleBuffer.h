@@ -0,0 +1,60 @@
+// Latest-value handoff from one writer thread to one reader thread.
+//
+// Three copies of T: the writer fills its own, then swaps it with the shared
+// middle one; the reader swaps the middle one with its own whenever a newer
+// value is waiting. Both sides are a single atomic exchange, so neither ever
+// waits for the other (a real-time thread can read while the UI writes), and
+// values the reader had no time to see are simply replaced by newer ones.
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace Core
+{
+    template <typename T>
+    class TripleBuffer
+    {
+    public:
+        TripleBuffer() = default;
+        TripleBuffer(const TripleBuffer&) = delete;
+        TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+        // Writer side: fill Back(), then Publish() it.
+        T& Back() { return buffers_[back_]; }
+        void Publish()
+        {
+            back_ = middle_.exchange((uint8_t)(back_ | fresh_bit), std::memory_order_acq_rel) & index_mask;
+        }
+
+        // Reader side: true when a newer value was published since the last
+        // call; Front() is then that value.
+        bool Acquire()
+        {
+            if ((middle_.load(std::memory_order_relaxed) & fresh_bit) == 0)
+                return false;
+            front_ = middle_.exchange(front_, std::memory_order_acq_rel) & index_mask;
+            return true;
+        }
+        const T& Front() const { return buffers_[front_]; }
+
+        // Before any thread runs: the same setup (e.g. reserved capacity) in
+        // every copy.
+        template <typename Fn>
+        void ForEach(Fn&& fn)
+        {
+            for (T& buffer : buffers_)
+                fn(buffer);
+        }
+
+    private:
+        static constexpr uint8_t index_mask = 3;
+        static constexpr uint8_t fresh_bit = 4;
+
+        T buffers_[3] = {};
+        uint8_t back_ = 0;                      // Writer only
+        uint8_t front_ = 1;                     // Reader only
+        std::atomic<uint8_t> middle_{ 2 };      // Index, plus fresh_bit when unread
+    };
+}
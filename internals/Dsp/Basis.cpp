@@ -0,0 +1,205 @@
+#include "Dsp/Basis.h"
+
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define BASIS_SSE2 1
+#else
+#define BASIS_SSE2 0
+#endif
+
+namespace Dsp
+{
+    // Floats of matrix per parallel chunk
+    static constexpr size_t chunk_floats = 1 << 16;
+
+    // cos(h theta), sin(h theta) for h = 0..max_harmonic at theta = j * step,
+    // by the Chebyshev recurrence f(h + 1) = 2 cos(theta) f(h) - f(h - 1).
+    static void BasisRow(size_t j, double step, int32_t max_harmonic, size_t stride, float* row)
+    {
+        double theta = ReduceAngle((double)j * step);
+        double c1 = std::cos(theta), s1 = std::sin(theta), twice = 2.0 * c1;
+        double c0 = 1.0, s0 = 0.0;
+        row[0] = 1.0f;
+        row[1] = 0.0f;
+        for (int32_t h = 1; h <= max_harmonic; h++)
+        {
+            row[2 * h] = (float)c1;
+            row[2 * h + 1] = (float)s1;
+            double c2 = twice * c1 - c0, s2 = twice * s1 - s0;
+            c0 = c1;
+            s0 = s1;
+            c1 = c2;
+            s1 = s2;
+        }
+        std::fill(row + 2 * (max_harmonic + 1), row + stride, 0.0f);
+    }
+
+    // x[r], y[r] for four rows: dot products with the coefficients, each
+    // accumulated in four lanes (column k in lane k % 4) and the lanes summed
+    // pairwise; the SSE2 and scalar paths round identically.
+    static void Dot4(const float* const rows[4], const float* cx, const float* cy, size_t stride, float x[4], float y[4])
+    {
+#if BASIS_SSE2
+        __m128 ax[4], ay[4];
+        for (int r = 0; r < 4; r++)
+            ax[r] = ay[r] = _mm_setzero_ps();
+        for (size_t k = 0; k < stride; k += 4)
+        {
+            __m128 vx = _mm_loadu_ps(cx + k), vy = _mm_loadu_ps(cy + k);
+            for (int r = 0; r < 4; r++)
+            {
+                __m128 m = _mm_loadu_ps(rows[r] + k);
+                ax[r] = _mm_add_ps(ax[r], _mm_mul_ps(m, vx));
+                ay[r] = _mm_add_ps(ay[r], _mm_mul_ps(m, vy));
+            }
+        }
+        for (int r = 0; r < 4; r++)
+        {
+            float lx[4], ly[4];
+            _mm_storeu_ps(lx, ax[r]);
+            _mm_storeu_ps(ly, ay[r]);
+            x[r] = (lx[0] + lx[1]) + (lx[2] + lx[3]);
+            y[r] = (ly[0] + ly[1]) + (ly[2] + ly[3]);
+        }
+#else
+        for (int r = 0; r < 4; r++)
+        {
+            float lx[4] = {}, ly[4] = {};
+            for (size_t k = 0; k < stride; k += 4)
+                for (size_t l = 0; l < 4; l++)
+                {
+                    lx[l] += rows[r][k + l] * cx[k + l];
+                    ly[l] += rows[r][k + l] * cy[k + l];
+                }
+            x[r] = (lx[0] + lx[1]) + (lx[2] + lx[3]);
+            y[r] = (ly[0] + ly[1]) + (ly[2] + ly[3]);
+        }
+#endif
+    }
+
+    BasisCache::BasisCache(size_t memory_limit)
+        : memory_limit_(memory_limit)
+    {
+    }
+
+    void BasisCache::SetMemoryLimit(size_t bytes)
+    {
+        memory_limit_ = bytes;
+        if (Bytes() > memory_limit_)
+            Invalidate();
+    }
+
+    void BasisCache::Invalidate()
+    {
+        matrix_.clear();
+        matrix_.shrink_to_fit();
+        points_ = 0;
+        step_ = 0.0;
+        max_harmonic_ = -1;
+    }
+
+    void BasisCache::Synthesize(const Epicycle* circles, size_t count, double time, size_t points, double step,
+                                float* x, float* y, Core::ThreadPool* pool)
+    {
+        if (points == 0)
+            return;
+        int32_t max_harmonic = 0;
+        for (size_t i = 0; i < count; i++)
+            max_harmonic = std::max(max_harmonic, std::abs(circles[i].harmonic));
+
+        // A new matrix covers harmonics up to the next multiple of 64, so a
+        // chain that grows by a few circles keeps using it
+        bool hit = Cached() && points == points_ && step == step_ && max_harmonic <= max_harmonic_;
+        int32_t columns = hit ? max_harmonic_ : (max_harmonic | 63);
+        size_t stride = 2 * ((size_t)columns + 1);
+        bool store = hit || (double)points * (double)stride * sizeof(float) <= (double)memory_limit_;
+        if (!hit)
+        {
+            Invalidate();
+            if (store)
+            {
+                matrix_.resize(points * stride);
+                auto build = [&](size_t begin, size_t end)
+                {
+                    for (size_t j = begin; j < end; j++)
+                        BasisRow(j, step, columns, stride, matrix_.data() + j * stride);
+                };
+                size_t grain = std::max<size_t>(1, chunk_floats / stride);
+                if (pool)
+                    pool->ParallelFor(points, build, grain);
+                else
+                    build(0, points);
+                points_ = points;
+                step_ = step;
+                max_harmonic_ = columns;
+                builds_++;
+            }
+            else
+                generated_++;
+        }
+
+        // The chain folded onto harmonics 0..columns: c exp(+-i h theta) with
+        // c = radius * exp(i (harmonic * time + phase))
+        sums_.assign(2 * stride, 0.0);
+        for (size_t i = 0; i < count; i++)
+        {
+            const Epicycle& circle = circles[i];
+            double angle = ReduceAngle((double)circle.harmonic * time + (double)circle.phase);
+            double re = circle.radius * std::cos(angle), im = circle.radius * std::sin(angle);
+            double sign = circle.harmonic >= 0 ? 1.0 : -1.0;
+            size_t h = (size_t)std::abs(circle.harmonic);
+            sums_[2 * h] += re;
+            sums_[2 * h + 1] -= sign * im;
+            sums_[stride + 2 * h] += im;
+            sums_[stride + 2 * h + 1] += sign * re;
+        }
+        coefficients_.resize(2 * stride);
+        for (size_t k = 0; k < 2 * stride; k++)
+            coefficients_[k] = (float)sums_[k];
+
+        const float* cx = coefficients_.data();
+        const float* cy = coefficients_.data() + stride;
+        size_t blocks = (points + 3) / 4;
+        auto run = [&](size_t begin, size_t end)
+        {
+            // Rows generated on the fly go to grow-only per-thread scratch
+            thread_local std::vector<float> scratch;
+            if (!store && scratch.size() < 4 * stride)
+                scratch.resize(4 * stride);
+            for (size_t b = begin; b < end; b++)
+            {
+                const float* rows[4];
+                for (size_t r = 0; r < 4; r++)
+                {
+                    // Past the last point, repeat it and drop the result
+                    size_t j = std::min(4 * b + r, points - 1);
+                    if (store)
+                        rows[r] = matrix_.data() + j * stride;
+                    else
+                    {
+                        BasisRow(j, step, columns, stride, scratch.data() + r * stride);
+                        rows[r] = scratch.data() + r * stride;
+                    }
+                }
+                float bx[4], by[4];
+                Dot4(rows, cx, cy, stride, bx, by);
+                for (size_t r = 0; r < 4 && 4 * b + r < points; r++)
+                {
+                    x[4 * b + r] = bx[r];
+                    y[4 * b + r] = by[r];
+                }
+            }
+        };
+        size_t grain = std::max<size_t>(1, chunk_floats / (4 * stride));
+        if (pool)
+            pool->ParallelFor(blocks, run, grain);
+        else
+            run(0, blocks);
+    }
+}
@@ -0,0 +1,70 @@
+// Epicycle chains sampled on a fixed grid of times, as a matrix-vector
+// product.
+//
+// On the grid t_j = time + j * step, the tip of a chain is
+//   x_j = sum_h a_h cos(h j step) + b_h sin(h j step),
+//   y_j = sum_h c_h cos(h j step) + d_h sin(h j step)
+// for harmonics h = 0..max, where the coefficients fold in the radii,
+// phases, negative harmonics and the start time. The cos / sin matrix only
+// depends on the grid, so it is built once and every later synthesis on
+// that grid is two dot products per sample instead of a sine and cosine per
+// sample and circle: 4-row blocks with SSE2, split across the thread pool.
+//
+// The matrix is keyed by (points, step, max harmonic) and kept while later
+// requests fit in it (same grid, harmonics up to its own); one that does not
+// fit replaces it. Rows come from a
+// double-precision Chebyshev recurrence, rounded to float. When the matrix
+// would exceed the memory limit, each block of rows is generated from the
+// same recurrence as it is used instead of stored, so the result is
+// bit-identical either way, at the cost of the recurrence every time.
+
+#pragma once
+
+#include "Dsp/Epicycles.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Core { class ThreadPool; }
+
+namespace Dsp
+{
+    class BasisCache
+    {
+    public:
+        explicit BasisCache(size_t memory_limit = (size_t)64 << 20);
+
+        // Bytes the matrix may take. A cached matrix over a new limit is
+        // dropped.
+        void SetMemoryLimit(size_t bytes);
+        size_t MemoryLimit() const { return memory_limit_; }
+        // Drops the matrix; the next Synthesize rebuilds it.
+        void Invalidate();
+
+        // x[j], y[j]: the chain's tip at time + j * step, j < points.
+        void Synthesize(const Epicycle* circles, size_t count, double time, size_t points, double step,
+                        float* x, float* y, Core::ThreadPool* pool = nullptr);
+
+        // The cached matrix, if any: its grid and harmonics, and size.
+        bool Cached() const { return !matrix_.empty(); }
+        size_t Points() const { return points_; }
+        int32_t MaxHarmonic() const { return max_harmonic_; }
+        size_t Bytes() const { return matrix_.size() * sizeof(float); }
+        // Matrices built, and syntheses that generated rows on the fly
+        // because the matrix would not fit.
+        uint64_t Builds() const { return builds_; }
+        uint64_t Generated() const { return generated_; }
+
+    private:
+        size_t points_ = 0;
+        double step_ = 0.0;
+        int32_t max_harmonic_ = -1;
+        size_t memory_limit_;
+        std::vector<float> matrix_;         // points_ rows of cos, sin pairs for h = 0..max_harmonic_
+        std::vector<float> coefficients_;   // x then y, one row each
+        std::vector<double> sums_;          // Coefficients before rounding
+        uint64_t builds_ = 0;
+        uint64_t generated_ = 0;
+    };
+}
@@ -0,0 +1,145 @@
+#include "Dsp/BatchFft.h"
+
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numbers>
+
+namespace Dsp
+{
+    BatchFftPlan::BatchFftPlan(size_t n)
+        : n_(n), plan_(n)
+    {
+        assert(n >= 1);
+        if (!IsPowerOfTwo(n))
+            return;
+
+        unsigned bits = 0;
+        while (((size_t)1 << bits) < n)
+            bits++;
+        bitrev_.resize(n);
+        for (size_t i = 0; i < n; i++)
+        {
+            size_t j = 0;
+            for (unsigned b = 0; b < bits; b++)
+                j |= ((i >> b) & 1) << (bits - 1 - b);
+            bitrev_[i] = (unsigned)j;
+        }
+        twiddles_.resize(n);
+        for (size_t h = 1; h < n; h <<= 1)
+            for (size_t j = 0; j < h; j++)
+            {
+                double a = -std::numbers::pi * (double)j / (double)h;
+                twiddles_[h + j] = Complex((float)std::cos(a), (float)std::sin(a));
+            }
+    }
+
+    // One butterfly across all lanes. The four rows are distinct, which the
+    // restrict qualifiers tell the compiler so the loop becomes vertical SIMD.
+    static inline void Butterfly(float* __restrict ar, float* __restrict ai, float* __restrict br, float* __restrict bi, float wr, float wi)
+    {
+        for (size_t l = 0; l < BatchFftPlan::lanes; l++)
+        {
+            float tr = br[l] * wr - bi[l] * wi;
+            float ti = br[l] * wi + bi[l] * wr;
+            br[l] = ar[l] - tr;
+            bi[l] = ai[l] - ti;
+            ar[l] = ar[l] + tr;
+            ai[l] = ai[l] + ti;
+        }
+    }
+
+    void BatchFftPlan::Butterflies(float* re, float* im, FftDirection dir) const
+    {
+        const float sign = (dir == FftDirection::Inverse) ? -1.0f : 1.0f;
+        for (size_t h = 1; h < n_; h <<= 1)
+        {
+            for (size_t base = 0; base < n_; base += 2 * h)
+            {
+                for (size_t j = 0; j < h; j++)
+                {
+                    float wr = twiddles_[h + j].real();
+                    float wi = sign * twiddles_[h + j].imag();
+                    size_t a = (base + j) * lanes;
+                    size_t b = (base + j + h) * lanes;
+                    Butterfly(re + a, im + a, re + b, im + b, wr, wi);
+                }
+            }
+        }
+    }
+
+    void BatchFftPlan::Run(Complex* data, size_t batch, size_t row, size_t column, FftDirection dir, Core::ThreadPool* pool) const
+    {
+        const bool pow2 = IsPowerOfTwo(n_);
+        size_t blocks = (batch + lanes - 1) / lanes;
+        auto run = [&](size_t begin, size_t end)
+        {
+            // Grow-only per-thread scratch: no allocation once warmed up.
+            thread_local std::vector<float> scratch;
+            if (scratch.size() < 2 * n_ * lanes)
+                scratch.resize(2 * n_ * lanes);
+            float* re = scratch.data();
+            float* im = re + n_ * lanes;
+            Complex* signal = reinterpret_cast<Complex*>(re);
+
+            for (size_t k = begin; k < end; k++)
+            {
+                size_t first = k * lanes;
+                size_t width = std::min(lanes, batch - first);
+                Complex* block = data + first * column;
+                if (!pow2)
+                {
+                    for (size_t b = 0; b < width; b++)
+                    {
+                        for (size_t j = 0; j < n_; j++)
+                            signal[j] = block[j * row + b * column];
+                        plan_.Transform(signal, dir);
+                        for (size_t j = 0; j < n_; j++)
+                            block[j * row + b * column] = signal[j];
+                    }
+                    continue;
+                }
+
+                // Gather with the bit reversal folded in; missing lanes are zero.
+                for (size_t j = 0; j < n_; j++)
+                {
+                    const Complex* src = block + bitrev_[j] * row;
+                    float* r = re + j * lanes;
+                    float* i = im + j * lanes;
+                    for (size_t b = 0; b < width; b++)
+                    {
+                        r[b] = src[b * column].real();
+                        i[b] = src[b * column].imag();
+                    }
+                    for (size_t b = width; b < lanes; b++)
+                        r[b] = i[b] = 0.0f;
+                }
+                Butterflies(re, im, dir);
+                for (size_t j = 0; j < n_; j++)
+                {
+                    Complex* dst = block + j * row;
+                    const float* r = re + j * lanes;
+                    const float* i = im + j * lanes;
+                    for (size_t b = 0; b < width; b++)
+                        dst[b * column] = Complex(r[b], i[b]);
+                }
+            }
+        };
+        if (pool != nullptr)
+            pool->ParallelFor(blocks, run);
+        else
+            run(0, blocks);
+    }
+
+    void BatchFftPlan::Transform(Complex* data, size_t batch, FftDirection dir, Core::ThreadPool* pool) const
+    {
+        Run(data, batch, batch, 1, dir, pool);
+    }
+
+    void BatchFftPlan::TransformContiguous(Complex* data, size_t batch, FftDirection dir, Core::ThreadPool* pool) const
+    {
+        Run(data, batch, 1, n_, dir, pool);
+    }
+}
@@ -0,0 +1,53 @@
+// Batched FFTs: many independent transforms of the same size.
+//
+// Signals are processed in blocks of `lanes` signals. A block is gathered
+// into a split real/imaginary scratch with the signals innermost
+// (re[j * lanes + b]), applying the bit-reversal permutation on the way in,
+// so every butterfly is a fixed-width loop over signals with one shared
+// twiddle that the compiler turns into plain vertical SIMD. Blocks are
+// spread over a thread pool.
+
+#pragma once
+
+#include "Dsp/Fft.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace Core { class ThreadPool; }
+
+namespace Dsp
+{
+    class BatchFftPlan
+    {
+    public:
+        // Signals per block, a multiple of every common SIMD width.
+        static constexpr size_t lanes = 16;
+
+        // Any n >= 1; power-of-two sizes run the split SIMD kernel,
+        // other sizes transform each signal with an FftPlan.
+        explicit BatchFftPlan(size_t n);
+
+        size_t Size() const { return n_; }
+
+        // `batch` interleaved signals (element j of signal b at data[j * batch + b]),
+        // transformed in place (unnormalized).
+        void Transform(Complex* data, size_t batch, FftDirection dir, Core::ThreadPool* pool = nullptr) const;
+        void Forward(Complex* data, size_t batch, Core::ThreadPool* pool = nullptr) const { Transform(data, batch, FftDirection::Forward, pool); }
+        void Inverse(Complex* data, size_t batch, Core::ThreadPool* pool = nullptr) const { Transform(data, batch, FftDirection::Inverse, pool); }
+
+        // `batch` contiguous signals (signal b at data[b * n]).
+        void TransformContiguous(Complex* data, size_t batch, FftDirection dir, Core::ThreadPool* pool = nullptr) const;
+
+    private:
+        // Runs the blocks of a batch; element j of signal b is at data[j * row + b * column].
+        void Run(Complex* data, size_t batch, size_t row, size_t column, FftDirection dir, Core::ThreadPool* pool) const;
+        // Butterflies over the split scratch of one block.
+        void Butterflies(float* re, float* im, FftDirection dir) const;
+
+        size_t n_ = 0;
+        FftPlan plan_;                      // Per-signal fallback for sizes that are not powers of two
+        std::vector<unsigned> bitrev_;      // Row index of each output row before the radix-2 stages
+        std::vector<Complex> twiddles_;     // Stage with half-size h uses [h, 2h)
+    };
+}
@@ -0,0 +1,205 @@
+#include "Dsp/Convergence.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define CONVERGENCE_SSE2 1
+#else
+#define CONVERGENCE_SSE2 0
+#endif
+
+namespace Dsp
+{
+    static constexpr size_t resync_points = 64;
+
+    ConvergenceCache::ConvergenceCache(size_t budget_bytes)
+        : budget_(budget_bytes)
+    {
+    }
+
+    void ConvergenceCache::Configure(const Epicycle* circles, size_t count, size_t points)
+    {
+        auto same = [](const Epicycle& a, const Epicycle& b)
+        {
+            return a.radius == b.radius && a.harmonic == b.harmonic && a.phase == b.phase;
+        };
+        if (points == points_ && count == circles_.size() && std::equal(circles, circles + count, circles_.begin(), same))
+            return;
+        circles_.assign(circles, circles + count);
+        if (points != points_)
+        {
+            points_ = points;
+            unit_.resize(points);
+            for (size_t j = 0; j < points; j++)
+            {
+                double angle = 2.0 * std::numbers::pi * (double)j / (double)points;
+                unit_[j] = Complex((float)std::cos(angle), (float)std::sin(angle));
+            }
+            zero_.assign(2 * points, 0.0f);
+        }
+        Layout();
+    }
+
+    void ConvergenceCache::SetBudget(size_t bytes)
+    {
+        budget_ = bytes;
+        Layout();
+    }
+
+    void ConvergenceCache::Clear()
+    {
+        std::fill(slot_of_level_.begin(), slot_of_level_.end(), -1);
+        std::fill(level_of_slot_.begin(), level_of_slot_.end(), -1);
+        std::fill(last_use_.begin(), last_use_.end(), 0);
+        hits_ = misses_ = additions_ = 0;
+    }
+
+    // Slots from the budget, and checkpoint spacing so that checkpoints never
+    // take more than half the slots and two are always left for a rebuild
+    // (its source and its destination).
+    void ConvergenceCache::Layout()
+    {
+        size_t count = circles_.size();
+        size_t level_bytes = std::max<size_t>(2 * points_ * sizeof(float), 1);
+        size_t slots = std::min(std::max<size_t>(budget_ / level_bytes, 2), std::max<size_t>(count, 2));
+        size_t checkpoints = (slots - 2) / 2;
+        if (slots >= count)
+            spacing_ = 1;
+        else if (checkpoints == 0)
+            spacing_ = count + 1;
+        else
+            spacing_ = (count + checkpoints - 1) / checkpoints;
+        storage_.assign(slots * 2 * points_, 0.0f);
+        slot_of_level_.assign(count + 1, -1);
+        level_of_slot_.assign(slots, -1);
+        last_use_.assign(slots, 0);
+        clock_ = 0;
+        Clear();
+    }
+
+    size_t ConvergenceCache::CachedLevels() const
+    {
+        return (size_t)std::count_if(level_of_slot_.begin(), level_of_slot_.end(), [](int32_t level) { return level >= 0; });
+    }
+
+    // A slot for `level`: a free one, else the least recently used that holds
+    // neither a checkpoint nor the level being built from.
+    size_t ConvergenceCache::Acquire(size_t level)
+    {
+        size_t victim = (size_t)-1;
+        for (size_t s = 0; s < level_of_slot_.size(); s++)
+        {
+            int32_t held = level_of_slot_[s];
+            if (held < 0)
+            {
+                victim = s;
+                break;
+            }
+            if ((size_t)held % spacing_ == 0 || (size_t)held == level - 1)
+                continue;
+            if (victim == (size_t)-1 || last_use_[s] < last_use_[victim])
+                victim = s;
+        }
+        if (level_of_slot_[victim] >= 0)
+            slot_of_level_[(size_t)level_of_slot_[victim]] = -1;
+        level_of_slot_[victim] = (int32_t)level;
+        slot_of_level_[level] = (int32_t)victim;
+        return victim;
+    }
+
+    ConvergenceCache::Level ConvergenceCache::Get(size_t terms)
+    {
+        size_t n = std::min(terms, circles_.size());
+        if (n == 0 || points_ == 0)
+            return { zero_.data(), zero_.data() + points_ };
+        if (slot_of_level_[n] >= 0)
+        {
+            hits_++;
+            size_t slot = (size_t)slot_of_level_[n];
+            last_use_[slot] = ++clock_;
+            return { Slot(slot), Slot(slot) + points_ };
+        }
+        misses_++;
+        size_t from = n - 1;
+        while (from > 0 && slot_of_level_[from] < 0)
+            from--;
+        const float* source = from == 0 ? zero_.data() : Slot((size_t)slot_of_level_[from]);
+        float* level = nullptr;
+        for (size_t k = from + 1; k <= n; k++)
+        {
+            size_t slot = Acquire(k);
+            level = Slot(slot);
+            AddCircle(source, level, circles_[k - 1]);
+            additions_++;
+            last_use_[slot] = ++clock_;
+            source = level;
+        }
+        return { level, level + points_ };
+    }
+
+    void ConvergenceCache::Precompute()
+    {
+        for (size_t n = 1; n <= circles_.size(); n++)
+            Get(n);
+    }
+
+    // to = from + radius * exp(i (harmonic * 2 pi j / points + phase)). Each
+    // run of resync_points starts from the exact table and steps four points
+    // at a time; the SSE2 and scalar paths round identically.
+    void ConvergenceCache::AddCircle(const float* from, float* to, const Epicycle& circle) const
+    {
+        size_t points = points_;
+        size_t harmonic = (size_t)(((int64_t)circle.harmonic % (int64_t)points + (int64_t)points) % (int64_t)points);
+        float cr = circle.radius * (float)std::cos((double)circle.phase);
+        float ci = circle.radius * (float)std::sin((double)circle.phase);
+        Complex step = unit_[(4 * harmonic) % points];
+        float sr = step.real(), si = step.imag();
+        const float* from_x = from;
+        const float* from_y = from + points;
+        float* to_x = to;
+        float* to_y = to + points;
+        for (size_t begin = 0; begin < points; begin += resync_points)
+        {
+            size_t end = std::min(begin + resync_points, points);
+            float zr[4], zi[4];
+            for (size_t l = 0; l < 4; l++)
+            {
+                Complex u = unit_[(harmonic * (begin + l)) % points];
+                zr[l] = cr * u.real() - ci * u.imag();
+                zi[l] = cr * u.imag() + ci * u.real();
+            }
+            size_t j = begin;
+#if CONVERGENCE_SSE2
+            __m128 vzr = _mm_loadu_ps(zr), vzi = _mm_loadu_ps(zi);
+            __m128 vsr = _mm_set1_ps(sr), vsi = _mm_set1_ps(si);
+            for (; j + 4 <= end; j += 4)
+            {
+                _mm_storeu_ps(to_x + j, _mm_add_ps(_mm_loadu_ps(from_x + j), vzr));
+                _mm_storeu_ps(to_y + j, _mm_add_ps(_mm_loadu_ps(from_y + j), vzi));
+                __m128 r = _mm_sub_ps(_mm_mul_ps(vzr, vsr), _mm_mul_ps(vzi, vsi));
+                vzi = _mm_add_ps(_mm_mul_ps(vzr, vsi), _mm_mul_ps(vzi, vsr));
+                vzr = r;
+            }
+            _mm_storeu_ps(zr, vzr);
+            _mm_storeu_ps(zi, vzi);
+#endif
+            for (; j < end; j += 4)
+            {
+                for (size_t l = 0; l < 4 && j + l < end; l++)
+                {
+                    to_x[j + l] = from_x[j + l] + zr[l];
+                    to_y[j + l] = from_y[j + l] + zi[l];
+                }
+                for (size_t l = 0; l < 4; l++)
+                {
+                    float r = zr[l] * sr - zi[l] * si;
+                    zi[l] = zr[l] * si + zi[l] * sr;
+                    zr[l] = r;
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,86 @@
+// Partial sums of an epicycle chain over one period, for every term count:
+// how the series converges as circles are added.
+//
+// Level n is the tip of the first n circles at `points` evenly spaced
+// phases. It is built from level n - 1 by adding one circle at every point,
+// four points at a time with SSE2 (a phasor stepped around the period and
+// reset from an exact table every 64 points), so all levels together cost
+// one pass over count * points terms. Every level is produced by the same
+// chain of additions, so a level computed again is bit-identical.
+//
+// Levels live in fixed slots sized by a byte budget. Up to half the slots
+// hold evenly spaced checkpoint levels that are never evicted; the others
+// keep the most recently used levels. A miss is rebuilt from the nearest
+// cached level below it, at most one checkpoint spacing of additions, and
+// the levels passed on the way are kept. Sweeping the term count up costs
+// at most one addition per step; sweeping down hits as long as the levels
+// fit the budget.
+
+#pragma once
+
+#include "Dsp/Epicycles.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Dsp
+{
+    class ConvergenceCache
+    {
+    public:
+        explicit ConvergenceCache(size_t budget_bytes = (size_t)4 << 20);
+
+        // The chain and grid; point j is at fundamental phase 2 pi j / points.
+        // Drops every cached level when either changed (nothing otherwise).
+        void Configure(const Epicycle* circles, size_t count, size_t points);
+        // Bytes of level storage; at least two levels are always kept. Drops
+        // every cached level.
+        void SetBudget(size_t bytes);
+        void Clear();
+
+        // Computes and caches levels 1..count in order, as far as they fit.
+        void Precompute();
+
+        struct Level
+        {
+            const float* x;
+            const float* y;
+        };
+        // Sum of the first `terms` circles (clamped to count) at every point.
+        // Valid until the next Get, Precompute or Configure.
+        Level Get(size_t terms);
+
+        size_t Count() const { return circles_.size(); }
+        size_t Points() const { return points_; }
+        size_t Budget() const { return budget_; }
+        size_t SlotCount() const { return level_of_slot_.size(); }
+        size_t CachedLevels() const;
+        size_t CheckpointSpacing() const { return spacing_; }
+        uint64_t Hits() const { return hits_; }
+        uint64_t Misses() const { return misses_; }
+        // Circles added at every point since Configure, for the cost of misses.
+        uint64_t Additions() const { return additions_; }
+
+    private:
+        void Layout();
+        size_t Acquire(size_t level);
+        void AddCircle(const float* from, float* to, const Epicycle& circle) const;
+        float* Slot(size_t slot) { return storage_.data() + 2 * points_ * slot; }
+
+        size_t budget_;
+        size_t points_ = 0;
+        size_t spacing_ = 0;                    // Checkpoints are multiples of this
+        std::vector<Epicycle> circles_;
+        std::vector<Complex> unit_;             // exp(2 pi i j / points)
+        std::vector<float> zero_;               // Level 0: x then y
+        std::vector<float> storage_;            // Per slot: x then y
+        std::vector<int32_t> slot_of_level_;    // -1 when not cached
+        std::vector<int32_t> level_of_slot_;    // -1 when free
+        std::vector<uint64_t> last_use_;
+        uint64_t clock_ = 0;
+        uint64_t hits_ = 0;
+        uint64_t misses_ = 0;
+        uint64_t additions_ = 0;
+    };
+}
@@ -0,0 +1,183 @@
+#include "Dsp/Cwt.h"
+
+#include "Core/ThreadPool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numbers>
+
+namespace Dsp
+{
+    // Responses below this are treated as zero when trimming the cached bands.
+    static const double band_threshold = 1e-6;
+
+    // Frequency response at w (radians/sample, w > 0) of a wavelet dilated by s.
+    static double Response(CwtWavelet wavelet, double s, double w, double omega0)
+    {
+        double sw = s * w;
+        if (wavelet == CwtWavelet::Morlet)
+        {
+            double d = sw - omega0;
+            return 2.0 * std::exp(-0.5 * d * d);
+        }
+        // Peak at sw = sqrt(2), value 2
+        return sw * sw * std::exp(1.0 - 0.5 * sw * sw);
+    }
+
+    CwtPlan::CwtPlan(CwtWavelet wavelet, size_t n, std::vector<float> scales, float omega0)
+        : wavelet_(wavelet), n_(n), m_(NextPowerOfTwo(2 * n)), omega0_(omega0), scales_(std::move(scales)),
+          forward_(m_), inverse_(m_)
+    {
+        assert(n >= 1);
+        const double pi = std::numbers::pi;
+        // Range of s*w where the response exceeds the threshold; the same for every scale.
+        double lo = 0.0, hi = 0.0;
+        for (double sw = 1e-3; sw < 64.0; sw += 1e-3)
+        {
+            if (Response(wavelet_, 1.0, sw, omega0_) > band_threshold)
+            {
+                if (lo == 0.0)
+                    lo = sw;
+                hi = sw;
+            }
+        }
+
+        bands_.resize(scales_.size());
+        for (size_t i = 0; i < scales_.size(); i++)
+        {
+            // Positive frequencies only: bins 1 .. m/2
+            double s = scales_[i];
+            double bin_to_w = 2.0 * pi / (double)m_;
+            size_t first = std::max<size_t>(1, (size_t)std::ceil(lo / (s * bin_to_w)));
+            size_t last = std::min<size_t>(m_ / 2, (size_t)std::floor(hi / (s * bin_to_w)));
+            if (first > last)
+                continue;
+            Band& band = bands_[i];
+            band.first = first;
+            band.response.resize(last - first + 1);
+            for (size_t k = first; k <= last; k++)
+                band.response[k - first] = (float)Response(wavelet_, s, bin_to_w * (double)k, omega0_);
+        }
+    }
+
+    const FftPlan& CwtPlan::PlanOfSize(size_t size) const
+    {
+        unsigned log2 = 0;
+        while (((size_t)1 << log2) < size)
+            log2++;
+        std::lock_guard<std::mutex> lock(plans_mutex_);
+        if (plans_.size() <= log2)
+            plans_.resize(log2 + 1);
+        if (!plans_[log2])
+            plans_[log2] = std::make_unique<FftPlan>((size_t)1 << log2);
+        return *plans_[log2];
+    }
+
+    float CwtPlan::ScaleToFrequency(float scale) const
+    {
+        double peak = (wavelet_ == CwtWavelet::Morlet) ? omega0_ : std::sqrt(2.0);
+        return (float)(peak / (2.0 * std::numbers::pi * scale));
+    }
+
+    std::vector<float> CwtPlan::LogScales(float min_scale, float max_scale, size_t count)
+    {
+        std::vector<float> scales(count);
+        double ratio = (count > 1) ? std::pow((double)max_scale / min_scale, 1.0 / (double)(count - 1)) : 1.0;
+        for (size_t i = 0; i < count; i++)
+            scales[i] = (float)(min_scale * std::pow(ratio, (double)i));
+        return scales;
+    }
+
+    // Spectrum of the zero-padded signal in per-thread buffers that only grow,
+    // so repeated transforms do not allocate. Valid until the calling
+    // thread's next call; workers read it through the returned pointer.
+    const Complex* CwtPlan::ForwardSpectrum(const float* signal) const
+    {
+        thread_local std::vector<float> padded;
+        thread_local std::vector<Complex> spectrum;
+        if (padded.size() < m_)
+            padded.resize(m_);
+        if (spectrum.size() < forward_.SpectrumSize())
+            spectrum.resize(forward_.SpectrumSize());
+        std::copy(signal, signal + n_, padded.begin());
+        std::fill(padded.begin() + n_, padded.begin() + m_, 0.0f);
+        forward_.Forward(padded.data(), spectrum.data());
+        return spectrum.data();
+    }
+
+    void CwtPlan::Execute(const float* signal, const std::function<void(size_t, const Complex*)>& sink, Core::ThreadPool* pool) const
+    {
+        // One forward real FFT of the zero-padded signal, shared by all scales.
+        const Complex* spectrum = ForwardSpectrum(signal);
+
+        float inv_m = 1.0f / (float)m_;
+        auto run = [&](size_t begin, size_t end)
+        {
+            thread_local std::vector<Complex> row;
+            if (row.size() < m_)
+                row.resize(m_);
+            for (size_t s = begin; s < end; s++)
+            {
+                const Band& band = bands_[s];
+                std::fill(row.begin(), row.begin() + m_, Complex(0.0f, 0.0f));
+                for (size_t k = 0; k < band.response.size(); k++)
+                    row[band.first + k] = spectrum[band.first + k] * (band.response[k] * inv_m);
+                inverse_.Inverse(row.data());
+                sink(s, row.data());
+            }
+        };
+
+        if (pool != nullptr)
+            pool->ParallelFor(scales_.size(), run);
+        else
+            run(0, scales_.size());
+    }
+
+    void CwtPlan::Scalogram(const float* signal, float* image, size_t width, Core::ThreadPool* pool) const
+    {
+        assert(width >= 1);
+        const Complex* spectrum = ForwardSpectrum(signal);
+
+        // A scale's coefficients are band-limited to its response band, so the
+        // band is shifted down to DC and inverse-transformed at a reduced size
+        // that still resolves every output column. The shift only changes the
+        // phase, and the magnitude at the decimated instants is exact.
+        size_t min_size = NextPowerOfTwo((2 * width * m_ + n_ - 1) / n_);
+        float inv_m = 1.0f / (float)m_;
+        auto run = [&](size_t begin, size_t end)
+        {
+            thread_local std::vector<Complex> row;
+            for (size_t s = begin; s < end; s++)
+            {
+                const Band& band = bands_[s];
+                float* out = image + s * width;
+                size_t size = std::min(m_, std::max(min_size, NextPowerOfTwo(band.response.size())));
+                const FftPlan& plan = PlanOfSize(size);
+                if (row.size() < size)
+                    row.resize(size);
+                std::fill(row.begin(), row.begin() + size, Complex(0.0f, 0.0f));
+                for (size_t k = 0; k < band.response.size(); k++)
+                    row[k % size] += spectrum[band.first + k] * (band.response[k] * inv_m);
+                plan.Inverse(row.data());
+
+                // Decimated sample t' sits at input time t' * m / size.
+                size_t step = m_ / size;
+                for (size_t x = 0; x < width; x++)
+                {
+                    size_t t0 = x * n_ / width;
+                    size_t t1 = std::max(t0 + 1, (x + 1) * n_ / width);
+                    float peak = 0.0f;
+                    for (size_t t = (t0 + step - 1) / step; t * step < t1; t++)
+                        peak = std::max(peak, std::norm(row[t]));
+                    out[x] = std::sqrt(peak);
+                }
+            }
+        };
+
+        if (pool != nullptr)
+            pool->ParallelFor(scales_.size(), run);
+        else
+            run(0, scales_.size());
+    }
+}
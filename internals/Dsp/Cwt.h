@@ -0,0 +1,82 @@
+// Continuous wavelet transform computed in the frequency domain.
+//
+// The signal is transformed once; every scale is then a pointwise product with
+// a cached wavelet frequency response followed by one inverse FFT, and the
+// inverse FFTs of different scales run in parallel on a thread pool.
+
+#pragma once
+
+#include "Dsp/Fft.h"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace Core { class ThreadPool; }
+
+namespace Dsp
+{
+    enum class CwtWavelet
+    {
+        Morlet,         // Analytic Morlet, centre frequency omega0 (rad per unit scale)
+        MexicanHat,     // Second derivative of a Gaussian, analytic (positive frequencies only)
+    };
+
+    // Coefficients are analytic (negative frequencies are dropped) and the
+    // responses are normalized to a peak gain of 2, so a sinusoid of amplitude
+    // A yields |W| close to A at its matching scale.
+    class CwtPlan
+    {
+    public:
+        // Scales are in samples. Responses are stored only over the band
+        // where they exceed ~1e-6, so memory is proportional to the total
+        // bandwidth of the bank rather than scales * n.
+        CwtPlan(CwtWavelet wavelet, size_t n, std::vector<float> scales, float omega0 = 6.0f);
+
+        size_t Size() const { return n_; }
+        size_t ScaleCount() const { return scales_.size(); }
+        float Scale(size_t i) const { return scales_[i]; }
+
+        // Frequency in cycles/sample at which a scale responds most.
+        float ScaleToFrequency(float scale) const;
+
+        // `count` scales geometrically spaced over [min_scale, max_scale].
+        static std::vector<float> LogScales(float min_scale, float max_scale, size_t count);
+
+        // Computes every scale and hands each row of n coefficients to `sink`.
+        // With a pool, sink is called concurrently from several threads (each
+        // with a different scale index); rows are only valid during the call.
+        void Execute(const float* signal, const std::function<void(size_t scale, const Complex* row)>& sink, Core::ThreadPool* pool = nullptr) const;
+
+        // Magnitude image of ScaleCount() rows by `width` columns, each column
+        // holding the peak |W| over its span of n / width samples. Each scale
+        // is inverse-transformed at the smallest size that holds its band and
+        // resolves the columns, so wide signals with narrow bands stay cheap.
+        void Scalogram(const float* signal, float* image, size_t width, Core::ThreadPool* pool = nullptr) const;
+
+    private:
+        const FftPlan& PlanOfSize(size_t size) const;
+        const Complex* ForwardSpectrum(const float* signal) const;
+
+        struct Band
+        {
+            size_t first = 0;               // First FFT bin with a non-negligible response
+            std::vector<float> response;
+        };
+
+        CwtWavelet wavelet_;
+        size_t n_ = 0;
+        size_t m_ = 0;                      // Zero-padded power-of-two FFT size
+        float omega0_ = 6.0f;
+        std::vector<float> scales_;
+        std::vector<Band> bands_;
+        RealFftPlan forward_;
+        FftPlan inverse_;
+
+        // Reduced-size inverse plans for Scalogram(), by log2 size, built on first use.
+        mutable std::mutex plans_mutex_;
+        mutable std::vector<std::unique_ptr<FftPlan>> plans_;
+    };
+}
@@ -0,0 +1,305 @@
+#include "Dsp/Dct.h"
+
+#include <cassert>
+#include <cmath>
+#include <numbers>
+
+namespace Dsp
+{
+    static size_t RealFftSize(DctType type, size_t n)
+    {
+        switch (type)
+        {
+            case DctType::DctI: return 2 * (n - 1);
+            case DctType::DstI: return 2 * (n + 1);
+            case DctType::DctIV:
+            case DctType::DstIV: return 1;
+            default: return n;
+        }
+    }
+
+    static size_t ComplexFftSize(DctType type, size_t n)
+    {
+        if (type != DctType::DctIV && type != DctType::DstIV)
+            return 1;
+        return (n % 2 == 0) ? n / 2 : 2 * n;
+    }
+
+    static Complex Phase(double angle)
+    {
+        return Complex((float)std::cos(angle), (float)std::sin(angle));
+    }
+
+    //-------------------------------------------------------------------------
+    // DctPlan
+    //-------------------------------------------------------------------------
+
+    DctPlan::DctPlan(DctType type, size_t n)
+        : type_(type), n_(n), real_(RealFftSize(type, n)), complex_(ComplexFftSize(type, n))
+    {
+        assert(n >= 1);
+        assert(type != DctType::DctI || n >= 2);
+
+        const double pi = std::numbers::pi;
+        switch (type)
+        {
+            case DctType::DctII:
+            case DctType::DstII:
+            case DctType::DctIII:
+            case DctType::DstIII:
+                // exp(-i*pi*k/(2n)); DCT-II also folds in its factor 2
+                post_.resize(n);
+                for (size_t k = 0; k < n; k++)
+                    post_[k] = Phase(-pi * (double)k / (2.0 * (double)n));
+                break;
+            case DctType::DctIV:
+            case DctType::DstIV:
+                if (n % 2 == 0)
+                {
+                    pre_.resize(n / 2);
+                    post_.resize(n / 2);
+                    for (size_t k = 0; k < n / 2; k++)
+                    {
+                        pre_[k] = Phase(-pi * (double)k / (double)n);
+                        post_[k] = 2.0f * Phase(-pi * (double)(4 * k + 1) / (4.0 * (double)n));
+                    }
+                }
+                else
+                {
+                    pre_.resize(n);
+                    post_.resize(n);
+                    for (size_t k = 0; k < n; k++)
+                    {
+                        pre_[k] = Phase(-pi * (double)k / (2.0 * (double)n));
+                        post_[k] = 2.0f * Phase(-pi * (double)(2 * k + 1) / (4.0 * (double)n));
+                    }
+                }
+                break;
+            default:
+                break;
+        }
+    }
+
+    void DctPlan::Execute(const float* in, float* out) const
+    {
+        // DST-II/III/IV are DCTs of a sign-flipped or reversed sequence.
+        thread_local std::vector<float> scratch;
+        if (scratch.size() < n_)
+            scratch.resize(n_);
+        float* tmp = scratch.data();
+
+        switch (type_)
+        {
+            case DctType::DctI: DctI(in, out); break;
+            case DctType::DstI: DstI(in, out); break;
+            case DctType::DctII: DctII(in, out); break;
+            case DctType::DctIII: DctIII(in, out); break;
+            case DctType::DctIV: DctIV(in, out); break;
+            case DctType::DstII:
+                for (size_t j = 0; j < n_; j++)
+                    tmp[j] = (j & 1) ? -in[j] : in[j];
+                DctII(tmp, tmp);
+                for (size_t k = 0; k < n_; k++)
+                    out[k] = tmp[n_ - 1 - k];
+                break;
+            case DctType::DstIII:
+            case DctType::DstIV:
+                for (size_t j = 0; j < n_; j++)
+                    tmp[j] = in[n_ - 1 - j];
+                if (type_ == DctType::DstIII)
+                    DctIII(tmp, out);
+                else
+                    DctIV(tmp, out);
+                for (size_t k = 1; k < n_; k += 2)
+                    out[k] = -out[k];
+                break;
+        }
+    }
+
+    // Symmetric extension of length 2(n-1): the real FFT of it is the DCT-I.
+    void DctPlan::DctI(const float* in, float* out) const
+    {
+        size_t m = real_.Size();
+        thread_local std::vector<float> ext;
+        thread_local std::vector<Complex> spec;
+        if (ext.size() < m) ext.resize(m);
+        if (spec.size() < m / 2 + 1) spec.resize(m / 2 + 1);
+
+        for (size_t j = 0; j < n_; j++)
+            ext[j] = in[j];
+        for (size_t j = 1; j + 1 < n_; j++)
+            ext[m - j] = in[j];
+        real_.Forward(ext.data(), spec.data());
+        for (size_t k = 0; k < n_; k++)
+            out[k] = spec[k].real();
+    }
+
+    // Odd extension of length 2(n+1): the DST-I is -Im of bins 1..n.
+    void DctPlan::DstI(const float* in, float* out) const
+    {
+        size_t m = real_.Size();
+        thread_local std::vector<float> ext;
+        thread_local std::vector<Complex> spec;
+        if (ext.size() < m) ext.resize(m);
+        if (spec.size() < m / 2 + 1) spec.resize(m / 2 + 1);
+
+        ext[0] = 0.0f;
+        ext[n_ + 1] = 0.0f;
+        for (size_t j = 0; j < n_; j++)
+        {
+            ext[j + 1] = in[j];
+            ext[m - 1 - j] = -in[j];
+        }
+        real_.Forward(ext.data(), spec.data());
+        for (size_t k = 0; k < n_; k++)
+            out[k] = -spec[k + 1].imag();
+    }
+
+    // Makhoul: v = (x[0], x[2], ..., x[3], x[1]); y[k] = 2 Re(exp(-i*pi*k/(2n)) V[k]).
+    void DctPlan::DctII(const float* in, float* out) const
+    {
+        thread_local std::vector<float> v;
+        thread_local std::vector<Complex> spec;
+        if (v.size() < n_) v.resize(n_);
+        if (spec.size() < n_ / 2 + 1) spec.resize(n_ / 2 + 1);
+
+        for (size_t j = 0; 2 * j < n_; j++)
+            v[j] = in[2 * j];
+        for (size_t j = 0; 2 * j + 1 < n_; j++)
+            v[n_ - 1 - j] = in[2 * j + 1];
+        real_.Forward(v.data(), spec.data());
+
+        for (size_t k = 0; k <= n_ / 2; k++)
+            out[k] = 2.0f * Mul(post_[k], spec[k]).real();
+        for (size_t k = n_ / 2 + 1; k < n_; k++)
+            out[k] = 2.0f * Mul(post_[k], std::conj(spec[n_ - k])).real();
+    }
+
+    // Inverse of the Makhoul reordering: V[k] = exp(i*pi*k/(2n)) (x[k] - i x[n-k]).
+    void DctPlan::DctIII(const float* in, float* out) const
+    {
+        thread_local std::vector<float> v;
+        thread_local std::vector<Complex> spec;
+        if (v.size() < n_) v.resize(n_);
+        if (spec.size() < n_ / 2 + 1) spec.resize(n_ / 2 + 1);
+
+        spec[0] = Complex(in[0], 0.0f);
+        for (size_t k = 1; k <= n_ / 2; k++)
+            spec[k] = Mul(std::conj(post_[k]), Complex(in[k], -in[n_ - k]));
+        real_.Inverse(spec.data(), v.data());
+
+        for (size_t j = 0; 2 * j < n_; j++)
+            out[2 * j] = v[j];
+        for (size_t j = 0; 2 * j + 1 < n_; j++)
+            out[2 * j + 1] = v[n_ - 1 - j];
+    }
+
+    void DctPlan::DctIV(const float* in, float* out) const
+    {
+        thread_local std::vector<Complex> z;
+        size_t m = complex_.Size();
+        if (z.size() < m) z.resize(m);
+
+        if (n_ % 2 != 0)
+        {
+            // Zero-padded DFT of length 2n with half-sample pre/post twiddles.
+            for (size_t j = 0; j < n_; j++)
+                z[j] = in[j] * pre_[j];
+            for (size_t j = n_; j < m; j++)
+                z[j] = Complex(0.0f, 0.0f);
+            complex_.Forward(z.data());
+            for (size_t k = 0; k < n_; k++)
+                out[k] = Mul(post_[k], z[k]).real();
+            return;
+        }
+
+        // Pair x[2j] with x[n-1-2j] as one complex sample, run an n/2 FFT and
+        // read y[2k] / y[n-1-2k] from the real / negated imaginary parts.
+        size_t h = n_ / 2;
+        for (size_t j = 0; j < h; j++)
+            z[j] = Mul(Complex(in[2 * j], in[n_ - 1 - 2 * j]), pre_[j]);
+        complex_.Forward(z.data());
+        for (size_t k = 0; k < h; k++)
+        {
+            Complex c = Mul(post_[k], z[k]);
+            out[2 * k] = c.real();
+            out[n_ - 1 - 2 * k] = -c.imag();
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    // MdctPlan
+    //-------------------------------------------------------------------------
+
+    MdctPlan::MdctPlan(size_t n)
+        : n_(n), dct4_(DctType::DctIV, n)
+    {
+        assert(n >= 2 && n % 2 == 0);
+    }
+
+    // With the input split in quarters (a, b, c, d), the MDCT is the DCT-IV of
+    // (-c_r - d, a - b_r). The DCT-IV factor 2 is cancelled while folding.
+    void MdctPlan::Forward(const float* in, float* out) const
+    {
+        thread_local std::vector<float> u;
+        if (u.size() < n_)
+            u.resize(n_);
+
+        size_t q = n_ / 2;
+        for (size_t j = 0; j < q; j++)
+            u[j] = -0.5f * (in[3 * q - 1 - j] + in[3 * q + j]);
+        for (size_t j = 0; j < q; j++)
+            u[q + j] = 0.5f * (in[j] - in[n_ - 1 - j]);
+        dct4_.Execute(u.data(), out);
+    }
+
+    // Unfolds u = DCT-IV(X) = (u1, u2) into (u2, -u2_r, -u1_r, -u1).
+    void MdctPlan::Inverse(const float* in, float* out) const
+    {
+        thread_local std::vector<float> u;
+        if (u.size() < n_)
+            u.resize(n_);
+
+        dct4_.Execute(in, u.data());
+        size_t q = n_ / 2;
+        for (size_t j = 0; j < q; j++)
+            out[j] = 0.5f * u[q + j];
+        for (size_t j = q; j < 3 * q; j++)
+            out[j] = -0.5f * u[3 * q - 1 - j];
+        for (size_t j = 3 * q; j < 2 * n_; j++)
+            out[j] = -0.5f * u[j - 3 * q];
+    }
+
+    void MdctPlan::SineWindow(float* window, size_t n)
+    {
+        for (size_t j = 0; j < 2 * n; j++)
+            window[j] = (float)std::sin(std::numbers::pi * ((double)j + 0.5) / (2.0 * (double)n));
+    }
+
+    //-------------------------------------------------------------------------
+    // Dct2dPlan
+    //-------------------------------------------------------------------------
+
+    Dct2dPlan::Dct2dPlan(DctType type, size_t rows, size_t cols)
+        : rows_(rows), cols_(cols), row_plan_(type, cols), col_plan_(type, rows)
+    {
+    }
+
+    void Dct2dPlan::Execute(const float* in, float* out) const
+    {
+        for (size_t r = 0; r < rows_; r++)
+            row_plan_.Execute(in + r * cols_, out + r * cols_);
+
+        thread_local std::vector<float> column;
+        if (column.size() < rows_)
+            column.resize(rows_);
+        for (size_t c = 0; c < cols_; c++)
+        {
+            for (size_t r = 0; r < rows_; r++)
+                column[r] = out[r * cols_ + c];
+            col_plan_.Execute(column.data(), column.data());
+            for (size_t r = 0; r < rows_; r++)
+                out[r * cols_ + c] = column[r];
+        }
+    }
+}
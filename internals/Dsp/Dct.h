@@ -0,0 +1,103 @@
+// Discrete cosine/sine transforms and the MDCT, computed through the FFT plans.
+//
+// Definitions follow FFTW's REDFT/RODFT conventions (unnormalized, with the
+// factor 2 on the sums), so the inverses are:
+//   DCT-I   <-> DCT-I  / (2 * (n - 1))      DST-I   <-> DST-I  / (2 * (n + 1))
+//   DCT-II  <-> DCT-III / (2 * n)           DST-II  <-> DST-III / (2 * n)
+//   DCT-IV  <-> DCT-IV / (2 * n)            DST-IV  <-> DST-IV / (2 * n)
+
+#pragma once
+
+#include "Dsp/Fft.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace Dsp
+{
+    enum class DctType
+    {
+        DctI,       // y[k] = x[0] + (-1)^k x[n-1] + 2 sum_{j=1}^{n-2} x[j] cos(pi j k / (n-1))
+        DctII,      // y[k] = 2 sum x[j] cos(pi (j+1/2) k / n)
+        DctIII,     // y[k] = x[0] + 2 sum_{j>=1} x[j] cos(pi j (k+1/2) / n)
+        DctIV,      // y[k] = 2 sum x[j] cos(pi (j+1/2) (k+1/2) / n)
+        DstI,       // y[k] = 2 sum x[j] sin(pi (j+1) (k+1) / (n+1))
+        DstII,      // y[k] = 2 sum x[j] sin(pi (j+1/2) (k+1) / n)
+        DstIII,     // y[k] = (-1)^k x[n-1] + 2 sum_{j<n-1} x[j] sin(pi (j+1) (k+1/2) / n)
+        DstIV,      // y[k] = 2 sum x[j] sin(pi (j+1/2) (k+1/2) / n)
+    };
+
+    // One-dimensional DCT/DST of a fixed type and size, O(n log n).
+    // Types II/III use Makhoul's reordering on a real FFT of size n, type IV
+    // uses a complex FFT of n/2 (n even) or 2n (n odd), and type I uses a real
+    // FFT of the symmetric extension. Execute() may run in place (in == out).
+    class DctPlan
+    {
+    public:
+        DctPlan(DctType type, size_t n);
+
+        DctType Type() const { return type_; }
+        size_t Size() const { return n_; }
+
+        void Execute(const float* in, float* out) const;
+
+    private:
+        void DctI(const float* in, float* out) const;
+        void DstI(const float* in, float* out) const;
+        void DctII(const float* in, float* out) const;
+        void DctIII(const float* in, float* out) const;
+        void DctIV(const float* in, float* out) const;
+
+        DctType type_;
+        size_t n_ = 0;
+        RealFftPlan real_;                  // Types I, II and III
+        FftPlan complex_;                   // Type IV
+        std::vector<Complex> pre_;          // Pre-twiddles
+        std::vector<Complex> post_;         // Post-twiddles
+    };
+
+    // Modified DCT with 50% overlap: Forward maps 2n windowed samples to n
+    // coefficients, Inverse maps n coefficients back to 2n aliased samples.
+    //   X[k] = sum_{j<2n} x[j] cos(pi/n (j + 1/2 + n/2) (k + 1/2))
+    //   y[j] = sum_{k<n}  X[k] cos(pi/n (j + 1/2 + n/2) (k + 1/2))
+    // With a Princen-Bradley window applied on both sides, overlap-adding
+    // consecutive Inverse outputs reconstructs the input scaled by n/2.
+    // Both directions fold onto a DCT-IV of size n (n must be even).
+    class MdctPlan
+    {
+    public:
+        explicit MdctPlan(size_t n);
+
+        size_t Size() const { return n_; }
+
+        void Forward(const float* in, float* out) const;
+        void Inverse(const float* in, float* out) const;
+
+        // Sine window of length 2n, satisfying the Princen-Bradley condition.
+        static void SineWindow(float* window, size_t n);
+
+    private:
+        size_t n_ = 0;
+        DctPlan dct4_;
+    };
+
+    // Separable 2D DCT/DST over a row-major rows x cols block, e.g. the 8x8
+    // blocks of JPEG-style compression demos. Rows are transformed first, then
+    // columns. Execute() may run in place.
+    class Dct2dPlan
+    {
+    public:
+        Dct2dPlan(DctType type, size_t rows, size_t cols);
+
+        size_t Rows() const { return rows_; }
+        size_t Cols() const { return cols_; }
+
+        void Execute(const float* in, float* out) const;
+
+    private:
+        size_t rows_ = 0;
+        size_t cols_ = 0;
+        DctPlan row_plan_;
+        DctPlan col_plan_;
+    };
+}
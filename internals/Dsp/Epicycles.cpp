@@ -0,0 +1,39 @@
+#include "Dsp/Epicycles.h"
+
+#include <cmath>
+#include <vector>
+
+namespace Dsp
+{
+    // Per-circle displacement vectors into thread-local scratch.
+    static void Terms(const Epicycle* circles, size_t count, double time, std::vector<float>& dx, std::vector<float>& dy)
+    {
+        if (dx.size() < count)
+        {
+            dx.resize(count);
+            dy.resize(count);
+        }
+        for (size_t i = 0; i < count; i++)
+        {
+            double angle = (double)circles[i].harmonic * time + (double)circles[i].phase;
+            float reduced = (float)ReduceAngle(angle);
+            dx[i] = circles[i].radius * std::cos(reduced);
+            dy[i] = circles[i].radius * std::sin(reduced);
+        }
+    }
+
+    void EvaluateEpicycles(const Epicycle* circles, size_t count, double time, float* x, float* y, Summation mode)
+    {
+        thread_local std::vector<float> dx, dy;
+        Terms(circles, count, time, dx, dy);
+        PrefixSum(dx.data(), count, x, mode);
+        PrefixSum(dy.data(), count, y, mode);
+    }
+
+    Complex EpicycleTip(const Epicycle* circles, size_t count, double time, Summation mode)
+    {
+        thread_local std::vector<float> dx, dy;
+        Terms(circles, count, time, dx, dy);
+        return Complex(Sum(dx.data(), count, mode), Sum(dy.data(), count, mode));
+    }
+}
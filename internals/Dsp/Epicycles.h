@@ -0,0 +1,42 @@
+// Floating-point epicycle chains: sums of rotating vectors
+// radius * exp(i (harmonic * time + phase)).
+//
+// Angles are reduced to one turn in double before the float sine and cosine,
+// so terms stay accurate to a rounding at any time and harmonic; the joints
+// are then accumulated with the chosen summation (see Summation.h).
+
+#pragma once
+
+#include "Dsp/Fft.h"
+#include "Dsp/Summation.h"
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+
+namespace Dsp
+{
+    inline constexpr double two_pi = 2.0 * std::numbers::pi;
+
+    // `angle` less the nearest whole number of turns, in [-pi, pi].
+    inline double ReduceAngle(double angle)
+    {
+        return angle - two_pi * std::nearbyint(angle / two_pi);
+    }
+
+    struct Epicycle
+    {
+        float radius = 0.0f;
+        int32_t harmonic = 1;   // Angular velocity in radians per time unit
+        float phase = 0.0f;     // Radians at time 0
+    };
+
+    // Writes the cumulative joint positions: (x[i], y[i]) is the end of
+    // circle i relative to the centre of the first.
+    void EvaluateEpicycles(const Epicycle* circles, size_t count, double time, float* x, float* y,
+                           Summation mode = Summation::Naive);
+
+    // End of the chain only.
+    Complex EpicycleTip(const Epicycle* circles, size_t count, double time, Summation mode = Summation::Naive);
+}
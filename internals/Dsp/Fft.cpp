@@ -0,0 +1,385 @@
+#include "Dsp/Fft.h"
+
+#include "Dsp/FftCodelets.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numbers>
+#include <utility>
+
+namespace Dsp
+{
+    bool IsPowerOfTwo(size_t n)
+    {
+        return n != 0 && (n & (n - 1)) == 0;
+    }
+
+    size_t NextPowerOfTwo(size_t n)
+    {
+        size_t p = 1;
+        while (p < n)
+            p <<= 1;
+        return p;
+    }
+
+    // Twiddles are evaluated in double so that large plans keep float accuracy.
+    static Complex Twiddle(double num, double den)
+    {
+        double a = -2.0 * std::numbers::pi * num / den;
+        return Complex((float)std::cos(a), (float)std::sin(a));
+    }
+
+    //-------------------------------------------------------------------------
+    // FftPlan
+    //-------------------------------------------------------------------------
+
+    // Block size of the unrolled leaves of the radix-2 path.
+    static const size_t leaf_size = 16;
+
+    // Runs the codelet of size `leaf` on every leaf-sized block of bit-reversed data.
+    template<bool Inverse>
+    static void Leaves(Complex* data, size_t n, size_t leaf)
+    {
+        auto run = [&]<size_t N>()
+        {
+            for (size_t base = 0; base < n; base += N)
+                Codelets::Butterflies<N, Inverse>(data + base);
+        };
+        switch (leaf)
+        {
+            case 2: run.template operator()<2>(); break;
+            case 4: run.template operator()<4>(); break;
+            case 8: run.template operator()<8>(); break;
+            case 16: run.template operator()<16>(); break;
+            case 32: run.template operator()<32>(); break;
+            case 64: run.template operator()<64>(); break;
+            default: assert(false); break;
+        }
+    }
+
+    // Whole power-of-two transforms up to 64 points.
+    template<bool Inverse>
+    static void Small(Complex* data, size_t n)
+    {
+        switch (n)
+        {
+            case 2: Codelets::Fft<2, Inverse>(data); break;
+            case 4: Codelets::Fft<4, Inverse>(data); break;
+            case 8: Codelets::Fft<8, Inverse>(data); break;
+            case 16: Codelets::Fft<16, Inverse>(data); break;
+            case 32: Codelets::Fft<32, Inverse>(data); break;
+            case 64: Codelets::Fft<64, Inverse>(data); break;
+            default: assert(false); break;
+        }
+    }
+
+    // Size-p DFTs of the mixed-radix path: p values strided by `stride`, `count` times.
+    template<bool Inverse>
+    static void PrimeDfts(size_t p, Complex* data, size_t stride, size_t count)
+    {
+        auto run = [&]<size_t P>()
+        {
+            for (size_t k = 0; k < count; k++)
+                Codelets::PrimeDft<P, Inverse>(data + k, data + k, stride);
+        };
+        switch (p)
+        {
+            case 3: run.template operator()<3>(); break;
+            case 5: run.template operator()<5>(); break;
+            case 7: run.template operator()<7>(); break;
+            case 11: run.template operator()<11>(); break;
+            case 13: run.template operator()<13>(); break;
+            default: assert(false); break;
+        }
+    }
+
+    FftPlan::FftPlan(size_t n, bool codelets)
+        : n_(n), pow2_(IsPowerOfTwo(n)), codelets_(codelets)
+    {
+        assert(n >= 1);
+        if (pow2_)
+        {
+            unsigned bits = 0;
+            while (((size_t)1 << bits) < n)
+                bits++;
+            for (size_t i = 0; i < n; i++)
+            {
+                size_t j = 0;
+                for (unsigned b = 0; b < bits; b++)
+                    j |= ((i >> b) & 1) << (bits - 1 - b);
+                if (i < j)
+                {
+                    bitrev_.push_back((unsigned)i);
+                    bitrev_.push_back((unsigned)j);
+                }
+            }
+
+            twiddles_.resize(n);
+            itwiddles_.resize(n);
+            for (size_t h = 1; h < n; h <<= 1)
+                for (size_t j = 0; j < h; j++)
+                {
+                    twiddles_[h + j] = Twiddle((double)j, (double)(2 * h));
+                    itwiddles_[h + j] = std::conj(twiddles_[h + j]);
+                }
+            return;
+        }
+
+        if (codelets_)
+        {
+            for (size_t p : { 3, 5, 7, 11, 13 })
+            {
+                if (n % p == 0 && IsPowerOfTwo(n / p))
+                {
+                    size_t m = n / p;
+                    prime_ = p;
+                    inner_ = std::make_unique<FftPlan>(m);
+                    mixed_twiddles_.resize(n);
+                    for (size_t r = 0; r < p; r++)
+                        for (size_t k = 0; k < m; k++)
+                            mixed_twiddles_[r * m + k] = Twiddle((double)((r * k) % n), (double)n);
+                    return;
+                }
+            }
+        }
+
+        // Bluestein: x[k] * w[k] convolved with conj(w), where w[k] = exp(-i*pi*k^2/n).
+        // k^2 is reduced modulo 2n in integers to keep the chirp phase exact.
+        size_t m = NextPowerOfTwo(2 * n - 1);
+        inner_ = std::make_unique<FftPlan>(m, codelets_);
+        chirp_.resize(n);
+        for (size_t k = 0; k < n; k++)
+        {
+            unsigned long long k2 = ((unsigned long long)k * k) % (2ull * n);
+            chirp_[k] = Twiddle((double)k2, (double)(2 * n));
+        }
+        chirp_fft_.assign(m, Complex(0.0f, 0.0f));
+        float inv_m = 1.0f / (float)m;
+        chirp_fft_[0] = std::conj(chirp_[0]) * inv_m;
+        for (size_t k = 1; k < n; k++)
+        {
+            chirp_fft_[k] = std::conj(chirp_[k]) * inv_m;
+            chirp_fft_[m - k] = chirp_fft_[k];
+        }
+        inner_->Forward(chirp_fft_.data());
+    }
+
+    FftPlan::~FftPlan() = default;
+    FftPlan::FftPlan(FftPlan&&) noexcept = default;
+    FftPlan& FftPlan::operator=(FftPlan&&) noexcept = default;
+
+    void FftPlan::Transform(Complex* data, FftDirection dir) const
+    {
+        if (n_ <= 1)
+            return;
+        if (pow2_)
+            Radix2(data, dir);
+        else if (prime_ != 0)
+            MixedRadix(data, dir);
+        else
+            Bluestein(data, dir);
+    }
+
+    void FftPlan::Radix2(Complex* data, FftDirection dir) const
+    {
+        if (codelets_ && n_ <= 64)
+        {
+            if (dir == FftDirection::Forward)
+                Small<false>(data, n_);
+            else
+                Small<true>(data, n_);
+            return;
+        }
+
+        for (size_t i = 0; i < bitrev_.size(); i += 2)
+            std::swap(data[bitrev_[i]], data[bitrev_[i + 1]]);
+
+        const Complex* tw = (dir == FftDirection::Forward) ? twiddles_.data() : itwiddles_.data();
+        size_t h = 1;
+        if (codelets_)
+        {
+            h = std::min(n_, leaf_size);
+            if (dir == FftDirection::Forward)
+                Leaves<false>(data, n_, h);
+            else
+                Leaves<true>(data, n_, h);
+        }
+        for (; h < n_; h <<= 1)
+        {
+            const Complex* w = tw + h;
+            for (size_t base = 0; base < n_; base += 2 * h)
+            {
+                Complex* a = data + base;
+                Complex* b = a + h;
+                for (size_t j = 0; j < h; j++)
+                {
+                    Complex t = Mul(b[j], w[j]);
+                    b[j] = a[j] - t;
+                    a[j] = a[j] + t;
+                }
+            }
+        }
+    }
+
+    void FftPlan::MixedRadix(Complex* data, FftDirection dir) const
+    {
+        // n = p * m. With x_r[j] = x[j * p + r]:
+        //   X[k + m * q] = sum_r W_p^(r q) * (W_n^(r k) * X_r[k])
+        // i.e. p transforms of size m, a twiddle, then m transforms of size p.
+        thread_local std::vector<Complex> scratch;
+        const size_t p = prime_;
+        const size_t m = n_ / p;
+        if (scratch.size() < n_)
+            scratch.resize(n_);
+
+        bool inverse = (dir == FftDirection::Inverse);
+        for (size_t r = 0; r < p; r++)
+        {
+            Complex* sub = scratch.data() + r * m;
+            for (size_t j = 0; j < m; j++)
+                sub[j] = data[j * p + r];
+            inner_->Transform(sub, dir);
+            const Complex* w = mixed_twiddles_.data() + r * m;
+            if (r > 0)
+            {
+                for (size_t k = 0; k < m; k++)
+                    sub[k] = Mul(sub[k], inverse ? std::conj(w[k]) : w[k]);
+            }
+        }
+
+        // Column k of the p x m scratch holds the inputs of output column k.
+        if (inverse)
+            PrimeDfts<true>(p, scratch.data(), m, m);
+        else
+            PrimeDfts<false>(p, scratch.data(), m, m);
+        std::copy(scratch.data(), scratch.data() + n_, data);
+    }
+
+    void FftPlan::Bluestein(Complex* data, FftDirection dir) const
+    {
+        // The scratch buffer only grows, so steady-state calls do not allocate.
+        thread_local std::vector<Complex> scratch;
+        size_t m = inner_->Size();
+        if (scratch.size() < m)
+            scratch.resize(m);
+
+        bool inverse = (dir == FftDirection::Inverse);
+        for (size_t k = 0; k < n_; k++)
+        {
+            Complex x = inverse ? std::conj(data[k]) : data[k];
+            scratch[k] = Mul(x, chirp_[k]);
+        }
+        for (size_t k = n_; k < m; k++)
+            scratch[k] = Complex(0.0f, 0.0f);
+
+        inner_->Forward(scratch.data());
+        for (size_t k = 0; k < m; k++)
+            scratch[k] = Mul(scratch[k], chirp_fft_[k]);
+        inner_->Inverse(scratch.data());
+
+        for (size_t k = 0; k < n_; k++)
+        {
+            Complex y = Mul(scratch[k], chirp_[k]);
+            data[k] = inverse ? std::conj(y) : y;
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    // RealFftPlan
+    //-------------------------------------------------------------------------
+
+    RealFftPlan::RealFftPlan(size_t n)
+        : n_(n), plan_((n % 2 == 0) ? n / 2 : n)
+    {
+        assert(n >= 1);
+        if (n % 2 == 0)
+        {
+            twiddles_.resize(n / 4 + 1);
+            for (size_t k = 0; k < twiddles_.size(); k++)
+                twiddles_[k] = Twiddle((double)k, (double)n);
+        }
+    }
+
+    void RealFftPlan::Forward(const float* in, Complex* out) const
+    {
+        if (n_ % 2 != 0)
+        {
+            thread_local std::vector<Complex> scratch;
+            if (scratch.size() < n_)
+                scratch.resize(n_);
+            for (size_t k = 0; k < n_; k++)
+                scratch[k] = Complex(in[k], 0.0f);
+            plan_.Forward(scratch.data());
+            for (size_t k = 0; k <= n_ / 2; k++)
+                out[k] = scratch[k];
+            return;
+        }
+
+        // Pack even/odd samples as one complex signal of length h, then split
+        // the spectrum: X[k] = E[k] + exp(-2*pi*i*k/n) * O[k].
+        size_t h = n_ / 2;
+        for (size_t k = 0; k < h; k++)
+            out[k] = Complex(in[2 * k], in[2 * k + 1]);
+        plan_.Forward(out);
+
+        Complex z0 = out[0];
+        out[0] = Complex(z0.real() + z0.imag(), 0.0f);
+        out[h] = Complex(z0.real() - z0.imag(), 0.0f);
+        for (size_t k = 1; k <= h / 2; k++)
+        {
+            Complex a = out[k];
+            Complex b = std::conj(out[h - k]);
+            Complex e = 0.5f * (a + b);
+            Complex d = a - b;
+            Complex o = Complex(0.5f * d.imag(), -0.5f * d.real());
+            Complex w = twiddles_[k];
+            // exp(-2*pi*i*(h-k)/n) == -conj(w)
+            Complex wr = -std::conj(w);
+            out[k] = e + Mul(w, o);
+            out[h - k] = std::conj(e) + Mul(wr, std::conj(o));
+        }
+    }
+
+    void RealFftPlan::Inverse(const Complex* in, float* out) const
+    {
+        if (n_ % 2 != 0)
+        {
+            thread_local std::vector<Complex> scratch;
+            if (scratch.size() < n_)
+                scratch.resize(n_);
+            scratch[0] = in[0];
+            for (size_t k = 1; k <= n_ / 2; k++)
+            {
+                scratch[k] = in[k];
+                scratch[n_ - k] = std::conj(in[k]);
+            }
+            plan_.Inverse(scratch.data());
+            for (size_t k = 0; k < n_; k++)
+                out[k] = scratch[k].real();
+            return;
+        }
+
+        // Rebuild Z[k] = E[k] + i*O[k] (scaled by 2 so the result is n * x),
+        // inverse-transform it in the output buffer and unpack the pairs.
+        size_t h = n_ / 2;
+        Complex* z = reinterpret_cast<Complex*>(out);
+        Complex z0 = in[0];
+        Complex zh = in[h];
+        for (size_t k = 1; k <= h / 2; k++)
+        {
+            Complex a = in[k];
+            Complex b = std::conj(in[h - k]);
+            Complex w = std::conj(twiddles_[k]);
+            Complex wr = -std::conj(w);
+            Complex e = a + b;
+            Complex o = Mul(a - b, w);
+            Complex e2 = std::conj(e);
+            Complex o2 = -Mul(std::conj(a - b), wr);
+            z[k] = e + Complex(-o.imag(), o.real());
+            z[h - k] = e2 + Complex(-o2.imag(), o2.real());
+        }
+        z[0] = Complex(z0.real() + zh.real(), z0.real() - zh.real());
+        plan_.Inverse(z);
+    }
+}
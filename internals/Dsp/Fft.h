@@ -0,0 +1,98 @@
+// Fast Fourier transform plans shared by every spectral module.
+//
+// Plans are built once per size and are immutable afterwards: executing a plan
+// is const, so a single plan can be shared between threads. Transforms are
+// unnormalized, i.e. Inverse(Forward(x)) == n * x.
+
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace Dsp
+{
+    using Complex = std::complex<float>;
+
+    enum class FftDirection
+    {
+        Forward,    // X[k] = sum x[j] * exp(-2*pi*i*j*k/n)
+        Inverse,    // x[j] = sum X[k] * exp(+2*pi*i*j*k/n)
+    };
+
+    // Complex FFT of any size >= 1.
+    // Power-of-two sizes run an in-place iterative radix-2 transform whose
+    // first stages are unrolled codelets (see FftCodelets.h). Sizes p * 2^k
+    // with p in {3, 5, 7, 11, 13} split into p power-of-two transforms and
+    // 2^k prime codelets. Other sizes are mapped onto a power-of-two plan with
+    // Bluestein's chirp-z algorithm, so every size stays O(n log n).
+    class FftPlan
+    {
+    public:
+        // codelets = false keeps only the generic radix-2 and Bluestein paths
+        // (the reference the codelets are benchmarked against).
+        explicit FftPlan(size_t n, bool codelets = true);
+        ~FftPlan();
+        FftPlan(FftPlan&&) noexcept;
+        FftPlan& operator=(FftPlan&&) noexcept;
+
+        size_t Size() const { return n_; }
+
+        void Forward(Complex* data) const { Transform(data, FftDirection::Forward); }
+        void Inverse(Complex* data) const { Transform(data, FftDirection::Inverse); }
+        void Transform(Complex* data, FftDirection dir) const;
+
+    private:
+        void Radix2(Complex* data, FftDirection dir) const;
+        void MixedRadix(Complex* data, FftDirection dir) const;
+        void Bluestein(Complex* data, FftDirection dir) const;
+
+        size_t n_ = 0;
+        bool pow2_ = false;
+        bool codelets_ = true;
+        std::vector<unsigned> bitrev_;      // Swap pairs (i < j) for the input permutation
+        std::vector<Complex> twiddles_;     // Stage with half-size h uses [h, 2h)
+        std::vector<Complex> itwiddles_;    // Conjugated twiddles for the inverse
+
+        // Mixed-radix state (n = prime * 2^k)
+        size_t prime_ = 0;
+        std::vector<Complex> mixed_twiddles_;   // exp(-2*pi*i*r*k/n) at [r * (n / prime) + k]
+
+        // Bluestein state (other sizes)
+        std::unique_ptr<FftPlan> inner_;    // Power-of-two plan: >= 2n - 1 for Bluestein, n / prime for mixed radix
+        std::vector<Complex> chirp_;        // exp(-i*pi*k^2/n), k < n
+        std::vector<Complex> chirp_fft_;    // FFT of the zero-padded conjugate chirp, scaled by 1/m
+    };
+
+    // FFT of real input. Forward produces the n/2 + 1 non-redundant bins,
+    // Inverse consumes them and writes n real samples.
+    // Even sizes run a complex FFT of n/2 on packed sample pairs.
+    class RealFftPlan
+    {
+    public:
+        explicit RealFftPlan(size_t n);
+
+        size_t Size() const { return n_; }
+        size_t SpectrumSize() const { return n_ / 2 + 1; }
+
+        void Forward(const float* in, Complex* out) const;
+        void Inverse(const Complex* in, float* out) const;
+
+    private:
+        size_t n_ = 0;
+        FftPlan plan_;                      // n/2 for even sizes, n otherwise
+        std::vector<Complex> twiddles_;     // exp(-2*pi*i*k/n), k <= n/4
+    };
+
+    // Helpers
+    bool IsPowerOfTwo(size_t n);
+    size_t NextPowerOfTwo(size_t n);
+
+    // Plain complex product. std::complex's operator* goes through the C99
+    // inf/nan recovery path (__mulsc3), which defeats vectorization in hot loops.
+    inline Complex Mul(Complex a, Complex b)
+    {
+        return Complex(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+    }
+}
@@ -0,0 +1,180 @@
+// Fully unrolled small-size FFT kernels ("codelets") generated from templates.
+//
+// Twiddles are compile-time constants, so every butterfly is straight-line
+// code and trivial twiddles (1, -i, +i) cost no multiplies. They are the
+// leaves of FftPlan: power-of-two codelets run the first stages of the
+// radix-2 transform on contiguous blocks, prime codelets are the small
+// transforms of the mixed-radix p * 2^k path.
+
+#pragma once
+
+#include "Dsp/Fft.h"
+
+#include <array>
+#include <cstddef>
+#include <numbers>
+#include <utility>
+
+namespace Dsp::Codelets
+{
+    // constexpr sin/cos (std:: versions are not constexpr everywhere).
+    constexpr double Sin(double x)
+    {
+        const double two_pi = 2.0 * std::numbers::pi;
+        while (x > std::numbers::pi)
+            x -= two_pi;
+        while (x < -std::numbers::pi)
+            x += two_pi;
+        double term = x, sum = x;
+        for (int k = 1; k < 40; k++)
+        {
+            term *= -x * x / (double)((2 * k) * (2 * k + 1));
+            sum += term;
+        }
+        return sum;
+    }
+
+    constexpr double Cos(double x)
+    {
+        return Sin(x + 0.5 * std::numbers::pi);
+    }
+
+    // exp(-2 pi i k / N) for k < N (conjugated for the inverse), as split
+    // real/imaginary tables.
+    template<size_t N, bool Inverse>
+    struct Roots
+    {
+        static constexpr std::array<float, N> re = []
+        {
+            std::array<float, N> r{};
+            for (size_t k = 0; k < N; k++)
+                r[k] = (float)Cos(2.0 * std::numbers::pi * (double)k / (double)N);
+            return r;
+        }();
+        static constexpr std::array<float, N> im = []
+        {
+            std::array<float, N> r{};
+            for (size_t k = 0; k < N; k++)
+                r[k] = (float)((Inverse ? 1.0 : -1.0) * Sin(2.0 * std::numbers::pi * (double)k / (double)N));
+            return r;
+        }();
+    };
+
+    // b * exp(-2 pi i J / N) with the trivial roots special-cased.
+    template<size_t N, size_t J, bool Inverse>
+    inline Complex Rotate(Complex b)
+    {
+        if constexpr (J == 0)
+            return b;
+        else if constexpr (4 * J == N)
+            return Inverse ? Complex(-b.imag(), b.real()) : Complex(b.imag(), -b.real());
+        else
+            return Mul(b, Complex(Roots<N, Inverse>::re[J], Roots<N, Inverse>::im[J]));
+    }
+
+    // Radix-2 decimation-in-time butterflies of size N on bit-reversed
+    // input, leaving the DFT in natural order (the first log2(N) stages of
+    // the iterative transform).
+    template<size_t N, bool Inverse>
+    inline void Butterflies(Complex* d)
+    {
+        if constexpr (N == 2)
+        {
+            Complex a = d[0], b = d[1];
+            d[0] = a + b;
+            d[1] = a - b;
+        }
+        else if constexpr (N > 2)
+        {
+            Butterflies<N / 2, Inverse>(d);
+            Butterflies<N / 2, Inverse>(d + N / 2);
+            [d]<size_t... J>(std::index_sequence<J...>)
+            {
+                ((
+                    [d]
+                    {
+                        Complex a = d[J];
+                        Complex t = Rotate<N, J, Inverse>(d[J + N / 2]);
+                        d[J] = a + t;
+                        d[J + N / 2] = a - t;
+                    }()
+                ), ...);
+            }(std::make_index_sequence<N / 2>{});
+        }
+    }
+
+    // Bit-reversal permutation of N points.
+    template<size_t N>
+    struct BitReverse
+    {
+        static constexpr std::array<size_t, N> index = []
+        {
+            std::array<size_t, N> r{};
+            size_t bits = 0;
+            while (((size_t)1 << bits) < N)
+                bits++;
+            for (size_t i = 0; i < N; i++)
+                for (size_t b = 0; b < bits; b++)
+                    r[i] |= ((i >> b) & 1) << (bits - 1 - b);
+            return r;
+        }();
+    };
+
+    // Complete power-of-two transform in natural order: the bit-reversal
+    // permutation is a compile-time swap list, followed by the butterflies.
+    template<size_t N, bool Inverse>
+    inline void Fft(Complex* d)
+    {
+        [d]<size_t... I>(std::index_sequence<I...>)
+        {
+            ((I < BitReverse<N>::index[I] ? std::swap(d[I], d[BitReverse<N>::index[I]]) : void()), ...);
+        }(std::make_index_sequence<N>{});
+        Butterflies<N, Inverse>(d);
+    }
+
+    // Direct DFT of odd prime size P over x[0], x[stride], ..., written to
+    // y[0], y[stride], ... (x == y allowed). Conjugate-symmetric pairs share
+    // their cosine and sine products, so the cost is about P^2 / 2 real
+    // multiply-adds per component.
+    template<size_t P, bool Inverse>
+    inline void PrimeDft(const Complex* x, Complex* y, size_t stride)
+    {
+        constexpr size_t half = P / 2;
+        using R = Roots<P, Inverse>;
+        Complex in[P];
+        for (size_t j = 0; j < P; j++)
+            in[j] = x[j * stride];
+
+        Complex sum[half];
+        Complex diff[half];
+        Complex dc = in[0];
+        for (size_t j = 1; j <= half; j++)
+        {
+            sum[j - 1] = in[j] + in[P - j];
+            diff[j - 1] = in[j] - in[P - j];
+            dc += sum[j - 1];
+        }
+        y[0] = dc;
+        [&]<size_t... K>(std::index_sequence<K...>)
+        {
+            ((
+                [&]
+                {
+                    constexpr size_t k = K + 1;
+                    float re_r = in[0].real(), re_i = in[0].imag();
+                    float im_r = 0.0f, im_i = 0.0f;
+                    [&]<size_t... J>(std::index_sequence<J...>)
+                    {
+                        ((re_r += R::re[(k * (J + 1)) % P] * sum[J].real(),
+                          re_i += R::re[(k * (J + 1)) % P] * sum[J].imag(),
+                          im_r += R::im[(k * (J + 1)) % P] * diff[J].real(),
+                          im_i += R::im[(k * (J + 1)) % P] * diff[J].imag()), ...);
+                    }(std::make_index_sequence<half>{});
+                    // y[k] = A + i B and y[P - k] = A - i B, where B carries the sine terms.
+                    y[k * stride] = Complex(re_r - im_i, re_i + im_r);
+                    y[(P - k) * stride] = Complex(re_r + im_i, re_i - im_r);
+                }()
+            ), ...);
+        }(std::make_index_sequence<half>{});
+    }
+}
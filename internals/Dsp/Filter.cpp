@@ -0,0 +1,382 @@
+#include "Dsp/Filter.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numbers>
+
+namespace Dsp
+{
+    using Cd = std::complex<double>;
+
+    //-------------------------------------------------------------------------
+    // Jacobi elliptic functions through descending Landen transformations
+    // (Orfanidis, "Lecture Notes on Elliptic Filter Design"). Arguments are
+    // normalized to the quarter period: cde(u, k) = cd(u * K(k), k).
+    //-------------------------------------------------------------------------
+
+    static std::vector<double> Landen(double k)
+    {
+        std::vector<double> v;
+        while (k > 1e-15 && v.size() < 16)
+        {
+            double kp = std::sqrt(1.0 - k * k);
+            k = (k / (1.0 + kp)) * (k / (1.0 + kp));
+            v.push_back(k);
+        }
+        return v;
+    }
+
+    static Cd Cde(Cd u, double k)
+    {
+        std::vector<double> v = Landen(k);
+        Cd w = std::cos(u * (std::numbers::pi / 2.0));
+        for (size_t n = v.size(); n-- > 0;)
+            w = (1.0 + v[n]) * w / (1.0 + v[n] * w * w);
+        return w;
+    }
+
+    static Cd Sne(Cd u, double k)
+    {
+        std::vector<double> v = Landen(k);
+        Cd w = std::sin(u * (std::numbers::pi / 2.0));
+        for (size_t n = v.size(); n-- > 0;)
+            w = (1.0 + v[n]) * w / (1.0 + v[n] * w * w);
+        return w;
+    }
+
+    // Inverse of Sne: returns u with sn(u * K, k) = w.
+    static Cd Asne(Cd w, double k)
+    {
+        std::vector<double> v = Landen(k);
+        double prev = k;
+        for (double kn : v)
+        {
+            w = w / (1.0 + std::sqrt(1.0 - w * w * (prev * prev))) * (2.0 / (1.0 + kn));
+            prev = kn;
+        }
+        return std::asin(w) * (2.0 / std::numbers::pi);
+    }
+
+    // Solves the degree equation for the selectivity k given the order and
+    // the discrimination k1 = ep / es.
+    static double EllipticDegree(int order, double k1)
+    {
+        double kp1 = std::sqrt(1.0 - k1 * k1);
+        double kp = std::pow(kp1, order);
+        for (int i = 1; i <= order / 2; i++)
+        {
+            double s = Sne(Cd((2.0 * i - 1.0) / order), kp1).real();
+            kp *= s * s * s * s;
+        }
+        return std::sqrt(1.0 - kp * kp);
+    }
+
+    //-------------------------------------------------------------------------
+    // Analog prototypes, passband edge at 1 rad/s. Only left half-plane poles
+    // with Im >= 0 are listed (conjugates are implied), likewise finite zeros.
+    //-------------------------------------------------------------------------
+
+    struct Prototype
+    {
+        std::vector<Cd> poles;
+        std::vector<Cd> zeros;
+    };
+
+    static Prototype AnalogPrototype(const FilterSpec& spec)
+    {
+        const double pi = std::numbers::pi;
+        const int n = spec.order;
+        Prototype proto;
+
+        if (spec.family == FilterFamily::Butterworth)
+        {
+            for (int i = 0; i < n / 2; i++)
+            {
+                double theta = pi * (2.0 * i + 1.0) / (2.0 * n);
+                proto.poles.push_back(Cd(-std::sin(theta), std::cos(theta)));
+            }
+            if (n % 2)
+                proto.poles.push_back(Cd(-1.0, 0.0));
+            return proto;
+        }
+
+        double ep = std::sqrt(std::pow(10.0, spec.passband_ripple_db / 10.0) - 1.0);
+        if (spec.family == FilterFamily::Chebyshev1)
+        {
+            double v0 = std::asinh(1.0 / ep) / n;
+            for (int i = 0; i < n / 2; i++)
+            {
+                double theta = pi * (2.0 * i + 1.0) / (2.0 * n);
+                proto.poles.push_back(Cd(-std::sinh(v0) * std::sin(theta), std::cosh(v0) * std::cos(theta)));
+            }
+            if (n % 2)
+                proto.poles.push_back(Cd(-std::sinh(v0), 0.0));
+            return proto;
+        }
+
+        // Elliptic
+        double es = std::sqrt(std::pow(10.0, spec.stopband_db / 10.0) - 1.0);
+        double k1 = ep / es;
+        double k = EllipticDegree(n, k1);
+        const Cd j(0.0, 1.0);
+        double v0 = (-j * Asne(j / ep, k1) / (double)n).real();
+        for (int i = 1; i <= n / 2; i++)
+        {
+            double u = (2.0 * i - 1.0) / n;
+            Cd zeta = Cde(Cd(u), k);
+            proto.zeros.push_back(j / (k * zeta));
+            Cd p = j * Cde(Cd(u, -v0), k);
+            proto.poles.push_back(p.imag() >= 0.0 ? p : std::conj(p));
+        }
+        if (n % 2)
+            proto.poles.push_back(Cd((j * Sne(j * v0, k)).real(), 0.0));
+        return proto;
+    }
+
+    //-------------------------------------------------------------------------
+    // Design
+    //-------------------------------------------------------------------------
+
+    static Cd Bilinear(Cd s)
+    {
+        return (1.0 + s) / (1.0 - s);
+    }
+
+    static Cd SectionResponse(const Biquad& q, Cd z1)
+    {
+        Cd z2 = z1 * z1;
+        return ((double)q.b0 + (double)q.b1 * z1 + (double)q.b2 * z2) / (1.0 + (double)q.a1 * z1 + (double)q.a2 * z2);
+    }
+
+    std::complex<double> CascadeResponse(const std::vector<Biquad>& sections, double freq)
+    {
+        Cd z1 = std::polar(1.0, -2.0 * std::numbers::pi * freq);
+        Cd h = 1.0;
+        for (const Biquad& q : sections)
+            h *= SectionResponse(q, z1);
+        return h;
+    }
+
+    std::vector<Biquad> DesignIir(const FilterSpec& spec)
+    {
+        assert(spec.order >= 1);
+        assert(spec.cutoff > 0.0 && spec.cutoff < 0.5);
+        bool highpass = (spec.response == FilterResponse::HighPass);
+        Prototype proto = AnalogPrototype(spec);
+
+        // Prewarped edge for the bilinear transform s = (z - 1) / (z + 1).
+        double wc = std::tan(std::numbers::pi * spec.cutoff);
+        auto map = [&](Cd s) { return Bilinear(highpass ? wc / s : wc * s); };
+        // Zeros at infinity land on Nyquist (low-pass) or DC (high-pass).
+        Cd zero_at_infinity = highpass ? Cd(1.0) : Cd(-1.0);
+        Cd ref = highpass ? Cd(-1.0) : Cd(1.0);       // z^-1 where the passband gain is set
+
+        std::vector<Biquad> sections;
+        for (size_t i = 0; i < proto.poles.size(); i++)
+        {
+            Cd p = map(proto.poles[i]);
+            Biquad q;
+            bool real_pole = (proto.poles[i].imag() == 0.0);
+            if (real_pole)
+            {
+                q.a1 = (float)-p.real();
+                q.b0 = 1.0f;
+                q.b1 = (float)-zero_at_infinity.real();
+            }
+            else
+            {
+                q.a1 = (float)(-2.0 * p.real());
+                q.a2 = (float)std::norm(p);
+                Cd z = (i < proto.zeros.size()) ? map(proto.zeros[i]) : zero_at_infinity;
+                q.b0 = 1.0f;
+                q.b1 = (float)(-2.0 * z.real());
+                q.b2 = (float)std::norm(z);
+            }
+
+            // Unity gain at the passband reference for every section.
+            double g = std::abs(SectionResponse(q, ref));
+            q.b0 = (float)(q.b0 / g);
+            q.b1 = (float)(q.b1 / g);
+            q.b2 = (float)(q.b2 / g);
+            sections.push_back(q);
+        }
+
+        // Even-order equiripple designs sit at the bottom of the ripple at DC / Nyquist.
+        if (spec.family != FilterFamily::Butterworth && spec.order % 2 == 0)
+        {
+            float g = (float)std::pow(10.0, -spec.passband_ripple_db / 20.0);
+            sections[0].b0 *= g;
+            sections[0].b1 *= g;
+            sections[0].b2 *= g;
+        }
+        return sections;
+    }
+
+    //-------------------------------------------------------------------------
+    // BiquadCascade
+    //-------------------------------------------------------------------------
+
+    BiquadCascade::BiquadCascade(std::vector<Biquad> sections, size_t channels)
+        : sections_(std::move(sections)), channels_(channels)
+    {
+        z1_.assign(sections_.size() * channels_, 0.0f);
+        z2_.assign(sections_.size() * channels_, 0.0f);
+        frame_.assign(channels_, 0.0f);
+    }
+
+    void BiquadCascade::Reset()
+    {
+        std::fill(z1_.begin(), z1_.end(), 0.0f);
+        std::fill(z2_.begin(), z2_.end(), 0.0f);
+    }
+
+    void BiquadCascade::Process(const float* in, float* out, size_t frames)
+    {
+        const size_t c_count = channels_;
+        float* x = frame_.data();
+        for (size_t f = 0; f < frames; f++)
+        {
+            std::copy(in + f * c_count, in + (f + 1) * c_count, x);
+            for (size_t s = 0; s < sections_.size(); s++)
+            {
+                const Biquad q = sections_[s];
+                float* z1 = z1_.data() + s * c_count;
+                float* z2 = z2_.data() + s * c_count;
+                for (size_t c = 0; c < c_count; c++)
+                {
+                    float xi = x[c];
+                    float y = q.b0 * xi + z1[c];
+                    z1[c] = q.b1 * xi - q.a1 * y + z2[c];
+                    z2[c] = q.b2 * xi - q.a2 * y;
+                    x[c] = y;
+                }
+            }
+            std::copy(x, x + c_count, out + f * c_count);
+        }
+    }
+
+    float BiquadCascade::ProcessSample(float x)
+    {
+        for (size_t s = 0; s < sections_.size(); s++)
+        {
+            const Biquad& q = sections_[s];
+            float& z1 = z1_[s * channels_];
+            float& z2 = z2_[s * channels_];
+            float y = q.b0 * x + z1;
+            z1 = q.b1 * x - q.a1 * y + z2;
+            z2 = q.b2 * x - q.a2 * y;
+            x = y;
+        }
+        return x;
+    }
+
+    //-------------------------------------------------------------------------
+    // FIR
+    //-------------------------------------------------------------------------
+
+    // Zeroth-order modified Bessel function of the first kind (power series).
+    static double BesselI0(double x)
+    {
+        double sum = 1.0, term = 1.0;
+        for (int k = 1; k < 64; k++)
+        {
+            term *= (x / (2.0 * k)) * (x / (2.0 * k));
+            sum += term;
+            if (term < 1e-17 * sum)
+                break;
+        }
+        return sum;
+    }
+
+    double KaiserBeta(double a)
+    {
+        if (a > 50.0)
+            return 0.1102 * (a - 8.7);
+        if (a >= 21.0)
+            return 0.5842 * std::pow(a - 21.0, 0.4) + 0.07886 * (a - 21.0);
+        return 0.0;
+    }
+
+    std::vector<float> DesignFirLowpass(size_t taps, double cutoff, double kaiser_beta)
+    {
+        assert(taps >= 1);
+        std::vector<double> h(taps);
+        double center = 0.5 * (double)(taps - 1);
+        double norm = BesselI0(kaiser_beta);
+        double sum = 0.0;
+        for (size_t i = 0; i < taps; i++)
+        {
+            double t = (double)i - center;
+            double sinc = (t == 0.0) ? 2.0 * cutoff : std::sin(2.0 * std::numbers::pi * cutoff * t) / (std::numbers::pi * t);
+            double r = (taps > 1) ? t / center : 0.0;
+            double window = BesselI0(kaiser_beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / norm;
+            h[i] = sinc * window;
+            sum += h[i];
+        }
+        std::vector<float> out(taps);
+        for (size_t i = 0; i < taps; i++)
+            out[i] = (float)(h[i] / sum);
+        return out;
+    }
+
+    FirFilter::FirFilter(std::vector<float> taps, size_t channels, size_t decimation, size_t interpolation)
+        : taps_(taps.size()), channels_(channels), decimation_(std::max<size_t>(1, decimation)),
+          interpolation_(std::max<size_t>(1, interpolation))
+    {
+        // Branch p holds taps p, p + L, p + 2L, ... (newest sample first),
+        // stored oldest first and zero-padded at the old end.
+        size_t l = interpolation_;
+        branch_ = (taps_ + l - 1) / l;
+        branches_.assign(l * branch_, 0.0f);
+        for (size_t p = 0; p < l; p++)
+            for (size_t j = 0; p + j * l < taps_; j++)
+                branches_[p * branch_ + branch_ - 1 - j] = taps[p + j * l] * (float)l;
+        history_.assign(2 * branch_ * channels_, 0.0f);
+    }
+
+    void FirFilter::Reset()
+    {
+        std::fill(history_.begin(), history_.end(), 0.0f);
+        pos_ = 0;
+        phase_ = 0;
+    }
+
+    size_t FirFilter::Process(const float* in, size_t frames, float* out)
+    {
+        const size_t len = branch_;
+        const size_t c_count = channels_;
+        const size_t l = interpolation_, m = decimation_;
+        size_t phase = phase_;
+        size_t produced = 0;
+        for (size_t f = 0; f < frames; f++)
+        {
+            const float* frame = in + f * c_count;
+            std::copy(frame, frame + c_count, history_.data() + pos_ * c_count);
+            std::copy(frame, frame + c_count, history_.data() + (pos_ + len) * c_count);
+            pos_ = (pos_ + 1 == len) ? 0 : pos_ + 1;
+
+            // Outputs that fall between this input and the next, each on
+            // the branch of its offset; with decimation most frames have none
+            for (; phase < l; phase += m)
+            {
+                // Oldest frame of the window is at pos_.
+                float* y = out + produced * c_count;
+                std::fill(y, y + c_count, 0.0f);
+                const float* window = history_.data() + pos_ * c_count;
+                const float* taps = branches_.data() + phase * len;
+                for (size_t k = 0; k < len; k++)
+                {
+                    float h = taps[k];
+                    const float* x = window + k * c_count;
+                    for (size_t c = 0; c < c_count; c++)
+                        y[c] += h * x[c];
+                }
+                produced++;
+            }
+            phase -= l;
+        }
+        phase_ = phase;
+        return produced;
+    }
+}
@@ -0,0 +1,120 @@
+// Digital filters: IIR design into biquad cascades, multi-channel biquad and
+// FIR processing, and polyphase FIR decimation and interpolation.
+//
+// Multi-channel streams are interleaved (in[frame * channels + channel]) and
+// filter state is stored channel-innermost, so every per-sample step is a
+// straight loop over channels that the compiler vectorizes.
+
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace Dsp
+{
+    enum class FilterFamily
+    {
+        Butterworth,    // Maximally flat, -3 dB at the cutoff
+        Chebyshev1,     // Equiripple passband, cutoff at the ripple band edge
+        Elliptic,       // Equiripple passband and stopband, cutoff at the ripple band edge
+    };
+
+    enum class FilterResponse
+    {
+        LowPass,
+        HighPass,
+    };
+
+    struct FilterSpec
+    {
+        FilterFamily family = FilterFamily::Butterworth;
+        FilterResponse response = FilterResponse::LowPass;
+        int order = 4;
+        double cutoff = 0.1;                // Cycles per sample, in (0, 0.5)
+        double passband_ripple_db = 1.0;    // Chebyshev / elliptic
+        double stopband_db = 60.0;          // Elliptic minimum stopband attenuation
+    };
+
+    // y[n] = b0 x[n] + b1 x[n-1] + b2 x[n-2] - a1 y[n-1] - a2 y[n-2]
+    struct Biquad
+    {
+        float b0 = 1.0f, b1 = 0.0f, b2 = 0.0f;
+        float a1 = 0.0f, a2 = 0.0f;
+    };
+
+    // Designs the analog prototype of the spec and maps it with the prewarped
+    // bilinear transform. Returns ceil(order / 2) sections; an odd order ends
+    // with a first-order section (b2 = a2 = 0).
+    std::vector<Biquad> DesignIir(const FilterSpec& spec);
+
+    // Frequency response of a cascade at `freq` cycles/sample.
+    std::complex<double> CascadeResponse(const std::vector<Biquad>& sections, double freq);
+
+    // Biquad cascade over `channels` interleaved channels, transposed direct form II.
+    class BiquadCascade
+    {
+    public:
+        BiquadCascade() = default;
+        BiquadCascade(std::vector<Biquad> sections, size_t channels);
+
+        size_t Channels() const { return channels_; }
+        const std::vector<Biquad>& Sections() const { return sections_; }
+
+        void Reset();
+        // Filters `frames` interleaved frames. in == out is allowed.
+        void Process(const float* in, float* out, size_t frames);
+        // Single-channel convenience for cascades built with one channel.
+        float ProcessSample(float x);
+
+    private:
+        std::vector<Biquad> sections_;
+        size_t channels_ = 0;
+        std::vector<float> z1_;             // [section][channel]
+        std::vector<float> z2_;
+        std::vector<float> frame_;          // One frame being carried through the sections
+    };
+
+    // Kaiser-windowed sinc low-pass with unity DC gain. cutoff in cycles/sample.
+    std::vector<float> DesignFirLowpass(size_t taps, double cutoff, double kaiser_beta = 8.0);
+
+    // Kaiser beta for a stopband attenuation in dB.
+    double KaiserBeta(double attenuation_db);
+
+    // Streaming multi-channel FIR with optional integer interpolation and
+    // decimation: the input is conceptually zero-stuffed to `interpolation`
+    // times its rate, filtered (with gain `interpolation`, so DC passes at
+    // unity) and every `decimation`-th sample kept. Only the kept outputs are
+    // evaluated, each from the one polyphase branch of taps / interpolation
+    // taps that meets non-zero input, so the cost per input frame is
+    // taps / decimation multiply-adds per channel whatever the interpolation.
+    class FirFilter
+    {
+    public:
+        FirFilter() = default;
+        FirFilter(std::vector<float> taps, size_t channels, size_t decimation = 1, size_t interpolation = 1);
+
+        size_t Channels() const { return channels_; }
+        size_t Decimation() const { return decimation_; }
+        size_t Interpolation() const { return interpolation_; }
+        // Group delay in input samples.
+        float Delay() const { return 0.5f * (float)(taps_ - 1) / (float)interpolation_; }
+
+        void Reset();
+        // Consumes `frames` interleaved input frames and writes the resampled
+        // outputs to `out`; returns how many output frames were written (at
+        // most frames * interpolation / decimation + 1).
+        size_t Process(const float* in, size_t frames, float* out);
+
+    private:
+        size_t taps_ = 0;
+        size_t channels_ = 0;
+        size_t decimation_ = 1;
+        size_t interpolation_ = 1;
+        size_t branch_ = 0;                 // Taps per polyphase branch, ceil(taps / interpolation)
+        std::vector<float> branches_;       // [phase][branch_], reversed and scaled, so [0] weighs the oldest sample
+        std::vector<float> history_;        // Ring of frames, stored twice: [2 * branch_][channel]
+        size_t pos_ = 0;
+        size_t phase_ = 0;                  // Zero-stuffed samples from the newest input to the next output
+    };
+}
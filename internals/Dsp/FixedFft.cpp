@@ -0,0 +1,266 @@
+#include "Dsp/FixedFft.h"
+
+#include "Dsp/FftCodelets.h"
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <numbers>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define DSP_FIXED_SSE2 1
+#else
+#define DSP_FIXED_SSE2 0
+#endif
+
+namespace Dsp
+{
+    static constexpr size_t sine_table_size = 4096;
+
+    // sin(2 pi k / 4096) in Q31, evaluated by the compiler so no libm is involved.
+    static constexpr std::array<int32_t, sine_table_size + 1> sine_table = []
+    {
+        std::array<int32_t, sine_table_size + 1> table{};
+        for (size_t k = 0; k <= sine_table_size; k++)
+        {
+            double q = Codelets::Sin(2.0 * std::numbers::pi * (double)k / (double)sine_table_size) * 2147483648.0;
+            long long v = (q >= 0.0) ? (long long)(q + 0.5) : -(long long)(-q + 0.5);
+            table[k] = (int32_t)std::clamp<long long>(v, -2147483647ll, 2147483647ll);
+        }
+        return table;
+    }();
+
+    // (x + 2^(s-1)) >> s: round half up, with s == 0 a no-op.
+    template<typename Wide>
+    static inline Wide RoundShift(Wide x, int s)
+    {
+        return (x + (((Wide)1 << s) >> 1)) >> s;
+    }
+
+    int32_t SinQ31(uint32_t turn)
+    {
+        uint32_t index = turn >> 20;
+        int64_t frac = (turn >> 4) & 0xFFFF;
+        int64_t a = sine_table[index];
+        int64_t b = sine_table[index + 1];
+        return (int32_t)(a + RoundShift<int64_t>((b - a) * frac, 16));
+    }
+
+    int32_t CosQ31(uint32_t turn)
+    {
+        return SinQ31(turn + (1u << 30));
+    }
+
+    //-------------------------------------------------------------------------
+    // FixedFftPlan
+    //-------------------------------------------------------------------------
+
+    // One group of h butterflies; the four halves never overlap. Q15 runs eight
+    // lanes of SSE2 at a time, Q31 needs 64-bit products and stays scalar.
+    template<typename Format>
+    static inline void Butterflies(typename Format::Value* __restrict ar, typename Format::Value* __restrict ai,
+                                   typename Format::Value* __restrict br, typename Format::Value* __restrict bi,
+                                   const typename Format::Value* __restrict wr, const typename Format::Value* __restrict wi,
+                                   size_t h, int shift)
+    {
+        using Value = typename Format::Value;
+        using Wide = typename Format::Wide;
+        constexpr int fraction = Format::fraction_bits;
+        const Wide round = ((Wide)1 << fraction) >> 1;
+        const Wide round_shift = ((Wide)1 << shift) >> 1;
+        size_t j = 0;
+#if DSP_FIXED_SSE2
+        if constexpr (std::is_same_v<Format, Q15>)
+        {
+            // Eight butterflies per step. pmaddwd on interleaved (b.re, b.im)
+            // pairs yields b.re * c - b.im * s and b.re * s + b.im * c in int32
+            // directly; every later step is the scalar arithmetic, lane-wise,
+            // so both paths give identical bits.
+            const __m128i round_v = _mm_set1_epi32((int)round);
+            const __m128i round_shift_v = _mm_set1_epi32((int)round_shift);
+            const __m128i shift_v = _mm_cvtsi32_si128(shift);
+            for (; j + 8 <= h; j += 8)
+            {
+                __m128i vbr = _mm_loadu_si128((const __m128i*)(br + j));
+                __m128i vbi = _mm_loadu_si128((const __m128i*)(bi + j));
+                __m128i vc = _mm_loadu_si128((const __m128i*)(wr + j));
+                __m128i vs = _mm_loadu_si128((const __m128i*)(wi + j));
+                __m128i vns = _mm_sub_epi16(_mm_setzero_si128(), vs);
+                __m128i vxr = _mm_loadu_si128((const __m128i*)(ar + j));
+                __m128i vxi = _mm_loadu_si128((const __m128i*)(ai + j));
+                __m128i out_ar[2], out_ai[2], out_br[2], out_bi[2];
+                for (int half = 0; half < 2; half++)
+                {
+                    __m128i b_pairs = half ? _mm_unpackhi_epi16(vbr, vbi) : _mm_unpacklo_epi16(vbr, vbi);
+                    __m128i cs = half ? _mm_unpackhi_epi16(vc, vns) : _mm_unpacklo_epi16(vc, vns);
+                    __m128i sc = half ? _mm_unpackhi_epi16(vs, vc) : _mm_unpacklo_epi16(vs, vc);
+                    __m128i tr = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(b_pairs, cs), round_v), fraction);
+                    __m128i ti = _mm_srai_epi32(_mm_add_epi32(_mm_madd_epi16(b_pairs, sc), round_v), fraction);
+                    // Sign-extend a to int32.
+                    __m128i xr = _mm_srai_epi32(half ? _mm_unpackhi_epi16(vxr, vxr) : _mm_unpacklo_epi16(vxr, vxr), 16);
+                    __m128i xi = _mm_srai_epi32(half ? _mm_unpackhi_epi16(vxi, vxi) : _mm_unpacklo_epi16(vxi, vxi), 16);
+                    out_ar[half] = _mm_sra_epi32(_mm_add_epi32(_mm_add_epi32(xr, tr), round_shift_v), shift_v);
+                    out_ai[half] = _mm_sra_epi32(_mm_add_epi32(_mm_add_epi32(xi, ti), round_shift_v), shift_v);
+                    out_br[half] = _mm_sra_epi32(_mm_add_epi32(_mm_sub_epi32(xr, tr), round_shift_v), shift_v);
+                    out_bi[half] = _mm_sra_epi32(_mm_add_epi32(_mm_sub_epi32(xi, ti), round_shift_v), shift_v);
+                }
+                // The stage shift guarantees int16 range, so saturation never engages.
+                _mm_storeu_si128((__m128i*)(ar + j), _mm_packs_epi32(out_ar[0], out_ar[1]));
+                _mm_storeu_si128((__m128i*)(ai + j), _mm_packs_epi32(out_ai[0], out_ai[1]));
+                _mm_storeu_si128((__m128i*)(br + j), _mm_packs_epi32(out_br[0], out_br[1]));
+                _mm_storeu_si128((__m128i*)(bi + j), _mm_packs_epi32(out_bi[0], out_bi[1]));
+            }
+        }
+#endif
+        for (; j < h; j++)
+        {
+            Wide c = wr[j], s = wi[j];
+            Wide tr = ((Wide)br[j] * c - (Wide)bi[j] * s + round) >> fraction;
+            Wide ti = ((Wide)br[j] * s + (Wide)bi[j] * c + round) >> fraction;
+            Wide xr = ar[j], xi = ai[j];
+            ar[j] = (Value)((xr + tr + round_shift) >> shift);
+            ai[j] = (Value)((xi + ti + round_shift) >> shift);
+            br[j] = (Value)((xr - tr + round_shift) >> shift);
+            bi[j] = (Value)((xi - ti + round_shift) >> shift);
+        }
+    }
+
+    // Largest component magnitude, from min / max reductions (abs of the most
+    // negative value would overflow).
+    template<typename Format>
+    static typename Format::Wide Peak(const typename Format::Value* __restrict re, const typename Format::Value* __restrict im, size_t n)
+    {
+        using Value = typename Format::Value;
+        using Wide = typename Format::Wide;
+        Value lo = 0, hi = 0;
+        size_t i = 0;
+#if DSP_FIXED_SSE2
+        if constexpr (std::is_same_v<Format, Q15>)
+        {
+            __m128i vlo = _mm_setzero_si128(), vhi = _mm_setzero_si128();
+            for (; i + 8 <= n; i += 8)
+            {
+                __m128i a = _mm_loadu_si128((const __m128i*)(re + i));
+                __m128i b = _mm_loadu_si128((const __m128i*)(im + i));
+                vlo = _mm_min_epi16(vlo, _mm_min_epi16(a, b));
+                vhi = _mm_max_epi16(vhi, _mm_max_epi16(a, b));
+            }
+            alignas(16) int16_t lanes_lo[8], lanes_hi[8];
+            _mm_store_si128((__m128i*)lanes_lo, vlo);
+            _mm_store_si128((__m128i*)lanes_hi, vhi);
+            for (size_t j = 0; j < 8; j++)
+            {
+                lo = std::min(lo, lanes_lo[j]);
+                hi = std::max(hi, lanes_hi[j]);
+            }
+        }
+#endif
+        for (; i < n; i++)
+        {
+            Value a = re[i], b = im[i];
+            lo = a < lo ? a : lo;
+            lo = b < lo ? b : lo;
+            hi = a > hi ? a : hi;
+            hi = b > hi ? b : hi;
+        }
+        return std::max((Wide)hi, -(Wide)lo);
+    }
+
+    template<typename Format>
+    FixedFftPlan<Format>::FixedFftPlan(size_t n)
+        : n_(n)
+    {
+        assert(n >= 1 && n <= fixed_fft_max_size && (n & (n - 1)) == 0);
+        unsigned bits = 0;
+        while (((size_t)1 << bits) < n)
+            bits++;
+        for (size_t i = 0; i < n; i++)
+        {
+            size_t j = 0;
+            for (unsigned b = 0; b < bits; b++)
+                j |= ((i >> b) & 1) << (bits - 1 - b);
+            if (i < j)
+            {
+                bitrev_.push_back((unsigned)i);
+                bitrev_.push_back((unsigned)j);
+            }
+        }
+
+        // exp(-2 pi i j / 2h) straight from the table: index j * 4096 / 2h.
+        constexpr int drop = 31 - Format::fraction_bits;
+        constexpr Wide max_value = ((Wide)1 << Format::fraction_bits) - 1;
+        auto convert = [&](int32_t q31)
+        {
+            int64_t v = RoundShift<int64_t>(q31, drop);
+            return (Value)std::clamp<int64_t>(v, -max_value, max_value);
+        };
+        twiddle_re_.resize(n);
+        twiddle_im_.resize(n);
+        conjugate_im_.resize(n);
+        for (size_t h = 1; h < n; h <<= 1)
+            for (size_t j = 0; j < h; j++)
+            {
+                size_t index = j * (sine_table_size / (2 * h));
+                twiddle_re_[h + j] = convert(sine_table[(index + sine_table_size / 4) % sine_table_size]);
+                twiddle_im_[h + j] = convert(-sine_table[index]);
+                conjugate_im_[h + j] = (Value)-twiddle_im_[h + j];
+            }
+    }
+
+    template<typename Format>
+    int FixedFftPlan<Format>::Transform(Value* re, Value* im, bool inverse) const
+    {
+        constexpr int fraction = Format::fraction_bits;
+        constexpr Wide max_value = ((Wide)1 << fraction) - 1;
+
+        for (size_t i = 0; i < bitrev_.size(); i += 2)
+        {
+            std::swap(re[bitrev_[i]], re[bitrev_[i + 1]]);
+            std::swap(im[bitrev_[i]], im[bitrev_[i + 1]]);
+        }
+
+        int exponent = 0;
+        for (size_t h = 1; h < n_; h <<= 1)
+        {
+            // A butterfly maps components of magnitude <= m to at most
+            // (1 + sqrt 2) m + 1; shift the stage down until that fits.
+            Wide peak = Peak<Format>(re, im, n_);
+            Wide bound = peak / 1024 * 2473 + (peak % 1024) * 2473 / 1024 + 2;
+            int shift = 0;
+            while (bound > (max_value << shift))
+                shift++;
+            exponent += shift;
+
+            const Value* wr = twiddle_re_.data() + h;
+            const Value* wi = (inverse ? conjugate_im_.data() : twiddle_im_.data()) + h;
+            for (size_t base = 0; base < n_; base += 2 * h)
+                Butterflies<Format>(re + base, im + base, re + base + h, im + base + h, wr, wi, h, shift);
+        }
+        return exponent;
+    }
+
+    template class FixedFftPlan<Q15>;
+    template class FixedFftPlan<Q31>;
+
+    //-------------------------------------------------------------------------
+    // Epicycles
+    //-------------------------------------------------------------------------
+
+    void EvaluateEpicyclesFixed(const FixedEpicycle* circles, size_t count, uint32_t turn, int32_t* x_q16, int32_t* y_q16)
+    {
+        int64_t x = 0, y = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            // Unsigned wrap-around is exactly angle modulo one turn.
+            uint32_t angle = (uint32_t)circles[i].harmonic * turn + circles[i].phase;
+            int64_t r = circles[i].radius_q16;
+            x += RoundShift<int64_t>(r * CosQ31(angle), 31);
+            y += RoundShift<int64_t>(r * SinQ31(angle), 31);
+            x_q16[i] = (int32_t)x;
+            y_q16[i] = (int32_t)y;
+        }
+    }
+}
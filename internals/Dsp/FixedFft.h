@@ -0,0 +1,84 @@
+// Fixed-point (Q15 / Q31) FFT and epicycle evaluation.
+//
+// Everything here is integer arithmetic with explicit round-half-up shifts,
+// and every trigonometric value comes from one compile-time table, so
+// results are bit-identical across compilers, CPUs and optimization levels.
+// The FFT uses block floating point: before each radix-2 stage the block is
+// scanned and shifted down just enough that the stage cannot overflow, and
+// the total shift is returned as the block exponent.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Dsp
+{
+    // Q15: int16 holding [-1, 1) in steps of 2^-15, products in int32.
+    struct Q15
+    {
+        using Value = int16_t;
+        using Wide = int32_t;
+        static constexpr int fraction_bits = 15;
+    };
+
+    // Q31: int32 holding [-1, 1) in steps of 2^-31, products in int64.
+    struct Q31
+    {
+        using Value = int32_t;
+        using Wide = int64_t;
+        static constexpr int fraction_bits = 31;
+    };
+
+    // sin / cos of a full-turn angle (2^32 == 2 pi) in Q31, linearly
+    // interpolated from a 4096-entry table. Exact at multiples of 2^20.
+    int32_t SinQ31(uint32_t turn);
+    int32_t CosQ31(uint32_t turn);
+
+    // Largest supported FFT size; twiddles are exact table entries up to it.
+    constexpr size_t fixed_fft_max_size = 4096;
+
+    template<typename Format>
+    class FixedFftPlan
+    {
+    public:
+        using Value = typename Format::Value;
+        using Wide = typename Format::Wide;
+
+        // n must be a power of two <= fixed_fft_max_size.
+        explicit FixedFftPlan(size_t n);
+
+        size_t Size() const { return n_; }
+
+        // In-place transform of split real / imaginary arrays. Returns the
+        // block exponent e: the unnormalized transform equals data * 2^e.
+        int Forward(Value* re, Value* im) const { return Transform(re, im, false); }
+        int Inverse(Value* re, Value* im) const { return Transform(re, im, true); }
+
+    private:
+        int Transform(Value* re, Value* im, bool inverse) const;
+
+        size_t n_ = 0;
+        std::vector<unsigned> bitrev_;      // Swap pairs (i < j)
+        std::vector<Value> twiddle_re_;     // Stage with half-size h uses [h, 2h)
+        std::vector<Value> twiddle_im_;     // Forward sign (exp(-i ...))
+        std::vector<Value> conjugate_im_;   // Inverse sign
+    };
+
+    using FixedFftQ15 = FixedFftPlan<Q15>;
+    using FixedFftQ31 = FixedFftPlan<Q31>;
+
+    // One circle of an epicycle chain: radius_q16 * exp(i (harmonic * turn + phase)).
+    struct FixedEpicycle
+    {
+        int32_t radius_q16 = 0;     // Q16.16
+        int32_t harmonic = 1;       // Turns per turn of the base angle (may be negative)
+        uint32_t phase = 0;         // 2^32 == one turn
+    };
+
+    // Evaluates the chain at base angle `turn` (2^32 == one turn). Writes the
+    // running centre after each circle to x_q16 / y_q16 (count entries, Q16.16,
+    // relative to the chain origin); the last entry is the tip.
+    void EvaluateEpicyclesFixed(const FixedEpicycle* circles, size_t count, uint32_t turn, int32_t* x_q16, int32_t* y_q16);
+}
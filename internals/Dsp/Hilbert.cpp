@@ -0,0 +1,133 @@
+#include "Dsp/Hilbert.h"
+
+#include "Dsp/Filter.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numbers>
+
+namespace Dsp
+{
+    HilbertPlan::HilbertPlan(size_t n)
+        : n_(n), forward_(n), inverse_(n)
+    {
+        assert(n >= 1);
+    }
+
+    void HilbertPlan::Analytic(const float* in, Complex* out) const
+    {
+        forward_.Forward(in, out);
+        float inv_n = 1.0f / (float)n_;
+        size_t half = n_ / 2;
+        out[0] *= inv_n;
+        for (size_t k = 1; k < (n_ + 1) / 2; k++)
+            out[k] *= 2.0f * inv_n;
+        if (n_ % 2 == 0 && half > 0)
+            out[half] *= inv_n;
+        std::fill(out + half + 1, out + n_, Complex(0.0f, 0.0f));
+        inverse_.Inverse(out);
+    }
+
+    void Envelope(const Complex* analytic, float* out, size_t n)
+    {
+        for (size_t i = 0; i < n; i++)
+            out[i] = std::sqrt(analytic[i].real() * analytic[i].real() + analytic[i].imag() * analytic[i].imag());
+    }
+
+    void InstantaneousFrequency(const Complex* analytic, float* out, size_t n)
+    {
+        const float inv_two_pi = (float)(0.5 / std::numbers::pi);
+        for (size_t i = 1; i < n; i++)
+        {
+            Complex d = Mul(analytic[i], std::conj(analytic[i - 1]));
+            out[i] = std::atan2(d.imag(), d.real()) * inv_two_pi;
+        }
+        if (n > 1)
+            out[0] = out[1];
+        else if (n == 1)
+            out[0] = 0.0f;
+    }
+
+    void UnwrappedPhase(const Complex* analytic, float* out, size_t n)
+    {
+        double phase = 0.0;
+        for (size_t i = 0; i < n; i++)
+        {
+            Complex d = i == 0 ? analytic[0] : Mul(analytic[i], std::conj(analytic[i - 1]));
+            phase += std::atan2((double)d.imag(), (double)d.real());
+            out[i] = (float)phase;
+        }
+    }
+
+    std::vector<float> DesignHilbertFir(size_t taps, double kaiser_beta)
+    {
+        assert(taps % 2 == 1);
+        // The ideal transformer is the half-band low-pass sin(pi k / 2) / (pi k)
+        // modulated by 2 sin(pi k / 2), so the windowed low-pass design is
+        // reused (undoing its unity-DC normalization via the centre tap 0.5).
+        std::vector<float> lowpass = DesignFirLowpass(taps, 0.25, kaiser_beta);
+        size_t half = taps / 2;
+        double scale = 2.0 * 0.5 / (double)lowpass[half];
+        std::vector<float> h(taps, 0.0f);
+        for (size_t k = 1; k <= half; k += 2)
+        {
+            float value = (float)(scale * (double)lowpass[half + k]) * ((k % 4 == 1) ? 1.0f : -1.0f);
+            h[half + k] = value;
+            h[half - k] = -value;
+        }
+        return h;
+    }
+
+    //-----------------------------------------------------------------------------
+
+    StreamingHilbert::StreamingHilbert(size_t taps)
+        : half_(taps / 2), taps_(2 * (taps / 2) + 1)
+    {
+        std::vector<float> h = DesignHilbertFir(taps_);
+        coefficients_.assign((taps_ + 7) & ~(size_t)7, 0.0f);
+        std::reverse_copy(h.begin(), h.end(), coefficients_.begin());
+        history_.assign(2 * taps_ + 8, 0.0f);
+    }
+
+    void StreamingHilbert::Reset()
+    {
+        std::fill(history_.begin(), history_.end(), 0.0f);
+        pos_ = 0;
+        last_ = previous_ = Complex(0.0f, 0.0f);
+        phase_ = 0.0;
+    }
+
+    Complex StreamingHilbert::Push(float x)
+    {
+        history_[pos_] = x;
+        history_[pos_ + taps_] = x;
+        pos_ = (pos_ + 1 == taps_) ? 0 : pos_ + 1;
+
+        // Oldest sample of the window is at pos_, its centre half_ later.
+        // Padding taps are zero, so reading past the window is harmless.
+        const float* window = history_.data() + pos_;
+        float acc[8] = {};
+        for (size_t k = 0; k < coefficients_.size(); k += 8)
+            for (size_t j = 0; j < 8; j++)
+                acc[j] += coefficients_[k + j] * window[k + j];
+        float imag = ((acc[0] + acc[4]) + (acc[1] + acc[5])) + ((acc[2] + acc[6]) + (acc[3] + acc[7]));
+        previous_ = last_;
+        last_ = Complex(window[half_], imag);
+        // The first output (nothing to difference against) contributes its own phase
+        Complex d = (previous_ == Complex(0.0f, 0.0f)) ? last_ : Mul(last_, std::conj(previous_));
+        phase_ += std::atan2((double)d.imag(), (double)d.real());
+        return last_;
+    }
+
+    float StreamingHilbert::Envelope() const
+    {
+        return std::abs(last_);
+    }
+
+    float StreamingHilbert::Frequency() const
+    {
+        Complex d = Mul(last_, std::conj(previous_));
+        return std::atan2(d.imag(), d.real()) * (float)(0.5 / std::numbers::pi);
+    }
+}
@@ -0,0 +1,87 @@
+// Hilbert transform and analytic signal.
+//
+// Blocks are transformed exactly (periodically) in the frequency domain;
+// streams go through a windowed FIR Hilbert transformer with a fixed delay.
+// Both produce the analytic signal z = x + i H{x}, from which the envelope
+// |z| and the instantaneous frequency d(arg z)/dt follow.
+
+#pragma once
+
+#include "Dsp/Fft.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace Dsp
+{
+    // Analytic signal of a block of n samples: the negative-frequency half of
+    // the spectrum is dropped and the positive half doubled, DC and Nyquist
+    // kept as they are.
+    class HilbertPlan
+    {
+    public:
+        explicit HilbertPlan(size_t n);
+
+        size_t Size() const { return n_; }
+
+        // out holds n values; in and out must not overlap.
+        void Analytic(const float* in, Complex* out) const;
+
+    private:
+        size_t n_ = 0;
+        RealFftPlan forward_;
+        FftPlan inverse_;
+    };
+
+    // |z| of n analytic samples.
+    void Envelope(const Complex* analytic, float* out, size_t n);
+
+    // Phase advance between neighbouring analytic samples in cycles/sample,
+    // taken as arg(z[i] conj(z[i-1])) so no unwrapping is needed. out[0]
+    // repeats out[1].
+    void InstantaneousFrequency(const Complex* analytic, float* out, size_t n);
+
+    // Phase of n analytic samples in radians with the 2 pi jumps of arg z
+    // removed: out[0] = arg z[0], then each sample adds its phase advance as
+    // measured by InstantaneousFrequency. Accumulated in double, so long
+    // signals do not drift.
+    void UnwrappedPhase(const Complex* analytic, float* out, size_t n);
+
+    // Kaiser-windowed ideal Hilbert transformer, h[k] = 2 / (pi k) at odd
+    // offsets k from the centre and 0 elsewhere. taps must be odd.
+    std::vector<float> DesignHilbertFir(size_t taps, double kaiser_beta = 8.0);
+
+    // Streaming analytic signal. The real part is the input delayed to the
+    // centre of the FIR, the imaginary part is the FIR output. The zero even
+    // taps are kept: one contiguous dot product with independent partial
+    // sums vectorizes better than the strided odd-tap form.
+    class StreamingHilbert
+    {
+    public:
+        explicit StreamingHilbert(size_t taps = 63);
+
+        // Latency of the analytic output in samples.
+        size_t Delay() const { return half_; }
+
+        void Reset();
+        // Returns the analytic sample of the input pushed Delay() samples ago.
+        Complex Push(float x);
+
+        // Envelope and instantaneous frequency (cycles/sample) of the last output.
+        float Envelope() const;
+        float Frequency() const;
+        // Unwrapped phase of the last output in radians since Reset(), summed
+        // from the per-sample phase advances in double like UnwrappedPhase().
+        double Phase() const { return phase_; }
+
+    private:
+        size_t half_ = 0;
+        size_t taps_ = 0;
+        std::vector<float> coefficients_;   // Reversed taps, padded with zeros to a multiple of 8
+        std::vector<float> history_;        // Ring of taps samples, stored twice (plus padding)
+        size_t pos_ = 0;
+        Complex last_;
+        Complex previous_;
+        double phase_ = 0.0;
+    };
+}
@@ -0,0 +1,227 @@
+#include "Dsp/OscillatorBank.h"
+
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define BANK_SSE2 1
+#else
+#define BANK_SSE2 0
+#endif
+
+namespace Dsp
+{
+    static constexpr size_t chunk_frames = 256;
+
+    OscillatorBank::OscillatorBank(size_t capacity, double sample_rate)
+        : capacity_((std::max<size_t>(capacity, 1) + 7) & ~(size_t)7), sample_rate_(sample_rate)
+    {
+        for (std::vector<float>* v : { &phase_, &radius_, &zr_, &zi_, &wr_, &wi_, &amp_, &target_ })
+            v->assign(capacity_, 0.0f);
+        harmonic_.assign(capacity_, 0);
+        acc_.assign(4 * chunk_frames, 0.0f);
+    }
+
+    void OscillatorBank::SetSampleRate(double sample_rate)
+    {
+        sample_rate_ = sample_rate;
+        Retarget();
+    }
+
+    void OscillatorBank::SetSeries(const Epicycle* circles, size_t count, double fundamental, float gain)
+    {
+        count = std::min(count, capacity_);
+        for (size_t i = 0; i < count; i++)
+        {
+            bool moved = i >= count_ || harmonic_[i] != circles[i].harmonic || phase_[i] != circles[i].phase;
+            harmonic_[i] = circles[i].harmonic;
+            phase_[i] = circles[i].phase;
+            radius_[i] = circles[i].radius;
+            if (moved)
+                Resync(i, i + 1);
+        }
+        // Dropped partials keep turning while they fade out
+        for (size_t i = count; i < count_; i++)
+            radius_[i] = 0.0f;
+        count_ = count;
+        fundamental_ = fundamental;
+        gain_ = gain;
+        Retarget();
+    }
+
+    void OscillatorBank::SetLimit(size_t limit)
+    {
+        if (limit == limit_)
+            return;
+        limit_ = limit;
+        Retarget();
+    }
+
+    // Rotations and target amplitudes from the current series.
+    void OscillatorBank::Retarget()
+    {
+        double step = two_pi * fundamental_ / sample_rate_;
+        double nyquist = 0.5 * sample_rate_;
+        size_t span = std::max(count_, groups_ * 8);
+        size_t last = 0;
+        active_ = 0;
+        for (size_t i = 0; i < span; i++)
+        {
+            double rotation = ReduceAngle((double)harmonic_[i] * step);
+            wr_[i] = (float)std::cos(rotation);
+            wi_[i] = (float)std::sin(rotation);
+            bool audible = i < count_ && i < limit_ && std::fabs((double)harmonic_[i] * fundamental_) < nyquist;
+            target_[i] = audible ? radius_[i] * gain_ : 0.0f;
+            // Silent partials are not advanced; they come back in phase
+            if (target_[i] != 0.0f && amp_[i] == 0.0f)
+                Resync(i, i + 1);
+            if (target_[i] != 0.0f)
+                active_++;
+            if (target_[i] != 0.0f || amp_[i] != 0.0f)
+                last = i + 1;
+        }
+        groups_ = (last + 7) / 8;
+    }
+
+    // Phasors of [begin, end) set from the exact phase.
+    void OscillatorBank::Resync(size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            double angle = ReduceAngle((double)harmonic_[i] * theta_ + (double)phase_[i]);
+            zr_[i] = (float)std::cos(angle);
+            zi_[i] = (float)std::sin(angle);
+        }
+    }
+
+    void OscillatorBank::Reset()
+    {
+        Resync(0, groups_ * 8);
+        for (size_t i = 0; i < groups_ * 8; i++)
+            amp_[i] = target_[i];
+    }
+
+    void OscillatorBank::Reset(double theta)
+    {
+        theta_ = std::fmod(theta, two_pi);
+        if (theta_ < 0.0)
+            theta_ += two_pi;
+        Reset();
+    }
+
+    void OscillatorBank::Render(float* out, size_t frames)
+    {
+        for (size_t done = 0; done < frames;)
+        {
+            size_t n = std::min(chunk_frames, frames - done);
+            RenderChunk(out + done, n);
+            done += n;
+        }
+    }
+
+    // Every lane of the SSE2 path performs the same operations in the same
+    // order as the scalar path, so both give identical samples.
+    void OscillatorBank::RenderChunk(float* out, size_t n)
+    {
+        float* acc = acc_.data();
+        std::fill(acc, acc + 4 * n, 0.0f);
+        float inv_n = 1.0f / (float)n;
+        for (size_t g = 0; g < groups_; g++)
+        {
+            size_t base = 8 * g;
+            bool silent = true;
+            for (size_t j = 0; j < 8 && silent; j++)
+                silent = amp_[base + j] == 0.0f && target_[base + j] == 0.0f;
+            if (silent)
+                continue;
+#if BANK_SSE2
+            __m128 z0r = _mm_loadu_ps(&zr_[base]), z0i = _mm_loadu_ps(&zi_[base]);
+            __m128 z1r = _mm_loadu_ps(&zr_[base + 4]), z1i = _mm_loadu_ps(&zi_[base + 4]);
+            __m128 w0r = _mm_loadu_ps(&wr_[base]), w0i = _mm_loadu_ps(&wi_[base]);
+            __m128 w1r = _mm_loadu_ps(&wr_[base + 4]), w1i = _mm_loadu_ps(&wi_[base + 4]);
+            __m128 a0 = _mm_loadu_ps(&amp_[base]), a1 = _mm_loadu_ps(&amp_[base + 4]);
+            __m128 scale = _mm_set1_ps(inv_n);
+            __m128 d0 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&target_[base]), a0), scale);
+            __m128 d1 = _mm_mul_ps(_mm_sub_ps(_mm_loadu_ps(&target_[base + 4]), a1), scale);
+            for (size_t s = 0; s < n; s++)
+            {
+                __m128 sum = _mm_loadu_ps(&acc[4 * s]);
+                sum = _mm_add_ps(sum, _mm_mul_ps(a0, z0i));
+                sum = _mm_add_ps(sum, _mm_mul_ps(a1, z1i));
+                _mm_storeu_ps(&acc[4 * s], sum);
+                __m128 r0 = _mm_sub_ps(_mm_mul_ps(z0r, w0r), _mm_mul_ps(z0i, w0i));
+                z0i = _mm_add_ps(_mm_mul_ps(z0r, w0i), _mm_mul_ps(z0i, w0r));
+                z0r = r0;
+                __m128 r1 = _mm_sub_ps(_mm_mul_ps(z1r, w1r), _mm_mul_ps(z1i, w1i));
+                z1i = _mm_add_ps(_mm_mul_ps(z1r, w1i), _mm_mul_ps(z1i, w1r));
+                z1r = r1;
+                a0 = _mm_add_ps(a0, d0);
+                a1 = _mm_add_ps(a1, d1);
+            }
+            _mm_storeu_ps(&zr_[base], z0r);
+            _mm_storeu_ps(&zi_[base], z0i);
+            _mm_storeu_ps(&zr_[base + 4], z1r);
+            _mm_storeu_ps(&zi_[base + 4], z1i);
+#else
+            float zr[8], zi[8], a[8], d[8];
+            for (size_t j = 0; j < 8; j++)
+            {
+                zr[j] = zr_[base + j];
+                zi[j] = zi_[base + j];
+                a[j] = amp_[base + j];
+                d[j] = (target_[base + j] - a[j]) * inv_n;
+            }
+            for (size_t s = 0; s < n; s++)
+            {
+                for (size_t j = 0; j < 8; j++)
+                    acc[4 * s + (j & 3)] += a[j] * zi[j];
+                for (size_t j = 0; j < 8; j++)
+                {
+                    float r = zr[j] * wr_[base + j] - zi[j] * wi_[base + j];
+                    zi[j] = zr[j] * wi_[base + j] + zi[j] * wr_[base + j];
+                    zr[j] = r;
+                    a[j] += d[j];
+                }
+            }
+            for (size_t j = 0; j < 8; j++)
+            {
+                zr_[base + j] = zr[j];
+                zi_[base + j] = zi[j];
+            }
+#endif
+        }
+        for (size_t s = 0; s < n; s++)
+            out[s] = (acc[4 * s] + acc[4 * s + 1]) + (acc[4 * s + 2] + acc[4 * s + 3]);
+
+        // Ramps end exactly on their targets; phasors are pulled back to unit
+        // length (one Newton step) and a slice is reset to the exact phase
+        size_t span = groups_ * 8;
+        for (size_t i = 0; i < span; i++)
+        {
+            amp_[i] = target_[i];
+            float k = 1.5f - 0.5f * (zr_[i] * zr_[i] + zi_[i] * zi_[i]);
+            zr_[i] *= k;
+            zi_[i] *= k;
+        }
+        theta_ = std::fmod(theta_ + (double)n * two_pi * fundamental_ / sample_rate_, two_pi);
+        if (span != 0)
+        {
+            size_t slice = std::max<size_t>(32, span / 32);
+            if (resync_ >= span)
+                resync_ = 0;
+            size_t end = std::min(resync_ + slice, span);
+            Resync(resync_, end);
+            resync_ = end;
+        }
+        // Partials that have faded out no longer need their groups
+        size_t last = 0;
+        for (size_t i = span; i > 0; i--)
+            if (target_[i - 1] != 0.0f)
+            {
+                last = i;
+                break;
+            }
+        groups_ = (last + 7) / 8;
+    }
+}
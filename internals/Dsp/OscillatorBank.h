@@ -0,0 +1,84 @@
+// Additive synthesis of an epicycle chain: the y coordinate of its tip as
+// audio, one sine oscillator per circle.
+//
+// Each partial is a unit phasor advanced by complex multiplication, eight
+// partials at a time with SSE2, so a sample costs a handful of multiplies
+// per partial and no sine. The phasors drift from float rounding, so a slice
+// of them is reset from the exact double-precision phase after every block;
+// every partial is resynchronized a few times per second. Partials at or
+// above Nyquist are silenced instead of aliasing.
+//
+// Nothing allocates after construction, so the bank can run on an audio
+// thread. Parameter changes are glitch-free: frequencies change at block
+// boundaries with the phase continuing, and amplitudes ramp linearly across
+// the next block.
+
+#pragma once
+
+#include "Dsp/Epicycles.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Dsp
+{
+    class OscillatorBank
+    {
+    public:
+        // Room for `capacity` partials; SetSeries keeps only that many.
+        explicit OscillatorBank(size_t capacity = 8192, double sample_rate = 48000.0);
+
+        size_t Capacity() const { return capacity_; }
+        double SampleRate() const { return sample_rate_; }
+        void SetSampleRate(double sample_rate);
+
+        // Partial i is circle i: amplitude radius * gain, frequency harmonic *
+        // fundamental (Hz), and phase harmonic * theta + phase where theta is
+        // the bank's running fundamental phase. A partial whose harmonic or
+        // phase changed restarts at its exact phase.
+        void SetSeries(const Epicycle* circles, size_t count, double fundamental, float gain);
+        // Partials from `limit` on fade out (a cheaper series under load).
+        void SetLimit(size_t limit);
+
+        // Overwrites out[0, frames) with the next samples.
+        void Render(float* out, size_t frames);
+        // Restarts every phasor at its exact phase and jumps amplitudes to
+        // their targets (no ramp).
+        void Reset();
+        // As Reset, from fundamental phase `theta` (handing over from
+        // another bank, see SpectralBank::Phase).
+        void Reset(double theta);
+        // Fundamental phase of the next output sample.
+        double Phase() const { return theta_; }
+
+        // Partials below the limit and Nyquist with a non-zero amplitude.
+        size_t Active() const { return active_; }
+
+    private:
+        void Retarget();
+        void Resync(size_t begin, size_t end);
+        void RenderChunk(float* out, size_t frames);
+
+        size_t capacity_;           // Multiple of eight
+        double sample_rate_;
+        double fundamental_ = 0.0;
+        float gain_ = 1.0f;
+        double theta_ = 0.0;        // Fundamental phase, radians in [0, 2 pi)
+        size_t count_ = 0;
+        size_t limit_ = (size_t)-1;
+        size_t active_ = 0;
+        size_t groups_ = 0;         // Groups of eight that may be audible
+        size_t resync_ = 0;         // Next partial to resynchronize
+
+        // Per partial, structure of arrays
+        std::vector<int32_t> harmonic_;
+        std::vector<float> phase_;
+        std::vector<float> radius_;
+        std::vector<float> zr_, zi_;        // Phasor
+        std::vector<float> wr_, wi_;        // Rotation per sample
+        std::vector<float> amp_;            // Amplitude now
+        std::vector<float> target_;         // Amplitude at the end of the next block
+        std::vector<float> acc_;            // Four lanes per frame of a chunk
+    };
+}
@@ -0,0 +1,152 @@
+#include "Dsp/Resampler.h"
+
+#include "Dsp/Filter.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <numeric>
+
+namespace Dsp
+{
+    Resampler::Resampler(size_t up, size_t down, size_t channels, const ResamplerSpec& spec)
+    {
+        assert(up >= 1 && down >= 1);
+        size_t g = std::gcd(up, down);
+        up /= g;
+        down /= g;
+        double ratio = (double)up / (double)down;
+        channels_ = channels;
+        interpolate_ = false;
+        step_ = (uint64_t)down << frac_bits;
+        Build(up, 0.5 * std::min(1.0, ratio) * spec.passband, ratio, spec);
+    }
+
+    Resampler::Resampler(double ratio, size_t channels, const ResamplerSpec& spec)
+    {
+        assert(ratio > 0.0);
+        // When decimating, the signal that survives the filter is ratio times
+        // narrower, so fewer phases give the same interpolation error.
+        size_t phases = std::max<size_t>(2, std::min(spec.phases, (size_t)std::ceil((double)spec.phases * ratio)));
+        channels_ = channels;
+        interpolate_ = true;
+        phases_ = phases;
+        SetRatio(ratio);
+        Build(phases, 0.5 * std::min(1.0, ratio) * spec.passband, ratio, spec);
+    }
+
+    void Resampler::Build(size_t phases, double cutoff, double ratio, const ResamplerSpec& spec)
+    {
+        phases_ = phases;
+        taps_ = std::max<size_t>(2, (size_t)std::ceil((double)spec.taps / std::min(1.0, ratio)));
+        taps_ = (taps_ + 7) & ~(size_t)7;
+
+        // Prototype at phases times the input rate. Phase q holds taps
+        // q, q + phases, q + 2 phases ... scaled by phases to restore unity
+        // gain; phase `phases` is phase 0 one input sample later, stored so
+        // the interpolating path can always read q + 1.
+        std::vector<float> prototype = DesignFirLowpass(taps_ * phases_, cutoff / (double)phases_, KaiserBeta(spec.stopband_db));
+        bank_.assign((phases_ + 1) * taps_, 0.0f);
+        for (size_t q = 0; q <= phases_; q++)
+        {
+            float* phase = bank_.data() + q * taps_;
+            for (size_t k = 0; k < taps_; k++)
+            {
+                size_t i = q + (taps_ - 1 - k) * phases_;
+                phase[k] = (i < prototype.size()) ? prototype[i] * (float)phases_ : 0.0f;
+            }
+        }
+
+        history_.assign(2 * taps_ * channels_, 0.0f);
+        coefficients_.assign(taps_, 0.0f);
+        pos_ = 0;
+        time_ = 0;
+    }
+
+    void Resampler::SetRatio(double ratio)
+    {
+        assert(ratio > 0.0);
+        double step = (double)phases_ * (double)(1ull << frac_bits) / ratio;
+        step_ = std::max<uint64_t>(1, (uint64_t)std::llround(step));
+    }
+
+    size_t Resampler::MaxOutput(size_t frames) const
+    {
+        return (size_t)((double)frames * Ratio()) + 2;
+    }
+
+    void Resampler::Reset()
+    {
+        std::fill(history_.begin(), history_.end(), 0.0f);
+        pos_ = 0;
+        time_ = 0;
+    }
+
+    // Dot products over taps padded to a multiple of 8, with independent
+    // partial sums so the loops vectorize without reassociation flags.
+    static float Dot(const float* h, const float* x, size_t len)
+    {
+        float acc[8] = {};
+        for (size_t k = 0; k < len; k += 8)
+            for (size_t j = 0; j < 8; j++)
+                acc[j] += h[k + j] * x[k + j];
+        return ((acc[0] + acc[4]) + (acc[1] + acc[5])) + ((acc[2] + acc[6]) + (acc[3] + acc[7]));
+    }
+
+    static float DotLerp(const float* h0, const float* h1, float t, const float* x, size_t len)
+    {
+        float acc[8] = {};
+        for (size_t k = 0; k < len; k += 8)
+            for (size_t j = 0; j < 8; j++)
+                acc[j] += (h0[k + j] + t * (h1[k + j] - h0[k + j])) * x[k + j];
+        return ((acc[0] + acc[4]) + (acc[1] + acc[5])) + ((acc[2] + acc[6]) + (acc[3] + acc[7]));
+    }
+
+    size_t Resampler::Process(const float* in, size_t frames, float* out)
+    {
+        const size_t len = taps_;
+        const size_t c_count = channels_;
+        const uint64_t one = (uint64_t)phases_ << frac_bits;
+        const uint64_t frac_mask = ((uint64_t)1 << frac_bits) - 1;
+        const float frac_scale = 1.0f / (float)(1ull << frac_bits);
+        size_t produced = 0;
+        for (size_t f = 0; f < frames; f++)
+        {
+            const float* frame = in + f * c_count;
+            for (size_t c = 0; c < c_count; c++)
+            {
+                float* ring = history_.data() + c * 2 * len;
+                ring[pos_] = frame[c];
+                ring[pos_ + len] = frame[c];
+            }
+            pos_ = (pos_ + 1 == len) ? 0 : pos_ + 1;
+
+            // Oldest frame of each channel's window is at pos_.
+            for (; time_ < one; time_ += step_)
+            {
+                float* y = out + produced * c_count;
+                const float* h = bank_.data() + (size_t)(time_ >> frac_bits) * len;
+                float t = (float)(time_ & frac_mask) * frac_scale;
+                if (!interpolate_ || t == 0.0f || c_count > 1)
+                {
+                    if (interpolate_ && t != 0.0f)
+                    {
+                        // Blend the two phases once and share them across channels.
+                        for (size_t k = 0; k < len; k++)
+                            coefficients_[k] = h[k] + t * (h[k + len] - h[k]);
+                        h = coefficients_.data();
+                    }
+                    for (size_t c = 0; c < c_count; c++)
+                        y[c] = Dot(h, history_.data() + c * 2 * len + pos_, len);
+                }
+                else
+                {
+                    y[0] = DotLerp(h, h + len, t, history_.data() + pos_, len);
+                }
+                produced++;
+            }
+            time_ -= one;
+        }
+        return produced;
+    }
+}
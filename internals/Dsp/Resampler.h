@@ -0,0 +1,75 @@
+// Streaming polyphase sample-rate conversion.
+//
+// A windowed-sinc prototype is designed once at `phases` times the input rate
+// and split into a bank of short filters, one per fractional position between
+// input samples. Each output is a single dot product of one phase with the
+// most recent input frames, so no intermediate upsampled signal exists and
+// nothing is allocated after construction.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Dsp
+{
+    struct ResamplerSpec
+    {
+        size_t taps = 32;               // Input samples per output at ratio >= 1, grows as 1/ratio when decimating
+        size_t phases = 256;            // Arbitrary-ratio bank size at ratio >= 1, shrinks with the ratio
+        double passband = 0.9;          // Cutoff as a fraction of the lower Nyquist frequency
+        double stopband_db = 80.0;      // Kaiser window attenuation
+    };
+
+    class Resampler
+    {
+    public:
+        Resampler() = default;
+        // Exact rational conversion by up/down (reduced internally): one
+        // phase per output position, no interpolation between phases.
+        Resampler(size_t up, size_t down, size_t channels, const ResamplerSpec& spec = {});
+        // Arbitrary ratio (output rate / input rate). Positions between
+        // phases are linearly interpolated across adjacent phases.
+        Resampler(double ratio, size_t channels, const ResamplerSpec& spec = {});
+
+        size_t Channels() const { return channels_; }
+        double Ratio() const { return (double)phases_ / ((double)step_ / (double)(1ull << frac_bits)); }
+        // Group delay in input samples.
+        double Delay() const { return 0.5 * (double)taps_ - 0.5 / (double)phases_; }
+
+        // Retunes an arbitrary-ratio resampler (e.g. to follow a drifting
+        // display rate) without touching the bank. The anti-aliasing cutoff
+        // stays where the constructor put it, so keep changes to a few percent
+        // or leave headroom in spec.passband.
+        void SetRatio(double ratio);
+
+        // Upper bound on the outputs produced by consuming `frames` frames.
+        size_t MaxOutput(size_t frames) const;
+
+        void Reset();
+        // Consumes `frames` interleaved input frames and writes the outputs
+        // that became available; returns how many output frames were written
+        // (never more than MaxOutput(frames)).
+        size_t Process(const float* in, size_t frames, float* out);
+
+    private:
+        static constexpr unsigned frac_bits = 32;
+
+        void Build(size_t phases, double cutoff, double ratio, const ResamplerSpec& spec);
+
+        size_t channels_ = 0;
+        size_t taps_ = 0;
+        size_t phases_ = 0;
+        bool interpolate_ = false;
+        std::vector<float> bank_;           // (phases + 1) x taps, each phase reversed to weigh the oldest frame first
+        std::vector<float> history_;        // Per-channel input rings, stored twice: [channel][2 * taps]
+        std::vector<float> coefficients_;   // Interpolated phase shared by all channels of one output
+        size_t pos_ = 0;
+        // Position of the next output after the newest input, in units of
+        // 1 / (phases * 2^frac_bits) input samples; an output is due while it
+        // is below one input sample.
+        uint64_t time_ = 0;
+        uint64_t step_ = 0;
+    };
+}
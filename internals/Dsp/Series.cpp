@@ -0,0 +1,180 @@
+#include "Dsp/Series.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numbers>
+
+namespace Dsp
+{
+    const char* SeriesTypeName(SeriesType type)
+    {
+        switch (type)
+        {
+            case SeriesType::Square: return "square";
+            case SeriesType::Sawtooth: return "sawtooth";
+            case SeriesType::Triangle: return "triangle";
+        }
+        return "?";
+    }
+
+    bool SeriesTypeFromName(const char* name, SeriesType& out)
+    {
+        for (SeriesType type : { SeriesType::Square, SeriesType::Sawtooth, SeriesType::Triangle })
+            if (strcmp(name, SeriesTypeName(type)) == 0)
+            {
+                out = type;
+                return true;
+            }
+        return false;
+    }
+
+    void MakeSeries(SeriesType type, size_t terms, float amplitude, Epicycle* out)
+    {
+        const double pi = std::numbers::pi;
+        for (size_t i = 0; i < terms; i++)
+        {
+            Epicycle& c = out[i];
+            c.phase = 0.0f;
+            switch (type)
+            {
+                case SeriesType::Square:
+                {
+                    double n = (double)(2 * i + 1);
+                    c.radius = (float)(amplitude * 4.0 / (n * pi));
+                    c.harmonic = -(int32_t)(2 * i + 1);
+                    break;
+                }
+                case SeriesType::Sawtooth:
+                {
+                    // Alternating signs as a half-turn phase
+                    double n = (double)(i + 1);
+                    c.radius = (float)(amplitude * 2.0 / (n * pi));
+                    c.harmonic = -(int32_t)(i + 1);
+                    c.phase = (i & 1) ? (float)pi : 0.0f;
+                    break;
+                }
+                case SeriesType::Triangle:
+                {
+                    double n = (double)(2 * i + 1);
+                    c.radius = (float)(amplitude * 8.0 / (n * n * pi * pi));
+                    c.harmonic = -(int32_t)(2 * i + 1);
+                    c.phase = (i & 1) ? (float)pi : 0.0f;
+                    break;
+                }
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    // Coefficients
+    //-------------------------------------------------------------------------
+
+    static void KeepLargest(std::vector<Epicycle>& circles, size_t max_terms)
+    {
+        std::stable_sort(circles.begin(), circles.end(), [](const Epicycle& a, const Epicycle& b) { return a.radius > b.radius; });
+        if (max_terms != 0 && circles.size() > max_terms)
+            circles.resize(max_terms);
+    }
+
+    std::vector<Epicycle> CurveSeries(const Complex* points, size_t n, size_t max_terms)
+    {
+        std::vector<Epicycle> circles;
+        if (n == 0)
+            return circles;
+        std::vector<Complex> spectrum(points, points + n);
+        FftPlan(n).Forward(spectrum.data());
+        circles.resize(n);
+        for (size_t k = 0; k < n; k++)
+        {
+            Complex c = spectrum[k] / (float)n;
+            circles[k].radius = std::abs(c);
+            circles[k].phase = std::arg(c);
+            circles[k].harmonic = (k <= n / 2) ? (int32_t)k : (int32_t)k - (int32_t)n;
+        }
+        KeepLargest(circles, max_terms);
+        return circles;
+    }
+
+    std::vector<Epicycle> SignalSeries(const float* samples, size_t n, size_t max_terms)
+    {
+        std::vector<Epicycle> circles;
+        if (n == 0)
+            return circles;
+        RealFftPlan plan(n);
+        std::vector<Complex> spectrum(plan.SpectrumSize());
+        plan.Forward(samples, spectrum.data());
+        circles.resize(spectrum.size());
+        for (size_t k = 0; k < spectrum.size(); k++)
+        {
+            // Bins other than DC and Nyquist stand for a conjugate pair. The
+            // quarter turn moves the cosine series onto the y axis.
+            bool paired = k != 0 && 2 * k != n;
+            Complex c = spectrum[k] * ((paired ? 2.0f : 1.0f) / (float)n) * Complex(0.0f, 1.0f);
+            circles[k].radius = std::abs(c);
+            circles[k].phase = std::arg(c);
+            circles[k].harmonic = (int32_t)k;
+        }
+        KeepLargest(circles, max_terms);
+        return circles;
+    }
+
+    //-------------------------------------------------------------------------
+    // Periodic synthesis
+    //-------------------------------------------------------------------------
+
+    PeriodicRate ApproximateRate(double frequency, double sample_rate, uint64_t max_period)
+    {
+        PeriodicRate rate;
+        if (!(frequency > 0.0) || !(sample_rate > 0.0))
+            return rate;
+        max_period = std::max<uint64_t>(max_period, 1);
+        // Convergents p / q of the continued fraction of x
+        double x = frequency / sample_rate;
+        double r = x;
+        uint64_t p0 = 0, q0 = 1, p1 = 1, q1 = 0;
+        for (int i = 0; i < 64; i++)
+        {
+            double a = std::floor(r);
+            if (a > 9.0e15 || (q1 != 0 && a > (double)((max_period - q0) / q1)))
+                break;
+            uint64_t ai = (uint64_t)a;
+            uint64_t p2 = ai * p1 + p0, q2 = ai * q1 + q0;
+            p0 = p1; q0 = q1;
+            p1 = p2; q1 = q2;
+            double fraction = r - a;
+            if (fraction < 1e-12 || std::fabs(x - (double)p1 / (double)q1) <= x * 1e-15)
+                break;
+            r = 1.0 / fraction;
+        }
+        rate.cycles = p1;
+        rate.period = q1;
+        return rate;
+    }
+
+    double Frequency(PeriodicRate rate, double sample_rate)
+    {
+        return sample_rate * (double)rate.cycles / (double)rate.period;
+    }
+
+    void SynthesizePeriod(const Epicycle* circles, size_t count, PeriodicRate rate, Complex* out, bool band_limit)
+    {
+        size_t period = (size_t)rate.period;
+        std::fill(out, out + period, Complex(0.0f, 0.0f));
+        // Sample j of circle c is r e^(i phase) e^(2 pi i j h cycles / period):
+        // bin (h cycles mod period) of an inverse DFT
+        int64_t p = (int64_t)period;
+        for (size_t i = 0; i < count; i++)
+        {
+            const Epicycle& c = circles[i];
+            if (band_limit && 2 * (uint64_t)std::abs((int64_t)c.harmonic) * rate.cycles >= rate.period)
+                continue;
+            int64_t bin = ((int64_t)c.harmonic % p) * (int64_t)(rate.cycles % (uint64_t)p) % p;
+            if (bin < 0)
+                bin += p;
+            out[bin] += std::polar(c.radius, c.phase);
+        }
+        if (period > 1)
+            FftPlan(period).Inverse(out);
+    }
+}
@@ -0,0 +1,66 @@
+// Fourier series as epicycle chains: the classic waveforms, coefficients of
+// sampled signals and curves, and fast synthesis of long sample streams.
+//
+// Every chain here has integer harmonics, so sampled at a rate that is a
+// rational multiple of its fundamental it repeats exactly after `period`
+// samples. SynthesizePeriod computes that period with one inverse FFT, which
+// places each circle in its bin, instead of evaluating every term at every
+// sample; long outputs are the period repeated.
+
+#pragma once
+
+#include "Dsp/Epicycles.h"
+#include "Dsp/Fft.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Dsp
+{
+    enum class SeriesType
+    {
+        Square,
+        Sawtooth,
+        Triangle,
+    };
+
+    const char* SeriesTypeName(SeriesType type);
+    // Case-sensitive match of SeriesTypeName; false for unknown names.
+    bool SeriesTypeFromName(const char* name, SeriesType& out);
+
+    // The first `terms` circles of a unit-amplitude waveform, in the
+    // clockwise convention of the Circle Window (negative harmonics). The
+    // waveform is the y coordinate of the tip.
+    void MakeSeries(SeriesType type, size_t terms, float amplitude, Epicycle* out);
+
+    // Circles of a closed curve sampled at n points, one revolution per
+    // period: the n DFT coefficients, harmonics in (-n/2, n/2], keeping the
+    // `max_terms` largest (all when 0), largest first.
+    std::vector<Epicycle> CurveSeries(const Complex* points, size_t n, size_t max_terms = 0);
+
+    // Circles of a real signal of n samples, one revolution per period: the
+    // one-sided spectrum (harmonics 0..n/2, positive frequencies doubled),
+    // phased so the y coordinate of the tip is the signal, as for MakeSeries.
+    // Largest first, as above.
+    std::vector<Epicycle> SignalSeries(const float* samples, size_t n, size_t max_terms = 0);
+
+    // The chain turns `cycles` times every `period` samples.
+    struct PeriodicRate
+    {
+        uint64_t cycles = 0;
+        uint64_t period = 1;
+    };
+
+    // frequency / sample_rate as the closest fraction with a denominator of
+    // at most max_period (continued fractions). The error in Hz is
+    // Frequency(rate, sample_rate) - frequency.
+    PeriodicRate ApproximateRate(double frequency, double sample_rate, uint64_t max_period = 1 << 22);
+    double Frequency(PeriodicRate rate, double sample_rate);
+
+    // Writes the rate.period samples of the tip, sample j at fundamental
+    // angle 2 pi j cycles / period. With band_limit, circles whose harmonic
+    // turns at least half a turn per sample are left out instead of aliasing.
+    // Exact up to float rounding; cost O(count + period log period).
+    void SynthesizePeriod(const Epicycle* circles, size_t count, PeriodicRate rate, Complex* out, bool band_limit = true);
+}
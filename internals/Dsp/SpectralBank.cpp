@@ -0,0 +1,314 @@
+#include "Dsp/SpectralBank.h"
+#include "Dsp/OscillatorBank.h"
+
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <cmath>
+#include <numbers>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define SPECTRAL_SSE2 1
+#else
+#define SPECTRAL_SSE2 0
+#endif
+
+namespace Dsp
+{
+    static constexpr size_t lobe_resolution = 64;   // Table steps per bin
+    static constexpr size_t lobe_bins = 8;          // Bins written per partial
+
+    // 4-term Blackman-Harris, centred on sample 0: sidelobes below -92 dB,
+    // main lobe +-4 bins
+    static constexpr double window_terms[4] = { 0.35875, 0.48829, 0.14128, 0.01168 };
+
+    static double Window(double n, size_t size)
+    {
+        double x = two_pi * n / (double)size;
+        return window_terms[0] + window_terms[1] * std::cos(x) + window_terms[2] * std::cos(2.0 * x) +
+               window_terms[3] * std::cos(3.0 * x);
+    }
+
+    // sum_{n = -size/2}^{size/2 - 1} exp(-2 pi i v n / size), v in bins.
+    static std::complex<double> Dirichlet(double v, size_t size)
+    {
+        double denominator = std::sin(std::numbers::pi * v / (double)size);
+        if (std::fabs(denominator) < 1e-12)
+            return (double)size;
+        double magnitude = std::sin(std::numbers::pi * v) / denominator;
+        return std::polar(magnitude, std::numbers::pi * v / (double)size);
+    }
+
+    SpectralBank::SpectralBank(size_t capacity, double sample_rate, size_t hop)
+        : capacity_(std::max<size_t>(capacity, 1)), sample_rate_(sample_rate),
+          hop_(std::bit_ceil(std::max<size_t>(hop, 16))), size_(4 * hop_), plan_(size_)
+    {
+        for (std::vector<float>* v : { &phase_, &radius_, &amp_, &bin_, &zr_, &zi_, &wr_, &wi_ })
+            v->assign(capacity_, 0.0f);
+        harmonic_.assign(capacity_, 0);
+
+        // The window is a sum of seven complex exponentials, so its spectrum
+        // is seven shifted Dirichlet kernels
+        lobe_.resize(2 * lobe_bins * (lobe_resolution + 2));
+        for (size_t q = 0; q < lobe_resolution + 2; q++)
+            for (size_t j = 0; j < lobe_bins; j++)
+            {
+                double u = (double)j - 3.0 - (double)(lobe_resolution - q) / (double)lobe_resolution;
+                std::complex<double> sum = window_terms[0] * Dirichlet(u, size_);
+                for (int m = 1; m < 4; m++)
+                    sum += 0.5 * window_terms[m] * (Dirichlet(u - m, size_) + Dirichlet(u + m, size_));
+                sum /= (double)size_;
+                lobe_[2 * (lobe_bins * q + j)] = (float)sum.real();
+                lobe_[2 * (lobe_bins * q + j) + 1] = (float)sum.imag();
+            }
+        ola_.resize(2 * hop_);
+        for (size_t j = 0; j < 2 * hop_; j++)
+        {
+            double n = (double)j - (double)hop_;
+            ola_[j] = (float)((1.0 - std::fabs(n) / (double)hop_) / Window(n, size_));
+        }
+        frame_.assign(size_, Complex());
+        tail_.assign(hop_, 0.0f);
+        ready_.assign(hop_, 0.0f);
+        read_ = hop_;
+    }
+
+    void SpectralBank::SetSampleRate(double sample_rate)
+    {
+        sample_rate_ = sample_rate;
+        Retarget();
+    }
+
+    void SpectralBank::SetSeries(const Epicycle* circles, size_t count, double fundamental, float gain)
+    {
+        count = std::min(count, capacity_);
+        for (size_t i = 0; i < count; i++)
+        {
+            bool moved = i >= count_ || harmonic_[i] != circles[i].harmonic || phase_[i] != circles[i].phase;
+            harmonic_[i] = circles[i].harmonic;
+            phase_[i] = circles[i].phase;
+            radius_[i] = circles[i].radius;
+            if (moved)
+                Resync(i, i + 1);
+        }
+        // Dropped partials fade out under the triangles of the next hop
+        for (size_t i = count; i < count_; i++)
+            amp_[i] = 0.0f;
+        count_ = count;
+        fundamental_ = fundamental;
+        gain_ = gain;
+        Retarget();
+    }
+
+    void SpectralBank::SetLimit(size_t limit)
+    {
+        if (limit == limit_)
+            return;
+        limit_ = limit;
+        Retarget();
+    }
+
+    void SpectralBank::Retarget()
+    {
+        double step = two_pi * fundamental_ * (double)hop_ / sample_rate_;
+        double bins = fundamental_ * (double)size_ / sample_rate_;
+        double nyquist = 0.5 * sample_rate_;
+        active_ = 0;
+        for (size_t i = 0; i < count_; i++)
+        {
+            double rotation = ReduceAngle((double)harmonic_[i] * step);
+            wr_[i] = (float)std::cos(rotation);
+            wi_[i] = (float)std::sin(rotation);
+            bin_[i] = (float)((double)harmonic_[i] * bins);
+            bool audible = i < limit_ && std::fabs((double)harmonic_[i] * fundamental_) < nyquist;
+            float amp = audible ? radius_[i] * gain_ : 0.0f;
+            // Silent partials are not advanced; they come back in phase
+            if (amp != 0.0f && amp_[i] == 0.0f)
+                Resync(i, i + 1);
+            amp_[i] = amp;
+            if (amp != 0.0f)
+                active_++;
+        }
+    }
+
+    // Phasors of [begin, end) set from the exact phase at the last frame.
+    void SpectralBank::Resync(size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; i++)
+        {
+            double angle = ReduceAngle((double)harmonic_[i] * theta_ + (double)phase_[i]);
+            zr_[i] = (float)std::cos(angle);
+            zi_[i] = (float)std::sin(angle);
+        }
+    }
+
+    void SpectralBank::Reset(double theta)
+    {
+        theta_ = ReduceAngle(theta - two_pi * fundamental_ * (double)hop_ / sample_rate_);
+        Resync(0, count_);
+        std::fill(tail_.begin(), tail_.end(), 0.0f);
+        // The frame centred on `theta` completes nothing yet; its second half
+        // waits in tail_ for the next one
+        NextFrame();
+        read_ = hop_;
+    }
+
+    double SpectralBank::Phase() const
+    {
+        return ReduceAngle(theta_ - (double)(hop_ - read_) * two_pi * fundamental_ / sample_rate_);
+    }
+
+    void SpectralBank::Render(float* out, size_t frames)
+    {
+        for (size_t done = 0; done < frames;)
+        {
+            if (read_ == hop_)
+            {
+                NextFrame();
+                read_ = 0;
+            }
+            size_t n = std::min(hop_ - read_, frames - done);
+            std::copy(ready_.begin() + read_, ready_.begin() + read_ + n, out + done);
+            read_ += n;
+            done += n;
+        }
+    }
+
+    // One frame, hop samples after the last: its first half completes ready_,
+    // its second half becomes tail_.
+    void SpectralBank::NextFrame()
+    {
+        theta_ = std::fmod(theta_ + two_pi * fundamental_ * (double)hop_ / sample_rate_, two_pi);
+        std::fill(frame_.begin(), frame_.end(), Complex());
+        float* frame = (float*)frame_.data();
+        const float* lobe = lobe_.data();
+        size_t mask = size_ - 1;
+        for (size_t i = 0; i < count_; i++)
+        {
+            if (amp_[i] == 0.0f)
+                continue;
+            float r = zr_[i] * wr_[i] - zi_[i] * wi_[i];
+            zi_[i] = zr_[i] * wi_[i] + zi_[i] * wr_[i];
+            zr_[i] = r;
+
+            // a sin(w n + psi) is the real part of a exp(i (psi - pi/2)) exp(i w n);
+            // a negative frequency is mirrored: sin(-w n + psi) = sin(w n + pi - psi)
+            float a = amp_[i];
+            float f = bin_[i];
+            float cr = a * zi_[i];
+            float ci = f >= 0.0f ? -a * zr_[i] : a * zr_[i];
+            f = std::fabs(f);
+            float floor = std::floor(f);
+            float position = (1.0f - (f - floor)) * (float)lobe_resolution;
+            size_t q = (size_t)position;
+            float t = position - (float)q;
+            // Interpolated lobe times the partial's phasor, added to eight
+            // consecutive bins; both paths round identically
+            const float* row = lobe + 2 * lobe_bins * q;
+            size_t bin = (size_t)floor + size_ - 3;
+            if ((bin & mask) + lobe_bins <= size_)
+            {
+                float* dst = frame + 2 * (bin & mask);
+#if SPECTRAL_SSE2
+                __m128 vt = _mm_set1_ps(t), vr = _mm_set1_ps(cr), vi = _mm_setr_ps(-ci, ci, -ci, ci);
+                for (size_t j = 0; j < 2 * lobe_bins; j += 4)
+                {
+                    __m128 l0 = _mm_loadu_ps(row + j);
+                    __m128 l = _mm_add_ps(l0, _mm_mul_ps(vt, _mm_sub_ps(_mm_loadu_ps(row + 2 * lobe_bins + j), l0)));
+                    __m128 swapped = _mm_shuffle_ps(l, l, _MM_SHUFFLE(2, 3, 0, 1));
+                    __m128 sum = _mm_add_ps(_mm_mul_ps(l, vr), _mm_mul_ps(swapped, vi));
+                    _mm_storeu_ps(dst + j, _mm_add_ps(_mm_loadu_ps(dst + j), sum));
+                }
+#else
+                for (size_t j = 0; j < 2 * lobe_bins; j += 2)
+                {
+                    float lr = row[j] + t * (row[2 * lobe_bins + j] - row[j]);
+                    float li = row[j + 1] + t * (row[2 * lobe_bins + j + 1] - row[j + 1]);
+                    dst[j] += lr * cr + li * -ci;
+                    dst[j + 1] += li * cr + lr * ci;
+                }
+#endif
+            }
+            else
+            {
+                // The lobe wraps around bin 0
+                for (size_t j = 0; j < lobe_bins; j++)
+                {
+                    float lr = row[2 * j] + t * (row[2 * lobe_bins + 2 * j] - row[2 * j]);
+                    float li = row[2 * j + 1] + t * (row[2 * lobe_bins + 2 * j + 1] - row[2 * j + 1]);
+                    float* dst = frame + 2 * ((bin + j) & mask);
+                    dst[0] += lr * cr + li * -ci;
+                    dst[1] += li * cr + lr * ci;
+                }
+            }
+        }
+        plan_.Inverse(frame_.data());
+
+        // Sample n of the frame is at index n mod size
+        for (size_t j = 0; j < hop_; j++)
+            ready_[j] = tail_[j] + frame_[size_ - hop_ + j].real() * ola_[j];
+        for (size_t j = 0; j < hop_; j++)
+            tail_[j] = frame_[j].real() * ola_[hop_ + j];
+
+        if (count_ != 0)
+        {
+            size_t slice = std::max<size_t>(32, count_ / 8);
+            if (resync_ >= count_)
+                resync_ = 0;
+            size_t end = std::min(resync_ + slice, count_);
+            Resync(resync_, end);
+            resync_ = end;
+        }
+    }
+
+    //----------------------------------------------------------------------------
+
+    size_t MeasureSpectralCrossover(double sample_rate, size_t frames, size_t hop)
+    {
+        constexpr size_t max_count = 8192;
+        OscillatorBank direct(max_count, sample_rate);
+        SpectralBank spectral(max_count, sample_rate, hop);
+        std::vector<Epicycle> circles(max_count);
+        std::vector<float> out(frames);
+        size_t total = std::max<size_t>(4 * spectral.Hop(), 8 * frames);
+
+        auto time = [&](auto& bank)
+        {
+            double best = 1e30;
+            for (int round = 0; round < 3; round++)
+            {
+                auto start = std::chrono::steady_clock::now();
+                for (size_t done = 0; done < total; done += frames)
+                    bank.Render(out.data(), frames);
+                best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+            }
+            return best;
+        };
+
+        // Cost difference at doubling counts; the crossover is interpolated
+        // between the last count where the direct bank won and the first
+        // where it lost
+        double previous = 0.0;
+        for (size_t count = 16; count <= max_count; count *= 2)
+        {
+            for (size_t i = 0; i < count; i++)
+                circles[i] = Epicycle{ 1.0f / (float)(i + 1), (int32_t)(i + 1), (float)i };
+            double fundamental = 0.45 * sample_rate / (double)count;
+            direct.SetSeries(circles.data(), count, fundamental, 1.0f);
+            direct.Reset();
+            spectral.SetSeries(circles.data(), count, fundamental, 1.0f);
+            spectral.Reset();
+            double margin = time(direct) - time(spectral);
+            if (margin > 0.0)
+            {
+                if (count == 16)
+                    return count;
+                double t = -previous / (margin - previous);
+                return (size_t)std::lround((double)count * std::exp2(t - 1.0));
+            }
+            previous = margin;
+        }
+        return (size_t)-1;
+    }
+}
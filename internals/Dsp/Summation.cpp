@@ -0,0 +1,155 @@
+#include "Dsp/Summation.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace Dsp
+{
+    static constexpr size_t lanes = 8;
+    static constexpr size_t pairwise_block = 128;  // Leaf of the pairwise tree, summed in lanes
+    static constexpr size_t prefix_block = 16;     // Sequential run of a pairwise prefix
+
+    static inline void Neumaier(float& sum, float& compensation, float v)
+    {
+        float t = sum + v;
+        compensation += (std::fabs(sum) >= std::fabs(v)) ? (sum - t) + v : (v - t) + sum;
+        sum = t;
+    }
+
+    //-------------------------------------------------------------------------
+    // Sums
+    //-------------------------------------------------------------------------
+
+    // Eight independent compensated accumulators over blocks of eight. The
+    // rounding error of each addition comes from Knuth's branch-free two-sum,
+    // which is exact like Neumaier's comparison but vectorizes.
+    static void CompensatedLanes(const float* __restrict x, size_t blocks, float* __restrict sum, float* __restrict compensation)
+    {
+        for (size_t k = 0; k < blocks; k++)
+            for (size_t j = 0; j < lanes; j++)
+            {
+                float v = x[k * lanes + j];
+                float t = sum[j] + v;
+                float part = t - sum[j];
+                compensation[j] += (sum[j] - (t - part)) + (v - part);
+                sum[j] = t;
+            }
+    }
+
+    static float PairwiseSum(const float* x, size_t n)
+    {
+        if (n > pairwise_block)
+        {
+            size_t half = (n / 2 + lanes - 1) / lanes * lanes;
+            return PairwiseSum(x, half) + PairwiseSum(x + half, n - half);
+        }
+        float acc[lanes] = {};
+        size_t i = 0;
+        for (; i + lanes <= n; i += lanes)
+            for (size_t j = 0; j < lanes; j++)
+                acc[j] += x[i + j];
+        for (size_t j = 0; i < n; i++, j++)
+            acc[j] += x[i];
+        return ((acc[0] + acc[4]) + (acc[1] + acc[5])) + ((acc[2] + acc[6]) + (acc[3] + acc[7]));
+    }
+
+    float Sum(const float* x, size_t n, Summation mode)
+    {
+        switch (mode)
+        {
+            case Summation::Compensated:
+            {
+                float sum[lanes] = {}, compensation[lanes] = {};
+                size_t blocks = n / lanes;
+                CompensatedLanes(x, blocks, sum, compensation);
+                float total = 0.0f, error = 0.0f;
+                for (size_t j = 0; j < lanes; j++)
+                {
+                    Neumaier(total, error, sum[j]);
+                    error += compensation[j];
+                }
+                for (size_t i = blocks * lanes; i < n; i++)
+                    Neumaier(total, error, x[i]);
+                return total + error;
+            }
+            case Summation::Pairwise:
+                return PairwiseSum(x, n);
+            case Summation::Naive:
+            default:
+            {
+                float total = 0.0f;
+                for (size_t i = 0; i < n; i++)
+                    total += x[i];
+                return total;
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    // Prefix sums
+    //-------------------------------------------------------------------------
+
+    // Sequential prefixes of runs of prefix_block; the run totals are
+    // prefix-summed the same way and added back as offsets, so each output
+    // is about log_block(n) short sequential sums deep.
+    static void PairwisePrefix(const float* x, size_t n, float* out, float* scratch)
+    {
+        size_t runs = (n + prefix_block - 1) / prefix_block;
+        for (size_t r = 0; r < runs; r++)
+        {
+            size_t begin = r * prefix_block;
+            size_t end = std::min(n, begin + prefix_block);
+            float sum = 0.0f;
+            for (size_t i = begin; i < end; i++)
+                out[i] = sum += x[i];
+            scratch[r] = sum;
+        }
+        if (runs <= 1)
+            return;
+        PairwisePrefix(scratch, runs, scratch, scratch + runs);
+        for (size_t r = 1; r < runs; r++)
+        {
+            size_t begin = r * prefix_block;
+            size_t end = std::min(n, begin + prefix_block);
+            float offset = scratch[r - 1];
+            for (size_t i = begin; i < end; i++)
+                out[i] += offset;
+        }
+    }
+
+    void PrefixSum(const float* x, size_t n, float* out, Summation mode)
+    {
+        switch (mode)
+        {
+            case Summation::Compensated:
+            {
+                float sum = 0.0f, compensation = 0.0f;
+                for (size_t i = 0; i < n; i++)
+                {
+                    Neumaier(sum, compensation, x[i]);
+                    out[i] = sum + compensation;
+                }
+                break;
+            }
+            case Summation::Pairwise:
+            {
+                // Each level needs ceil(n / block^k) totals.
+                thread_local std::vector<float> scratch;
+                size_t needed = n / (prefix_block - 1) + 64;
+                if (scratch.size() < needed)
+                    scratch.resize(needed);
+                PairwisePrefix(x, n, out, scratch.data());
+                break;
+            }
+            case Summation::Naive:
+            default:
+            {
+                float sum = 0.0f;
+                for (size_t i = 0; i < n; i++)
+                    out[i] = sum += x[i];
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,30 @@
+// Accurate float summation.
+//
+// Naive left-to-right float summation has a worst-case error that grows
+// linearly with the number of terms. Compensated (Kahan-Neumaier) summation
+// carries the rounding error of every addition in a second accumulator and is
+// accurate to about one rounding regardless of length; pairwise summation
+// adds in a balanced tree so the error grows with log2(n). Both run in
+// independent lanes that the compiler vectorizes, so on arrays they are no
+// slower than the sequential naive loop.
+
+#pragma once
+
+#include <cstddef>
+
+namespace Dsp
+{
+    enum class Summation
+    {
+        Naive,          // Left to right, the reference order of a plain loop
+        Compensated,    // Kahan-Neumaier
+        Pairwise,       // Balanced tree over blocks
+    };
+
+    float Sum(const float* x, size_t n, Summation mode);
+
+    // Inclusive prefix sums: out[i] = x[0] + ... + x[i]. in == out is allowed.
+    // Compensated prefixes are sequential with a running error term;
+    // pairwise prefixes sum fixed blocks and recurse on the block totals.
+    void PrefixSum(const float* x, size_t n, float* out, Summation mode);
+}
@@ -0,0 +1,398 @@
+#include "Dsp/Wavelet.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <complex>
+
+namespace Dsp
+{
+    //-------------------------------------------------------------------------
+    // Filters
+    //-------------------------------------------------------------------------
+
+    // JPEG 2000 irreversible 9/7 lifting constants.
+    static const float cdf97_alpha = -1.586134342059924f;
+    static const float cdf97_beta = -0.052980118572961f;
+    static const float cdf97_gamma = 0.882911075530934f;
+    static const float cdf97_delta = 0.443506852043971f;
+    static const float cdf97_k = 1.149604398860241f;
+
+    // Matching analysis filters, both ending on the same input sample.
+    static const float cdf97_low[9] = {
+        0.026748757411f, -0.016864118443f, -0.078223266529f, 0.266864118443f, 0.602949018236f,
+        0.266864118443f, -0.078223266529f, -0.016864118443f, 0.026748757411f };
+    static const float cdf97_high[7] = {
+        0.091271763114f, -0.057543526229f, -0.591271763114f, 1.115087052457f,
+        -0.591271763114f, -0.057543526229f, 0.091271763114f };
+
+    std::vector<double> DaubechiesLowpass(int order)
+    {
+        assert(order >= 1 && order <= 10);
+        using C = std::complex<double>;
+        const int n = order;
+
+        // P(y) = sum_{k<N} C(N-1+k, k) y^k; its roots give the zeros of |Q|^2.
+        std::vector<double> p(n);
+        for (int k = 0; k < n; k++)
+        {
+            double c = 1.0;
+            for (int j = 1; j <= k; j++)
+                c = c * (double)(n - 1 + j) / (double)j;
+            p[k] = c;
+        }
+
+        // Durand-Kerner on the monic form of P.
+        int degree = n - 1;
+        std::vector<C> roots(degree);
+        for (int i = 0; i < degree; i++)
+            roots[i] = std::pow(C(0.4, 0.9), i);
+        for (int iter = 0; iter < 500; iter++)
+        {
+            for (int i = 0; i < degree; i++)
+            {
+                C num = 1.0;
+                for (int k = degree - 1; k >= 0; k--)
+                    num = num * roots[i] + p[k] / p[degree];
+                C den = 1.0;
+                for (int j = 0; j < degree; j++)
+                    if (j != i)
+                        den *= roots[i] - roots[j];
+                roots[i] -= num / den;
+            }
+        }
+
+        // y = (2 - z - 1/z) / 4; keep the root inside the unit circle (minimum phase).
+        std::vector<C> poly = { C(1.0) };
+        for (const C& y : roots)
+        {
+            C b = 1.0 - 2.0 * y;
+            C s = std::sqrt(b * b - 1.0);
+            C z = (std::abs(b + s) < 1.0) ? b + s : b - s;
+            std::vector<C> next(poly.size() + 1, C(0.0));
+            for (size_t i = 0; i < poly.size(); i++)
+            {
+                next[i] -= z * poly[i];
+                next[i + 1] += poly[i];
+            }
+            poly = next;
+        }
+        for (int i = 0; i < n; i++)
+        {
+            std::vector<C> next(poly.size() + 1, C(0.0));
+            for (size_t j = 0; j < poly.size(); j++)
+            {
+                next[j] += poly[j];
+                next[j + 1] += poly[j];
+            }
+            poly = next;
+        }
+
+        std::vector<double> h(poly.size());
+        double sum = 0.0;
+        for (size_t i = 0; i < poly.size(); i++)
+        {
+            h[i] = poly[poly.size() - 1 - i].real();
+            sum += h[i];
+        }
+        for (double& v : h)
+            v *= std::sqrt(2.0) / sum;
+        return h;
+    }
+
+    WaveletFilter GetWaveletFilter(const Wavelet& wavelet)
+    {
+        WaveletFilter f;
+        switch (wavelet.type)
+        {
+            case WaveletType::Cdf97:
+                f.low.assign(std::begin(cdf97_low), std::end(cdf97_low));
+                f.high.assign(std::begin(cdf97_high), std::end(cdf97_high));
+                return f;
+            case WaveletType::Haar:
+            case WaveletType::Daubechies:
+            {
+                // Orthogonal: quadrature mirror high-pass g[k] = (-1)^(k+1) h[L-1-k],
+                // the sign the Haar and D4 lifting steps produce (Haar: (odd - even) / sqrt(2)).
+                int order = (wavelet.type == WaveletType::Haar) ? 1 : wavelet.order;
+                std::vector<double> h = DaubechiesLowpass(order);
+                size_t len = h.size();
+                f.low.resize(len);
+                f.high.resize(len);
+                for (size_t k = 0; k < len; k++)
+                {
+                    f.low[k] = (float)h[k];
+                    f.high[k] = (float)((k & 1) ? h[len - 1 - k] : -h[len - 1 - k]);
+                }
+                return f;
+            }
+        }
+        return f;
+    }
+
+    //-------------------------------------------------------------------------
+    // Lifting steps on the strided even/odd halves of one level.
+    // e(i) = data[2i * stride], o(i) = data[(2i + 1) * stride], i < half.
+    //-------------------------------------------------------------------------
+
+    // o(i) += c * (e(i) + e(i + 1)), e(half) mirrored to e(half - 1)
+    static void PredictSymmetric(float* data, size_t stride, size_t half, float c)
+    {
+        size_t s2 = 2 * stride;
+        for (size_t i = 0; i + 1 < half; i++)
+            data[i * s2 + stride] += c * (data[i * s2] + data[(i + 1) * s2]);
+        data[(half - 1) * s2 + stride] += 2.0f * c * data[(half - 1) * s2];
+    }
+
+    // e(i) += c * (o(i - 1) + o(i)), o(-1) mirrored to o(0)
+    static void UpdateSymmetric(float* data, size_t stride, size_t half, float c)
+    {
+        size_t s2 = 2 * stride;
+        data[0] += 2.0f * c * data[stride];
+        for (size_t i = 1; i < half; i++)
+            data[i * s2] += c * (data[(i - 1) * s2 + stride] + data[i * s2 + stride]);
+    }
+
+    static void ScaleHalves(float* data, size_t stride, size_t half, float even, float odd)
+    {
+        size_t s2 = 2 * stride;
+        for (size_t i = 0; i < half; i++)
+        {
+            data[i * s2] *= even;
+            data[i * s2 + stride] *= odd;
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    // DwtPlan
+    //-------------------------------------------------------------------------
+
+    DwtPlan::DwtPlan(const Wavelet& wavelet, size_t n, int levels)
+        : wavelet_(wavelet), n_(n), levels_(levels), filter_(GetWaveletFilter(wavelet))
+    {
+        assert(levels >= 1);
+        assert(n % ((size_t)1 << levels) == 0);
+    }
+
+    void DwtPlan::Forward(float* data) const
+    {
+        for (int l = 0; l < levels_; l++)
+            ForwardLevel(data, (size_t)1 << l, n_ >> l);
+    }
+
+    void DwtPlan::Inverse(float* data) const
+    {
+        for (int l = levels_ - 1; l >= 0; l--)
+            InverseLevel(data, (size_t)1 << l, n_ >> l);
+    }
+
+    void DwtPlan::ForwardLevel(float* data, size_t stride, size_t m) const
+    {
+        const float sqrt2 = 1.41421356237309505f;
+        const float sqrt3 = 1.73205080756887729f;
+        size_t half = m / 2;
+        size_t s2 = 2 * stride;
+
+        if (wavelet_.type == WaveletType::Haar)
+        {
+            for (size_t i = 0; i < half; i++)
+            {
+                float& e = data[i * s2];
+                float& o = data[i * s2 + stride];
+                o -= e;
+                e += 0.5f * o;
+            }
+            ScaleHalves(data, stride, half, sqrt2, 1.0f / sqrt2);
+            return;
+        }
+
+        if (wavelet_.type == WaveletType::Cdf97)
+        {
+            PredictSymmetric(data, stride, half, cdf97_alpha);
+            UpdateSymmetric(data, stride, half, cdf97_beta);
+            PredictSymmetric(data, stride, half, cdf97_gamma);
+            UpdateSymmetric(data, stride, half, cdf97_delta);
+            ScaleHalves(data, stride, half, cdf97_k, 1.0f / cdf97_k);
+            return;
+        }
+
+        if (wavelet_.order == 2)
+        {
+            // Daubechies D4 factorization (Daubechies & Sweldens), periodic.
+            for (size_t i = 0; i < half; i++)
+                data[i * s2] += sqrt3 * data[i * s2 + stride];
+            for (size_t i = 0; i < half; i++)
+            {
+                size_t prev = (i == 0) ? half - 1 : i - 1;
+                data[i * s2 + stride] -= (sqrt3 / 4.0f) * data[i * s2] + ((sqrt3 - 2.0f) / 4.0f) * data[prev * s2];
+            }
+            for (size_t i = 0; i < half; i++)
+            {
+                size_t next = (i + 1 == half) ? 0 : i + 1;
+                data[i * s2] -= data[next * s2 + stride];
+            }
+            ScaleHalves(data, stride, half, (sqrt3 - 1.0f) / sqrt2, (sqrt3 + 1.0f) / sqrt2);
+            return;
+        }
+
+        // Generic orthogonal filter bank, periodized. The gathered level is
+        // extended by the filter length so the inner loop never wraps.
+        size_t len = filter_.low.size();
+        thread_local std::vector<float> x;
+        if (x.size() < m + len)
+            x.resize(m + len);
+        for (size_t p = 0; p < m; p++)
+            x[p] = data[p * stride];
+        for (size_t p = 0; p < len; p++)
+            x[m + p] = x[p % m];
+        for (size_t i = 0; i < half; i++)
+        {
+            const float* window = x.data() + 2 * i;
+            float a = 0.0f, d = 0.0f;
+            for (size_t k = 0; k < len; k++)
+            {
+                a += filter_.low[k] * window[k];
+                d += filter_.high[k] * window[k];
+            }
+            data[i * s2] = a;
+            data[i * s2 + stride] = d;
+        }
+    }
+
+    void DwtPlan::InverseLevel(float* data, size_t stride, size_t m) const
+    {
+        const float sqrt2 = 1.41421356237309505f;
+        const float sqrt3 = 1.73205080756887729f;
+        size_t half = m / 2;
+        size_t s2 = 2 * stride;
+
+        if (wavelet_.type == WaveletType::Haar)
+        {
+            ScaleHalves(data, stride, half, 1.0f / sqrt2, sqrt2);
+            for (size_t i = 0; i < half; i++)
+            {
+                float& e = data[i * s2];
+                float& o = data[i * s2 + stride];
+                e -= 0.5f * o;
+                o += e;
+            }
+            return;
+        }
+
+        if (wavelet_.type == WaveletType::Cdf97)
+        {
+            ScaleHalves(data, stride, half, 1.0f / cdf97_k, cdf97_k);
+            UpdateSymmetric(data, stride, half, -cdf97_delta);
+            PredictSymmetric(data, stride, half, -cdf97_gamma);
+            UpdateSymmetric(data, stride, half, -cdf97_beta);
+            PredictSymmetric(data, stride, half, -cdf97_alpha);
+            return;
+        }
+
+        if (wavelet_.order == 2)
+        {
+            ScaleHalves(data, stride, half, sqrt2 / (sqrt3 - 1.0f), sqrt2 / (sqrt3 + 1.0f));
+            for (size_t i = 0; i < half; i++)
+            {
+                size_t next = (i + 1 == half) ? 0 : i + 1;
+                data[i * s2] += data[next * s2 + stride];
+            }
+            for (size_t i = 0; i < half; i++)
+            {
+                size_t prev = (i == 0) ? half - 1 : i - 1;
+                data[i * s2 + stride] += (sqrt3 / 4.0f) * data[i * s2] + ((sqrt3 - 2.0f) / 4.0f) * data[prev * s2];
+            }
+            for (size_t i = 0; i < half; i++)
+                data[i * s2] -= sqrt3 * data[i * s2 + stride];
+            return;
+        }
+
+        // Transpose of the periodized analysis bank (orthogonal, so it is the inverse).
+        size_t len = filter_.low.size();
+        thread_local std::vector<float> x;
+        if (x.size() < m + len)
+            x.resize(m + len);
+        std::fill(x.begin(), x.begin() + m + len, 0.0f);
+        for (size_t i = 0; i < half; i++)
+        {
+            float a = data[i * s2];
+            float d = data[i * s2 + stride];
+            float* window = x.data() + 2 * i;
+            for (size_t k = 0; k < len; k++)
+                window[k] += filter_.low[k] * a + filter_.high[k] * d;
+        }
+        for (size_t p = 0; p < len; p++)
+            x[p % m] += x[m + p];
+        for (size_t p = 0; p < m; p++)
+            data[p * stride] = x[p];
+    }
+
+    //-------------------------------------------------------------------------
+    // StreamingDwt
+    //-------------------------------------------------------------------------
+
+    StreamingDwt::StreamingDwt(const Wavelet& wavelet, int levels, size_t history)
+        : wavelet_(wavelet), filter_(GetWaveletFilter(wavelet)), levels_(levels)
+    {
+        assert(levels >= 1);
+        size_t len = std::max(filter_.low.size(), filter_.high.size());
+        for (int l = 0; l < levels; l++)
+        {
+            levels_[l].input.assign(2 * len, 0.0f);
+            levels_[l].output.assign(std::max<size_t>(1, history >> (l + 1)), 0.0f);
+        }
+    }
+
+    void StreamingDwt::Reset()
+    {
+        for (Level& level : levels_)
+        {
+            std::fill(level.input.begin(), level.input.end(), 0.0f);
+            std::fill(level.output.begin(), level.output.end(), 0.0f);
+            level.input_pos = level.phase = level.output_pos = level.output_count = 0;
+        }
+    }
+
+    void StreamingDwt::Push(float sample)
+    {
+        for (Level& level : levels_)
+        {
+            // The history is stored twice so the filter window is always contiguous.
+            size_t len = level.input.size() / 2;
+            level.input[level.input_pos] = sample;
+            level.input[level.input_pos + len] = sample;
+            level.input_pos = (level.input_pos + 1 == len) ? 0 : level.input_pos + 1;
+            level.phase ^= 1;
+            if (level.phase != 0)
+                return;
+
+            // Both filters end on the newest sample; input_pos is now the oldest.
+            const float* window = level.input.data() + level.input_pos;
+            const float* low_window = window + (len - filter_.low.size());
+            const float* high_window = window + (len - filter_.high.size());
+            float a = 0.0f, d = 0.0f;
+            for (size_t k = 0; k < filter_.low.size(); k++)
+                a += filter_.low[k] * low_window[k];
+            for (size_t k = 0; k < filter_.high.size(); k++)
+                d += filter_.high[k] * high_window[k];
+
+            level.output[level.output_pos] = d;
+            level.output_pos = (level.output_pos + 1) % level.output.size();
+            if (level.output_count < level.output.size())
+                level.output_count++;
+            sample = a;
+        }
+    }
+
+    size_t StreamingDwt::DetailCount(int level) const
+    {
+        return levels_[level - 1].output_count;
+    }
+
+    float StreamingDwt::Detail(int level, size_t age) const
+    {
+        const Level& l = levels_[level - 1];
+        size_t cap = l.output.size();
+        return l.output[(l.output_pos + cap - 1 - (age % cap)) % cap];
+    }
+}
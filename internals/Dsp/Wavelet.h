@@ -0,0 +1,110 @@
+// Discrete wavelet transforms: in-place multi-level block transforms and a
+// streaming filter-bank cascade for incrementally arriving samples.
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+namespace Dsp
+{
+    enum class WaveletType
+    {
+        Haar,           // Orthonormal Haar, lifting
+        Daubechies,     // Daubechies-N (N vanishing moments, 2N taps). N == 2 uses the D4 lifting scheme
+        Cdf97,          // Cohen-Daubechies-Feauveau 9/7 (JPEG 2000), lifting
+    };
+
+    struct Wavelet
+    {
+        WaveletType type = WaveletType::Haar;
+        int order = 1;  // Daubechies N in [1, 10], ignored otherwise
+    };
+
+    // Analysis filters of a wavelet. low/high are applied as correlations
+    // (y[i] = sum_k low[k] * x[2i + k]), synthesis filters are their duals.
+    struct WaveletFilter
+    {
+        std::vector<float> low;
+        std::vector<float> high;
+    };
+
+    WaveletFilter GetWaveletFilter(const Wavelet& wavelet);
+
+    // Daubechies-N scaling filter (2N taps, sum sqrt(2)) from the spectral
+    // factorization of the maximally flat half-band polynomial.
+    std::vector<double> DaubechiesLowpass(int order);
+
+    // Multi-level DWT of a fixed-size signal, computed in place.
+    // Coefficients stay interleaved the way the lifting steps leave them:
+    // after `levels` levels, approximation i sits at ApproxIndex(i) and detail
+    // i of level l (1 = finest) at DetailIndex(l, i). No memory is allocated
+    // per call for the lifting wavelets; Daubechies-N with N != 2 runs a
+    // periodic filter bank through a thread-local scratch of n samples.
+    // n must be divisible by 2^levels. Boundaries are periodic, except for
+    // CDF 9/7 which uses whole-sample symmetric extension.
+    class DwtPlan
+    {
+    public:
+        DwtPlan(const Wavelet& wavelet, size_t n, int levels);
+
+        size_t Size() const { return n_; }
+        int Levels() const { return levels_; }
+
+        void Forward(float* data) const;
+        void Inverse(float* data) const;
+
+        // Number of detail coefficients at level l (1 = finest).
+        size_t DetailCount(int level) const { return n_ >> level; }
+        size_t ApproxCount() const { return n_ >> levels_; }
+        size_t DetailIndex(int level, size_t i) const { return ((2 * i + 1) << (level - 1)); }
+        size_t ApproxIndex(size_t i) const { return i << levels_; }
+
+    private:
+        void ForwardLevel(float* data, size_t stride, size_t m) const;
+        void InverseLevel(float* data, size_t stride, size_t m) const;
+
+        Wavelet wavelet_;
+        size_t n_ = 0;
+        int levels_ = 0;
+        WaveletFilter filter_;
+    };
+
+    // Causal multi-level DWT over an unbounded stream. Each level keeps only
+    // its filter history and a fixed ring of recent output coefficients, so
+    // memory stays constant no matter how many samples are pushed.
+    // Level l (1 = finest) emits one detail coefficient every 2^l samples;
+    // the ring of level l holds history >> l of them, so every level covers
+    // the same span of `history` input samples.
+    class StreamingDwt
+    {
+    public:
+        StreamingDwt(const Wavelet& wavelet, int levels, size_t history);
+
+        void Push(float sample);
+        void Reset();
+
+        int Levels() const { return (int)levels_.size(); }
+        const Wavelet& GetWavelet() const { return wavelet_; }
+
+        // Number of stored detail coefficients of a level.
+        size_t DetailCount(int level) const;
+        // Detail coefficient of a level by age: 0 = newest.
+        float Detail(int level, size_t age) const;
+
+    private:
+        struct Level
+        {
+            std::vector<float> input;   // Circular input history, filter length, stored twice
+            size_t input_pos = 0;
+            size_t phase = 0;           // Samples seen modulo 2
+            std::vector<float> output;  // Circular detail history
+            size_t output_pos = 0;
+            size_t output_count = 0;
+        };
+
+        Wavelet wavelet_;
+        WaveletFilter filter_;
+        std::vector<Level> levels_;
+    };
+}
@@ -0,0 +1,39 @@
+#include "Raster/Export.h"
+
+#include <algorithm>
+#include <future>
+#include <vector>
+
+namespace Raster
+{
+    bool ExportScene(const Scene& scene, const ExportSettings& settings, ImageWriter& writer, Core::ThreadPool* pool,
+                     const std::function<bool(int rows)>& progress)
+    {
+        int band_rows = std::max(settings.band_rows, 1);
+        size_t band_pixels = (size_t)settings.width * (size_t)band_rows;
+        std::vector<uint32_t> bands[2] = { std::vector<uint32_t>(band_pixels), std::vector<uint32_t>(band_pixels) };
+        Rasterizer rasterizer;
+        std::future<bool> pending;
+        bool ok = true;
+
+        for (int row = 0, band = 0; row < settings.height && ok; row += band_rows, band ^= 1)
+        {
+            int rows = std::min(band_rows, settings.height - row);
+            Target target{ bands[band].data(), settings.width, rows, settings.width, 0, row };
+            Fill(target, settings.background, pool);
+            rasterizer.Draw(scene, target, pool);
+
+            // The previous band must be out before its buffer is reused next
+            // iteration; this one is written while the next is rasterized.
+            if (pending.valid())
+                ok = pending.get() && (!progress || progress(row));
+            if (!ok)
+                break;
+            const uint32_t* pixels = bands[band].data();
+            pending = std::async(std::launch::async, [&writer, pixels, rows, width = settings.width] { return writer.WriteRows(pixels, rows, width); });
+        }
+        if (pending.valid())
+            ok = pending.get() && ok && (!progress || progress(settings.height));
+        return writer.Finish() && ok;
+    }
+}
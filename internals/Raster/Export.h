@@ -0,0 +1,33 @@
+// Offline rendering of scenes far larger than the window (posters, 8K frames).
+//
+// The image is produced in horizontal bands: every band is rasterized tile by
+// tile on the thread pool, then handed to the writer, which compresses and
+// writes it on its own thread while the next band is rasterized. Only two
+// bands are in memory at any time.
+
+#pragma once
+
+#include "Core/ThreadPool.h"
+#include "Raster/ImageWriter.h"
+#include "Raster/Rasterizer.h"
+
+#include <functional>
+
+namespace Raster
+{
+    struct ExportSettings
+    {
+        int width = 7680;
+        int height = 4320;
+        Color background = MakeColor(0, 0, 0);
+        int band_rows = 256;
+    };
+
+    // Renders the scene, whose top-left corner is pixel (0, 0) (see
+    // Scene::Transform), into an opened writer and finishes it. `progress` is
+    // called with the number of rows written after every band and may return
+    // false to cancel. False when writing failed or was cancelled (the error
+    // is in writer.Error() for the former).
+    bool ExportScene(const Scene& scene, const ExportSettings& settings, ImageWriter& writer, Core::ThreadPool* pool,
+                     const std::function<bool(int rows)>& progress = {});
+}
@@ -0,0 +1,371 @@
+#include "Raster/ImageWriter.h"
+
+#include <algorithm>
+#include <array>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+
+namespace Raster
+{
+    //-------------------------------------------------------------------------
+    // Checksums and byte order
+    //-------------------------------------------------------------------------
+
+    static constexpr std::array<uint32_t, 256> crc_table = []
+    {
+        std::array<uint32_t, 256> table{};
+        for (uint32_t n = 0; n < 256; n++)
+        {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            table[n] = c;
+        }
+        return table;
+    }();
+
+    uint32_t Crc32(uint32_t crc, const uint8_t* data, size_t size)
+    {
+        crc = ~crc;
+        for (size_t i = 0; i < size; i++)
+            crc = crc_table[(crc ^ data[i]) & 0xFF] ^ (crc >> 8);
+        return ~crc;
+    }
+
+    // Sums reduced every 5552 bytes, the most that cannot overflow 32 bits.
+    uint32_t Adler32(uint32_t adler, const uint8_t* data, size_t size)
+    {
+        uint32_t a = adler & 0xFFFF, b = adler >> 16;
+        for (size_t start = 0; start < size; start += 5552)
+        {
+            size_t end = std::min(size, start + 5552);
+            for (size_t i = start; i < end; i++)
+            {
+                a += data[i];
+                b += a;
+            }
+            a %= 65521;
+            b %= 65521;
+        }
+        return (b << 16) | a;
+    }
+
+    static void StoreBig32(uint8_t* p, uint32_t v)
+    {
+        p[0] = (uint8_t)(v >> 24);
+        p[1] = (uint8_t)(v >> 16);
+        p[2] = (uint8_t)(v >> 8);
+        p[3] = (uint8_t)v;
+    }
+
+    static void StoreLittle16(uint8_t* p, uint16_t v)
+    {
+        p[0] = (uint8_t)v;
+        p[1] = (uint8_t)(v >> 8);
+    }
+
+    static void StoreLittle32(uint8_t* p, uint32_t v)
+    {
+        StoreLittle16(p, (uint16_t)v);
+        StoreLittle16(p + 2, (uint16_t)(v >> 16));
+    }
+
+    ImageFormat FormatFromPath(const char* path)
+    {
+        const char* dot = strrchr(path, '.');
+        char extension[8] = "";
+        for (size_t i = 0; dot != nullptr && dot[i] != '\0' && i + 1 < sizeof(extension); i++)
+            extension[i] = (char)tolower((unsigned char)dot[i]);
+        if (strcmp(extension, ".tif") == 0 || strcmp(extension, ".tiff") == 0)
+            return ImageFormat::Tiff;
+        return ImageFormat::Png;
+    }
+
+    //-------------------------------------------------------------------------
+    // Common
+    //-------------------------------------------------------------------------
+
+    static constexpr size_t idat_chunk_size = 1 << 18;
+    static constexpr size_t tiff_strip_bytes = 1 << 18;
+
+    ImageWriter::~ImageWriter()
+    {
+        if (file_ != nullptr)
+            fclose(file_);
+    }
+
+    bool ImageWriter::Fail(const char* what)
+    {
+        if (!failed_)
+            snprintf(error_, sizeof(error_), "%s: %s", what, errno != 0 ? strerror(errno) : "invalid");
+        failed_ = true;
+        return false;
+    }
+
+    bool ImageWriter::Write(const void* data, size_t size)
+    {
+        if (failed_)
+            return false;
+        if (fwrite(data, 1, size, file_) != size)
+            return Fail("write");
+        return true;
+    }
+
+    bool ImageWriter::Open(const char* path, ImageFormat format, int width, int height)
+    {
+        format_ = format;
+        width_ = width;
+        height_ = height;
+        errno = 0;
+        uint64_t row_bytes = 4 * (uint64_t)width;
+        if (width <= 0 || height <= 0 || width > (1 << 30) || height > (1 << 30))
+            return Fail("image size");
+        if (format == ImageFormat::Tiff && row_bytes * (uint64_t)height > 0xF0000000ull)
+            return Fail("TIFF larger than 4 GiB (use PNG)");
+        file_ = fopen(path, "wb");
+        if (file_ == nullptr)
+            return Fail(path);
+
+        if (format == ImageFormat::Png)
+        {
+            static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+            Write(signature, sizeof(signature));
+            uint8_t ihdr[13] = {};
+            StoreBig32(ihdr, (uint32_t)width);
+            StoreBig32(ihdr + 4, (uint32_t)height);
+            ihdr[8] = 8;        // Bits per channel
+            ihdr[9] = 6;        // RGBA
+            Chunk("IHDR", ihdr, sizeof(ihdr));
+
+            previous_.assign((size_t)row_bytes, 0);
+            filtered_.resize((size_t)row_bytes + 1);
+            idat_.reserve(idat_chunk_size + 64);
+            // zlib header (deflate, 32 KiB window), then one final block with fixed codes
+            idat_.push_back(0x78);
+            idat_.push_back(0x01);
+            PutBits(1, 1);
+            PutBits(1, 2);
+            return !failed_;
+        }
+
+        // TIFF: header, one IFD and the strip tables up front, since
+        // uncompressed strip sizes are known; pixel data follows.
+        uint32_t rows_per_strip = (uint32_t)std::max<uint64_t>(1, tiff_strip_bytes / row_bytes);
+        uint32_t strips = (uint32_t)((height + rows_per_strip - 1) / rows_per_strip);
+        const uint16_t entries = 11;
+        uint32_t ifd_end = 8 + 2 + entries * 12 + 4;
+        uint32_t bits_offset = ifd_end;
+        uint32_t offsets_offset = bits_offset + 8;
+        uint32_t counts_offset = offsets_offset + 4 * strips;
+        uint32_t data_offset = counts_offset + 4 * strips;
+
+        std::vector<uint8_t> head(data_offset, 0);
+        head[0] = 'I';
+        head[1] = 'I';
+        StoreLittle16(&head[2], 42);
+        StoreLittle32(&head[4], 8);
+        StoreLittle16(&head[8], entries);
+        uint8_t* entry = &head[10];
+        auto add = [&](uint16_t tag, uint16_t type, uint32_t count, uint32_t value)
+        {
+            StoreLittle16(entry, tag);
+            StoreLittle16(entry + 2, type);
+            StoreLittle32(entry + 4, count);
+            if (type == 3 && count == 1)
+                StoreLittle16(entry + 8, (uint16_t)value);
+            else
+                StoreLittle32(entry + 8, value);
+            entry += 12;
+        };
+        const uint16_t type_short = 3, type_long = 4;
+        // Tags in ascending order; single values live in the entry itself
+        add(256, type_long, 1, (uint32_t)width);                                 // ImageWidth
+        add(257, type_long, 1, (uint32_t)height);                                // ImageLength
+        add(258, type_short, 4, bits_offset);                                    // BitsPerSample
+        add(259, type_short, 1, 1);                                              // Compression: none
+        add(262, type_short, 1, 2);                                              // Photometric: RGB
+        add(273, type_long, strips, strips == 1 ? data_offset : offsets_offset);  // StripOffsets
+        add(277, type_short, 1, 4);                                              // SamplesPerPixel
+        add(278, type_long, 1, rows_per_strip);                                  // RowsPerStrip
+        uint32_t strip_size = rows_per_strip * (uint32_t)row_bytes;
+        uint32_t last_size = (uint32_t)(height - (strips - 1) * rows_per_strip) * (uint32_t)row_bytes;
+        add(279, type_long, strips, strips == 1 ? last_size : counts_offset);    // StripByteCounts
+        add(284, type_short, 1, 1);                                              // PlanarConfiguration: chunky
+        add(338, type_short, 1, 2);                                              // ExtraSamples: unassociated alpha
+        StoreLittle32(entry, 0);                                                 // No next IFD
+        for (int i = 0; i < 4; i++)
+            StoreLittle16(&head[bits_offset + 2 * i], 8);
+        for (uint32_t s = 0; s < strips; s++)
+        {
+            StoreLittle32(&head[offsets_offset + 4 * s], data_offset + s * strip_size);
+            StoreLittle32(&head[counts_offset + 4 * s], s + 1 == strips ? last_size : strip_size);
+        }
+        return Write(head.data(), head.size());
+    }
+
+    bool ImageWriter::WriteRows(const uint32_t* pixels, int rows, int stride)
+    {
+        if (file_ == nullptr || failed_)
+            return false;
+        if (rows_written_ + rows > height_)
+        {
+            errno = 0;
+            return Fail("more rows than the image height");
+        }
+        size_t row_bytes = 4 * (size_t)width_;
+        for (int r = 0; r < rows; r++)
+        {
+            const uint8_t* row = (const uint8_t*)(pixels + (size_t)r * (size_t)stride);
+            if (format_ == ImageFormat::Tiff)
+            {
+                if (!Write(row, row_bytes))
+                    return false;
+                continue;
+            }
+            // Up filter: mostly zeros wherever the scene is flat vertically
+            filtered_[0] = 2;
+            for (size_t i = 0; i < row_bytes; i++)
+                filtered_[i + 1] = (uint8_t)(row[i] - previous_[i]);
+            memcpy(previous_.data(), row, row_bytes);
+            DeflateBytes(filtered_.data(), filtered_.size());
+            if (idat_.size() >= idat_chunk_size)
+                FlushIdat();
+        }
+        rows_written_ += rows;
+        return !failed_;
+    }
+
+    bool ImageWriter::Finish()
+    {
+        if (file_ == nullptr)
+            return false;
+        if (!failed_ && rows_written_ != height_)
+        {
+            errno = 0;
+            Fail("image incomplete");
+        }
+        if (!failed_ && format_ == ImageFormat::Png)
+        {
+            FlushRun();
+            PutLiteral(256);                    // End of block
+            if (bit_count_ > 0)
+                PutBits(0, 8 - bit_count_);
+            uint8_t adler[4];
+            StoreBig32(adler, adler_);
+            idat_.insert(idat_.end(), adler, adler + 4);
+            FlushIdat();
+            Chunk("IEND", nullptr, 0);
+        }
+        errno = 0;
+        if (fclose(file_) != 0)
+            Fail("close");
+        file_ = nullptr;
+        return !failed_;
+    }
+
+    //-------------------------------------------------------------------------
+    // PNG
+    //-------------------------------------------------------------------------
+
+    void ImageWriter::Chunk(const char type[4], const uint8_t* data, size_t size)
+    {
+        uint8_t header[8];
+        StoreBig32(header, (uint32_t)size);
+        memcpy(header + 4, type, 4);
+        uint32_t crc = Crc32(0, header + 4, 4);
+        if (size > 0)
+            crc = Crc32(crc, data, size);
+        uint8_t trailer[4];
+        StoreBig32(trailer, crc);
+        Write(header, sizeof(header));
+        if (size > 0)
+            Write(data, size);
+        Write(trailer, sizeof(trailer));
+    }
+
+    void ImageWriter::FlushIdat()
+    {
+        if (!idat_.empty())
+            Chunk("IDAT", idat_.data(), idat_.size());
+        idat_.clear();
+    }
+
+    void ImageWriter::PutBits(uint32_t bits, int count)
+    {
+        bit_buffer_ |= (uint64_t)bits << bit_count_;
+        bit_count_ += count;
+        while (bit_count_ >= 8)
+        {
+            idat_.push_back((uint8_t)bit_buffer_);
+            bit_buffer_ >>= 8;
+            bit_count_ -= 8;
+        }
+    }
+
+    // Huffman codes are sent most significant bit first.
+    void ImageWriter::PutCode(uint32_t code, int length)
+    {
+        uint32_t reversed = 0;
+        for (int i = 0; i < length; i++)
+            reversed |= ((code >> i) & 1) << (length - 1 - i);
+        PutBits(reversed, length);
+    }
+
+    // Fixed literal / length code (RFC 1951 3.2.6).
+    void ImageWriter::PutLiteral(uint32_t symbol)
+    {
+        if (symbol < 144)
+            PutCode(0x30 + symbol, 8);
+        else if (symbol < 256)
+            PutCode(0x190 + symbol - 144, 9);
+        else if (symbol < 280)
+            PutCode(symbol - 256, 7);
+        else
+            PutCode(0xC0 + symbol - 280, 8);
+    }
+
+    // A match of 3..258 bytes at distance 1, i.e. repeats of the previous byte.
+    void ImageWriter::PutRun(size_t length)
+    {
+        static const uint16_t base[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+        static const uint8_t extra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+        int k = 28;
+        while (base[k] > length)
+            k--;
+        PutLiteral(257 + (uint32_t)k);
+        if (extra[k] > 0)
+            PutBits((uint32_t)(length - base[k]), extra[k]);
+        PutCode(0, 5);                          // Distance code 0: distance 1
+    }
+
+    void ImageWriter::FlushRun()
+    {
+        while (run_ >= 3)
+        {
+            size_t length = std::min<size_t>(run_, 258);
+            if (run_ - length > 0 && run_ - length < 3)
+                length = run_ - 3;              // Leave a remainder a match can take
+            PutRun(length);
+            run_ -= length;
+        }
+        for (; run_ > 0; run_--)
+            PutLiteral((uint32_t)last_byte_);
+    }
+
+    void ImageWriter::DeflateBytes(const uint8_t* data, size_t size)
+    {
+        adler_ = Adler32(adler_, data, size);
+        for (size_t i = 0; i < size; i++)
+        {
+            if (data[i] == last_byte_)
+            {
+                run_++;
+                continue;
+            }
+            FlushRun();
+            PutLiteral(data[i]);
+            last_byte_ = data[i];
+        }
+    }
+}
@@ -0,0 +1,85 @@
+// Streaming RGBA image files: rows are written as they are produced, so an
+// image never has to exist in memory as a whole.
+//
+// PNG output is 8-bit RGBA, every row filtered with "Up" and deflated with
+// fixed Huffman codes and run-length matches, which shrinks the flat
+// backgrounds and thin strokes of rendered scenes well without zlib. TIFF
+// output is baseline uncompressed RGBA (unassociated alpha) in strips, and is
+// limited to files under 4 GiB.
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace Raster
+{
+    enum class ImageFormat
+    {
+        Png,
+        Tiff,
+    };
+
+    // From the extension of `path` (.png, .tif, .tiff); PNG otherwise.
+    ImageFormat FormatFromPath(const char* path);
+
+    // The PNG checksums, continued from their value for the bytes before
+    // `data` (0 for CRC-32, 1 for Adler-32 when there are none): CRC-32 of
+    // every chunk, Adler-32 of the zlib stream.
+    uint32_t Crc32(uint32_t crc, const uint8_t* data, size_t size);
+    uint32_t Adler32(uint32_t adler, const uint8_t* data, size_t size);
+
+    class ImageWriter
+    {
+    public:
+        ImageWriter() = default;
+        ~ImageWriter();
+
+        ImageWriter(const ImageWriter&) = delete;
+        ImageWriter& operator=(const ImageWriter&) = delete;
+
+        // Creates the file and writes the header. False (see Error()) when the
+        // file cannot be created or the size is not representable.
+        bool Open(const char* path, ImageFormat format, int width, int height);
+        // Appends rows of pixels in IM_COL32 byte order (R, G, B, A in memory).
+        bool WriteRows(const uint32_t* pixels, int rows, int stride);
+        // Writes the trailer and closes the file; every row must have been written.
+        bool Finish();
+
+        int RowsWritten() const { return rows_written_; }
+        const char* Error() const { return error_; }
+
+    private:
+        bool Fail(const char* what);
+        bool Write(const void* data, size_t size);
+
+        // PNG
+        void Chunk(const char type[4], const uint8_t* data, size_t size);
+        void DeflateBytes(const uint8_t* data, size_t size);
+        void PutBits(uint32_t bits, int count);
+        void PutCode(uint32_t code, int length);
+        void PutLiteral(uint32_t symbol);
+        void PutRun(size_t length);
+        void FlushRun();
+        void FlushIdat();
+
+        FILE* file_ = nullptr;
+        ImageFormat format_ = ImageFormat::Png;
+        int width_ = 0;
+        int height_ = 0;
+        int rows_written_ = 0;
+        bool failed_ = false;
+        char error_[160] = "";
+
+        std::vector<uint8_t> previous_;     // Last row, for the Up filter
+        std::vector<uint8_t> filtered_;     // Filter byte + filtered row
+        std::vector<uint8_t> idat_;         // Compressed bytes waiting for the next IDAT chunk
+        uint64_t bit_buffer_ = 0;
+        int bit_count_ = 0;
+        int last_byte_ = -1;                // Byte the pending run repeats, -1 before the first
+        size_t run_ = 0;                    // Repeats of last_byte_ not yet emitted
+        uint32_t adler_ = 1;
+    };
+}
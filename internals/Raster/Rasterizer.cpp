@@ -0,0 +1,417 @@
+#include "Raster/Rasterizer.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+#include <emmintrin.h>
+#define RASTER_SSE2 1
+#else
+#define RASTER_SSE2 0
+#endif
+
+namespace Raster
+{
+    //-------------------------------------------------------------------------
+    // Scene
+    //-------------------------------------------------------------------------
+
+    void Scene::AddCircle(float cx, float cy, float radius, Color color, float thickness)
+    {
+        Shape s;
+        s.kind = ShapeKind::Ring;
+        s.color = color;
+        s.x0 = cx;
+        s.y0 = cy;
+        s.radius = radius;
+        s.half_width = std::max(0.5f * thickness, 0.5f);
+        s.weight = std::clamp(thickness, 0.0f, 1.0f);
+        shapes_.push_back(s);
+    }
+
+    void Scene::AddDisc(float cx, float cy, float radius, Color color)
+    {
+        Shape s;
+        s.kind = ShapeKind::Disc;
+        s.color = color;
+        s.x0 = cx;
+        s.y0 = cy;
+        s.radius = radius;
+        shapes_.push_back(s);
+    }
+
+    void Scene::AddLine(float x0, float y0, float x1, float y1, Color color, float thickness)
+    {
+        Shape s;
+        s.kind = ShapeKind::Line;
+        s.color = color;
+        s.x0 = x0;
+        s.y0 = y0;
+        s.x1 = x1;
+        s.y1 = y1;
+        s.half_width = std::max(0.5f * thickness, 0.5f);
+        s.weight = std::clamp(thickness, 0.0f, 1.0f);
+        shapes_.push_back(s);
+    }
+
+    void Scene::Transform(float scale, float offset_x, float offset_y)
+    {
+        for (Shape& s : shapes_)
+        {
+            s.x0 = s.x0 * scale + offset_x;
+            s.y0 = s.y0 * scale + offset_y;
+            s.x1 = s.x1 * scale + offset_x;
+            s.y1 = s.y1 * scale + offset_y;
+            s.radius *= scale;
+            // Stroke width is 2 * half_width, faded by weight below one pixel
+            float thickness = (s.weight < 1.0f ? s.weight : 2.0f * s.half_width) * scale;
+            s.half_width = std::max(0.5f * thickness, 0.5f);
+            s.weight = std::clamp(thickness, 0.0f, 1.0f);
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    // Coverage
+    //-------------------------------------------------------------------------
+
+    // A shape in the form the inner loops use. Coverage of a pixel centre at
+    // distance d from the shape's edge is clamp(edge - d, 0, 1), turned into a
+    // blend factor in [0, 256] by alpha_scale.
+    struct Prepared
+    {
+        ShapeKind kind;
+        float cx, cy;           // Centre, or line start
+        float ex, ey;           // Line direction (end - start)
+        float inv_length2;      // 1 / |e|^2, 0 for a point
+        float radius;
+        float edge;             // Distance from the centre line / circle where coverage reaches zero
+        float alpha_scale;
+        uint32_t rgb;           // Colour with alpha forced opaque
+    };
+
+    static Prepared Prepare(const Shape& s)
+    {
+        Prepared p;
+        p.kind = s.kind;
+        p.cx = s.x0;
+        p.cy = s.y0;
+        p.ex = s.x1 - s.x0;
+        p.ey = s.y1 - s.y0;
+        float length2 = p.ex * p.ex + p.ey * p.ey;
+        p.inv_length2 = (length2 > 0.0f) ? 1.0f / length2 : 0.0f;
+        p.radius = s.radius;
+        p.edge = (s.kind == ShapeKind::Disc) ? s.radius + 0.5f : s.half_width + 0.5f;
+        p.alpha_scale = s.weight * (float)(s.color >> 24) * (256.0f / 255.0f);
+        p.rgb = s.color | 0xFF000000u;
+        return p;
+    }
+
+    // Scene-space bounds outside which coverage is zero.
+    static void Bounds(const Shape& s, float& x0, float& y0, float& x1, float& y1)
+    {
+        float pad = (s.kind == ShapeKind::Disc) ? s.radius + 1.0f
+                  : (s.kind == ShapeKind::Ring) ? s.radius + s.half_width + 1.0f
+                  : s.half_width + 1.0f;
+        x0 = std::min(s.x0, s.kind == ShapeKind::Line ? s.x1 : s.x0) - pad;
+        x1 = std::max(s.x0, s.kind == ShapeKind::Line ? s.x1 : s.x0) + pad;
+        y0 = std::min(s.y0, s.kind == ShapeKind::Line ? s.y1 : s.y0) - pad;
+        y1 = std::max(s.y0, s.kind == ShapeKind::Line ? s.y1 : s.y0) + pad;
+    }
+
+    // Whether a shape can cover any pixel of the scene rectangle [x0, x1) x [y0, y1).
+    static bool Touches(const Shape& s, float x0, float y0, float x1, float y1)
+    {
+        if (s.kind == ShapeKind::Line)
+        {
+            // Distance from the rectangle's centre to the segment, against its half diagonal.
+            float hx = 0.5f * (x1 - x0), hy = 0.5f * (y1 - y0);
+            float qx = x0 + hx - s.x0, qy = y0 + hy - s.y0;
+            float ex = s.x1 - s.x0, ey = s.y1 - s.y0;
+            float length2 = ex * ex + ey * ey;
+            float t = (length2 > 0.0f) ? std::clamp((qx * ex + qy * ey) / length2, 0.0f, 1.0f) : 0.0f;
+            float dx = qx - t * ex, dy = qy - t * ey;
+            float reach = std::sqrt(hx * hx + hy * hy) + s.half_width + 1.0f;
+            return dx * dx + dy * dy <= reach * reach;
+        }
+        float nx = std::clamp(s.x0, x0, x1) - s.x0, ny = std::clamp(s.y0, y0, y1) - s.y0;
+        float near2 = nx * nx + ny * ny;
+        float outer = s.radius + (s.kind == ShapeKind::Ring ? s.half_width : 0.0f) + 1.0f;
+        if (near2 > outer * outer)
+            return false;
+        if (s.kind == ShapeKind::Disc)
+            return true;
+        // Rectangles entirely inside a ring's hole are skipped.
+        float fx = std::max(std::fabs(x0 - s.x0), std::fabs(x1 - s.x0));
+        float fy = std::max(std::fabs(y0 - s.y0), std::fabs(y1 - s.y0));
+        float inner = s.radius - s.half_width - 1.0f;
+        return inner <= 0.0f || fx * fx + fy * fy >= inner * inner;
+    }
+
+    // Blend factor of the pixel centre at scene x = origin_x + column; the
+    // SSE2 path below performs the same operations lane-wise, so both give
+    // identical pixels.
+    static inline int CoverageScalar(const Prepared& p, float origin_x, float column, float py)
+    {
+        float dx = (origin_x - p.cx) + column, dy = py - p.cy;
+        float d;
+        if (p.kind == ShapeKind::Line)
+        {
+            float t = std::min(std::max((dx * p.ex + dy * p.ey) * p.inv_length2, 0.0f), 1.0f);
+            float rx = dx - t * p.ex, ry = dy - t * p.ey;
+            d = std::sqrt(rx * rx + ry * ry);
+        }
+        else
+        {
+            d = std::sqrt(dx * dx + dy * dy);
+            if (p.kind == ShapeKind::Ring)
+                d = std::fabs(d - p.radius);
+        }
+        float coverage = std::min(std::max(p.edge - d, 0.0f), 1.0f);
+        return (int)std::lrint(coverage * p.alpha_scale);
+    }
+
+    static inline uint32_t BlendScalar(uint32_t dst, uint32_t src, int a)
+    {
+        uint32_t out = 0;
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            uint32_t d = (dst >> shift) & 0xFF, s = (src >> shift) & 0xFF;
+            out |= ((d * (uint32_t)(256 - a) + s * (uint32_t)a + 128) >> 8) << shift;
+        }
+        return out;
+    }
+
+#if RASTER_SSE2
+    // Blend factors of four horizontally adjacent pixel centres.
+    static inline __m128i Coverage4(const Prepared& p, float origin_x, float column, float py)
+    {
+        __m128 x = _mm_add_ps(_mm_set1_ps(origin_x - p.cx), _mm_setr_ps(column, column + 1.0f, column + 2.0f, column + 3.0f));
+        __m128 dy = _mm_set1_ps(py - p.cy);
+        __m128 zero = _mm_setzero_ps();
+        __m128 d;
+        if (p.kind == ShapeKind::Line)
+        {
+            __m128 ex = _mm_set1_ps(p.ex), ey = _mm_set1_ps(p.ey);
+            __m128 t = _mm_mul_ps(_mm_add_ps(_mm_mul_ps(x, ex), _mm_mul_ps(dy, ey)), _mm_set1_ps(p.inv_length2));
+            t = _mm_min_ps(_mm_max_ps(t, zero), _mm_set1_ps(1.0f));
+            __m128 rx = _mm_sub_ps(x, _mm_mul_ps(t, ex));
+            __m128 ry = _mm_sub_ps(dy, _mm_mul_ps(t, ey));
+            d = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(rx, rx), _mm_mul_ps(ry, ry)));
+        }
+        else
+        {
+            d = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(dy, dy)));
+            if (p.kind == ShapeKind::Ring)
+                d = _mm_and_ps(_mm_sub_ps(d, _mm_set1_ps(p.radius)), _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF)));
+        }
+        __m128 coverage = _mm_min_ps(_mm_max_ps(_mm_sub_ps(_mm_set1_ps(p.edge), d), zero), _mm_set1_ps(1.0f));
+        return _mm_cvtps_epi32(_mm_mul_ps(coverage, _mm_set1_ps(p.alpha_scale)));
+    }
+
+    // dst = (dst * (256 - a) + src * a + 128) >> 8 per channel, in 16-bit lanes.
+    static inline void Blend4(uint32_t* pixels, uint32_t src, __m128i a)
+    {
+        __m128i zero = _mm_setzero_si128();
+        __m128i dst = _mm_loadu_si128((const __m128i*)pixels);
+        __m128i s = _mm_unpacklo_epi8(_mm_set1_epi32((int)src), zero);
+        __m128i a16 = _mm_packs_epi32(a, a);
+        __m128i a_pairs = _mm_unpacklo_epi16(a16, a16);
+        __m128i a01 = _mm_unpacklo_epi32(a_pairs, a_pairs);
+        __m128i a23 = _mm_unpackhi_epi32(a_pairs, a_pairs);
+        __m128i full = _mm_set1_epi16(256), round = _mm_set1_epi16(128);
+        __m128i d01 = _mm_unpacklo_epi8(dst, zero);
+        __m128i d23 = _mm_unpackhi_epi8(dst, zero);
+        d01 = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(d01, _mm_sub_epi16(full, a01)), _mm_mullo_epi16(s, a01)), round), 8);
+        d23 = _mm_srli_epi16(_mm_add_epi16(_mm_add_epi16(_mm_mullo_epi16(d23, _mm_sub_epi16(full, a23)), _mm_mullo_epi16(s, a23)), round), 8);
+        _mm_storeu_si128((__m128i*)pixels, _mm_packus_epi16(d01, d23));
+    }
+#endif
+
+    //-------------------------------------------------------------------------
+    // Spans
+    //-------------------------------------------------------------------------
+
+    // floor(v) clamped to [lo, hi] before the conversion, so shapes far
+    // off the target cannot overflow the int.
+    static inline int ClampedFloor(float v, int lo, int hi)
+    {
+        return (int)std::clamp(std::floor(v), (float)lo, (float)hi);
+    }
+
+    // Target columns in [c0, c1) whose pixel centres may lie in the scene
+    // interval [lo, hi]; empty when first >= last.
+    static inline void Columns(float lo, float hi, float origin_x, int c0, int c1, int& first, int& last)
+    {
+        first = ClampedFloor(lo - origin_x, c0, c1);
+        last = ClampedFloor(hi - origin_x + 2.0f, c0, c1);
+    }
+
+    // Blends columns [first, last) of one row, four at a time.
+    static void Span(const Prepared& p, uint32_t* row, int first, int last, float origin_x, float py)
+    {
+        int c = first;
+#if RASTER_SSE2
+        for (; c + 4 <= last; c += 4)
+        {
+            __m128i a = Coverage4(p, origin_x, (float)c + 0.5f, py);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(a, _mm_setzero_si128())) == 0xFFFF)
+                continue;
+            Blend4(row + c, p.rgb, a);
+        }
+#endif
+        for (; c < last; c++)
+        {
+            int a = CoverageScalar(p, origin_x, (float)c + 0.5f, py);
+            if (a != 0)
+                row[c] = BlendScalar(row[c], p.rgb, a);
+        }
+    }
+
+    static void RasterizeTile(const Shape* shapes, const std::vector<uint32_t>& bin, const Target& target, int tile_x, int tile_y, int tile_size)
+    {
+        int c0 = tile_x, c1 = std::min(tile_x + tile_size, target.width);
+        int r0 = tile_y, r1 = std::min(tile_y + tile_size, target.height);
+        float origin_x = (float)target.x, origin_y = (float)target.y;
+        for (uint32_t index : bin)
+        {
+            const Shape& s = shapes[index];
+            Prepared p = Prepare(s);
+            float bx0, by0, bx1, by1;
+            Bounds(s, bx0, by0, bx1, by1);
+            int row_first = ClampedFloor(by0 - origin_y, r0, r1);
+            int row_last = ClampedFloor(by1 - origin_y + 2.0f, r0, r1);
+            for (int r = row_first; r < row_last; r++)
+            {
+                uint32_t* row = target.pixels + (size_t)r * (size_t)target.stride;
+                float py = origin_y + (float)r + 0.5f;
+                float dy = py - p.cy;
+                if (s.kind == ShapeKind::Line)
+                {
+                    // Columns within `edge` of the infinite line through the
+                    // segment, intersected with the bounds.
+                    float lo = bx0, hi = bx1;
+                    float length = std::sqrt(p.ex * p.ex + p.ey * p.ey);
+                    if (std::fabs(p.ey) > 1e-3f * length)
+                    {
+                        float x_at = p.cx + dy * p.ex / p.ey;
+                        float half = p.edge * length / std::fabs(p.ey);
+                        lo = std::max(lo, x_at - half - 1.0f);
+                        hi = std::min(hi, x_at + half + 1.0f);
+                    }
+                    int first, last;
+                    Columns(lo, hi, origin_x, c0, c1, first, last);
+                    Span(p, row, first, last, origin_x, py);
+                    continue;
+                }
+                float outer = (s.kind == ShapeKind::Disc) ? p.edge + 0.5f : p.radius + p.edge + 0.5f;
+                if (dy * dy >= outer * outer)
+                    continue;
+                float half = std::sqrt(outer * outer - dy * dy);
+                float inner = (s.kind == ShapeKind::Ring) ? p.radius - p.edge - 0.5f : 0.0f;
+                if (inner > 0.0f && dy * dy < inner * inner)
+                {
+                    // Both arcs of the ring, skipping the hole; the right arc
+                    // starts after the left one so no pixel blends twice.
+                    float hole = std::sqrt(inner * inner - dy * dy);
+                    int first, last, second_first, second_last;
+                    Columns(p.cx - half, p.cx - hole, origin_x, c0, c1, first, last);
+                    Columns(p.cx + hole, p.cx + half, origin_x, c0, c1, second_first, second_last);
+                    Span(p, row, first, last, origin_x, py);
+                    Span(p, row, std::max(second_first, last), second_last, origin_x, py);
+                }
+                else
+                {
+                    int first, last;
+                    Columns(p.cx - half, p.cx + half, origin_x, c0, c1, first, last);
+                    Span(p, row, first, last, origin_x, py);
+                }
+            }
+        }
+    }
+
+    //-------------------------------------------------------------------------
+    // Rasterizer
+    //-------------------------------------------------------------------------
+
+    void Fill(const Target& target, Color color, Core::ThreadPool* pool)
+    {
+        auto rows = [&](size_t begin, size_t end)
+        {
+            for (size_t r = begin; r < end; r++)
+                std::fill_n(target.pixels + r * (size_t)target.stride, target.width, color);
+        };
+        if (pool != nullptr)
+            pool->ParallelFor((size_t)target.height, rows, 64);
+        else
+            rows(0, (size_t)target.height);
+    }
+
+    void ScaleAlpha(const Target& target, int factor, Core::ThreadPool* pool)
+    {
+        uint32_t f = (uint32_t)std::clamp(factor, 0, 256);
+        auto rows = [&](size_t begin, size_t end)
+        {
+            for (size_t r = begin; r < end; r++)
+            {
+                uint32_t* row = target.pixels + r * (size_t)target.stride;
+                for (int c = 0; c < target.width; c++)
+                    row[c] = (row[c] & 0x00FFFFFFu) | ((((row[c] >> 24) * f) >> 8) << 24);
+            }
+        };
+        if (pool != nullptr)
+            pool->ParallelFor((size_t)target.height, rows, 64);
+        else
+            rows(0, (size_t)target.height);
+    }
+
+    Rasterizer::Rasterizer(int tile_size)
+        : tile_size_((std::max(tile_size, 4) + 3) & ~3)
+    {
+    }
+
+    void Rasterizer::Draw(const Scene& scene, const Target& target, Core::ThreadPool* pool)
+    {
+        assert(target.stride >= target.width);
+        if (scene.Size() == 0 || target.width <= 0 || target.height <= 0)
+            return;
+        int tiles_x = (target.width + tile_size_ - 1) / tile_size_;
+        int tiles_y = (target.height + tile_size_ - 1) / tile_size_;
+        bins_.resize((size_t)tiles_x * (size_t)tiles_y);
+        for (std::vector<uint32_t>& bin : bins_)
+            bin.clear();
+
+        // Binning, in scene order so every tile blends in the order shapes were added.
+        const Shape* shapes = scene.Shapes();
+        float tile = (float)tile_size_;
+        for (size_t i = 0; i < scene.Size(); i++)
+        {
+            float x0, y0, x1, y1;
+            Bounds(shapes[i], x0, y0, x1, y1);
+            int tx0 = ClampedFloor((x0 - (float)target.x) / tile, 0, tiles_x);
+            int ty0 = ClampedFloor((y0 - (float)target.y) / tile, 0, tiles_y);
+            int tx1 = ClampedFloor((x1 - (float)target.x) / tile, -1, tiles_x - 1);
+            int ty1 = ClampedFloor((y1 - (float)target.y) / tile, -1, tiles_y - 1);
+            for (int ty = ty0; ty <= ty1; ty++)
+            {
+                for (int tx = tx0; tx <= tx1; tx++)
+                {
+                    float sx = (float)target.x + (float)tx * tile, sy = (float)target.y + (float)ty * tile;
+                    if (Touches(shapes[i], sx, sy, sx + tile, sy + tile))
+                        bins_[(size_t)ty * (size_t)tiles_x + (size_t)tx].push_back((uint32_t)i);
+                }
+            }
+        }
+
+        auto tiles = [&](size_t begin, size_t end)
+        {
+            for (size_t t = begin; t < end; t++)
+                if (!bins_[t].empty())
+                    RasterizeTile(shapes, bins_[t], target, (int)(t % (size_t)tiles_x) * tile_size_, (int)(t / (size_t)tiles_x) * tile_size_, tile_size_);
+        };
+        if (pool != nullptr)
+            pool->ParallelFor(bins_.size(), tiles, 1);
+        else
+            tiles(0, bins_.size());
+    }
+}
@@ -0,0 +1,179 @@
+#include "AudioOutput.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+AudioOutput::AudioOutput()
+    : bank_(max_partials), spectral_(max_partials)
+{
+    params_.ForEach([](Params& p) { p.circles.reserve(max_partials); });
+    last_.circles.reserve(max_partials);
+}
+
+AudioOutput::~AudioOutput()
+{
+    Close();
+}
+
+bool AudioOutput::Open(int buffer_frames)
+{
+    Close();
+    error_[0] = '\0';
+    if (SDL_InitSubSystem(SDL_INIT_AUDIO) != 0)
+    {
+        snprintf(error_, sizeof(error_), "%s", SDL_GetError());
+        return false;
+    }
+    SDL_AudioSpec want, have;
+    memset(&want, 0, sizeof(want));
+    want.freq = 48000;
+    want.format = AUDIO_F32SYS;
+    want.channels = 1;
+    want.samples = (Uint16)buffer_frames;
+    want.callback = Callback;
+    want.userdata = this;
+    // SDL converts channels if it must; the block size and rate are taken as given
+    device_ = SDL_OpenAudioDevice(nullptr, 0, &want, &have, SDL_AUDIO_ALLOW_FREQUENCY_CHANGE | SDL_AUDIO_ALLOW_SAMPLES_CHANGE);
+    if (device_ == 0)
+    {
+        snprintf(error_, sizeof(error_), "%s", SDL_GetError());
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        return false;
+    }
+    sample_rate_ = have.freq;
+    buffer_frames_ = have.samples;
+    // Paused until here, so the callback cannot race these
+    crossover_ = Dsp::MeasureSpectralCrossover((double)have.freq, (size_t)have.samples, spectral_.Hop());
+    bank_.SetSampleRate((double)have.freq);
+    spectral_.SetSampleRate((double)have.freq);
+    fade_.assign((size_t)have.samples, 0.0f);
+    limit_ = max_partials;
+    load_ = 0.0f;
+    peak_load_ = 0.0f;
+    late_blocks_ = 0;
+    SDL_PauseAudioDevice(device_, 0);
+    return true;
+}
+
+void AudioOutput::Close()
+{
+    // Each open device holds one reference on the audio subsystem
+    if (device_ != 0)
+    {
+        SDL_CloseAudioDevice(device_);     // Returns once the callback has finished
+        SDL_QuitSubSystem(SDL_INIT_AUDIO);
+    }
+    device_ = 0;
+}
+
+void AudioOutput::SetSeries(const Dsp::Epicycle* circles, size_t count, float fundamental, float gain)
+{
+    count = std::min(count, max_partials);
+    auto same = [](const Dsp::Epicycle& a, const Dsp::Epicycle& b)
+    {
+        return a.radius == b.radius && a.harmonic == b.harmonic && a.phase == b.phase;
+    };
+    if (count == last_.count && fundamental == last_.fundamental && gain == last_.gain &&
+        std::equal(circles, circles + count, last_.circles.begin(), same))
+        return;
+    last_.circles.assign(circles, circles + count);
+    last_.count = count;
+    last_.fundamental = fundamental;
+    last_.gain = gain;
+
+    Params& back = params_.Back();
+    back.circles.assign(circles, circles + count);
+    back.count = count;
+    back.fundamental = fundamental;
+    back.gain = gain;
+    params_.Publish();
+}
+
+void SDLCALL AudioOutput::Callback(void* user, Uint8* stream, int len)
+{
+    ((AudioOutput*)user)->Render((float*)stream, len / (int)sizeof(float));
+}
+
+void AudioOutput::Render(float* out, int frames)
+{
+    auto start = std::chrono::steady_clock::now();
+    if (params_.Acquire())
+    {
+        const Params& p = params_.Front();
+        count_ = p.count;
+        if (spectral_on_)
+            spectral_.SetSeries(p.circles.data(), p.count, (double)p.fundamental, p.gain);
+        else
+            bank_.SetSeries(p.circles.data(), p.count, (double)p.fundamental, p.gain);
+    }
+
+    // Auto switches a quarter past the crossover either way, so a partial
+    // count near it does not flip the bank back and forth
+    Synthesis synthesis = synthesis_.load(std::memory_order_relaxed);
+    double partials = (double)std::min(count_, limit_);
+    bool spectral = synthesis == Synthesis::Spectral;
+    if (synthesis == Synthesis::Auto && crossover_ != (size_t)-1)
+        spectral = partials > (spectral_on_ ? 0.8 : 1.25) * (double)crossover_;
+    if (spectral != spectral_on_ && (size_t)frames <= fade_.size())
+        Switch(out, (size_t)frames);
+    else if (spectral_on_)
+    {
+        spectral_.SetLimit(limit_);
+        spectral_.Render(out, (size_t)frames);
+    }
+    else
+    {
+        bank_.SetLimit(limit_);
+        bank_.Render(out, (size_t)frames);
+    }
+
+    float budget = (float)frames / (float)sample_rate_;
+    float load = std::chrono::duration<float>(std::chrono::steady_clock::now() - start).count() / budget;
+    float smoothed = 0.9f * load_.load(std::memory_order_relaxed) + 0.1f * load;
+    load_.store(smoothed, std::memory_order_relaxed);
+    if (load > peak_load_.load(std::memory_order_relaxed))
+        peak_load_.store(load, std::memory_order_relaxed);
+    if (load > 1.0f)
+        late_blocks_.fetch_add(1, std::memory_order_relaxed);
+
+    // Shed an eighth of the partials after any block over 60 % of its
+    // budget, so the next ones finish in time; grow back slowly under 30 %
+    size_t active = spectral_on_ ? spectral_.Active() : bank_.Active();
+    if (load > 0.6f)
+        limit_ = std::max<size_t>(16, active - active / 8);
+    else if (smoothed < 0.3f && limit_ < max_partials)
+        limit_ = std::min(max_partials, limit_ + std::max<size_t>(16, limit_ / 16));
+    active_.store(active, std::memory_order_relaxed);
+}
+
+// Starts the other bank at the phase where the current one stands and fades
+// from one to the other over the block.
+void AudioOutput::Switch(float* out, size_t frames)
+{
+    const Params& p = params_.Front();
+    if (spectral_on_)
+    {
+        bank_.SetSeries(p.circles.data(), p.count, (double)p.fundamental, p.gain);
+        bank_.SetLimit(limit_);
+        bank_.Reset(spectral_.Phase());
+        spectral_.Render(fade_.data(), frames);
+        bank_.Render(out, frames);
+    }
+    else
+    {
+        spectral_.SetSeries(p.circles.data(), p.count, (double)p.fundamental, p.gain);
+        spectral_.SetLimit(limit_);
+        spectral_.Reset(bank_.Phase());
+        bank_.Render(fade_.data(), frames);
+        spectral_.Render(out, frames);
+    }
+    for (size_t i = 0; i < frames; i++)
+    {
+        float t = ((float)i + 0.5f) / (float)frames;
+        out[i] = fade_[i] + t * (out[i] - fade_[i]);
+    }
+    spectral_on_ = !spectral_on_;
+    spectral_active_.store(spectral_on_, std::memory_order_relaxed);
+}
@@ -0,0 +1,106 @@
+// The epicycle series as sound: SDL audio callback around an oscillator bank.
+
+#pragma once
+
+#include <SDL.h>
+
+#include "Core/TripleBuffer.h"
+#include "Dsp/OscillatorBank.h"
+#include "Dsp/SpectralBank.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Plays the y coordinate of a chain's tip. The UI thread hands over new
+// series through a triple buffer, so the audio callback never waits on a
+// lock, and nothing in the callback allocates. The callback times itself:
+// when a block takes too large a share of its real-time budget the smallest
+// partials are faded out, and brought back once there is room again.
+//
+// Two banks can render the series: direct oscillators, cheapest for a few
+// partials, and inverse-FFT overlap-add, whose cost barely grows with their
+// number. Auto picks by a crossover measured when the device opens; a switch
+// hands the running phase over and crossfades across one block.
+class AudioOutput
+{
+public:
+    static constexpr size_t max_partials = 8192;
+
+    enum class Synthesis
+    {
+        Auto,
+        Direct,
+        Spectral,
+    };
+
+    AudioOutput();
+    ~AudioOutput();
+
+    AudioOutput(const AudioOutput&) = delete;
+    AudioOutput& operator=(const AudioOutput&) = delete;
+
+    // Opens the default device for mono float output with blocks of
+    // `buffer_frames` and starts playing (silence until SetSeries).
+    bool Open(int buffer_frames = 128);
+    void Close();
+    bool IsOpen() const { return device_ != 0; }
+
+    // UI thread. Circles are played in order of importance (the first ones
+    // are kept under load); fundamental in Hz. Publishes only on change.
+    void SetSeries(const Dsp::Epicycle* circles, size_t count, float fundamental, float gain);
+    void SetSynthesis(Synthesis synthesis) { synthesis_.store(synthesis, std::memory_order_relaxed); }
+
+    int SampleRate() const { return sample_rate_; }
+    int BufferFrames() const { return buffer_frames_; }
+    // Share of the real-time budget used per block: smoothed, and the worst
+    // since the device was opened.
+    float Load() const { return load_.load(std::memory_order_relaxed); }
+    float PeakLoad() const { return peak_load_.load(std::memory_order_relaxed); }
+    size_t ActivePartials() const { return active_.load(std::memory_order_relaxed); }
+    // Whether the spectral bank is playing, and the partial count above
+    // which Auto prefers it ((size_t)-1 when it never won).
+    bool SpectralActive() const { return spectral_active_.load(std::memory_order_relaxed); }
+    size_t Crossover() const { return crossover_; }
+    // Blocks that took longer than their own duration.
+    uint64_t LateBlocks() const { return late_blocks_.load(std::memory_order_relaxed); }
+    const char* Error() const { return error_; }
+
+private:
+    struct Params
+    {
+        std::vector<Dsp::Epicycle> circles;     // Reserved to max_partials
+        size_t count = 0;
+        float fundamental = 0.0f;
+        float gain = 0.0f;
+    };
+
+    static void SDLCALL Callback(void* user, Uint8* stream, int len);
+    void Render(float* out, int frames);
+    void Switch(float* out, size_t frames);
+
+    SDL_AudioDeviceID device_ = 0;
+    int sample_rate_ = 0;
+    int buffer_frames_ = 0;
+    Core::TripleBuffer<Params> params_;
+    Params last_;                               // Last published, UI thread only
+
+    // Audio thread only
+    Dsp::OscillatorBank bank_;
+    Dsp::SpectralBank spectral_;
+    bool spectral_on_ = false;
+    size_t count_ = 0;
+    size_t limit_ = max_partials;
+    std::vector<float> fade_;                   // Old bank's block while switching
+
+    size_t crossover_ = (size_t)-1;
+    std::atomic<Synthesis> synthesis_{ Synthesis::Auto };
+    std::atomic<bool> spectral_active_{ false };
+
+    std::atomic<float> load_{ 0.0f };
+    std::atomic<float> peak_load_{ 0.0f };
+    std::atomic<size_t> active_{ 0 };
+    std::atomic<uint64_t> late_blocks_{ 0 };
+    char error_[128] = "";
+};
@@ -0,0 +1,124 @@
+#include "DrawStats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+static DrawCounts CountsOf(const ImDrawList* list)
+{
+    return DrawCounts{ list->VtxBuffer.Size, list->IdxBuffer.Size, list->CmdBuffer.Size };
+}
+
+//-----------------------------------------------------------------------------
+// DrawStats
+//-----------------------------------------------------------------------------
+
+void DrawStats::NextFrame()
+{
+    std::copy(building_, building_ + building_count_, layers_);
+    layer_count_ = building_count_;
+    building_count_ = 0;
+}
+
+void DrawStats::CaptureWindows(const ImDrawData* data)
+{
+    window_count_ = 0;
+    total_ = DrawCounts();
+    if (data == nullptr || !data->Valid)
+        return;
+    for (int i = 0; i < data->CmdListsCount; i++)
+    {
+        const ImDrawList* list = data->CmdLists[i];
+        DrawCounts c = CountsOf(list);
+        total_.vertices += c.vertices;
+        total_.indices += c.indices;
+        total_.commands += c.commands;
+        if (window_count_ == max_windows)
+            continue;
+        snprintf(window_names_[window_count_], sizeof(window_names_[0]), "%s", list->_OwnerName != nullptr ? list->_OwnerName : "?");
+        windows_[window_count_].name = window_names_[window_count_];
+        windows_[window_count_].counts = c;
+        window_count_++;
+    }
+}
+
+DrawCounts DrawStats::LayerCounts(const char* name) const
+{
+    for (int i = 0; i < layer_count_; i++)
+        if (strcmp(layers_[i].name, name) == 0)
+            return layers_[i].counts;
+    return DrawCounts();
+}
+
+void DrawStats::AddLayer(const char* name, const DrawCounts& counts)
+{
+    int i = 0;
+    while (i < building_count_ && strcmp(building_[i].name, name) != 0)
+        i++;
+    if (i == building_count_)
+    {
+        if (building_count_ == max_layers)
+            return;
+        building_[building_count_++] = Entry{ name, DrawCounts() };
+    }
+    building_[i].counts.vertices += counts.vertices;
+    building_[i].counts.indices += counts.indices;
+    building_[i].counts.commands += counts.commands;
+}
+
+DrawStats::Scope::Scope(DrawStats& stats, ImDrawList* draw_list, const char* layer)
+    : stats_(stats), draw_list_(draw_list), layer_(layer), start_(CountsOf(draw_list))
+{
+}
+
+DrawStats::Scope::~Scope()
+{
+    DrawCounts end = CountsOf(draw_list_);
+    stats_.AddLayer(layer_, DrawCounts{ end.vertices - start_.vertices, end.indices - start_.indices, end.commands - start_.commands });
+}
+
+//-----------------------------------------------------------------------------
+// VertexBudget
+//-----------------------------------------------------------------------------
+
+void VertexBudget::Update(const DrawStats& stats, int circles, int trace_points)
+{
+    // Unit costs from last frame, when it drew enough to measure them.
+    DrawCounts circle_layer = stats.LayerCounts("circles");
+    DrawCounts trace_layer = stats.LayerCounts("trace");
+    if (last_circle_segments_ > 0 && circle_layer.vertices > 0)
+        segment_cost_ = (float)circle_layer.vertices / (float)last_circle_segments_;
+    if (last_trace_segments_ > 0 && trace_layer.vertices > 0)
+        trace_cost_ = (float)trace_layer.vertices / (float)last_trace_segments_;
+
+    circle_segments = max_segments;
+    trace_stride = 1;
+    int trace_segments = std::max(trace_points - 1, 0);
+    if (enabled && max_vertices > 0)
+    {
+        int fixed = std::max(stats.Total().vertices - circle_layer.vertices - trace_layer.vertices, 0);
+        float available = (float)(max_vertices - fixed);
+        float trace_full = trace_cost_ * (float)trace_segments;
+
+        // Tessellation first: whatever the full trace leaves for the circles.
+        if (circles > 0)
+        {
+            float per_circle = (available - trace_full) / (float)circles;
+            int segments = (int)std::floor(per_circle / segment_cost_);
+            circle_segments = std::clamp(segments, min_segments, max_segments);
+        }
+
+        // Then the trace, with what the circles at their floor leave.
+        float trace_room = available - segment_cost_ * (float)(circles * circle_segments);
+        if (trace_full > trace_room && trace_segments > 0)
+        {
+            int drawable = (int)std::floor(std::max(trace_room, 0.0f) / trace_cost_);
+            trace_stride = (drawable > 0) ? (trace_segments + drawable - 1) / drawable : trace_segments;
+            trace_stride = std::max(trace_stride, 1);
+        }
+    }
+
+    last_circle_segments_ = circles * circle_segments;
+    last_trace_segments_ = (trace_segments + trace_stride - 1) / trace_stride;
+}
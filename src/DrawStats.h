@@ -0,0 +1,101 @@
+// Draw-list instrumentation and the Circle Window's vertex budget.
+
+#pragma once
+
+#include <imgui.h>
+
+struct DrawCounts
+{
+    int vertices = 0;
+    int indices = 0;
+    int commands = 0;
+};
+
+// Vertices, indices and draw commands per ImGui window of the last rendered
+// frame, and per named layer of the windows that mark them. Layers are
+// collected while a frame is built and become visible on the next NextFrame().
+class DrawStats
+{
+public:
+    static constexpr int max_windows = 32;
+    static constexpr int max_layers = 16;
+
+    struct Entry
+    {
+        const char* name = nullptr;     // Window names are copied, layer names must be literals
+        DrawCounts counts;
+    };
+
+    // Call once at the top of the frame.
+    void NextFrame();
+    // Call right after ImGui::Render().
+    void CaptureWindows(const ImDrawData* data);
+
+    int WindowCount() const { return window_count_; }
+    const Entry& Window(int i) const { return windows_[i]; }
+    const DrawCounts& Total() const { return total_; }
+
+    int LayerCount() const { return layer_count_; }
+    const Entry& Layer(int i) const { return layers_[i]; }
+    // Counts of a layer in the last frame (zero if it was not drawn).
+    DrawCounts LayerCounts(const char* name) const;
+
+    // Adds what was appended to draw_list between the constructor and the
+    // destructor to the named layer of the current frame.
+    class Scope
+    {
+    public:
+        Scope(DrawStats& stats, ImDrawList* draw_list, const char* layer);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        DrawStats& stats_;
+        ImDrawList* draw_list_;
+        const char* layer_;
+        DrawCounts start_;
+    };
+
+private:
+    void AddLayer(const char* name, const DrawCounts& counts);
+
+    Entry windows_[max_windows];
+    char window_names_[max_windows][48] = {};
+    int window_count_ = 0;
+    DrawCounts total_;
+
+    Entry layers_[max_layers];          // Last frame
+    int layer_count_ = 0;
+    Entry building_[max_layers];        // Current frame
+    int building_count_ = 0;
+};
+
+// Scales the Circle Window's detail so the whole frame stays within a vertex
+// budget. The vertex cost of one circle segment and of one trace segment is
+// measured from the previous frame's layers, so it follows whatever ImGui
+// emits (anti-aliasing, line thickness); everything else in the frame is
+// taken as fixed. Circle tessellation is lowered first, down to
+// min_segments, then the trace is thinned by drawing every stride-th sample.
+struct VertexBudget
+{
+    bool enabled = true;
+    int max_vertices = 60000;
+    int max_segments = 64;          // Tessellation when the budget allows
+    int min_segments = 8;
+
+    // Decisions for the current frame
+    int circle_segments = 64;
+    int trace_stride = 1;
+
+    // circles / trace_points: what the Circle Window is about to draw.
+    void Update(const DrawStats& stats, int circles, int trace_points);
+
+private:
+    // What the previous frame drew, to turn its layer counts into unit costs.
+    int last_circle_segments_ = 0;
+    int last_trace_segments_ = 0;
+    float segment_cost_ = 3.0f;     // Vertices per anti-aliased 1 px circle segment until measured
+    float trace_cost_ = 4.0f;       // Vertices per trace segment until measured
+};
@@ -0,0 +1,70 @@
+#include "Scalogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+ImU32 HeatColor(float t)
+{
+    t = std::clamp(t, 0.0f, 1.0f);
+    // black -> purple -> orange -> yellow
+    float r = std::clamp(1.8f * t, 0.0f, 1.0f);
+    float g = std::clamp(2.0f * t - 0.8f, 0.0f, 1.0f);
+    float b = std::clamp(t < 0.4f ? 1.5f * t : 1.2f - 1.5f * t, 0.0f, 1.0f);
+    return IM_COL32((int)(r * 255), (int)(g * 255), (int)(b * 255), 255);
+}
+
+void DrawScalogram(ImDrawList* draw_list, ImVec2 origin, ImVec2 size, const Dsp::StreamingDwt& dwt)
+{
+    int levels = dwt.Levels();
+    float row_height = size.y / (float)levels;
+    draw_list->AddRectFilled(origin, ImVec2(origin.x + size.x, origin.y + size.y), IM_COL32(0, 0, 0, 255));
+
+    for (int l = 1; l <= levels; l++)
+    {
+        float width = (float)(1 << l);
+        size_t count = std::min(dwt.DetailCount(l), (size_t)(size.x / width) + 1);
+        float peak = 1e-6f;
+        for (size_t a = 0; a < count; a++)
+            peak = std::max(peak, fabsf(dwt.Detail(l, a)));
+
+        float y0 = origin.y + (float)(l - 1) * row_height;
+        for (size_t a = 0; a < count; a++)
+        {
+            float x0 = origin.x + (float)a * width;
+            float x1 = std::min(x0 + width, origin.x + size.x);
+            float t = sqrtf(fabsf(dwt.Detail(l, a)) / peak);
+            draw_list->AddRectFilled(ImVec2(x0, y0), ImVec2(x1, y0 + row_height), HeatColor(t));
+        }
+    }
+}
+
+SDL_Texture* EnsureStreamingTexture(SDL_Renderer* renderer, SDL_Texture* texture, int w, int h)
+{
+    int tex_w = 0, tex_h = 0;
+    if (texture != nullptr)
+        SDL_QueryTexture(texture, nullptr, nullptr, &tex_w, &tex_h);
+    if (texture != nullptr && tex_w == w && tex_h == h)
+        return texture;
+    if (texture != nullptr)
+        SDL_DestroyTexture(texture);
+    return SDL_CreateTexture(renderer, SDL_PIXELFORMAT_ABGR8888, SDL_TEXTUREACCESS_STREAMING, w, h);
+}
+
+SDL_Texture* UploadHeatmap(SDL_Renderer* renderer, SDL_Texture* texture, const float* image, int cols, int rows)
+{
+    texture = EnsureStreamingTexture(renderer, texture, cols, rows);
+    if (texture == nullptr)
+        return nullptr;
+
+    float peak = 1e-12f;
+    for (int i = 0; i < cols * rows; i++)
+        peak = std::max(peak, image[i]);
+
+    static std::vector<ImU32> pixels;
+    pixels.resize((size_t)cols * rows);
+    for (int i = 0; i < cols * rows; i++)
+        pixels[i] = HeatColor(sqrtf(image[i] / peak));
+    SDL_UpdateTexture(texture, nullptr, pixels.data(), cols * (int)sizeof(ImU32));
+    return texture;
+}
@@ -0,0 +1,27 @@
+// Scalogram views drawn under the real-time graph.
+
+#pragma once
+
+#include <imgui.h>
+#include <SDL.h>
+
+#include "Dsp/Wavelet.h"
+
+// Draws the detail coefficients of a streaming DWT as one row per level
+// (finest on top), newest on the left to line up with the scrolling graph.
+// Each coefficient of level l spans 2^l pixels; colours are normalized per level.
+void DrawScalogram(ImDrawList* draw_list, ImVec2 origin, ImVec2 size, const Dsp::StreamingDwt& dwt);
+
+// Maps t in [0, 1] to a dark-to-bright heat colour.
+ImU32 HeatColor(float t);
+
+// Returns a streaming texture of w x h pixels in IM_COL32 layout, reusing
+// `texture` when it already has that size and replacing it otherwise.
+// SDL_PIXELFORMAT_ABGR8888 matches IM_COL32's byte order on little-endian
+// machines. Returns nullptr if the texture cannot be created.
+SDL_Texture* EnsureStreamingTexture(SDL_Renderer* renderer, SDL_Texture* texture, int w, int h);
+
+// Uploads a row-major magnitude image into a streaming texture as heat colours
+// (normalized to the image peak), creating or resizing the texture as needed.
+// Returns the texture to keep using; it is owned by the caller.
+SDL_Texture* UploadHeatmap(SDL_Renderer* renderer, SDL_Texture* texture, const float* image, int cols, int rows);
@@ -0,0 +1,121 @@
+#include "SceneCanvas.h"
+#include "Scalogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+SceneCanvas::~SceneCanvas()
+{
+    if (texture_ != nullptr)
+        SDL_DestroyTexture(texture_);
+}
+
+void SceneCanvas::Begin(ImDrawList* draw_list)
+{
+    draw_list_ = draw_list;
+    scene_.Clear();
+}
+
+void SceneCanvas::AddCircle(ImVec2 center, float radius, ImU32 color, int segments, float thickness)
+{
+    scene_.AddCircle(center.x, center.y, radius, color, thickness);
+    if (!software)
+        draw_list_->AddCircle(center, radius, color, segments, thickness);
+}
+
+void SceneCanvas::AddCircleFilled(ImVec2 center, float radius, ImU32 color)
+{
+    scene_.AddDisc(center.x, center.y, radius, color);
+    if (!software)
+        draw_list_->AddCircleFilled(center, radius, color);
+}
+
+void SceneCanvas::AddLine(ImVec2 a, ImVec2 b, ImU32 color, float thickness)
+{
+    scene_.AddLine(a.x, a.y, b.x, b.y, color, thickness);
+    if (!software)
+        draw_list_->AddLine(a, b, color, thickness);
+}
+
+void SceneCanvas::End(SDL_Renderer* renderer, ImVec2 min, ImVec2 max, ImU32 background, Core::ThreadPool* pool)
+{
+    if (!software)
+        return;
+    int x = (int)std::floor(min.x), y = (int)std::floor(min.y);
+    int w = (int)std::ceil(max.x) - x, h = (int)std::ceil(max.y) - y;
+    if (w <= 0 || h <= 0)
+        return;
+    texture_ = EnsureStreamingTexture(renderer, texture_, w, h);
+    if (texture_ == nullptr)
+        return;
+    // Opaque, so the copy needs no blending
+    SDL_SetTextureBlendMode(texture_, SDL_BLENDMODE_NONE);
+
+    // Rendered in place into the locked texture memory
+    void* pixels = nullptr;
+    int pitch = 0;
+    if (SDL_LockTexture(texture_, nullptr, &pixels, &pitch) != 0)
+        return;
+    Raster::Target target{ (uint32_t*)pixels, w, h, pitch / (int)sizeof(uint32_t), x, y };
+    Raster::Fill(target, background | IM_COL32_A_MASK, pool);
+    rasterizer_.Draw(scene_, target, pool);
+    SDL_UnlockTexture(texture_);
+    draw_list_->AddImage((ImTextureID)texture_, ImVec2((float)x, (float)y), ImVec2((float)(x + w), (float)(y + h)));
+}
+
+//-----------------------------------------------------------------------------
+// SceneExport
+//-----------------------------------------------------------------------------
+
+SceneExport::~SceneExport()
+{
+    cancel_ = true;
+    if (thread_.joinable())
+        thread_.join();
+}
+
+bool SceneExport::Start(const Raster::Scene& scene, ImVec2 min, ImVec2 max, int width, ImU32 background, const char* path)
+{
+    if (Running() || max.x <= min.x || max.y <= min.y || width <= 0)
+        return false;
+    if (thread_.joinable())
+        thread_.join();
+
+    float scale = (float)width / (max.x - min.x);
+    Raster::ExportSettings settings;
+    settings.width = width;
+    settings.height = std::max((int)std::lround((max.y - min.y) * scale), 1);
+    settings.background = background | IM_COL32_A_MASK;
+    Raster::Scene scaled = scene;
+    scaled.Transform(scale, -min.x * scale, -min.y * scale);
+
+    height_ = settings.height;
+    rows_ = 0;
+    cancel_ = false;
+    status_[0] = '\0';
+    running_.store(true, std::memory_order_release);
+    thread_ = std::thread([this, scaled = std::move(scaled), settings, file = std::string(path)]
+    {
+        Raster::ImageWriter writer;
+        bool ok = writer.Open(file.c_str(), Raster::FormatFromPath(file.c_str()), settings.width, settings.height);
+        if (ok)
+        {
+            Core::ThreadPool pool;
+            ok = Raster::ExportScene(scaled, settings, writer, &pool, [this](int rows)
+            {
+                rows_ = rows;
+                return !cancel_.load();
+            });
+        }
+        if (ok)
+            snprintf(status_, sizeof(status_), "Wrote %s (%dx%d)", file.c_str(), settings.width, settings.height);
+        else if (cancel_)
+            snprintf(status_, sizeof(status_), "Cancelled; %s is incomplete", file.c_str());
+        else
+            snprintf(status_, sizeof(status_), "Export failed: %s", writer.Error());
+        running_.store(false, std::memory_order_release);
+    });
+    return true;
+}
@@ -0,0 +1,80 @@
+// The Circle Window's geometry, drawn through ImGui or rasterized on the CPU.
+
+#pragma once
+
+#include <imgui.h>
+#include <SDL.h>
+
+#include "Core/ThreadPool.h"
+#include "Raster/Export.h"
+#include "Raster/Rasterizer.h"
+
+#include <atomic>
+#include <thread>
+
+// Collects circles and lines between Begin() and End(), and keeps them as a
+// Raster::Scene for export. Through ImGui they also go straight to the draw
+// list; in software mode they are rasterized with
+// analytic anti-aliasing into a streaming texture, which End() adds to the
+// draw list so that everything drawn after it (overlays, widgets) stays on
+// top. Software mode avoids tessellated, anti-aliased ImGui strokes, which
+// SDL's software renderer fills triangle by triangle.
+class SceneCanvas
+{
+public:
+    SceneCanvas() = default;
+    ~SceneCanvas();
+
+    SceneCanvas(const SceneCanvas&) = delete;
+    SceneCanvas& operator=(const SceneCanvas&) = delete;
+
+    bool software = false;
+
+    void Begin(ImDrawList* draw_list);
+    void AddCircle(ImVec2 center, float radius, ImU32 color, int segments, float thickness = 1.0f);
+    void AddCircleFilled(ImVec2 center, float radius, ImU32 color);
+    void AddLine(ImVec2 a, ImVec2 b, ImU32 color, float thickness = 1.0f);
+    // Rasterizes the screen rectangle [min, max) over an opaque background and
+    // places it in the draw list; nothing to do when drawing through ImGui.
+    void End(SDL_Renderer* renderer, ImVec2 min, ImVec2 max, ImU32 background, Core::ThreadPool* pool);
+
+    size_t ShapeCount() const { return scene_.Size(); }
+    // The last frame's shapes, in screen coordinates.
+    const Raster::Scene& Scene() const { return scene_; }
+
+private:
+    ImDrawList* draw_list_ = nullptr;
+    Raster::Scene scene_;
+    Raster::Rasterizer rasterizer_;
+    SDL_Texture* texture_ = nullptr;
+};
+
+// Writes a scene to a PNG or TIFF file far larger than the window on a
+// background thread with its own worker pool, so the UI keeps running.
+class SceneExport
+{
+public:
+    SceneExport() = default;
+    ~SceneExport();
+
+    SceneExport(const SceneExport&) = delete;
+    SceneExport& operator=(const SceneExport&) = delete;
+
+    // Exports the screen rectangle [min, max) of `scene` scaled to `width`
+    // pixels (height keeps the aspect ratio). False when one is running.
+    bool Start(const Raster::Scene& scene, ImVec2 min, ImVec2 max, int width, ImU32 background, const char* path);
+    void Cancel() { cancel_ = true; }
+
+    bool Running() const { return running_.load(std::memory_order_acquire); }
+    float Progress() const { return height_ > 0 ? (float)rows_.load() / (float)height_ : 0.0f; }
+    // Outcome of the last export; valid once Running() is false.
+    const char* Status() const { return status_; }
+
+private:
+    std::thread thread_;
+    std::atomic<bool> running_{ false };
+    std::atomic<bool> cancel_{ false };
+    std::atomic<int> rows_{ 0 };
+    int height_ = 0;
+    char status_[256] = "";
+};
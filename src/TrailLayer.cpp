@@ -0,0 +1,87 @@
+#include "TrailLayer.h"
+#include "Scalogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+TrailLayer::~TrailLayer()
+{
+    if (texture_ != nullptr)
+        SDL_DestroyTexture(texture_);
+}
+
+void TrailLayer::Clear()
+{
+    // Trail colour everywhere, fully transparent
+    std::fill(pixels_.begin(), pixels_.end(), color & ~IM_COL32_A_MASK);
+    has_last_ = false;
+    upload_all_ = true;
+    pending_fade_ = 1.0f;
+}
+
+void TrailLayer::Update(SDL_Renderer* renderer, ImDrawList* draw_list, ImVec2 min, ImVec2 max, ImVec2 point, float dt)
+{
+    if (!enabled)
+    {
+        has_last_ = false;
+        return;
+    }
+    int x = (int)std::floor(min.x), y = (int)std::floor(min.y);
+    int w = (int)std::ceil(max.x) - x, h = (int)std::ceil(max.y) - y;
+    if (w <= 0 || h <= 0)
+        return;
+    if (texture_ == nullptr || w != width_ || h != height_)
+    {
+        texture_ = EnsureStreamingTexture(renderer, texture_, w, h);
+        if (texture_ == nullptr)
+            return;
+        SDL_SetTextureBlendMode(texture_, SDL_BLENDMODE_BLEND);
+        width_ = w;
+        height_ = h;
+        pixels_.resize((size_t)w * (size_t)h);
+        Clear();
+    }
+    Raster::Target target{ pixels_.data(), width_, height_, width_, 0, 0 };
+
+    // Exponential fade, applied once the accumulated decay reaches a 1/256 step
+    if (half_life > 0.0f)
+    {
+        pending_fade_ *= std::exp2(-dt / half_life);
+        int factor = (int)std::lround(pending_fade_ * 256.0f);
+        if (factor < 256)
+        {
+            Raster::ScaleAlpha(target, factor);
+            pending_fade_ = (factor > 0) ? pending_fade_ * 256.0f / (float)factor : 1.0f;
+            upload_all_ = true;
+        }
+    }
+
+    // Only the newest segment is drawn
+    ImVec2 p(point.x - (float)x, point.y - (float)y);
+    SDL_Rect dirty = { 0, 0, 0, 0 };
+    if (has_last_)
+    {
+        segment_.Clear();
+        segment_.AddLine(last_.x, last_.y, p.x, p.y, color, thickness);
+        rasterizer_.Draw(segment_, target);
+        int pad = (int)std::ceil(thickness) + 2;
+        int x0 = std::clamp((int)std::floor(std::min(last_.x, p.x)) - pad, 0, width_);
+        int y0 = std::clamp((int)std::floor(std::min(last_.y, p.y)) - pad, 0, height_);
+        int x1 = std::clamp((int)std::ceil(std::max(last_.x, p.x)) + pad, 0, width_);
+        int y1 = std::clamp((int)std::ceil(std::max(last_.y, p.y)) + pad, 0, height_);
+        dirty = { x0, y0, x1 - x0, y1 - y0 };
+    }
+    last_ = p;
+    has_last_ = true;
+
+    if (upload_all_)
+    {
+        SDL_UpdateTexture(texture_, nullptr, pixels_.data(), width_ * (int)sizeof(uint32_t));
+        upload_all_ = false;
+    }
+    else if (dirty.w > 0 && dirty.h > 0)
+    {
+        SDL_UpdateTexture(texture_, &dirty, pixels_.data() + (size_t)dirty.y * (size_t)width_ + (size_t)dirty.x, width_ * (int)sizeof(uint32_t));
+    }
+    draw_list->AddImage((ImTextureID)texture_, ImVec2((float)x, (float)y), ImVec2((float)(x + w), (float)(y + h)));
+}
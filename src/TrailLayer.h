@@ -0,0 +1,51 @@
+// Persistent trail of the epicycle tip.
+
+#pragma once
+
+#include <imgui.h>
+#include <SDL.h>
+
+#include "Raster/Rasterizer.h"
+
+#include <cstdint>
+#include <vector>
+
+// Accumulates the path of a moving point in an offscreen RGBA buffer: each
+// frame rasterizes only the segment from the previous position to the new
+// one and uploads only the pixels it touched, so the cost of a frame does not
+// depend on how long the trail is and no history of points is kept. With a
+// half-life, the alpha of the whole buffer decays exponentially instead,
+// which costs one pass over the buffer per frame. The buffer holds the trail
+// colour everywhere and coverage in alpha, so it blends as straight alpha.
+class TrailLayer
+{
+public:
+    TrailLayer() = default;
+    ~TrailLayer();
+
+    TrailLayer(const TrailLayer&) = delete;
+    TrailLayer& operator=(const TrailLayer&) = delete;
+
+    bool enabled = false;
+    float half_life = 0.0f;         // Seconds to fade to half; 0 keeps the trail forever
+    float thickness = 1.5f;
+    ImU32 color = IM_COL32(255, 200, 0, 255);
+
+    // Extends the trail to `point` inside the screen rectangle [min, max) and
+    // adds the texture to the draw list. The trail is cleared when the
+    // rectangle changes size. dt is the frame time in seconds.
+    void Update(SDL_Renderer* renderer, ImDrawList* draw_list, ImVec2 min, ImVec2 max, ImVec2 point, float dt);
+    void Clear();
+
+private:
+    std::vector<uint32_t> pixels_;
+    int width_ = 0;
+    int height_ = 0;
+    SDL_Texture* texture_ = nullptr;
+    bool upload_all_ = true;
+    bool has_last_ = false;
+    ImVec2 last_;                   // Previous point, relative to the rectangle
+    float pending_fade_ = 1.0f;     // Decay not yet applied (below one 1/256 step)
+    Raster::Scene segment_;
+    Raster::Rasterizer rasterizer_;
+};
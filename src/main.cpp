@@ -8,11 +8,37 @@
 #include <imgui.h>
 #include <imgui_impl_sdl2.h>
 #include <imgui_impl_sdlrenderer2.h>
+#include <algorithm>
+#include <cfloat>
 #include <cstdio>
 #include <cmath>
+#include <memory>
+#include <memory_resource>
+#include <new>
 #include <vector>
 #include <SDL.h>
 
+#include "Core/AllocTracker.h"
+#include "Core/Arena.h"
+#include "Core/PerfCounters.h"
+#include "Core/SampleRing.h"
+#include "Core/ThreadPool.h"
+#include "Dsp/Basis.h"
+#include "Dsp/Convergence.h"
+#include "Dsp/Cwt.h"
+#include "Dsp/Epicycles.h"
+#include "Dsp/Filter.h"
+#include "Dsp/FixedFft.h"
+#include "Dsp/Hilbert.h"
+#include "Dsp/Resampler.h"
+#include "Dsp/Series.h"
+#include "Dsp/Wavelet.h"
+#include "DrawStats.h"
+#include "Scalogram.h"
+#include "SceneCanvas.h"
+#include "AudioOutput.h"
+#include "TrailLayer.h"
+
 // Windows specific includes for debugging popups and console allocation
 #if defined(_WIN32)
 #include <windows.h>
@@ -32,6 +58,19 @@ void ShowError(const char* title, const char* message)
     #endif
 }
 
+// Dear ImGui allocates through malloc by default; route it through operator
+// new so the allocation tracker sees it under the UI tag.
+static void* ImGuiAlloc(size_t size, void*)
+{
+    Core::AllocScope scope(Core::AllocTag::Ui);
+    return ::operator new(size, std::nothrow);
+}
+
+static void ImGuiFree(void* p, void*)
+{
+    ::operator delete(p);
+}
+
 // Main code
 int main(int, char**)
 {
@@ -98,6 +137,7 @@ int main(int, char**)
 
     // Setup Dear ImGui context
     IMGUI_CHECKVERSION();
+    ImGui::SetAllocatorFunctions(ImGuiAlloc, ImGuiFree);
     ImGui::CreateContext();
     ImGuiIO& io = ImGui::GetIO(); (void)io;
     io.ConfigFlags |= ImGuiConfigFlags_NavEnableKeyboard;     // Enable Keyboard Controls
@@ -114,12 +154,38 @@ int main(int, char**)
     bool show_demo_window = true;
     bool show_another_window = false;
     bool show_circle_window = false;
+    bool show_memory_window = false;
+    bool show_perf_window = false;
+    bool show_draw_window = false;
     ImVec4 clear_color = ImVec4(0.45f, 0.55f, 0.60f, 1.00f);
+    SDL_Texture* cwt_texture = nullptr;
+
+    // Transient per-frame data (joints, FFT inputs, images) lives here and is
+    // released in one step at the top of every frame.
+    Core::FrameArena frame_arena(4 << 20);
+
+    // Geometry of the last rendered frame, and the detail the Circle Window
+    // can afford under the vertex budget
+    DrawStats draw_stats;
+    VertexBudget vertex_budget;
+
+    // Without a GPU, the epicycle scene is rasterized on the CPU by default
+    SceneCanvas scene_canvas;
+    scene_canvas.software = (info.flags & SDL_RENDERER_SOFTWARE) != 0;
+    SceneExport scene_export;
+    TrailLayer tip_trail;
+    // plot_y and the tip, every frame, for other processes on this machine
+    Core::SampleRingWriter sample_ring;
+    AudioOutput audio_output;
 
     // Main loop
     bool done = false;
     while (!done)
     {
+        frame_arena.Reset();
+        Core::AllocTracker::NextFrame();
+        draw_stats.NextFrame();
+
         // Poll and handle events (inputs, window resize, etc.)
         SDL_Event event;
         while (SDL_PollEvent(&event))
@@ -151,6 +217,9 @@ int main(int, char**)
             ImGui::Checkbox("Demo Window", &show_demo_window);      // Edit bools storing our window open/close state
             ImGui::Checkbox("Another Window", &show_another_window);
             ImGui::Checkbox("Circle Window", &show_circle_window);
+            ImGui::Checkbox("Memory Window", &show_memory_window);
+            ImGui::Checkbox("Perf Window", &show_perf_window);
+            ImGui::Checkbox("Draw Stats Window", &show_draw_window);
 
             ImGui::SliderFloat("float", &f, 0.0f, 1.0f);            // Edit 1 float using a slider from 0.0f to 1.0f
             ImGui::ColorEdit3("clear color", (float*)&clear_color); // Edit 3 floats representing a color
@@ -174,9 +243,141 @@ int main(int, char**)
             ImGui::End();
         }
 
+        // Heap use per subsystem (needs the alloc_tracking build option) and the frame arena
+        if (show_memory_window)
+        {
+            ImGui::Begin("Memory Window", &show_memory_window);
+            if (!Core::AllocTracker::Installed())
+                ImGui::TextWrapped("Allocation tracking is not compiled in. Configure with -Dalloc_tracking=true.");
+            else if (ImGui::BeginTable("alloc", 7, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+            {
+                ImGui::TableSetupColumn("Tag");
+                ImGui::TableSetupColumn("Live KiB");
+                ImGui::TableSetupColumn("Peak KiB");
+                ImGui::TableSetupColumn("Allocs");
+                ImGui::TableSetupColumn("Frees");
+                ImGui::TableSetupColumn("Allocs/frame");
+                ImGui::TableSetupColumn("Bytes/frame");
+                ImGui::TableHeadersRow();
+                auto row = [](const char* name, const Core::AllocStats& s, const Core::AllocStats& d)
+                {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn(); ImGui::TextUnformatted(name);
+                    ImGui::TableNextColumn(); ImGui::Text("%.1f", (double)s.live_bytes / 1024.0);
+                    ImGui::TableNextColumn(); ImGui::Text("%.1f", (double)s.peak_bytes / 1024.0);
+                    ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)s.allocations);
+                    ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)s.frees);
+                    ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)d.allocations);
+                    ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)d.bytes);
+                };
+                for (int t = 0; t < (int)Core::AllocTag::Count; t++)
+                    row(Core::AllocTagName((Core::AllocTag)t), Core::AllocTracker::Stats((Core::AllocTag)t), Core::AllocTracker::FrameDelta((Core::AllocTag)t));
+                row("Total", Core::AllocTracker::Total(), Core::AllocTracker::FrameDeltaTotal());
+                ImGui::EndTable();
+
+                static float history[Core::AllocTracker::history_frames];
+                size_t frames = Core::AllocTracker::History(history);
+                ImGui::PlotHistogram("Allocs/frame", history, (int)frames, 0, nullptr, 0.0f, FLT_MAX, ImVec2(0, 60));
+                static char export_status[128] = "";
+                if (ImGui::Button("Export CSV"))
+                    snprintf(export_status, sizeof(export_status), Core::AllocTracker::ExportCsv("alloc_stats.csv") ? "Wrote alloc_stats.csv" : "Could not write alloc_stats.csv");
+                ImGui::SameLine();
+                ImGui::TextUnformatted(export_status);
+            }
+            ImGui::Text("Frame arena: %.1f / %.1f KiB (peak %.1f KiB)", (double)frame_arena.Used() / 1024.0, (double)frame_arena.Capacity() / 1024.0, (double)frame_arena.Peak() / 1024.0);
+            ImGui::End();
+        }
+
+        // Hardware counters per named stage of the frame (main thread only)
+        if (show_perf_window)
+        {
+            ImGui::Begin("Perf Window", &show_perf_window);
+            const Core::PerfCounters& counters = Core::PerfCounters::ThisThread();
+            if (!counters.Available())
+                ImGui::TextWrapped("Hardware counters unavailable (%s); showing wall time only.", counters.Error());
+            if (ImGui::BeginTable("perf", 7, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+            {
+                ImGui::TableSetupColumn("Scope");
+                ImGui::TableSetupColumn("Calls");
+                ImGui::TableSetupColumn("us/call");
+                ImGui::TableSetupColumn("IPC");
+                ImGui::TableSetupColumn("Cache miss");
+                ImGui::TableSetupColumn("Branch miss");
+                ImGui::TableSetupColumn("MPKI");
+                ImGui::TableHeadersRow();
+                // Unavailable ratios are NaN and show as n/a.
+                auto cell = [](double v, const char* format)
+                {
+                    ImGui::TableNextColumn();
+                    if (std::isnan(v))
+                        ImGui::TextDisabled("n/a");
+                    else
+                        ImGui::Text(format, v);
+                };
+                Core::PerfScopeStats stats[Core::PerfRegistry::max_scopes];
+                size_t count = Core::PerfRegistry::Snapshot(stats, Core::PerfRegistry::max_scopes);
+                for (size_t i = 0; i < count; i++)
+                {
+                    const Core::PerfCounts& c = stats[i].counts;
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn(); ImGui::TextUnformatted(stats[i].name);
+                    ImGui::TableNextColumn(); ImGui::Text("%llu", (unsigned long long)stats[i].calls);
+                    cell((double)c.ns / 1000.0 / (double)stats[i].calls, "%.1f");
+                    cell(c.Ipc(), "%.2f");
+                    cell(100.0 * c.CacheMissRate(), "%.1f%%");
+                    cell(100.0 * c.BranchMissRate(), "%.2f%%");
+                    cell(c.CacheMpki(), "%.2f");
+                }
+                ImGui::EndTable();
+            }
+            if (ImGui::Button("Reset"))
+                Core::PerfRegistry::Reset();
+            ImGui::End();
+        }
+
+        // Vertices, indices and draw commands of the last frame, per window
+        // and per layer of the Circle Window
+        if (show_draw_window)
+        {
+            ImGui::Begin("Draw Stats Window", &show_draw_window);
+            auto table = [](const char* id, const char* first, int count, auto entry)
+            {
+                if (!ImGui::BeginTable(id, 4, ImGuiTableFlags_Borders | ImGuiTableFlags_RowBg))
+                    return;
+                ImGui::TableSetupColumn(first);
+                ImGui::TableSetupColumn("Vertices");
+                ImGui::TableSetupColumn("Indices");
+                ImGui::TableSetupColumn("Commands");
+                ImGui::TableHeadersRow();
+                for (int i = 0; i < count; i++)
+                {
+                    const DrawStats::Entry& e = entry(i);
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn(); ImGui::TextUnformatted(e.name);
+                    ImGui::TableNextColumn(); ImGui::Text("%d", e.counts.vertices);
+                    ImGui::TableNextColumn(); ImGui::Text("%d", e.counts.indices);
+                    ImGui::TableNextColumn(); ImGui::Text("%d", e.counts.commands);
+                }
+                ImGui::EndTable();
+            };
+            const DrawCounts& total = draw_stats.Total();
+            ImGui::Text("Frame: %d vertices, %d indices, %d commands", total.vertices, total.indices, total.commands);
+            table("windows", "Window", draw_stats.WindowCount(), [&](int i) -> const DrawStats::Entry& { return draw_stats.Window(i); });
+            table("layers", "Circle Window layer", draw_stats.LayerCount(), [&](int i) -> const DrawStats::Entry& { return draw_stats.Layer(i); });
+
+            ImGui::Checkbox("Vertex budget", &vertex_budget.enabled);
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(200);
+            ImGui::SliderInt("##max_vertices", &vertex_budget.max_vertices, 5000, 500000, "%d", ImGuiSliderFlags_Logarithmic);
+            ImGui::Text("Circle segments %d, trace stride %d", vertex_budget.circle_segments, vertex_budget.trace_stride);
+            ImGui::End();
+        }
+
         if (show_circle_window)
         {
             ImGui::Begin("Circle Window", &show_circle_window);
+            // Histories and overlays by default; plan rebuilds and images are tagged below
+            Core::AllocScope trace_scope(Core::AllocTag::Trace);
             
             static float scale = 1.0f;
             ImGui::SliderFloat("Scale", &scale, 0.5f, 2.0f);
@@ -184,36 +385,227 @@ int main(int, char**)
             ImGui::SliderInt("Num Circles", &num_circles, 1, 360);
             static int func_type = 0;
             ImGui::Combo("Function", &func_type, "Sine\0Cosine\0Tan\0Csc\0Sec\0Cot\0");
+            static bool fixed_point = false;
+            ImGui::Checkbox("Fixed-point chain", &fixed_point);
+            static int summation = 0;
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(160 * scale);
+            ImGui::Combo("Summation", &summation, "Naive\0Kahan-Neumaier\0Pairwise\0");
+            Dsp::Summation summation_mode = (Dsp::Summation)summation;
+            ImGui::Checkbox("CPU rasterizer", &scene_canvas.software);
+            if (scene_canvas.software)
+            {
+                ImGui::SameLine();
+                ImGui::TextDisabled("(%zu shapes)", scene_canvas.ShapeCount());
+            }
+            ImGui::Checkbox("Trail", &tip_trail.enabled);
+            if (tip_trail.enabled)
+            {
+                ImGui::SameLine();
+                ImGui::SetNextItemWidth(150 * scale);
+                ImGui::SliderFloat("Fade half-life (s)", &tip_trail.half_life, 0.0f, 30.0f, tip_trail.half_life > 0.0f ? "%.1f" : "off");
+                ImGui::SameLine();
+                if (ImGui::Button("Clear trail"))
+                    tip_trail.Clear();
+            }
+            bool share_samples = sample_ring.IsOpen();
+            if (ImGui::Checkbox("Share samples", &share_samples))
+            {
+                if (share_samples)
+                    sample_ring.Create();
+                else
+                    sample_ring.Close();
+            }
+            if (sample_ring.IsOpen() || sample_ring.Error()[0] != '\0')
+            {
+                ImGui::SameLine();
+                if (sample_ring.IsOpen())
+                    ImGui::TextDisabled("(%s, %llu published)", Core::ring_default_name, (unsigned long long)sample_ring.Published());
+                else
+                    ImGui::TextDisabled("(%s)", sample_ring.Error());
+            }
+
+            // The square wave as sound, with far more partials than circles
+            bool play_audio = audio_output.IsOpen();
+            if (ImGui::Checkbox("Audio", &play_audio))
+            {
+                if (play_audio)
+                    audio_output.Open();
+                else
+                    audio_output.Close();
+            }
+            if (audio_output.IsOpen())
+            {
+                static float audio_pitch = 110.0f;
+                static int audio_partials = 1000;
+                static float audio_volume = 0.25f;
+                static int audio_synthesis = 0;
+                static std::vector<Dsp::Epicycle> audio_series;
+                ImGui::SameLine();
+                ImGui::SetNextItemWidth(150 * scale);
+                ImGui::SliderFloat("Pitch (Hz)", &audio_pitch, 20.0f, 2000.0f, "%.1f", ImGuiSliderFlags_Logarithmic);
+                ImGui::SameLine();
+                ImGui::SetNextItemWidth(150 * scale);
+                ImGui::SliderInt("Partials", &audio_partials, 1, (int)AudioOutput::max_partials, "%d", ImGuiSliderFlags_Logarithmic);
+                ImGui::SameLine();
+                ImGui::SetNextItemWidth(100 * scale);
+                ImGui::SliderFloat("Volume", &audio_volume, 0.0f, 1.0f);
+                ImGui::SameLine();
+                ImGui::SetNextItemWidth(100 * scale);
+                if (ImGui::Combo("Synthesis", &audio_synthesis, "Auto\0Direct\0IFFT\0"))
+                    audio_output.SetSynthesis((AudioOutput::Synthesis)audio_synthesis);
+                if (audio_series.size() != (size_t)audio_partials)
+                {
+                    audio_series.resize((size_t)audio_partials);
+                    Dsp::MakeSeries(Dsp::SeriesType::Square, audio_series.size(), 1.0f, audio_series.data());
+                }
+                audio_output.SetSeries(audio_series.data(), audio_series.size(), audio_pitch, audio_volume);
+                ImGui::TextDisabled("%zu partials below Nyquist, %d Hz in %d-frame blocks, load %.0f%% (peak %.0f%%), %llu late blocks",
+                                    audio_output.ActivePartials(), audio_output.SampleRate(), audio_output.BufferFrames(),
+                                    100.0f * audio_output.Load(), 100.0f * audio_output.PeakLoad(), (unsigned long long)audio_output.LateBlocks());
+                if (audio_output.Crossover() == (size_t)-1)
+                    ImGui::TextDisabled("%s bank (direct is faster at every count here)", audio_output.SpectralActive() ? "IFFT" : "Direct");
+                else
+                    ImGui::TextDisabled("%s bank (IFFT is faster above ~%zu partials)", audio_output.SpectralActive() ? "IFFT" : "Direct",
+                                        audio_output.Crossover());
+            }
+            else if (audio_output.Error()[0] != '\0')
+            {
+                ImGui::SameLine();
+                ImGui::TextDisabled("(%s)", audio_output.Error());
+            }
+
+            // The partial sum over one period for every term count, cached, so
+            // dragging Num Circles or replaying the sweep only looks levels up
+            static bool show_convergence = false;
+            ImGui::Checkbox("Convergence", &show_convergence);
+            if (show_convergence)
+            {
+                const size_t convergence_terms = 360, convergence_points = 1024;
+                static Dsp::ConvergenceCache convergence;
+                static int convergence_budget_mb = 4;
+                static bool replay = false;
+                static float replay_rate = 30.0f;
+                static double replay_terms = 1.0;
+                ImGui::SameLine();
+                ImGui::SetNextItemWidth(120 * scale);
+                bool relayout = ImGui::SliderInt("Budget (MB)", &convergence_budget_mb, 1, 64);
+                ImGui::SameLine();
+                ImGui::Checkbox("Replay", &replay);
+                ImGui::SameLine();
+                ImGui::SetNextItemWidth(120 * scale);
+                ImGui::SliderFloat("Terms/s", &replay_rate, 1.0f, 360.0f, "%.0f", ImGuiSliderFlags_Logarithmic);
+                if (convergence.Count() == 0 || relayout)
+                {
+                    Core::AllocScope scope(Core::AllocTag::Dsp);
+                    std::vector<Dsp::Epicycle> series(convergence_terms);
+                    Dsp::MakeSeries(Dsp::SeriesType::Square, convergence_terms, 1.0f, series.data());
+                    convergence.SetBudget((size_t)convergence_budget_mb << 20);
+                    convergence.Configure(series.data(), series.size(), convergence_points);
+                    convergence.Precompute();
+                }
+                if (replay)
+                {
+                    replay_terms += (double)(io.DeltaTime * replay_rate);
+                    if (replay_terms >= (double)(convergence_terms + 1))
+                        replay_terms = 1.0;
+                    num_circles = (int)replay_terms;
+                }
+                else
+                    replay_terms = (double)num_circles;
+                Dsp::ConvergenceCache::Level level = convergence.Get((size_t)num_circles);
+                char overlay[32];
+                snprintf(overlay, sizeof(overlay), "%d terms", num_circles);
+                ImGui::PlotLines("##convergence", func_type == 1 ? level.x : level.y, (int)convergence.Points(), 0, overlay,
+                                 -1.5f, 1.5f, ImVec2(ImGui::GetContentRegionAvail().x, 100 * scale));
+                ImGui::TextDisabled("%zu of %zu levels cached (checkpoints every %zu), %llu hits, %llu misses, %llu circles added",
+                                    convergence.CachedLevels(), convergence.Count(), convergence.CheckpointSpacing(),
+                                    (unsigned long long)convergence.Hits(), (unsigned long long)convergence.Misses(),
+                                    (unsigned long long)convergence.Additions());
+            }
 
             // Get current draw list
             ImDrawList* draw_list = ImGui::GetWindowDrawList();
+            scene_canvas.Begin(draw_list);
             
             // Parameters
-            ImVec2 center = ImGui::GetCursorScreenPos();
+            ImVec2 canvas_min = ImGui::GetCursorScreenPos();
+            ImVec2 center = canvas_min;
             center.x += 100 * scale; // offset from cursor
             center.y += 150 * scale;
-            int segments = 64; // Higher = smoother
+
+            // Detail for this frame from what the last one cost; the CPU
+            // rasterizer draws full detail without vertices
+            static std::vector<float> wave_data;
+            if (scene_canvas.software)
+                vertex_budget.Update(draw_stats, 0, 0);
+            else
+                vertex_budget.Update(draw_stats, num_circles, (int)wave_data.size() + 1);
+            int segments = vertex_budget.circle_segments; // Higher = smoother
+            size_t stride = (size_t)vertex_budget.trace_stride;
 
             double time = ImGui::GetTime();
 
-            ImVec2 prev_pos = center;
             ImVec2 current_pos = center;
             float base_radius = 60.0f * scale;
             float max_extent = 0.0f;
             ImVec2 last_circle_center = center;
 
+            // Joints of the chain, accumulated with the selected summation so
+            // long chains keep an accurate tip
+            std::pmr::vector<Dsp::Epicycle> circles(num_circles, &frame_arena);
+            std::pmr::vector<float> joint_x(num_circles, &frame_arena);
+            std::pmr::vector<float> joint_y(num_circles, &frame_arena);
+            Dsp::MakeSeries(Dsp::SeriesType::Square, (size_t)num_circles, base_radius, circles.data());
+
+            // Integer evaluation of the chain: bit-identical joints on every compiler and CPU
+            std::pmr::vector<Dsp::FixedEpicycle> fixed_circles(&frame_arena);
+            std::pmr::vector<int32_t> fixed_x(&frame_arena);
+            std::pmr::vector<int32_t> fixed_y(&frame_arena);
+            if (fixed_point)
+            {
+                fixed_circles.resize(num_circles);
+                fixed_x.resize(num_circles);
+                fixed_y.resize(num_circles);
+                for (int i = 0; i < num_circles; i++)
+                {
+                    fixed_circles[i].radius_q16 = (int32_t)lroundf(circles[i].radius * 65536.0f);
+                    fixed_circles[i].harmonic = circles[i].harmonic;
+                }
+                double turns = fmod(time / (2.0 * 3.14159265358979), 1.0);
+                uint32_t turn = (uint32_t)(uint64_t)llround(turns * 4294967296.0);
+                Core::PerfScope perf("epicycles");
+                Dsp::EvaluateEpicyclesFixed(fixed_circles.data(), fixed_circles.size(), turn, fixed_x.data(), fixed_y.data());
+            }
+            else
+            {
+                Core::PerfScope perf("epicycles");
+                Dsp::EvaluateEpicycles(circles.data(), circles.size(), time, joint_x.data(), joint_y.data(), summation_mode);
+            }
+
+            // Joint positions first, so circles and the chain are drawn (and
+            // counted) as separate layers
+            std::pmr::vector<ImVec2> joints(num_circles + 1, &frame_arena);
+            joints[0] = center;
             for (int i = 0; i < num_circles; i++)
             {
-                float n = (float)(2 * i + 1);
-                float radius = base_radius * (4.0f / (n * 3.14159f));
-                max_extent += radius;
-                float angle = (float)(-time * n);
-                current_pos.x = prev_pos.x + radius * cosf(angle);
-                current_pos.y = prev_pos.y + radius * sinf(angle);
-                draw_list->AddCircle(prev_pos, radius, IM_COL32(255, 255, 255, 100), segments);
-                draw_list->AddLine(prev_pos, current_pos, IM_COL32(255, 255, 255, 100));
-                last_circle_center = prev_pos;
-                prev_pos = current_pos;
+                max_extent += circles[i].radius;
+                if (fixed_point)
+                    joints[i + 1] = ImVec2(center.x + (float)fixed_x[i] * (1.0f / 65536.0f), center.y + (float)fixed_y[i] * (1.0f / 65536.0f));
+                else
+                    joints[i + 1] = ImVec2(center.x + joint_x[i], center.y + joint_y[i]);
+            }
+            current_pos = joints[num_circles];
+            last_circle_center = joints[num_circles - 1];
+            {
+                DrawStats::Scope layer(draw_stats, draw_list, "circles");
+                for (int i = 0; i < num_circles; i++)
+                    scene_canvas.AddCircle(joints[i], circles[i].radius, IM_COL32(255, 255, 255, 100), segments);
+            }
+            {
+                DrawStats::Scope layer(draw_stats, draw_list, "chain");
+                for (int i = 0; i < num_circles; i++)
+                    scene_canvas.AddLine(joints[i], joints[i + 1], IM_COL32(255, 255, 255, 100));
             }
 
             // Tangent on last circle
@@ -226,32 +618,150 @@ int main(int, char**)
             ImVec2 t1 = ImVec2(current_pos.x - tangent_vec.x * tangent_len, current_pos.y - tangent_vec.y * tangent_len);
             ImVec2 t2 = ImVec2(current_pos.x + tangent_vec.x * tangent_len, current_pos.y + tangent_vec.y * tangent_len);
             
-            draw_list->AddLine(t1, t2, IM_COL32(0, 255, 255, 255), 2.0f);
-            draw_list->AddCircleFilled(current_pos, 4.0f * scale, IM_COL32(255, 0, 0, 255));
+            {
+                DrawStats::Scope layer(draw_stats, draw_list, "tangent");
+                scene_canvas.AddLine(t1, t2, IM_COL32(0, 255, 255, 255), 2.0f);
+                scene_canvas.AddCircleFilled(current_pos, 4.0f * scale, IM_COL32(255, 0, 0, 255));
+            }
 
             // Calculate value to plot
-            float val = 0.0f;
-            float dx = current_pos.x - center.x;
-            float dy = current_pos.y - center.y;
-            float epsilon = 0.001f;
-
-            switch (func_type)
-            {
-                case 0: val = dy; break; // Sine
-                case 1: val = dx; break; // Cosine
-                case 2: val = (fabsf(dx) > epsilon) ? (dy / dx) * base_radius : ((dy > 0) ? 2000.0f : -2000.0f); break; // Tan
-                case 3: val = (fabsf(dy) > epsilon) ? (base_radius * base_radius) / dy : ((dy > 0) ? 2000.0f : -2000.0f); break; // Csc
-                case 4: val = (fabsf(dx) > epsilon) ? (base_radius * base_radius) / dx : ((dx > 0) ? 2000.0f : -2000.0f); break; // Sec
-                case 5: val = (fabsf(dy) > epsilon) ? (dx / dy) * base_radius : ((dx > 0) ? 2000.0f : -2000.0f); break; // Cot
+            auto value_of = [&](float dx, float dy)
+            {
+                float val = 0.0f;
+                float epsilon = 0.001f;
+
+                switch (func_type)
+                {
+                    case 0: val = dy; break; // Sine
+                    case 1: val = dx; break; // Cosine
+                    case 2: val = (fabsf(dx) > epsilon) ? (dy / dx) * base_radius : ((dy > 0) ? 2000.0f : -2000.0f); break; // Tan
+                    case 3: val = (fabsf(dy) > epsilon) ? (base_radius * base_radius) / dy : ((dy > 0) ? 2000.0f : -2000.0f); break; // Csc
+                    case 4: val = (fabsf(dx) > epsilon) ? (base_radius * base_radius) / dx : ((dx > 0) ? 2000.0f : -2000.0f); break; // Sec
+                    case 5: val = (fabsf(dy) > epsilon) ? (dx / dy) * base_radius : ((dx > 0) ? 2000.0f : -2000.0f); break; // Cot
+                }
+
+                if (val > 4000.0f) val = 4000.0f;
+                if (val < -4000.0f) val = -4000.0f;
+                return val;
+            };
+            float val = value_of(current_pos.x - center.x, current_pos.y - center.y);
+
+            // Optional fixed-rate source: the curve is sampled at source_rate
+            // and resampled to the display rate, so the graph shows an
+            // anti-aliased trace instead of whatever each frame happens to hit.
+            static bool resample_trace = false;
+            static int source_rate = 1000;
+            static Dsp::Resampler trace_resampler;
+            static double resampler_display_rate = 0.0;
+            static double source_time = 0.0;
+            static std::vector<float> source_block;
+            static std::vector<float> display_block;
+            static float last_resampled = 0.0f;
+            {
+                bool changed = ImGui::Checkbox("Resample", &resample_trace);
+                ImGui::SameLine();
+                ImGui::SetNextItemWidth(150 * scale);
+                changed |= ImGui::SliderInt("Source rate (Hz)", &source_rate, 100, 48000, "%d", ImGuiSliderFlags_Logarithmic);
+                const double max_block_seconds = 0.25;
+                double display_rate = (io.Framerate > 1.0f) ? (double)io.Framerate : 60.0;
+                // The bank is rebuilt (and allocates) only on user changes or a large
+                // display rate swing; small drift is followed by SetRatio.
+                if (resample_trace && (changed || fabs(display_rate / resampler_display_rate - 1.0) > 0.1))
+                {
+                    Core::AllocScope scope(Core::AllocTag::Dsp);
+                    Dsp::ResamplerSpec spec;
+                    spec.passband = 0.8;
+                    trace_resampler = Dsp::Resampler(display_rate / source_rate, 1, spec);
+                    resampler_display_rate = display_rate;
+                    source_block.assign((size_t)(source_rate * max_block_seconds) + 1, 0.0f);
+                    display_block.assign(trace_resampler.MaxOutput(source_block.size()), 0.0f);
+                    source_time = time;
+                }
+                if (resample_trace)
+                {
+                    trace_resampler.SetRatio(display_rate / source_rate);
+                    if (time - source_time > max_block_seconds)
+                        source_time = time - max_block_seconds;
+                    Core::PerfScope perf("resample");
+                    size_t count = 0;
+                    while (source_time + 1.0 / source_rate <= time && count < source_block.size())
+                    {
+                        source_time += 1.0 / source_rate;
+                        Dsp::Complex tip = Dsp::EpicycleTip(circles.data(), circles.size(), source_time, summation_mode);
+                        source_block[count++] = value_of(tip.real(), tip.imag());
+                    }
+                    size_t produced = trace_resampler.Process(source_block.data(), count, display_block.data());
+                    if (produced > 0)
+                        last_resampled = display_block[produced - 1];
+                    val = last_resampled;
+                }
+            }
+
+            // Optional IIR stage between the generated value and the graph (one sample per frame)
+            static bool filter_trace = false;
+            static Dsp::FilterSpec filter_spec;
+            static Dsp::BiquadCascade trace_filter(Dsp::DesignIir(filter_spec), 1);
+            {
+                bool changed = ImGui::Checkbox("Filter", &filter_trace);
+                ImGui::SameLine();
+                int family = (int)filter_spec.family;
+                int response = (int)filter_spec.response;
+                float cutoff = (float)filter_spec.cutoff;
+                ImGui::SetNextItemWidth(120 * scale);
+                changed |= ImGui::Combo("##family", &family, "Butterworth\0Chebyshev I\0Elliptic\0");
+                ImGui::SameLine();
+                ImGui::SetNextItemWidth(100 * scale);
+                changed |= ImGui::Combo("##response", &response, "Low-pass\0High-pass\0");
+                ImGui::SameLine();
+                ImGui::SetNextItemWidth(100 * scale);
+                changed |= ImGui::SliderInt("Order", &filter_spec.order, 1, 12);
+                ImGui::SameLine();
+                ImGui::SetNextItemWidth(150 * scale);
+                changed |= ImGui::SliderFloat("Cutoff (cycles/frame)", &cutoff, 0.002f, 0.45f, "%.3f", ImGuiSliderFlags_Logarithmic);
+                if (changed)
+                {
+                    filter_spec.family = (Dsp::FilterFamily)family;
+                    filter_spec.response = (Dsp::FilterResponse)response;
+                    filter_spec.cutoff = cutoff;
+                    Core::AllocScope scope(Core::AllocTag::Dsp);
+                    trace_filter = Dsp::BiquadCascade(Dsp::DesignIir(filter_spec), 1);
+                }
+            }
+            if (filter_trace)
+                val = trace_filter.ProcessSample(val);
+            // The graph recomputed from the series across its whole width every
+            // frame, one sample per 1/60 s, instead of one new sample per frame
+            static bool resynthesize_graph = false;
+            static Dsp::BasisCache graph_basis;
+            static int basis_limit_mb = 64;
+            ImGui::Checkbox("Resynthesize graph", &resynthesize_graph);
+            if (resynthesize_graph)
+            {
+                ImGui::SameLine();
+                ImGui::SetNextItemWidth(150 * scale);
+                if (ImGui::SliderInt("Basis limit (MB)", &basis_limit_mb, 1, 256))
+                    graph_basis.SetMemoryLimit((size_t)basis_limit_mb << 20);
+                ImGui::SameLine();
+                if (graph_basis.Cached())
+                    ImGui::TextDisabled("(%zu x %d basis, %.1f MB, %llu builds)", graph_basis.Points(), graph_basis.MaxHarmonic(),
+                                        (double)graph_basis.Bytes() / (1 << 20), (unsigned long long)graph_basis.Builds());
+                else
+                    ImGui::TextDisabled("(over the limit: rows generated every frame)");
             }
 
-            if (val > 4000.0f) val = 4000.0f;
-            if (val < -4000.0f) val = -4000.0f;
             float plot_y = center.y + val;
+            if (sample_ring.IsOpen())
+            {
+                Core::RingSample sample;
+                sample.tick = (uint64_t)ImGui::GetFrameCount();
+                sample.time = time;
+                sample.plot_y = val / scale;
+                sample.tip_x = (current_pos.x - center.x) / scale;
+                sample.tip_y = (current_pos.y - center.y) / scale;
+                sample_ring.Publish(sample);
+            }
 
             // Graph
-            static std::vector<float> wave_data;
-            
             float graph_x_start = center.x + max_extent + 50.0f * scale;
             float avail_width = ImGui::GetContentRegionAvail().x;
             float graph_width = avail_width - (graph_x_start - ImGui::GetCursorScreenPos().x);
@@ -261,21 +771,227 @@ int main(int, char**)
                 wave_data.erase(wave_data.begin(), wave_data.begin() + (wave_data.size() - (size_t)graph_width));
             wave_data.push_back(plot_y);
 
-            draw_list->AddLine(current_pos, ImVec2(graph_x_start, plot_y), IM_COL32(255, 255, 255, 50));
+            scene_canvas.AddLine(current_pos, ImVec2(graph_x_start, plot_y), IM_COL32(255, 255, 255, 50));
 
-            if (wave_data.size() > 1)
+            if (resynthesize_graph)
             {
-                for (size_t i = 0; i < wave_data.size() - 1; i++)
+                size_t points = (size_t)graph_width;
+                std::pmr::vector<float> graph_x(points, &frame_arena);
+                std::pmr::vector<float> graph_y(points, &frame_arena);
+                {
+                    Core::PerfScope perf("resynthesis");
+                    Core::AllocScope scope(Core::AllocTag::Dsp);
+                    graph_basis.Synthesize(circles.data(), circles.size(), time, points, -1.0 / 60.0, graph_x.data(), graph_y.data(),
+                                           &Core::ThreadPool::Global());
+                }
+                DrawStats::Scope layer(draw_stats, draw_list, "trace");
+                for (size_t i = 0; i + 1 < points; i += stride)
                 {
-                    float x1 = graph_x_start + (wave_data.size() - 1 - i);
+                    size_t j = std::min(i + stride, points - 1);
+                    ImVec2 p1(graph_x_start + (float)i, center.y + value_of(graph_x[i], graph_y[i]));
+                    ImVec2 p2(graph_x_start + (float)j, center.y + value_of(graph_x[j], graph_y[j]));
+                    scene_canvas.AddLine(p1, p2, IM_COL32(255, 0, 0, 255), 1.5f);
+                }
+            }
+            else if (wave_data.size() > 1)
+            {
+                // Every stride-th sample when over budget; the newest is always drawn
+                DrawStats::Scope layer(draw_stats, draw_list, "trace");
+                size_t last = wave_data.size() - 1;
+                for (size_t i = 0; i < last; i += stride)
+                {
+                    size_t j = std::min(i + stride, last);
+                    float x1 = graph_x_start + (last - i);
                     float y1 = wave_data[i];
-                    float x2 = graph_x_start + (wave_data.size() - 1 - (i + 1));
-                    float y2 = wave_data[i + 1];
-                    draw_list->AddLine(ImVec2(x1, y1), ImVec2(x2, y2), IM_COL32(255, 0, 0, 255), 1.5f);
+                    float x2 = graph_x_start + (last - j);
+                    float y2 = wave_data[j];
+                    scene_canvas.AddLine(ImVec2(x1, y1), ImVec2(x2, y2), IM_COL32(255, 0, 0, 255), 1.5f);
                 }
             }
+            // The window background as it appears over the clear colour
+            ImVec4 window_bg = ImGui::GetStyleColorVec4(ImGuiCol_WindowBg);
+            ImU32 canvas_bg = ImGui::ColorConvertFloat4ToU32(ImVec4(window_bg.x * window_bg.w + clear_color.x * (1.0f - window_bg.w),
+                                                                    window_bg.y * window_bg.w + clear_color.y * (1.0f - window_bg.w),
+                                                                    window_bg.z * window_bg.w + clear_color.z * (1.0f - window_bg.w), 1.0f));
+            ImVec2 canvas_max(graph_x_start + graph_width, canvas_min.y + 300 * scale);
+            {
+                Core::PerfScope perf("raster");
+                Core::AllocScope scope(Core::AllocTag::Render);
+                scene_canvas.End(renderer, canvas_min, canvas_max, canvas_bg, &Core::ThreadPool::Global());
+            }
+            // Whole path of the tip, over the scene and under the overlays
+            {
+                Core::AllocScope scope(Core::AllocTag::Render);
+                tip_trail.Update(renderer, draw_list, canvas_min, canvas_max, current_pos, io.DeltaTime);
+            }
 
             ImGui::Dummy(ImVec2(graph_x_start - ImGui::GetCursorScreenPos().x + graph_width, 300 * scale));
+
+            // The scene above, rendered offline at poster / 8K width
+            static char export_path[256] = "epicycles.png";
+            static int export_width = 7680;
+            ImGui::SetNextItemWidth(200 * scale);
+            ImGui::InputText("##export_path", export_path, sizeof(export_path));
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(120 * scale);
+            ImGui::InputInt("Width (px)", &export_width, 0);
+            export_width = std::clamp(export_width, 16, 65536);
+            ImGui::SameLine();
+            if (scene_export.Running())
+            {
+                ImGui::ProgressBar(scene_export.Progress(), ImVec2(150 * scale, 0));
+                ImGui::SameLine();
+                if (ImGui::Button("Cancel"))
+                    scene_export.Cancel();
+            }
+            else
+            {
+                if (ImGui::Button("Export PNG/TIFF"))
+                    scene_export.Start(scene_canvas.Scene(), canvas_min, canvas_max, export_width, canvas_bg, export_path);
+                ImGui::SameLine();
+                ImGui::TextUnformatted(scene_export.Status());
+            }
+
+            // Envelope and instantaneous frequency of the trace from its analytic signal:
+            // exact over the whole visible trace (block FFT), or causal with a fixed lag (FIR)
+            static bool show_envelope = false;
+            static bool show_frequency = false;
+            static int hilbert_mode = 0;
+            static Dsp::StreamingHilbert trace_hilbert(255);
+            static std::vector<float> envelope_data;
+            static std::vector<float> frequency_data;
+            ImGui::Checkbox("Envelope", &show_envelope);
+            ImGui::SameLine();
+            ImGui::Checkbox("Inst. frequency", &show_frequency);
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(150 * scale);
+            ImGui::Combo("Analytic signal", &hilbert_mode, "Block FFT\0Streaming FIR\0");
+            if ((show_envelope || show_frequency) && wave_data.size() >= 2)
+            {
+                size_t n = wave_data.size();
+                size_t lag = 0;
+                envelope_data.resize(n);
+                frequency_data.resize(n);
+                if (hilbert_mode == 0)
+                {
+                    static std::unique_ptr<Dsp::HilbertPlan> hilbert_plan;
+                    if (!hilbert_plan || hilbert_plan->Size() != n)
+                    {
+                        Core::AllocScope scope(Core::AllocTag::Dsp);
+                        hilbert_plan = std::make_unique<Dsp::HilbertPlan>(n);
+                    }
+                    std::pmr::vector<float> hilbert_input(n, &frame_arena);
+                    std::pmr::vector<Dsp::Complex> analytic(n, &frame_arena);
+                    Core::PerfScope perf("hilbert");
+                    for (size_t i = 0; i < n; i++)
+                        hilbert_input[i] = wave_data[i] - center.y;
+                    hilbert_plan->Analytic(hilbert_input.data(), analytic.data());
+                    Dsp::Envelope(analytic.data(), envelope_data.data(), n);
+                    Dsp::InstantaneousFrequency(analytic.data(), frequency_data.data(), n);
+                }
+                else
+                {
+                    // Histories stay aligned with wave_data; sample i describes wave_data[i - lag].
+                    Core::PerfScope perf("hilbert");
+                    trace_hilbert.Push(val);
+                    lag = trace_hilbert.Delay();
+                    std::rotate(envelope_data.begin(), envelope_data.begin() + 1, envelope_data.end());
+                    std::rotate(frequency_data.begin(), frequency_data.begin() + 1, frequency_data.end());
+                    envelope_data.back() = trace_hilbert.Envelope();
+                    frequency_data.back() = trace_hilbert.Frequency();
+                }
+
+                // Frequency maps [0, 0.5] cycles/frame onto the graph height.
+                float graph_top = center.y - 150 * scale;
+                float graph_height = 300 * scale;
+                float x_end = graph_x_start + graph_width;
+                DrawStats::Scope layer(draw_stats, draw_list, "overlays");
+                for (size_t i = 0; i + 1 < n; i += stride)
+                {
+                    size_t j = std::min(i + stride, n - 1);
+                    float x1 = graph_x_start + (float)(n - 1 - i + lag);
+                    float x2 = x1 - (float)(j - i);
+                    if (x1 > x_end)
+                        continue;
+                    if (show_envelope)
+                    {
+                        draw_list->AddLine(ImVec2(x1, center.y - envelope_data[i]), ImVec2(x2, center.y - envelope_data[j]), IM_COL32(255, 220, 0, 200));
+                        draw_list->AddLine(ImVec2(x1, center.y + envelope_data[i]), ImVec2(x2, center.y + envelope_data[j]), IM_COL32(255, 220, 0, 200));
+                    }
+                    if (show_frequency)
+                    {
+                        float y1 = graph_top + graph_height * (1.0f - 2.0f * fabsf(frequency_data[i]));
+                        float y2 = graph_top + graph_height * (1.0f - 2.0f * fabsf(frequency_data[j]));
+                        draw_list->AddLine(ImVec2(x1, y1), ImVec2(x2, y2), IM_COL32(0, 255, 120, 200));
+                    }
+                }
+                if (show_frequency)
+                {
+                    ImGui::SameLine();
+                    ImGui::Text("%.2f Hz", fabsf(frequency_data.back()) * io.Framerate);
+                }
+            }
+            else
+            {
+                trace_hilbert.Reset();
+                envelope_data.clear();
+                frequency_data.clear();
+            }
+
+            // Scalogram of the plotted value, fed one sample per frame
+            static bool show_scalogram = false;
+            static int wavelet_type = 0;
+            static Dsp::StreamingDwt scalogram_dwt(Dsp::Wavelet{ Dsp::WaveletType::Haar, 1 }, 7, 4096);
+            ImGui::Checkbox("Scalogram", &show_scalogram);
+            ImGui::SameLine();
+            ImGui::SetNextItemWidth(150 * scale);
+            if (ImGui::Combo("Wavelet", &wavelet_type, "Haar\0Daubechies-2\0Daubechies-4\0CDF 9/7\0"))
+            {
+                static const Dsp::Wavelet wavelets[] = { { Dsp::WaveletType::Haar, 1 }, { Dsp::WaveletType::Daubechies, 2 }, { Dsp::WaveletType::Daubechies, 4 }, { Dsp::WaveletType::Cdf97, 0 } };
+                Core::AllocScope scope(Core::AllocTag::Dsp);
+                scalogram_dwt = Dsp::StreamingDwt(wavelets[wavelet_type], 7, 4096);
+            }
+            scalogram_dwt.Push(val);
+            if (show_scalogram)
+            {
+                ImVec2 origin = ImGui::GetCursorScreenPos();
+                origin.x = graph_x_start;
+                Core::AllocScope scope(Core::AllocTag::Render);
+                Core::PerfScope perf("scalogram");
+                DrawStats::Scope layer(draw_stats, draw_list, "scalogram");
+                DrawScalogram(draw_list, origin, ImVec2(graph_width, 140 * scale), scalogram_dwt);
+                ImGui::Dummy(ImVec2(graph_x_start - ImGui::GetCursorScreenPos().x + graph_width, 140 * scale));
+            }
+
+            // Morlet CWT of the whole trace, shown as a texture (newest on the left)
+            static bool show_cwt = false;
+            ImGui::Checkbox("CWT", &show_cwt);
+            if (show_cwt && wave_data.size() >= 64)
+            {
+                const size_t cwt_scales = 64;
+                static std::unique_ptr<Dsp::CwtPlan> cwt_plan;
+                size_t n = wave_data.size();
+                if (!cwt_plan || cwt_plan->Size() != n)
+                {
+                    Core::AllocScope scope(Core::AllocTag::Dsp);
+                    cwt_plan = std::make_unique<Dsp::CwtPlan>(Dsp::CwtWavelet::Morlet, n, Dsp::CwtPlan::LogScales(2.0f, (float)n / 8.0f, cwt_scales));
+                }
+                std::pmr::vector<float> cwt_input(wave_data.rbegin(), wave_data.rend(), &frame_arena);
+                std::pmr::vector<float> cwt_image(cwt_scales * n, &frame_arena);
+                {
+                    Core::PerfScope perf("cwt");
+                    cwt_plan->Scalogram(cwt_input.data(), cwt_image.data(), n, &Core::ThreadPool::Global());
+                }
+                cwt_texture = UploadHeatmap(renderer, cwt_texture, cwt_image.data(), (int)n, (int)cwt_scales);
+
+                ImVec2 origin = ImGui::GetCursorScreenPos();
+                origin.x = graph_x_start;
+                DrawStats::Scope layer(draw_stats, draw_list, "cwt");
+                if (cwt_texture != nullptr)
+                    draw_list->AddImage((ImTextureID)cwt_texture, origin, ImVec2(origin.x + (float)n, origin.y + 140 * scale));
+                ImGui::Dummy(ImVec2(graph_x_start - ImGui::GetCursorScreenPos().x + graph_width, 140 * scale));
+            }
+
             ImGui::Text("Epicycles with Tangent and Real-time Graph");
             if (ImGui::Button("Close Me"))
                 show_circle_window = false;
@@ -283,20 +999,27 @@ int main(int, char**)
         }
 
         // Rendering
-        ImGui::Render();
-        SDL_RenderSetScale(renderer, io.DisplayFramebufferScale.x, io.DisplayFramebufferScale.y);
-        SDL_SetRenderDrawColor(renderer, (Uint8)(clear_color.x * 255), (Uint8)(clear_color.y * 255), (Uint8)(clear_color.z * 255), (Uint8)(clear_color.w * 255));
-        SDL_RenderClear(renderer);
-        ImGui_ImplSDLRenderer2_RenderDrawData(ImGui::GetDrawData());
+        {
+            Core::PerfScope perf("render");
+            ImGui::Render();
+            draw_stats.CaptureWindows(ImGui::GetDrawData());
+            SDL_RenderSetScale(renderer, io.DisplayFramebufferScale.x, io.DisplayFramebufferScale.y);
+            SDL_SetRenderDrawColor(renderer, (Uint8)(clear_color.x * 255), (Uint8)(clear_color.y * 255), (Uint8)(clear_color.z * 255), (Uint8)(clear_color.w * 255));
+            SDL_RenderClear(renderer);
+            ImGui_ImplSDLRenderer2_RenderDrawData(ImGui::GetDrawData());
+        }
         SDL_RenderPresent(renderer);
     }
 
     // Cleanup
+    audio_output.Close();
     ImGui_ImplSDLRenderer2_Shutdown();
     ImGui_ImplSDL2_Shutdown();
     ImGui::DestroyContext();
     
 
+    if (cwt_texture != nullptr)
+        SDL_DestroyTexture(cwt_texture);
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
@@ -0,0 +1,19 @@
+// Minimal assertion helper shared by the test executables: a failed CHECK
+// prints its location and condition and is counted, so one run reports
+// every failure. main() returns non-zero when `failures` is non-zero.
+
+#pragma once
+
+#include <cstdio>
+
+inline int failures = 0;
+
+#define CHECK(cond)                                                       \
+    do                                                                    \
+    {                                                                     \
+        if (!(cond))                                                      \
+        {                                                                 \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            failures++;                                                   \
+        }                                                                 \
+    } while (0)
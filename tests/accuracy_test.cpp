@@ -0,0 +1,1276 @@
+// Property-based accuracy checks for the DSP kernels.
+//
+// Every transform, series generator and approximation kernel is run on
+// randomized sizes and inputs and compared against a plain long double
+// evaluation of its definition; where a kernel has no closed form (wavelet
+// lifting, streaming filters) it is checked against an identity it must
+// satisfy instead. For each kernel the worst normwise relative error
+// (||y - ref|| / ||ref||) and the worst error in units in the last place of
+// the output format (at the largest reference magnitude) are reported, and
+// the run fails when either exceeds the kernel's bound.
+//
+// Usage: accuracy-test [seed] [rounds]
+
+#include "Dsp/BatchFft.h"
+#include "Dsp/Basis.h"
+#include "Dsp/Convergence.h"
+#include "Dsp/Cwt.h"
+#include "Dsp/Dct.h"
+#include "Dsp/Epicycles.h"
+#include "Dsp/Fft.h"
+#include "Dsp/FftCodelets.h"
+#include "Dsp/Filter.h"
+#include "Dsp/FixedFft.h"
+#include "Dsp/Hilbert.h"
+#include "Dsp/OscillatorBank.h"
+#include "Dsp/Resampler.h"
+#include "Dsp/Series.h"
+#include "Dsp/SpectralBank.h"
+#include "Dsp/Summation.h"
+#include "Dsp/Wavelet.h"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <numbers>
+#include <random>
+#include <vector>
+
+using Dsp::Complex;
+using LComplex = std::complex<long double>;
+using Rng = std::mt19937_64;
+
+static const long double pi_l = std::numbers::pi_v<long double>;
+
+//-----------------------------------------------------------------------------
+// Bookkeeping
+//-----------------------------------------------------------------------------
+
+struct Kernel
+{
+    const char* name;
+    double max_relative;        // Bound on the normwise relative error
+    double max_ulps;            // Bound on the error in output ulps / LSBs, 0 = reported only
+
+    size_t cases = 0;
+    double relative = 0.0;      // Worst observed
+    double ulps = 0.0;
+    size_t worst_size = 0;
+};
+
+// Bounds leave headroom over the worst errors seen across many seeds; they
+// are there to catch regressions, not to certify the last bit.
+static Kernel kernels[] =
+{
+    { "fft",                2e-6,   64 },
+    { "fft-generic",        2e-6,   64 },
+    { "fft-roundtrip",      2e-6,   64 },
+    { "real-fft",           2e-6,   64 },
+    { "real-fft-roundtrip", 2e-6,   64 },
+    { "batch-fft",          2e-6,   64 },
+    { "dct-i",              4e-6,   256 },
+    { "dct-ii",             2e-6,   64 },
+    { "dct-iii",            2e-6,   64 },
+    { "dct-iv",             2e-6,   64 },
+    { "dst-i",              4e-6,   256 },
+    { "dst-ii",             2e-6,   64 },
+    { "dst-iii",            2e-6,   64 },
+    { "dst-iv",             2e-6,   64 },
+    { "mdct",               2e-6,   64 },
+    { "mdct-tdac",          2e-6,   64 },
+    { "dct-2d",             2e-6,   64 },
+    { "dwt-roundtrip",      2e-6,   64 },
+    { "dwt-energy",         2e-6,   0 },
+    { "dwt-streaming",      2e-6,   64 },
+    { "daubechies-filter",  1e-12,  0 },
+    { "cwt",                2e-6,   64 },
+    { "iir-response",       1e-12,  0 },
+    { "biquad",             1e-4,   0 },
+    { "fir",                1e-6,   16 },
+    { "fir-design",         1e-6,   16 },
+    { "hilbert",            2e-6,   64 },
+    { "envelope",           2e-7,   2 },
+    { "inst-frequency",     2e-6,   0 },
+    { "unwrapped-phase",    1e-6,   4 },
+    { "hilbert-fir",        2e-3,   0 },
+    { "hilbert-fir-phase",  1e-5,   0 },
+    { "resampler-rational", 1e-3,   0 },
+    { "resampler-ratio",    1e-3,   0 },
+    { "fixed-fft-q15",      2e-3,   0 },
+    { "fixed-fft-q31",      1e-6,   0 },
+    { "sin-cos-q31",        4e-7,   700 },
+    { "epicycles-fixed",    1e-5,   0 },
+    { "codelet-sin-cos",    4e-15,  16 },
+    { "sum-naive",          1e-5,   0 },
+    { "sum-compensated",    1e-7,   1 },
+    { "sum-pairwise",       1e-6,   0 },
+    { "prefix-naive",       1e-5,   0 },
+    { "prefix-compensated", 1e-7,   0 },
+    { "prefix-pairwise",    1e-6,   0 },
+    { "epicycles-naive",    1e-5,   0 },
+    { "epicycles-compensated", 2e-7, 4 },
+    { "epicycles-pairwise", 1e-6,   0 },
+    { "series-period",      1e-6,   0 },
+    { "oscillator-bank",    1e-5,   0 },
+    { "spectral-bank",      1e-4,   0 },
+    { "convergence",        1e-6,   0 },
+    { "basis",              1e-6,   0 },
+};
+
+static Kernel& Find(const char* name)
+{
+    for (Kernel& k : kernels)
+        if (strcmp(k.name, name) == 0)
+            return k;
+    std::fprintf(stderr, "unknown kernel %s\n", name);
+    std::abort();
+}
+
+static void Record(const char* name, size_t size, double relative, double ulps)
+{
+    Kernel& k = Find(name);
+    k.cases++;
+    if (relative > k.relative || (relative == k.relative && ulps > k.ulps))
+        k.worst_size = size;
+    k.relative = std::max(k.relative, relative);
+    k.ulps = std::max(k.ulps, ulps);
+}
+
+// One ulp of a float / double of magnitude x.
+static long double FloatUlp(long double x)
+{
+    return (x > 0) ? std::ldexp(1.0L, std::ilogb(x) - 23) : (long double)std::numeric_limits<float>::denorm_min();
+}
+
+static long double DoubleUlp(long double x)
+{
+    return (x > 0) ? std::ldexp(1.0L, std::ilogb(x) - 52) : (long double)std::numeric_limits<double>::denorm_min();
+}
+
+// Error of one case: normwise relative error, and the largest absolute error
+// in float ulps of the largest reference magnitude.
+struct Errors
+{
+    long double diff2 = 0, ref2 = 0, max_diff = 0, max_ref = 0;
+
+    void Add(long double got, long double ref)
+    {
+        long double d = got - ref;
+        diff2 += d * d;
+        ref2 += ref * ref;
+        max_diff = std::max(max_diff, std::fabs(d));
+        max_ref = std::max(max_ref, std::fabs(ref));
+    }
+
+    void Add(Complex got, LComplex ref)
+    {
+        Add(got.real(), ref.real());
+        Add(got.imag(), ref.imag());
+    }
+
+    double Relative() const { return (double)(ref2 > 0 ? std::sqrt(diff2 / ref2) : std::sqrt(diff2)); }
+    double FloatUlps() const { return (double)(max_diff / FloatUlp(max_ref)); }
+};
+
+static void Record(const char* name, size_t size, const Errors& e)
+{
+    Record(name, size, e.Relative(), e.FloatUlps());
+}
+
+//-----------------------------------------------------------------------------
+// Random inputs
+//-----------------------------------------------------------------------------
+
+static double Uniform(Rng& rng, double lo, double hi)
+{
+    return std::uniform_real_distribution<double>(lo, hi)(rng);
+}
+
+static size_t UniformInt(Rng& rng, size_t lo, size_t hi)
+{
+    return std::uniform_int_distribution<size_t>(lo, hi)(rng);
+}
+
+// Sizes in [1, max] that exercise each FFT path: powers of two, p * 2^k
+// (mixed radix) and anything else (Bluestein).
+static size_t RandomSize(Rng& rng, size_t max)
+{
+    static const size_t primes[] = { 3, 5, 7, 11, 13 };
+    switch (rng() % 3)
+    {
+    case 0:
+    {
+        size_t n = 1;
+        for (size_t bits = UniformInt(rng, 0, 20); bits > 0 && 2 * n <= max; bits--)
+            n *= 2;
+        return n;
+    }
+    case 1:
+    {
+        size_t n = primes[rng() % 5];
+        for (size_t bits = UniformInt(rng, 0, 20); bits > 0 && 2 * n <= max; bits--)
+            n *= 2;
+        return std::min(n, max);
+    }
+    default:
+        return UniformInt(rng, 1, max);
+    }
+}
+
+static std::vector<float> RandomFloats(Rng& rng, size_t n, double lo = -1.0, double hi = 1.0)
+{
+    std::vector<float> x(n);
+    for (float& v : x)
+        v = (float)Uniform(rng, lo, hi);
+    return x;
+}
+
+static std::vector<Complex> RandomComplex(Rng& rng, size_t n)
+{
+    std::vector<Complex> x(n);
+    for (Complex& v : x)
+        v = Complex((float)Uniform(rng, -1.0, 1.0), (float)Uniform(rng, -1.0, 1.0));
+    return x;
+}
+
+//-----------------------------------------------------------------------------
+// Long double references
+//-----------------------------------------------------------------------------
+
+// Naive DFT; twiddle indices are reduced exactly before the trig call.
+static std::vector<LComplex> ReferenceDft(const std::vector<LComplex>& x, bool inverse)
+{
+    size_t n = x.size();
+    long double sign = inverse ? 1.0L : -1.0L;
+    std::vector<LComplex> w(n);
+    for (size_t k = 0; k < n; k++)
+        w[k] = std::polar(1.0L, sign * 2.0L * pi_l * (long double)k / (long double)n);
+    std::vector<LComplex> y(n);
+    for (size_t k = 0; k < n; k++)
+    {
+        LComplex sum = 0;
+        size_t index = 0;
+        for (size_t j = 0; j < n; j++)
+        {
+            sum += x[j] * w[index];
+            index += k;
+            if (index >= n)
+                index -= n;
+        }
+        y[k] = sum;
+    }
+    return y;
+}
+
+template<typename T>
+static std::vector<LComplex> Widen(const std::vector<T>& x)
+{
+    std::vector<LComplex> y(x.size());
+    for (size_t i = 0; i < x.size(); i++)
+        y[i] = LComplex(x[i]);
+    return y;
+}
+
+static std::vector<long double> ReferenceDct(Dsp::DctType type, const std::vector<float>& x)
+{
+    using Dsp::DctType;
+    size_t n = x.size();
+    long double nl = (long double)n;
+    std::vector<long double> y(n);
+    for (size_t k = 0; k < n; k++)
+    {
+        long double kl = (long double)k, sum = 0;
+        for (size_t j = 0; j < n; j++)
+        {
+            long double jl = (long double)j, xj = x[j];
+            switch (type)
+            {
+            case DctType::DctI:
+                if (j == 0 || j == n - 1)
+                    sum += (j == 0 ? xj : ((k % 2) ? -xj : xj));
+                else
+                    sum += 2 * xj * std::cos(pi_l * jl * kl / (nl - 1));
+                break;
+            case DctType::DctII: sum += 2 * xj * std::cos(pi_l * (jl + 0.5L) * kl / nl); break;
+            case DctType::DctIII: sum += (j == 0) ? xj : 2 * xj * std::cos(pi_l * jl * (kl + 0.5L) / nl); break;
+            case DctType::DctIV: sum += 2 * xj * std::cos(pi_l * (jl + 0.5L) * (kl + 0.5L) / nl); break;
+            case DctType::DstI: sum += 2 * xj * std::sin(pi_l * (jl + 1) * (kl + 1) / (nl + 1)); break;
+            case DctType::DstII: sum += 2 * xj * std::sin(pi_l * (jl + 0.5L) * (kl + 1) / nl); break;
+            case DctType::DstIII: sum += (j == n - 1) ? ((k % 2) ? -xj : xj) : 2 * xj * std::sin(pi_l * (jl + 1) * (kl + 0.5L) / nl); break;
+            case DctType::DstIV: sum += 2 * xj * std::sin(pi_l * (jl + 0.5L) * (kl + 0.5L) / nl); break;
+            }
+        }
+        y[k] = sum;
+    }
+    return y;
+}
+
+//-----------------------------------------------------------------------------
+// Transforms
+//-----------------------------------------------------------------------------
+
+static void TestFft(Rng& rng)
+{
+    size_t n = RandomSize(rng, 2048);
+    bool inverse = rng() % 2;
+    std::vector<Complex> x = RandomComplex(rng, n);
+    std::vector<LComplex> ref = ReferenceDft(Widen(x), inverse);
+
+    for (bool codelets : { true, false })
+    {
+        Dsp::FftPlan plan(n, codelets);
+        std::vector<Complex> y = x;
+        plan.Transform(y.data(), inverse ? Dsp::FftDirection::Inverse : Dsp::FftDirection::Forward);
+        Errors e;
+        for (size_t k = 0; k < n; k++)
+            e.Add(y[k], ref[k]);
+        Record(codelets ? "fft" : "fft-generic", n, e);
+
+        if (codelets)
+        {
+            plan.Transform(y.data(), inverse ? Dsp::FftDirection::Forward : Dsp::FftDirection::Inverse);
+            Errors r;
+            for (size_t k = 0; k < n; k++)
+                r.Add(y[k] / (float)n, LComplex(x[k]));
+            Record("fft-roundtrip", n, r);
+        }
+    }
+}
+
+static void TestRealFft(Rng& rng)
+{
+    size_t n = RandomSize(rng, 2048);
+    std::vector<float> x = RandomFloats(rng, n);
+    std::vector<LComplex> ref = ReferenceDft(Widen(x), false);
+
+    Dsp::RealFftPlan plan(n);
+    std::vector<Complex> spectrum(plan.SpectrumSize());
+    plan.Forward(x.data(), spectrum.data());
+    Errors e;
+    for (size_t k = 0; k < spectrum.size(); k++)
+        e.Add(spectrum[k], ref[k]);
+    Record("real-fft", n, e);
+
+    std::vector<float> back(n);
+    plan.Inverse(spectrum.data(), back.data());
+    Errors r;
+    for (size_t j = 0; j < n; j++)
+        r.Add(back[j] / (float)n, x[j]);
+    Record("real-fft-roundtrip", n, r);
+}
+
+static void TestBatchFft(Rng& rng)
+{
+    size_t n = RandomSize(rng, 512);
+    size_t batch = UniformInt(rng, 1, 40);
+    bool inverse = rng() % 2;
+    std::vector<Complex> data = RandomComplex(rng, n * batch);
+    std::vector<Complex> contiguous(n * batch);
+    for (size_t b = 0; b < batch; b++)
+        for (size_t j = 0; j < n; j++)
+            contiguous[b * n + j] = data[j * batch + b];
+
+    Dsp::BatchFftPlan plan(n);
+    Dsp::FftDirection dir = inverse ? Dsp::FftDirection::Inverse : Dsp::FftDirection::Forward;
+    std::vector<Complex> interleaved = data;
+    plan.Transform(interleaved.data(), batch, dir);
+    plan.TransformContiguous(contiguous.data(), batch, dir);
+
+    Errors e;
+    for (size_t b = 0; b < batch; b++)
+    {
+        std::vector<LComplex> x(n);
+        for (size_t j = 0; j < n; j++)
+            x[j] = LComplex(data[j * batch + b]);
+        std::vector<LComplex> ref = ReferenceDft(x, inverse);
+        for (size_t k = 0; k < n; k++)
+        {
+            e.Add(interleaved[k * batch + b], ref[k]);
+            e.Add(contiguous[b * n + k], ref[k]);
+        }
+    }
+    Record("batch-fft", n, e);
+}
+
+static void TestDct(Rng& rng)
+{
+    static const char* names[] = { "dct-i", "dct-ii", "dct-iii", "dct-iv", "dst-i", "dst-ii", "dst-iii", "dst-iv" };
+    for (int t = 0; t < 8; t++)
+    {
+        Dsp::DctType type = (Dsp::DctType)t;
+        size_t n = std::max<size_t>(2, RandomSize(rng, 512));
+        std::vector<float> x = RandomFloats(rng, n);
+        std::vector<long double> ref = ReferenceDct(type, x);
+        Dsp::DctPlan plan(type, n);
+        std::vector<float> y(n);
+        plan.Execute(x.data(), y.data());
+        Errors e;
+        for (size_t k = 0; k < n; k++)
+            e.Add(y[k], ref[k]);
+        Record(names[t], n, e);
+    }
+}
+
+static void TestMdct(Rng& rng)
+{
+    size_t n = 2 * std::max<size_t>(1, RandomSize(rng, 256));
+    Dsp::MdctPlan plan(n);
+    long double nl = (long double)n;
+
+    // Forward against the definition.
+    std::vector<float> x = RandomFloats(rng, 3 * n);
+    std::vector<float> coeffs(n);
+    plan.Forward(x.data(), coeffs.data());
+    Errors e;
+    for (size_t k = 0; k < n; k++)
+    {
+        long double sum = 0;
+        for (size_t j = 0; j < 2 * n; j++)
+            sum += x[j] * std::cos(pi_l / nl * ((long double)j + 0.5L + nl / 2) * ((long double)k + 0.5L));
+        e.Add(coeffs[k], sum);
+    }
+    Record("mdct", n, e);
+
+    // Time-domain aliasing cancellation: windowed overlap-add of two frames
+    // recovers the shared middle block scaled by n / 2.
+    std::vector<float> window(2 * n);
+    Dsp::MdctPlan::SineWindow(window.data(), n);
+    std::vector<float> frame(2 * n), c0(n), c1(n), y0(2 * n), y1(2 * n);
+    for (size_t j = 0; j < 2 * n; j++)
+        frame[j] = x[j] * window[j];
+    plan.Forward(frame.data(), c0.data());
+    for (size_t j = 0; j < 2 * n; j++)
+        frame[j] = x[n + j] * window[j];
+    plan.Forward(frame.data(), c1.data());
+    plan.Inverse(c0.data(), y0.data());
+    plan.Inverse(c1.data(), y1.data());
+    Errors r;
+    for (size_t j = 0; j < n; j++)
+        r.Add((y0[n + j] * window[n + j] + y1[j] * window[j]) / (0.5f * (float)n), x[n + j]);
+    Record("mdct-tdac", n, r);
+}
+
+static void TestDct2d(Rng& rng)
+{
+    size_t rows = UniformInt(rng, 2, 24), cols = UniformInt(rng, 2, 24);
+    Dsp::DctType type = (Dsp::DctType)(rng() % 4);
+    std::vector<float> x = RandomFloats(rng, rows * cols);
+    Dsp::Dct2dPlan plan(type, rows, cols);
+    std::vector<float> y(rows * cols);
+    plan.Execute(x.data(), y.data());
+
+    // Rows, then columns, each rounded to float like the plan does.
+    std::vector<float> stage(rows * cols);
+    for (size_t r = 0; r < rows; r++)
+    {
+        std::vector<long double> row = ReferenceDct(type, std::vector<float>(x.begin() + r * cols, x.begin() + (r + 1) * cols));
+        for (size_t c = 0; c < cols; c++)
+            stage[r * cols + c] = (float)row[c];
+    }
+    Errors e;
+    for (size_t c = 0; c < cols; c++)
+    {
+        std::vector<float> column(rows);
+        for (size_t r = 0; r < rows; r++)
+            column[r] = stage[r * cols + c];
+        std::vector<long double> ref = ReferenceDct(type, column);
+        for (size_t r = 0; r < rows; r++)
+            e.Add(y[r * cols + c], ref[r]);
+    }
+    Record("dct-2d", rows * cols, e);
+}
+
+static void TestDwt(Rng& rng)
+{
+    Dsp::Wavelet wavelet;
+    switch (rng() % 3)
+    {
+    case 0: wavelet.type = Dsp::WaveletType::Haar; break;
+    case 1: wavelet.type = Dsp::WaveletType::Daubechies; wavelet.order = (int)UniformInt(rng, 1, 10); break;
+    default: wavelet.type = Dsp::WaveletType::Cdf97; break;
+    }
+    int levels = (int)UniformInt(rng, 1, 6);
+    size_t n = UniformInt(rng, 1, 64) << levels;
+    if (wavelet.type == Dsp::WaveletType::Daubechies)
+        n = std::max(n, (size_t)(2 * wavelet.order) << levels);
+
+    std::vector<float> x = RandomFloats(rng, n);
+    std::vector<float> y = x;
+    Dsp::DwtPlan plan(wavelet, n, levels);
+    plan.Forward(y.data());
+
+    // Periodic orthonormal wavelets preserve energy.
+    if (wavelet.type != Dsp::WaveletType::Cdf97)
+    {
+        long double ex = 0, ey = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            ex += (long double)x[i] * x[i];
+            ey += (long double)y[i] * y[i];
+        }
+        Record("dwt-energy", n, (double)(std::fabs(ey - ex) / ex), 0.0);
+    }
+
+    plan.Inverse(y.data());
+    Errors e;
+    for (size_t i = 0; i < n; i++)
+        e.Add(y[i], x[i]);
+    Record("dwt-roundtrip", n, e);
+}
+
+// StreamingDwt and DwtPlan share one sign convention: away from the stream's
+// zero history and the block's periodic wrap, the level-1 details agree.
+static void TestStreamingDwt(Rng& rng)
+{
+    Dsp::Wavelet wavelet;
+    if (rng() % 2 == 0)
+        wavelet.type = Dsp::WaveletType::Haar;
+    else
+    {
+        wavelet.type = Dsp::WaveletType::Daubechies;
+        wavelet.order = (int)UniformInt(rng, 1, 10);
+    }
+    size_t len = Dsp::GetWaveletFilter(wavelet).low.size();
+    size_t n = 2 * UniformInt(rng, len, 256);
+
+    std::vector<float> x = RandomFloats(rng, n);
+    std::vector<float> y = x;
+    Dsp::DwtPlan plan(wavelet, n, 1);
+    plan.Forward(y.data());
+    Dsp::StreamingDwt stream(wavelet, 1, n);
+    for (float v : x)
+        stream.Push(v);
+
+    // Stream detail j ends on sample 2j + 1, block detail i starts on sample
+    // 2i. The D4 lifting factorization is centred one coefficient later.
+    bool d4 = wavelet.type == Dsp::WaveletType::Daubechies && wavelet.order == 2;
+    size_t lag = len / 2 - (d4 ? 2 : 1);
+    size_t count = stream.DetailCount(1);
+    Errors e;
+    for (size_t j = len / 2; j < count && 2 * (j - lag) + len <= n; j++)
+        e.Add(stream.Detail(1, count - 1 - j), y[plan.DetailIndex(1, j - lag)]);
+    Record("dwt-streaming", n, e);
+}
+
+// Orthonormality and vanishing moments of the generated Daubechies filters.
+static void TestDaubechiesFilters()
+{
+    for (int order = 1; order <= 10; order++)
+    {
+        std::vector<double> h = Dsp::DaubechiesLowpass(order);
+        size_t taps = h.size();
+        double worst = 0.0;
+        long double sum = 0;
+        for (double v : h)
+            sum += v;
+        worst = std::max(worst, (double)std::fabs(sum - std::sqrt(2.0L)));
+        for (size_t shift = 0; shift < taps; shift += 2)
+        {
+            long double dot = 0;
+            for (size_t k = 0; k + shift < taps; k++)
+                dot += (long double)h[k] * h[k + shift];
+            worst = std::max(worst, (double)std::fabs(dot - (shift == 0 ? 1.0L : 0.0L)));
+        }
+        // The high-pass (-1)^k h[taps-1-k] annihilates polynomials of degree < order.
+        for (int p = 0; p < order; p++)
+        {
+            long double moment = 0, scale = 0;
+            for (size_t k = 0; k < taps; k++)
+            {
+                long double term = std::pow((long double)k, (long double)p) * h[taps - 1 - k];
+                moment += (k % 2) ? -term : term;
+                scale += std::fabs(term);
+            }
+            worst = std::max(worst, (double)(std::fabs(moment) / scale));
+        }
+        Record("daubechies-filter", taps, worst, 0.0);
+    }
+}
+
+static void TestCwt(Rng& rng)
+{
+    size_t n = UniformInt(rng, 8, 300);
+    Dsp::CwtWavelet wavelet = (rng() % 2) ? Dsp::CwtWavelet::Morlet : Dsp::CwtWavelet::MexicanHat;
+    float omega0 = (float)Uniform(rng, 5.0, 8.0);
+    std::vector<float> scales = Dsp::CwtPlan::LogScales(1.0f, (float)n / 4.0f, 4);
+    std::vector<float> x = RandomFloats(rng, n);
+    Dsp::CwtPlan plan(wavelet, n, scales, omega0);
+
+    // Reference: zero-padded DFT, analytic wavelet response, inverse DFT.
+    size_t m = Dsp::NextPowerOfTwo(2 * n);
+    std::vector<LComplex> padded(m, 0.0L);
+    for (size_t j = 0; j < n; j++)
+        padded[j] = x[j];
+    std::vector<LComplex> spectrum = ReferenceDft(padded, false);
+
+    Errors e;
+    plan.Execute(x.data(), [&](size_t s, const Complex* row)
+    {
+        long double scale = scales[s];
+        std::vector<LComplex> band(m, 0.0L);
+        for (size_t k = 1; k <= m / 2; k++)
+        {
+            long double sw = scale * 2.0L * pi_l * (long double)k / (long double)m, response;
+            if (wavelet == Dsp::CwtWavelet::Morlet)
+                response = 2.0L * std::exp(-0.5L * (sw - omega0) * (sw - omega0));
+            else
+                response = sw * sw * std::exp(1.0L - 0.5L * sw * sw);
+            band[k] = spectrum[k] * response / (long double)m;
+        }
+        std::vector<LComplex> ref = ReferenceDft(band, true);
+        for (size_t j = 0; j < n; j++)
+            e.Add(row[j], ref[j]);
+    });
+    Record("cwt", n, e);
+}
+
+//-----------------------------------------------------------------------------
+// Filters
+//-----------------------------------------------------------------------------
+
+static Dsp::FilterSpec RandomFilterSpec(Rng& rng)
+{
+    Dsp::FilterSpec spec;
+    spec.family = (Dsp::FilterFamily)(rng() % 3);
+    spec.response = (rng() % 2) ? Dsp::FilterResponse::HighPass : Dsp::FilterResponse::LowPass;
+    spec.order = (int)UniformInt(rng, 1, 8);
+    spec.cutoff = Uniform(rng, 0.02, 0.45);
+    return spec;
+}
+
+static void TestIir(Rng& rng)
+{
+    Dsp::FilterSpec spec = RandomFilterSpec(rng);
+    std::vector<Dsp::Biquad> sections = Dsp::DesignIir(spec);
+
+    // Response of the float coefficients, in long double.
+    double freq = Uniform(rng, 0.0, 0.5);
+    LComplex z1 = std::polar(1.0L, -2.0L * pi_l * (long double)freq), z2 = z1 * z1;
+    LComplex h = 1.0L;
+    for (const Dsp::Biquad& s : sections)
+        h *= ((long double)s.b0 + (long double)s.b1 * z1 + (long double)s.b2 * z2) / (1.0L + (long double)s.a1 * z1 + (long double)s.a2 * z2);
+    std::complex<double> got = Dsp::CascadeResponse(sections, freq);
+    Record("iir-response", (size_t)spec.order, (double)(std::abs(LComplex(got.real(), got.imag()) - h) / std::max(std::abs(h), 1e-6L)), 0.0);
+
+    // Processing: float recursion against the same recursion in long double.
+    size_t frames = 2048;
+    std::vector<float> x = RandomFloats(rng, frames), y(frames);
+    Dsp::BiquadCascade cascade(sections, 1);
+    cascade.Process(x.data(), y.data(), frames);
+    std::vector<long double> ref(x.begin(), x.end());
+    for (const Dsp::Biquad& s : sections)
+    {
+        long double x1 = 0, x2 = 0, y1 = 0, y2 = 0;
+        for (long double& v : ref)
+        {
+            long double out = s.b0 * v + s.b1 * x1 + s.b2 * x2 - s.a1 * y1 - s.a2 * y2;
+            x2 = x1;
+            x1 = v;
+            y2 = y1;
+            y1 = out;
+            v = out;
+        }
+    }
+    Errors e;
+    for (size_t i = 0; i < frames; i++)
+        e.Add(y[i], ref[i]);
+    Record("biquad", (size_t)spec.order, e.Relative(), 0.0);
+}
+
+static void TestFir(Rng& rng)
+{
+    size_t taps = UniformInt(rng, 1, 96);
+    size_t decimation = UniformInt(rng, 1, 6);
+    size_t channels = UniformInt(rng, 1, 3);
+    double cutoff = Uniform(rng, 0.02, 0.45);
+    std::vector<float> h = Dsp::DesignFirLowpass(taps, cutoff);
+
+    // Unity DC gain and linear phase.
+    long double dc = 0;
+    for (float v : h)
+        dc += v;
+    double asymmetry = 0.0;
+    for (size_t k = 0; k < taps; k++)
+        asymmetry = std::max(asymmetry, (double)std::fabs(h[k] - h[taps - 1 - k]));
+    Record("fir-design", taps, std::max((double)std::fabs(dc - 1.0L), asymmetry), (double)(std::fabs(dc - 1.0L) / FloatUlp(1.0L)));
+
+    // Zero-stuffed by `interpolation`, filtered with gain `interpolation`,
+    // decimated; upsampled time t = i * decimation only meets inputs at
+    // multiples of `interpolation`.
+    size_t interpolation = UniformInt(rng, 1, 4);
+    size_t frames = UniformInt(rng, 1, 600);
+    std::vector<float> x = RandomFloats(rng, frames * channels);
+    Dsp::FirFilter filter(h, channels, decimation, interpolation);
+    std::vector<float> y((frames * interpolation / decimation + 1) * channels);
+    size_t produced = filter.Process(x.data(), frames, y.data());
+    Errors e;
+    for (size_t i = 0; i < produced; i++)
+        for (size_t c = 0; c < channels; c++)
+        {
+            size_t t = i * decimation;
+            long double sum = 0;
+            for (size_t k = t % interpolation; k < taps && k <= t; k += interpolation)
+                sum += (long double)h[k] * x[(t - k) / interpolation * channels + c];
+            e.Add(y[i * channels + c], sum * (long double)interpolation);
+        }
+    // A wrong output count fails the kernel
+    if (produced != (frames * interpolation + decimation - 1) / decimation)
+        e.Add(1.0L, 0.0L);
+    Record("fir", taps, e);
+}
+
+static void TestHilbert(Rng& rng)
+{
+    size_t n = RandomSize(rng, 1024);
+    std::vector<float> x = RandomFloats(rng, n);
+    std::vector<LComplex> spectrum = ReferenceDft(Widen(x), false);
+    for (size_t k = 1; k < n; k++)
+    {
+        if (2 * k < n)
+            spectrum[k] *= 2.0L;
+        else if (2 * k > n)
+            spectrum[k] = 0.0L;
+    }
+    std::vector<LComplex> ref = ReferenceDft(spectrum, true);
+
+    Dsp::HilbertPlan plan(n);
+    std::vector<Complex> z(n);
+    plan.Analytic(x.data(), z.data());
+    Errors e;
+    for (size_t j = 0; j < n; j++)
+        e.Add(z[j], ref[j] / (long double)n);
+    Record("hilbert", n, e);
+
+    // Envelope and instantaneous frequency of the plan's own output.
+    std::vector<float> envelope(n), freq(n);
+    Dsp::Envelope(z.data(), envelope.data(), n);
+    Dsp::InstantaneousFrequency(z.data(), freq.data(), n);
+    Errors env, inst;
+    for (size_t j = 0; j < n; j++)
+    {
+        LComplex zj(z[j]);
+        env.Add(envelope[j], std::abs(zj));
+        if (j >= 1)
+            inst.Add(freq[j], std::arg(zj * std::conj(LComplex(z[j - 1]))) / (2.0L * pi_l));
+    }
+    Record("envelope", n, env);
+    if (n >= 2)
+        Record("inst-frequency", n, inst);
+}
+
+// A linear chirp between random frequencies of either sign, whose phase
+// runs through many turns, against its exact phase.
+static void TestUnwrappedPhase(Rng& rng)
+{
+    size_t n = RandomSize(rng, 4096);
+    long double f0 = Uniform(rng, -0.45, 0.45), f1 = Uniform(rng, -0.45, 0.45);
+    long double phase0 = Uniform(rng, -std::numbers::pi, std::numbers::pi);
+    long double rate = (f1 - f0) / (long double)std::max<size_t>(n - 1, 1);
+    std::vector<long double> ref(n);
+    std::vector<Complex> z(n);
+    for (size_t t = 0; t < n; t++)
+    {
+        long double tl = (long double)t;
+        ref[t] = phase0 + 2.0L * pi_l * (f0 * tl + 0.5L * rate * tl * tl);
+        long double amplitude = 0.5L + 0.4L * std::sin(0.01L * tl);
+        z[t] = Complex((float)(amplitude * std::cos(ref[t])), (float)(amplitude * std::sin(ref[t])));
+    }
+    std::vector<float> phase(n);
+    Dsp::UnwrappedPhase(z.data(), phase.data(), n);
+    Errors e;
+    for (size_t t = 0; t < n; t++)
+        e.Add(phase[t], ref[t]);
+    Record("unwrapped-phase", n, e);
+}
+
+static void TestStreamingHilbert(Rng& rng)
+{
+    size_t taps = 2 * UniformInt(rng, 16, 64) + 1;
+    double freq = Uniform(rng, 0.12, 0.38);
+    double phase = Uniform(rng, 0.0, 2.0 * std::numbers::pi);
+    Dsp::StreamingHilbert hilbert(taps);
+    size_t delay = hilbert.Delay();
+
+    // Past the start-up transient the accumulated phase advances by exactly
+    // 2 pi freq per sample, however many turns it has made.
+    Errors e, unwrapped;
+    double start = 0.0;
+    for (size_t t = 0; t < 4 * taps; t++)
+    {
+        Complex z = hilbert.Push((float)std::cos(2.0 * std::numbers::pi * freq * (double)t + phase));
+        if (t < taps)
+            continue;
+        long double theta = 2.0L * pi_l * (long double)freq * (long double)(t - delay) + phase;
+        e.Add(z, std::polar(1.0L, theta));
+        if (t == taps)
+            start = hilbert.Phase();
+        unwrapped.Add(hilbert.Phase() - start, 2.0L * pi_l * (long double)freq * (long double)(t - taps));
+    }
+    Record("hilbert-fir", taps, e.Relative(), 0.0);
+    Record("hilbert-fir-phase", taps, unwrapped.Relative(), 0.0);
+}
+
+// A sinusoid well inside the passband must come out as the same sinusoid at
+// the new rate, delayed by Delay() input samples.
+static void CheckResampler(Dsp::Resampler& resampler, double ratio, double freq, const char* name)
+{
+    size_t frames = 4096;
+    std::vector<float> x(frames), y(resampler.MaxOutput(frames));
+    for (size_t t = 0; t < frames; t++)
+        x[t] = (float)std::sin(2.0 * std::numbers::pi * freq * (double)t);
+    size_t produced = resampler.Process(x.data(), frames, y.data());
+
+    long double delay = resampler.Delay();
+    Errors e;
+    for (size_t j = 0; j < produced; j++)
+    {
+        long double t = (long double)j / (long double)ratio - delay;
+        if (t < 2.0L * delay + 8.0L || t > (long double)frames - 8.0L)
+            continue;
+        e.Add(y[j], std::sin(2.0L * pi_l * (long double)freq * t));
+    }
+    Record(name, (size_t)(ratio * 1000.0), e.Relative(), 0.0);
+}
+
+static void TestResampler(Rng& rng)
+{
+    static const size_t pairs[][2] = { { 2, 1 }, { 1, 2 }, { 3, 2 }, { 2, 3 }, { 160, 147 }, { 147, 160 }, { 5, 4 } };
+    const size_t* pair = pairs[rng() % 7];
+    double ratio = (double)pair[0] / (double)pair[1];
+    Dsp::Resampler rational(pair[0], pair[1], 1);
+    CheckResampler(rational, ratio, Uniform(rng, 0.01, 0.3) * std::min(1.0, ratio), "resampler-rational");
+
+    ratio = Uniform(rng, 0.5, 2.0);
+    Dsp::Resampler arbitrary(ratio, 1);
+    CheckResampler(arbitrary, arbitrary.Ratio(), Uniform(rng, 0.01, 0.3) * std::min(1.0, ratio), "resampler-ratio");
+}
+
+//-----------------------------------------------------------------------------
+// Fixed point
+//-----------------------------------------------------------------------------
+
+template<typename Format>
+static void TestFixedFft(Rng& rng, const char* name)
+{
+    using Value = typename Format::Value;
+    size_t n = (size_t)1 << UniformInt(rng, 1, 12);
+    long double full = std::ldexp(1.0L, Format::fraction_bits);
+    std::vector<Value> re(n), im(n);
+    std::vector<LComplex> x(n);
+    for (size_t j = 0; j < n; j++)
+    {
+        re[j] = (Value)std::llround(Uniform(rng, -0.5, 0.5) * (double)full);
+        im[j] = (Value)std::llround(Uniform(rng, -0.5, 0.5) * (double)full);
+        x[j] = LComplex(re[j], im[j]);
+    }
+    bool inverse = rng() % 2;
+    std::vector<LComplex> ref = ReferenceDft(x, inverse);
+    Dsp::FixedFftPlan<Format> plan(n);
+    int exponent = inverse ? plan.Inverse(re.data(), im.data()) : plan.Forward(re.data(), im.data());
+
+    long double scale = std::ldexp(1.0L, exponent);
+    Errors e;
+    for (size_t k = 0; k < n; k++)
+    {
+        e.Add((long double)re[k] * scale, ref[k].real());
+        e.Add((long double)im[k] * scale, ref[k].imag());
+    }
+    Record(name, n, e.Relative(), (double)(e.max_diff / scale));
+}
+
+static void TestFixedTrig(Rng& rng)
+{
+    long double worst = 0;
+    for (int i = 0; i < 4096; i++)
+    {
+        uint32_t turn = (uint32_t)rng();
+        long double angle = 2.0L * pi_l * (long double)turn / 4294967296.0L;
+        long double full = 2147483648.0L;
+        worst = std::max(worst, std::fabs((long double)Dsp::SinQ31(turn) - std::sin(angle) * full));
+        worst = std::max(worst, std::fabs((long double)Dsp::CosQ31(turn) - std::cos(angle) * full));
+    }
+    Record("sin-cos-q31", 4096, (double)(worst / 2147483648.0L), (double)worst);
+}
+
+static void TestFixedEpicycles(Rng& rng)
+{
+    size_t count = UniformInt(rng, 1, 200);
+    std::vector<Dsp::FixedEpicycle> circles(count);
+    long double total = 0;
+    for (Dsp::FixedEpicycle& c : circles)
+    {
+        c.radius_q16 = (int32_t)UniformInt(rng, 0, 100 << 16);
+        c.harmonic = (int32_t)UniformInt(rng, 0, 400) - 200;
+        c.phase = (uint32_t)rng();
+        total += c.radius_q16;
+    }
+    uint32_t turn = (uint32_t)rng();
+    std::vector<int32_t> x(count), y(count);
+    Dsp::EvaluateEpicyclesFixed(circles.data(), count, turn, x.data(), y.data());
+
+    long double rx = 0, ry = 0, worst = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        // Angles wrap modulo 2^32 exactly like the integer chain.
+        uint32_t a = (uint32_t)((uint64_t)(int64_t)circles[i].harmonic * turn) + circles[i].phase;
+        long double angle = 2.0L * pi_l * (long double)a / 4294967296.0L;
+        rx += circles[i].radius_q16 * std::cos(angle);
+        ry += circles[i].radius_q16 * std::sin(angle);
+        worst = std::max({ worst, std::fabs(x[i] - rx), std::fabs(y[i] - ry) });
+    }
+    Record("epicycles-fixed", count, total > 0 ? (double)(worst / total) : 0.0, (double)worst);
+}
+
+//-----------------------------------------------------------------------------
+// Series
+//-----------------------------------------------------------------------------
+
+static void TestCodeletTrig(Rng& rng)
+{
+    long double worst = 0, worst_ulps = 0;
+    for (int i = 0; i < 1024; i++)
+    {
+        double x = Uniform(rng, -4.0 * std::numbers::pi, 4.0 * std::numbers::pi);
+        long double s = std::sin((long double)x), c = std::cos((long double)x);
+        long double ds = std::fabs(Dsp::Codelets::Sin(x) - s), dc = std::fabs(Dsp::Codelets::Cos(x) - c);
+        worst = std::max({ worst, ds, dc });
+        // Near a zero crossing the argument's own rounding dominates; measure
+        // ulps against 1, the function's scale.
+        worst_ulps = std::max(worst_ulps, std::max(ds, dc) / DoubleUlp(1.0L));
+    }
+    Record("codelet-sin-cos", 1024, (double)worst, (double)worst_ulps);
+}
+
+static const char* SummationSuffix(Dsp::Summation mode)
+{
+    switch (mode)
+    {
+    case Dsp::Summation::Naive: return "naive";
+    case Dsp::Summation::Compensated: return "compensated";
+    default: return "pairwise";
+    }
+}
+
+// Values spanning several binades with mixed signs.
+static std::vector<float> RandomTerms(Rng& rng, size_t n)
+{
+    std::vector<float> x(n);
+    int spread = (int)UniformInt(rng, 0, 12);
+    for (float& v : x)
+        v = (float)std::ldexp(Uniform(rng, -1.0, 1.0), (int)UniformInt(rng, 0, (size_t)spread) - spread / 2);
+    return x;
+}
+
+// Errors are measured against sum |x|, the scale of the rounding errors
+// (the result itself may cancel to almost nothing); ulps are those of the
+// exact result, which only compensated summation is expected to reach.
+static void TestSummation(Rng& rng)
+{
+    size_t n = UniformInt(rng, 1, 100000);
+    std::vector<float> x = RandomTerms(rng, n);
+    std::vector<float> prefix(n);
+    for (Dsp::Summation mode : { Dsp::Summation::Naive, Dsp::Summation::Compensated, Dsp::Summation::Pairwise })
+    {
+        char sum_name[32], prefix_name[32];
+        snprintf(sum_name, sizeof(sum_name), "sum-%s", SummationSuffix(mode));
+        snprintf(prefix_name, sizeof(prefix_name), "prefix-%s", SummationSuffix(mode));
+
+        Dsp::PrefixSum(x.data(), n, prefix.data(), mode);
+        long double exact = 0, magnitude = 0, worst = 0, worst_ulps = 0;
+        for (size_t i = 0; i < n; i++)
+        {
+            exact += x[i];
+            magnitude += std::fabs((long double)x[i]);
+            long double d = std::fabs(prefix[i] - exact);
+            worst = std::max(worst, d / magnitude);
+            worst_ulps = std::max(worst_ulps, d / FloatUlp(std::fabs(exact)));
+        }
+        Record(prefix_name, n, (double)worst, (double)worst_ulps);
+
+        long double d = std::fabs(Dsp::Sum(x.data(), n, mode) - exact);
+        Record(sum_name, n, (double)(d / magnitude), (double)(d / FloatUlp(std::fabs(exact))));
+    }
+}
+
+static void TestEpicycles(Rng& rng)
+{
+    size_t count = UniformInt(rng, 1, 2000);
+    std::vector<Dsp::Epicycle> circles(count);
+    long double total = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        circles[i].harmonic = (int32_t)UniformInt(rng, 0, 400) - 200;
+        circles[i].radius = (float)(Uniform(rng, 0.0, 100.0) / (double)(1 + std::abs(circles[i].harmonic)));
+        circles[i].phase = (float)Uniform(rng, -std::numbers::pi, std::numbers::pi);
+        total += circles[i].radius;
+    }
+    double time = Uniform(rng, 0.0, 1000.0);
+    std::vector<float> x(count), y(count);
+    for (Dsp::Summation mode : { Dsp::Summation::Naive, Dsp::Summation::Compensated, Dsp::Summation::Pairwise })
+    {
+        char name[32];
+        snprintf(name, sizeof(name), "epicycles-%s", SummationSuffix(mode));
+        Dsp::EvaluateEpicycles(circles.data(), count, time, x.data(), y.data(), mode);
+        Complex tip = Dsp::EpicycleTip(circles.data(), count, time, mode);
+
+        long double rx = 0, ry = 0, worst = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            long double angle = (long double)circles[i].harmonic * (long double)time + (long double)circles[i].phase;
+            rx += circles[i].radius * std::cos(angle);
+            ry += circles[i].radius * std::sin(angle);
+            worst = std::max({ worst, std::fabs(x[i] - rx), std::fabs(y[i] - ry) });
+        }
+        worst = std::max({ worst, std::fabs(tip.real() - rx), std::fabs(tip.imag() - ry) });
+        Record(name, count, (double)(worst / total), (double)(worst / FloatUlp(total)));
+    }
+}
+
+// `count` circles with harmonics in [-max_harmonic, max_harmonic], radii in
+// [0, 1] and phases in [-pi, pi]; `total` gets the sum of the radii.
+static std::vector<Dsp::Epicycle> RandomChain(Rng& rng, size_t count, int32_t max_harmonic, long double& total)
+{
+    std::vector<Dsp::Epicycle> circles(count);
+    total = 0;
+    for (Dsp::Epicycle& c : circles)
+    {
+        c.harmonic = (int32_t)UniformInt(rng, 0, 2 * (size_t)max_harmonic) - max_harmonic;
+        c.radius = (float)Uniform(rng, 0.0, 1.0);
+        c.phase = (float)Uniform(rng, -std::numbers::pi, std::numbers::pi);
+        total += c.radius;
+    }
+    return circles;
+}
+
+// One period from the inverse FFT against every term summed at every sample.
+static void TestSeriesPeriod(Rng& rng)
+{
+    size_t count = UniformInt(rng, 1, 500);
+    long double total = 0;
+    std::vector<Dsp::Epicycle> circles = RandomChain(rng, count, 2000, total);
+    Dsp::PeriodicRate rate{ UniformInt(rng, 1, 50), UniformInt(rng, 1, 3000) };
+    std::vector<Complex> out((size_t)rate.period);
+    Dsp::SynthesizePeriod(circles.data(), count, rate, out.data(), false);
+    long double worst = 0;
+    for (size_t j = 0; j < out.size(); j++)
+    {
+        long double rx = 0, ry = 0;
+        long double theta = 2 * pi_l * (long double)((j * rate.cycles) % rate.period) / (long double)rate.period;
+        for (const Dsp::Epicycle& c : circles)
+        {
+            rx += c.radius * std::cos(c.harmonic * theta + c.phase);
+            ry += c.radius * std::sin(c.harmonic * theta + c.phase);
+        }
+        worst = std::max({ worst, std::fabs(out[j].real() - rx), std::fabs(out[j].imag() - ry) });
+    }
+    Record("series-period", (size_t)rate.period, (double)(worst / total), 0.0);
+}
+
+// Phasor bank against the exact sum of the audible partials, over enough
+// blocks for every phasor to be resynchronized several times, with new
+// radii, phases and fundamental half way (amplitudes ramp across the block
+// after the change).
+static void TestOscillatorBank(Rng& rng)
+{
+    const double sample_rate = 48000.0;
+    const size_t block = 128, frames = 8192, change = frames / 2;
+    size_t count = UniformInt(rng, 1, 300);
+    std::vector<Dsp::Epicycle> before(count), after(count);
+    long double total = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        before[i].harmonic = after[i].harmonic = (int32_t)UniformInt(rng, 0, 600) - 300;
+        before[i].radius = (float)Uniform(rng, 0.0, 1.0);
+        before[i].phase = (float)Uniform(rng, -std::numbers::pi, std::numbers::pi);
+        after[i].radius = UniformInt(rng, 0, 1) ? (float)Uniform(rng, 0.0, 1.0) : before[i].radius;
+        after[i].phase = UniformInt(rng, 0, 1) ? (float)Uniform(rng, -std::numbers::pi, std::numbers::pi) : before[i].phase;
+        total += std::max(before[i].radius, after[i].radius);
+    }
+    double fundamentals[2] = { Uniform(rng, 20.0, 200.0), Uniform(rng, 20.0, 200.0) };
+    double theta = Uniform(rng, 0.0, 2.0 * std::numbers::pi);
+    Dsp::OscillatorBank bank(count, sample_rate);
+    bank.SetSeries(before.data(), count, fundamentals[0], 1.0f);
+    bank.Reset(theta);
+    std::vector<float> out(frames);
+    for (size_t done = 0; done < frames; done += block)
+    {
+        if (done == change)
+            bank.SetSeries(after.data(), count, fundamentals[1], 1.0f);
+        bank.Render(out.data() + done, block);
+    }
+    auto amplitude = [&](const Dsp::Epicycle& c, double fundamental)
+    {
+        return std::fabs(c.harmonic * fundamental) < 0.5 * sample_rate ? (long double)c.radius : 0.0L;
+    };
+    long double worst = 0;
+    for (size_t j = 0; j < frames; j++)
+    {
+        bool late = j >= change;
+        long double t = late ? theta + 2 * pi_l * (fundamentals[0] * (long double)change + fundamentals[1] * (long double)(j - change)) / sample_rate
+                             : theta + 2 * pi_l * fundamentals[0] * (long double)j / sample_rate;
+        long double ramp = late && j < change + block ? (long double)(j - change) / block : 1.0L;
+        long double y = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            const Dsp::Epicycle& c = late ? after[i] : before[i];
+            long double a = late ? amplitude(before[i], fundamentals[0]) + ramp * (amplitude(after[i], fundamentals[1]) - amplitude(before[i], fundamentals[0]))
+                                 : amplitude(c, fundamentals[0]);
+            y += a * std::sin(c.harmonic * t + c.phase);
+        }
+        worst = std::max(worst, std::fabs(out[j] - y));
+    }
+    Record("oscillator-bank", count, (double)(worst / total), 0.0);
+}
+
+// Overlap-added IFFT frames against the exact sum of the audible partials.
+static void TestSpectralBank(Rng& rng)
+{
+    const double sample_rate = 48000.0;
+    size_t count = UniformInt(rng, 1, 500);
+    double fundamental = Uniform(rng, 20.0, 200.0);
+    long double total = 0;
+    std::vector<Dsp::Epicycle> circles = RandomChain(rng, count, 300, total);
+    double theta = Uniform(rng, 0.0, 2.0 * std::numbers::pi);
+    Dsp::SpectralBank bank(count, sample_rate);
+    bank.SetSeries(circles.data(), count, fundamental, 1.0f);
+    bank.Reset(theta);
+    std::vector<float> out(4096);
+    for (size_t done = 0; done < out.size(); done += 128)
+        bank.Render(out.data() + done, 128);
+    long double worst = 0;
+    for (size_t j = 0; j < out.size(); j++)
+    {
+        long double t = theta + 2 * pi_l * fundamental * (long double)j / sample_rate;
+        long double y = 0;
+        for (const Dsp::Epicycle& c : circles)
+            if (std::fabs(c.harmonic * fundamental) < 0.5 * sample_rate)
+                y += c.radius * std::sin(c.harmonic * t + c.phase);
+        worst = std::max(worst, std::fabs(out[j] - y));
+    }
+    Record("spectral-bank", count, (double)(worst / total), 0.0);
+}
+
+// Cached partial sums, some rebuilt after eviction, against direct sums.
+static void TestConvergence(Rng& rng)
+{
+    size_t count = UniformInt(rng, 1, 200);
+    size_t points = UniformInt(rng, 1, 700);
+    long double total = 0;
+    std::vector<Dsp::Epicycle> circles = RandomChain(rng, count, 1000, total);
+    // Room for a handful of levels, so most are evicted and recomputed
+    Dsp::ConvergenceCache cache(UniformInt(rng, 1, 12) * 2 * points * sizeof(float));
+    cache.Configure(circles.data(), count, points);
+    cache.Precompute();
+    long double worst = 0;
+    for (int probe = 0; probe < 4; probe++)
+    {
+        size_t terms = UniformInt(rng, 1, count);
+        Dsp::ConvergenceCache::Level level = cache.Get(terms);
+        for (size_t j = 0; j < points; j++)
+        {
+            long double t = 2 * pi_l * (long double)j / (long double)points;
+            long double x = 0, y = 0;
+            for (size_t i = 0; i < terms; i++)
+            {
+                x += circles[i].radius * std::cos(circles[i].harmonic * t + circles[i].phase);
+                y += circles[i].radius * std::sin(circles[i].harmonic * t + circles[i].phase);
+            }
+            worst = std::max({ worst, std::fabs(level.x[j] - x), std::fabs(level.y[j] - y) });
+        }
+    }
+    Record("convergence", points, (double)(worst / total), 0.0);
+}
+
+// Grid synthesis from a cached basis, and from rows generated when the
+// basis is over its limit, against direct sums; both must agree exactly.
+static void TestBasis(Rng& rng)
+{
+    size_t count = UniformInt(rng, 1, 300);
+    size_t points = UniformInt(rng, 1, 500);
+    double time = Uniform(rng, -100.0, 100.0);
+    double step = Uniform(rng, -0.1, 0.1);
+    long double total = 0;
+    std::vector<Dsp::Epicycle> circles = RandomChain(rng, count, 500, total);
+    std::vector<float> x(points), y(points), gx(points), gy(points);
+    Dsp::BasisCache cached, generated(0);
+    cached.Synthesize(circles.data(), count, time, points, step, x.data(), y.data());
+    generated.Synthesize(circles.data(), count, time, points, step, gx.data(), gy.data());
+    long double worst = 0;
+    bool same = x == gx && y == gy;
+    for (size_t j = 0; j < points; j++)
+    {
+        long double t = time + (long double)j * step;
+        long double rx = 0, ry = 0;
+        for (const Dsp::Epicycle& c : circles)
+        {
+            rx += c.radius * std::cos(c.harmonic * t + c.phase);
+            ry += c.radius * std::sin(c.harmonic * t + c.phase);
+        }
+        worst = std::max({ worst, std::fabs(x[j] - rx), std::fabs(y[j] - ry) });
+    }
+    Record("basis", points, same ? (double)(worst / total) : 1.0, 0.0);
+}
+
+//-----------------------------------------------------------------------------
+
+int main(int argc, char** argv)
+{
+    uint64_t seed = (argc > 1) ? std::strtoull(argv[1], nullptr, 0) : 20240601;
+    int rounds = (argc > 2) ? std::atoi(argv[2]) : 16;
+    Rng rng(seed);
+
+    TestDaubechiesFilters();
+    for (int round = 0; round < rounds; round++)
+    {
+        TestFft(rng);
+        TestRealFft(rng);
+        TestBatchFft(rng);
+        TestDct(rng);
+        TestMdct(rng);
+        TestDct2d(rng);
+        TestDwt(rng);
+        TestStreamingDwt(rng);
+        TestCwt(rng);
+        TestIir(rng);
+        TestFir(rng);
+        TestHilbert(rng);
+        TestUnwrappedPhase(rng);
+        TestStreamingHilbert(rng);
+        TestResampler(rng);
+        TestFixedFft<Dsp::Q15>(rng, "fixed-fft-q15");
+        TestFixedFft<Dsp::Q31>(rng, "fixed-fft-q31");
+        TestFixedTrig(rng);
+        TestFixedEpicycles(rng);
+        TestCodeletTrig(rng);
+        TestSummation(rng);
+        TestEpicycles(rng);
+        TestSeriesPeriod(rng);
+        TestOscillatorBank(rng);
+        TestSpectralBank(rng);
+        TestConvergence(rng);
+        TestBasis(rng);
+    }
+
+    int failures = 0;
+    std::printf("seed %llu, %d rounds\n", (unsigned long long)seed, rounds);
+    std::printf("%-22s %6s %11s %11s %10s %10s %7s\n", "kernel", "cases", "max rel", "bound", "max ulp", "bound", "worst n");
+    for (const Kernel& k : kernels)
+    {
+        bool ok = k.relative <= k.max_relative && (k.max_ulps == 0 || k.ulps <= k.max_ulps);
+        std::printf("%-22s %6zu %11.3e %11.1e %10.1f %10.0f %7zu%s\n", k.name, k.cases, k.relative, k.max_relative,
+                    k.ulps, k.max_ulps, k.worst_size, ok ? "" : "  FAIL");
+        if (!ok)
+            failures++;
+    }
+    if (failures != 0)
+    {
+        std::fprintf(stderr, "%d kernel(s) out of bounds (seed %llu)\n", failures, (unsigned long long)seed);
+        return 1;
+    }
+    std::printf("accuracy: all kernels within bounds\n");
+    return 0;
+}
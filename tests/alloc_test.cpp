@@ -0,0 +1,243 @@
+// Verifies that a steady-state frame of the per-frame math performs no heap
+// allocations: transient buffers come from a FrameArena, long-lived objects
+// from pools, and the DSP code only grows its scratch during warm-up.
+//
+// Global operator new / delete are replaced by counting versions.
+
+#include "Core/Arena.h"
+#include "Core/Pool.h"
+#include "Core/ThreadPool.h"
+#include "Dsp/Basis.h"
+#include "Dsp/Cwt.h"
+#include "Dsp/Epicycles.h"
+#include "Dsp/Filter.h"
+#include "Dsp/FixedFft.h"
+#include "Dsp/Hilbert.h"
+#include "Dsp/Resampler.h"
+#include "Raster/Rasterizer.h"
+
+#include "Check.h"
+
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+#include <vector>
+
+static std::atomic<size_t> allocations{ 0 };
+
+void* operator new(size_t size)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size != 0 ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t alignment)
+{
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    size_t a = (size_t)alignment;
+    if (void* p = std::aligned_alloc(a, (size + a - 1) / a * a))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { std::free(p); }
+
+// A fixed-size long-lived object, e.g. one marker on the trace.
+struct Marker
+{
+    float x = 0.0f, y = 0.0f;
+    uint32_t color = 0;
+    double born = 0.0;
+};
+
+// Everything the main loop computes per frame, minus the UI.
+struct FrameWork
+{
+    Core::FrameArena arena{ 4096 };
+    Core::ObjectPool<Marker> markers{ 4 };
+    std::vector<Marker*> live = std::vector<Marker*>(8, nullptr);
+    Dsp::Resampler resampler{ 60.0 / 1000.0, 1 };
+    Dsp::BiquadCascade filter{ Dsp::DesignIir(Dsp::FilterSpec{}), 1 };
+    Dsp::StreamingHilbert hilbert{ 63 };
+    size_t frame = 0;
+    Dsp::HilbertPlan hilbert_plan{ 512 };
+    Dsp::FixedFftQ15 fixed_fft{ 256 };
+    std::vector<float> wave = std::vector<float>(512, 0.0f);
+    double time = 0.0;
+    // The pooled paths: CWT overlay, CPU rasterizer, resynthesized graph
+    Core::ThreadPool pool{ 3 };
+    Dsp::CwtPlan cwt{ Dsp::CwtWavelet::Morlet, 512, Dsp::CwtPlan::LogScales(2.0f, 64.0f, 24) };
+    std::vector<float> scalogram = std::vector<float>(24 * 256, 0.0f);
+    Raster::Scene scene;
+    Raster::Rasterizer rasterizer;
+    std::vector<uint32_t> pixels = std::vector<uint32_t>(320 * 200, 0u);
+    Dsp::BasisCache basis;
+    // The GUI's smallest limit, under this graph's 1.8 MB matrix, so rows are generated
+    Dsp::BasisCache generated_basis{ (size_t)1 << 20 };
+    std::vector<float> graph_x = std::vector<float>(300, 0.0f);
+    std::vector<float> graph_y = std::vector<float>(300, 0.0f);
+
+    void Run()
+    {
+        arena.Reset();
+        time += 1.0 / 60.0;
+
+        const size_t count = 360;
+        std::pmr::vector<Dsp::Epicycle> circles(count, &arena);
+        for (size_t i = 0; i < count; i++)
+        {
+            circles[i].radius = 60.0f * 4.0f / ((float)(2 * i + 1) * 3.14159f);
+            circles[i].harmonic = -(int32_t)(2 * i + 1);
+        }
+        std::pmr::vector<float> joint_x(count, &arena), joint_y(count, &arena);
+        for (Dsp::Summation mode : { Dsp::Summation::Naive, Dsp::Summation::Compensated, Dsp::Summation::Pairwise })
+            Dsp::EvaluateEpicycles(circles.data(), count, time, joint_x.data(), joint_y.data(), mode);
+
+        float* source = arena.Allocate<float>(17);
+        for (size_t i = 0; i < 17; i++)
+            source[i] = Dsp::EpicycleTip(circles.data(), count, time + i / 1000.0, Dsp::Summation::Pairwise).imag();
+        float* display = arena.Allocate<float>(resampler.MaxOutput(17));
+        resampler.Process(source, 17, display);
+
+        float val = filter.ProcessSample(joint_y.back());
+        hilbert.Push(val);
+
+        // One marker retired and one created every frame.
+        Marker*& slot = live[frame++ % live.size()];
+        markers.Destroy(slot);
+        slot = markers.Create(Marker{ joint_x.back(), val, 0xffffffffu, time });
+
+        wave.erase(wave.begin());
+        wave.push_back(val);
+        Dsp::Complex* analytic = arena.Allocate<Dsp::Complex>(wave.size());
+        float* envelope = arena.Allocate<float>(wave.size());
+        hilbert_plan.Analytic(wave.data(), analytic);
+        Dsp::Envelope(analytic, envelope, wave.size());
+        Dsp::InstantaneousFrequency(analytic, envelope, wave.size());
+
+        int16_t* re = arena.Allocate<int16_t>(256);
+        int16_t* im = arena.Allocate<int16_t>(256);
+        for (size_t i = 0; i < 256; i++)
+        {
+            re[i] = (int16_t)(wave[i] * 100.0f);
+            im[i] = 0;
+        }
+        fixed_fft.Forward(re, im);
+
+        cwt.Scalogram(wave.data(), scalogram.data(), 256, &pool);
+
+        scene.Clear();
+        for (size_t i = 0; i < 64; i++)
+        {
+            scene.AddCircle(100.0f + joint_x[i] * 0.1f, 100.0f + joint_y[i] * 0.1f, circles[i].radius * 0.1f, Raster::MakeColor(255, 255, 255, 100));
+            scene.AddLine(100.0f, 100.0f, 100.0f + joint_x[i] * 0.1f, 100.0f + joint_y[i] * 0.1f, Raster::MakeColor(255, 0, 0));
+        }
+        Raster::Target target{ pixels.data(), 320, 200, 320, 0, 0 };
+        Raster::Fill(target, Raster::MakeColor(15, 15, 15), &pool);
+        rasterizer.Draw(scene, target, &pool);
+
+        basis.Synthesize(circles.data(), count, time, graph_x.size(), -1.0 / 60.0, graph_x.data(), graph_y.data(), &pool);
+        generated_basis.Synthesize(circles.data(), count, time, graph_x.size(), -1.0 / 60.0, graph_x.data(), graph_y.data(), &pool);
+    }
+};
+
+static void TestArena()
+{
+    Core::FrameArena arena(256);
+    void* a = arena.allocate(3, 1);
+    void* b = arena.allocate(64, 64);
+    CHECK(a != nullptr && b != nullptr);
+    CHECK(reinterpret_cast<uintptr_t>(b) % 64 == 0);
+
+    // Spill past the block, then check Reset merges the spill.
+    for (int i = 0; i < 10; i++)
+        arena.Allocate<double>(40);
+    CHECK(arena.Used() > 256);
+    arena.Reset();
+    CHECK(arena.Used() == 0);
+    CHECK(arena.Capacity() > 256);
+    size_t before = allocations.load();
+    for (int i = 0; i < 10; i++)
+        arena.Allocate<double>(40);
+    CHECK(allocations.load() == before);
+    CHECK(arena.Peak() > 256);
+
+    // std::pmr containers through the arena.
+    arena.Reset();
+    before = allocations.load();
+    std::pmr::vector<int> v(&arena);
+    for (int i = 0; i < 100; i++)
+        v.push_back(i);
+    CHECK(v[99] == 99);
+    CHECK(allocations.load() == before);
+}
+
+static void TestPool()
+{
+    Core::ObjectPool<std::pair<double, int>> pool(8);
+    std::vector<std::pair<double, int>*> objects;
+    objects.reserve(20);
+    for (int i = 0; i < 20; i++)
+        objects.push_back(pool.Create(i * 0.5, i));
+    CHECK(pool.Live() == 20);
+    CHECK(objects[7]->second == 7);
+    for (auto* o : objects)
+        pool.Destroy(o);
+    CHECK(pool.Live() == 0);
+
+    // Reuse never reaches the heap.
+    size_t before = allocations.load();
+    for (int i = 0; i < 20; i++)
+        objects[i] = pool.Create(0.0, i);
+    for (auto* o : objects)
+        pool.Destroy(o);
+    CHECK(allocations.load() == before);
+
+    // Oversized requests fall through to the upstream resource.
+    Core::PoolResource small(8, 4);
+    void* big = small.allocate(1000);
+    CHECK(big != nullptr);
+    small.deallocate(big, 1000);
+    CHECK(small.Live() == 0);
+}
+
+static void TestSteadyStateFrames()
+{
+    FrameWork work;
+    // Long enough for every pool worker to have grown its thread-local scratch
+    for (int frame = 0; frame < 50; frame++)
+        work.Run();
+    size_t before = allocations.load();
+    for (int frame = 0; frame < 200; frame++)
+        work.Run();
+    size_t steady = allocations.load() - before;
+    if (steady != 0)
+        std::fprintf(stderr, "%zu allocations in 200 steady-state frames\n", steady);
+    CHECK(steady == 0);
+    CHECK(work.arena.Peak() > 4096);     // The first frame spilled and was merged
+    CHECK(work.markers.Live() == work.live.size());
+    CHECK(work.basis.Cached() && !work.generated_basis.Cached());
+}
+
+int main()
+{
+    TestArena();
+    TestPool();
+    TestSteadyStateFrames();
+    if (failures != 0)
+    {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("alloc: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,415 @@
+// Checks the image writer and the banded scene export byte for byte.
+//
+// The checksums are compared with published test vectors. PNG files are
+// read back through their chunk CRCs, a fixed-Huffman inflater and the
+// zlib Adler-32, and TIFF files through their IFD. Tiny images must match
+// known bytes exactly, and an exported scene must match the same scene
+// rasterized in one piece, whatever the band height.
+
+#include "Core/ThreadPool.h"
+#include "Raster/Export.h"
+#include "Raster/ImageWriter.h"
+#include "Raster/Rasterizer.h"
+
+#include "Check.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <random>
+#include <string>
+#include <vector>
+
+static std::string TempPath(const char* name)
+{
+    return (std::filesystem::temp_directory_path() / ("fourier-image-test-" + std::to_string(std::random_device{}()) + "-" + name)).string();
+}
+
+static std::vector<uint8_t> ReadFile(const std::string& path)
+{
+    std::vector<uint8_t> bytes;
+    if (FILE* f = std::fopen(path.c_str(), "rb"))
+    {
+        uint8_t buffer[4096];
+        for (size_t n; (n = std::fread(buffer, 1, sizeof(buffer), f)) > 0;)
+            bytes.insert(bytes.end(), buffer, buffer + n);
+        std::fclose(f);
+    }
+    return bytes;
+}
+
+// Writes the image in calls of 1, 2, 3... rows and returns the file.
+static std::vector<uint8_t> WriteImage(Raster::ImageFormat format, const std::vector<uint32_t>& pixels, int width, int height)
+{
+    std::string path = TempPath(format == Raster::ImageFormat::Png ? "write.png" : "write.tif");
+    Raster::ImageWriter writer;
+    bool ok = writer.Open(path.c_str(), format, width, height);
+    for (int row = 0, rows = 1; ok && row < height; row += rows, rows++)
+    {
+        rows = std::min(rows, height - row);
+        ok = writer.WriteRows(pixels.data() + (size_t)row * (size_t)width, rows, width);
+    }
+    ok = writer.Finish() && ok;
+    if (!ok)
+        std::fprintf(stderr, "%s\n", writer.Error());
+    CHECK(ok);
+    std::vector<uint8_t> bytes = ReadFile(path);
+    std::filesystem::remove(path);
+    return bytes;
+}
+
+static uint32_t LoadBig32(const uint8_t* p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+static uint32_t LoadLittle(const uint8_t* p, int bytes)
+{
+    uint32_t v = 0;
+    for (int i = bytes - 1; i >= 0; i--)
+        v = (v << 8) | p[i];
+    return v;
+}
+
+//-----------------------------------------------------------------------------
+// Reading back
+//-----------------------------------------------------------------------------
+
+// Inflates a deflate stream of fixed-Huffman blocks (all the writer emits);
+// false on anything else or on a malformed stream.
+static bool Inflate(const uint8_t* data, size_t size, std::vector<uint8_t>& out)
+{
+    size_t bit = 0;
+    bool ok = true;
+    auto bits = [&](int count)                  // Least significant bit first
+    {
+        uint32_t v = 0;
+        for (int i = 0; i < count; i++, bit++)
+        {
+            if (bit / 8 >= size)
+            {
+                ok = false;
+                return 0u;
+            }
+            v |= (uint32_t)((data[bit / 8] >> (bit % 8)) & 1) << i;
+        }
+        return v;
+    };
+    auto code = [&](int count)                  // Most significant bit first
+    {
+        uint32_t v = 0;
+        for (int i = 0; i < count; i++)
+            v = (v << 1) | bits(1);
+        return v;
+    };
+    static const uint16_t length_base[29] = { 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+    static const uint8_t length_extra[29] = { 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+    static const uint16_t distance_base[30] = { 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+    static const uint8_t distance_extra[30] = { 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+    for (bool last = false; !last && ok;)
+    {
+        last = bits(1) != 0;
+        if (bits(2) != 1)
+            return false;
+        for (;;)
+        {
+            uint32_t symbol = code(7);
+            if (symbol <= 0x17)
+                symbol += 256;
+            else
+            {
+                symbol = (symbol << 1) | bits(1);
+                if (symbol >= 0x30 && symbol <= 0xBF)
+                    symbol -= 0x30;
+                else if (symbol >= 0xC0 && symbol <= 0xC7)
+                    symbol = symbol - 0xC0 + 280;
+                else
+                    symbol = ((symbol << 1) | bits(1)) - 0x190 + 144;
+            }
+            if (!ok || symbol > 285)
+                return false;
+            if (symbol < 256)
+            {
+                out.push_back((uint8_t)symbol);
+                continue;
+            }
+            if (symbol == 256)
+                break;
+            size_t length = length_base[symbol - 257] + bits(length_extra[symbol - 257]);
+            uint32_t d = code(5);
+            if (d >= 30)
+                return false;
+            size_t distance = distance_base[d] + bits(distance_extra[d]);
+            if (!ok || distance > out.size())
+                return false;
+            for (size_t i = 0; i < length; i++)
+                out.push_back(out[out.size() - distance]);
+        }
+    }
+    return ok;
+}
+
+// Pixels of a PNG written by ImageWriter, checking every chunk CRC, the
+// zlib header and Adler-32; empty when anything is wrong.
+static std::vector<uint32_t> ReadPng(const std::vector<uint8_t>& file, int& width, int& height)
+{
+    static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+    if (file.size() < 8 || std::memcmp(file.data(), signature, 8) != 0)
+        return {};
+    std::vector<uint8_t> zlib;
+    bool ended = false;
+    width = height = 0;
+    for (size_t at = 8; at < file.size() && !ended;)
+    {
+        if (at + 12 > file.size())
+            return {};
+        uint32_t size = LoadBig32(&file[at]);
+        if (at + 12 + size > file.size())
+            return {};
+        const uint8_t* type = &file[at + 4];
+        const uint8_t* data = type + 4;
+        if (Raster::Crc32(0, type, 4 + size) != LoadBig32(data + size))
+            return {};
+        if (std::memcmp(type, "IHDR", 4) == 0)
+        {
+            width = (int)LoadBig32(data);
+            height = (int)LoadBig32(data + 4);
+            if (data[8] != 8 || data[9] != 6 || data[10] != 0 || data[11] != 0 || data[12] != 0)
+                return {};
+        }
+        else if (std::memcmp(type, "IDAT", 4) == 0)
+            zlib.insert(zlib.end(), data, data + size);
+        else if (std::memcmp(type, "IEND", 4) == 0)
+            ended = at + 12 == file.size();
+        at += 12 + size;
+    }
+    if (!ended || zlib.size() < 6 || (zlib[0] & 0x0F) != 8 || ((zlib[0] << 8) | zlib[1]) % 31 != 0)
+        return {};
+    std::vector<uint8_t> raw;
+    if (!Inflate(zlib.data() + 2, zlib.size() - 6, raw) || Raster::Adler32(1, raw.data(), raw.size()) != LoadBig32(&zlib[zlib.size() - 4]))
+        return {};
+    size_t row_bytes = 4 * (size_t)width;
+    if (raw.size() != (row_bytes + 1) * (size_t)height)
+        return {};
+    // Filters None and Up
+    std::vector<uint32_t> pixels((size_t)width * (size_t)height);
+    uint8_t* out = (uint8_t*)pixels.data();
+    for (size_t y = 0; y < (size_t)height; y++)
+    {
+        const uint8_t* row = &raw[y * (row_bytes + 1)];
+        if (row[0] != 0 && row[0] != 2)
+            return {};
+        for (size_t i = 0; i < row_bytes; i++)
+        {
+            uint8_t up = (row[0] == 2 && y > 0) ? out[(y - 1) * row_bytes + i] : 0;
+            out[y * row_bytes + i] = (uint8_t)(row[1 + i] + up);
+        }
+    }
+    return pixels;
+}
+
+// Pixels of a little-endian, uncompressed, chunky 8-bit RGBA TIFF; empty
+// when it is anything else.
+static std::vector<uint32_t> ReadTiff(const std::vector<uint8_t>& file, int& width, int& height)
+{
+    if (file.size() < 8 || file[0] != 'I' || file[1] != 'I' || LoadLittle(&file[2], 2) != 42)
+        return {};
+    size_t ifd = LoadLittle(&file[4], 4);
+    if (ifd + 2 > file.size())
+        return {};
+    size_t entries = LoadLittle(&file[ifd], 2);
+    if (ifd + 2 + 12 * entries + 4 > file.size())
+        return {};
+    // Every value as a list, read from the entry or from its offset
+    auto values = [&](uint16_t tag)
+    {
+        std::vector<uint32_t> v;
+        for (size_t e = 0; e < entries; e++)
+        {
+            const uint8_t* entry = &file[ifd + 2 + 12 * e];
+            if (LoadLittle(entry, 2) != tag)
+                continue;
+            int bytes = LoadLittle(entry + 2, 2) == 3 ? 2 : 4;
+            size_t count = LoadLittle(entry + 4, 4);
+            size_t at = count * (size_t)bytes <= 4 ? (size_t)(entry + 8 - file.data()) : LoadLittle(entry + 8, 4);
+            for (size_t i = 0; i < count && at + (i + 1) * bytes <= file.size(); i++)
+                v.push_back(LoadLittle(&file[at + i * bytes], bytes));
+        }
+        return v;
+    };
+    std::vector<uint32_t> w = values(256), h = values(257), bits = values(258), offsets = values(273), counts = values(279);
+    if (w.size() != 1 || h.size() != 1 || bits != std::vector<uint32_t>{ 8, 8, 8, 8 } || values(259) != std::vector<uint32_t>{ 1 } ||
+        values(277) != std::vector<uint32_t>{ 4 } || values(338) != std::vector<uint32_t>{ 2 } || offsets.size() != counts.size())
+        return {};
+    width = (int)w[0];
+    height = (int)h[0];
+    std::vector<uint8_t> data;
+    for (size_t s = 0; s < offsets.size(); s++)
+    {
+        if ((size_t)offsets[s] + counts[s] > file.size())
+            return {};
+        data.insert(data.end(), &file[offsets[s]], &file[offsets[s]] + counts[s]);
+    }
+    if (data.size() != 4 * (size_t)width * (size_t)height)
+        return {};
+    std::vector<uint32_t> pixels((size_t)width * (size_t)height);
+    std::memcpy(pixels.data(), data.data(), data.size());
+    return pixels;
+}
+
+//-----------------------------------------------------------------------------
+// Tests
+//-----------------------------------------------------------------------------
+
+static void TestChecksums()
+{
+    auto crc = [](const char* s) { return Raster::Crc32(0, (const uint8_t*)s, std::strlen(s)); };
+    auto adler = [](const char* s) { return Raster::Adler32(1, (const uint8_t*)s, std::strlen(s)); };
+    CHECK(crc("") == 0);
+    CHECK(crc("IEND") == 0xAE426082u);
+    CHECK(crc("123456789") == 0xCBF43926u);
+    CHECK(adler("") == 1);
+    CHECK(adler("Wikipedia") == 0x11E60398u);
+    CHECK(adler("123456789") == 0x091E01DEu);
+
+    // Continued in pieces across the modulo reduction interval
+    std::vector<uint8_t> bytes(100000);
+    std::mt19937 rng(7);
+    for (uint8_t& b : bytes)
+        b = (uint8_t)(rng() | 0xF0);
+    uint32_t whole_crc = Raster::Crc32(0, bytes.data(), bytes.size());
+    uint32_t whole_adler = Raster::Adler32(1, bytes.data(), bytes.size());
+    uint32_t part_crc = 0, part_adler = 1;
+    for (size_t at = 0, n = 1; at < bytes.size(); at += n, n = n * 3 + 1)
+    {
+        n = std::min(n, bytes.size() - at);
+        part_crc = Raster::Crc32(part_crc, bytes.data() + at, n);
+        part_adler = Raster::Adler32(part_adler, bytes.data() + at, n);
+    }
+    CHECK(part_crc == whole_crc);
+    CHECK(part_adler == whole_adler);
+}
+
+// A 3x2 image: exact bytes of both formats.
+static void TestKnownFiles()
+{
+    const std::vector<uint32_t> pixels = {
+        Raster::MakeColor(255, 0, 0), Raster::MakeColor(0, 255, 0), Raster::MakeColor(0, 0, 255, 128),
+        Raster::MakeColor(255, 0, 0), Raster::MakeColor(0, 255, 0), Raster::MakeColor(0, 0, 0, 0),
+    };
+    static const uint8_t png[] = {
+        0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 0x00, 0x00, 0x00, 0x0D, 0x49, 0x48, 0x44, 0x52,
+        0x00, 0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x02, 0x08, 0x06, 0x00, 0x00, 0x00, 0x9D, 0x74, 0x66,
+        0x1A, 0x00, 0x00, 0x00, 0x1B, 0x49, 0x44, 0x41, 0x54, 0x78, 0x01, 0x63, 0xFA, 0xCF, 0xC0, 0xF0,
+        0x9F, 0xE1, 0x3F, 0xC3, 0x7F, 0x06, 0x86, 0xFF, 0x0D, 0x4C, 0x0C, 0x70, 0xC0, 0xD8, 0x00, 0x00,
+        0x6B, 0x86, 0x06, 0x01, 0x79, 0xF6, 0x6C, 0x04, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4E, 0x44,
+        0xAE, 0x42, 0x60, 0x82,
+    };
+    static const uint8_t tiff[] = {
+        0x49, 0x49, 0x2A, 0x00, 0x08, 0x00, 0x00, 0x00, 0x0B, 0x00, 0x00, 0x01, 0x04, 0x00, 0x01, 0x00,
+        0x00, 0x00, 0x03, 0x00, 0x00, 0x00, 0x01, 0x01, 0x04, 0x00, 0x01, 0x00, 0x00, 0x00, 0x02, 0x00,
+        0x00, 0x00, 0x02, 0x01, 0x03, 0x00, 0x04, 0x00, 0x00, 0x00, 0x92, 0x00, 0x00, 0x00, 0x03, 0x01,
+        0x03, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x00, 0x00, 0x00, 0x06, 0x01, 0x03, 0x00, 0x01, 0x00,
+        0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x11, 0x01, 0x04, 0x00, 0x01, 0x00, 0x00, 0x00, 0xA2, 0x00,
+        0x00, 0x00, 0x15, 0x01, 0x03, 0x00, 0x01, 0x00, 0x00, 0x00, 0x04, 0x00, 0x00, 0x00, 0x16, 0x01,
+        0x04, 0x00, 0x01, 0x00, 0x00, 0x00, 0x55, 0x55, 0x00, 0x00, 0x17, 0x01, 0x04, 0x00, 0x01, 0x00,
+        0x00, 0x00, 0x18, 0x00, 0x00, 0x00, 0x1C, 0x01, 0x03, 0x00, 0x01, 0x00, 0x00, 0x00, 0x01, 0x00,
+        0x00, 0x00, 0x52, 0x01, 0x03, 0x00, 0x01, 0x00, 0x00, 0x00, 0x02, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0x00, 0x00, 0x08, 0x00, 0x08, 0x00, 0x08, 0x00, 0x08, 0x00, 0xA2, 0x00, 0x00, 0x00, 0x18, 0x00,
+        0x00, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0x00, 0xFF, 0x80, 0xFF, 0x00,
+        0x00, 0xFF, 0x00, 0xFF, 0x00, 0xFF, 0x00, 0x00, 0x00, 0x00,
+    };
+    std::vector<uint8_t> png_file = WriteImage(Raster::ImageFormat::Png, pixels, 3, 2);
+    std::vector<uint8_t> tiff_file = WriteImage(Raster::ImageFormat::Tiff, pixels, 3, 2);
+    CHECK(png_file == std::vector<uint8_t>(png, png + sizeof(png)));
+    CHECK(tiff_file == std::vector<uint8_t>(tiff, tiff + sizeof(tiff)));
+}
+
+// Noise (incompressible, several IDAT chunks and TIFF strips) above flat
+// rows and long runs (matches split at 258 bytes), read back exactly.
+static void TestRoundTrip()
+{
+    const int width = 300, height = 400;
+    std::vector<uint32_t> pixels((size_t)width * height);
+    std::mt19937 rng(11);
+    for (int y = 0; y < height; y++)
+        for (int x = 0; x < width; x++)
+        {
+            uint32_t& p = pixels[(size_t)y * width + x];
+            if (y < height / 2)
+                p = (uint32_t)rng();
+            else if (y % 7 == 0)
+                p = Raster::MakeColor((uint32_t)x, (uint32_t)y, 0);
+            else
+                p = x < 100 + y ? Raster::MakeColor(10, 20, 30) : Raster::MakeColor(10, 20, 31, 0);
+        }
+    for (Raster::ImageFormat format : { Raster::ImageFormat::Png, Raster::ImageFormat::Tiff })
+    {
+        std::vector<uint8_t> file = WriteImage(format, pixels, width, height);
+        int w = 0, h = 0;
+        std::vector<uint32_t> read = format == Raster::ImageFormat::Png ? ReadPng(file, w, h) : ReadTiff(file, w, h);
+        CHECK(w == width && h == height);
+        CHECK(read == pixels);
+    }
+}
+
+// Banded export with a pool against the whole scene rasterized at once.
+static void TestExport()
+{
+    const int width = 61, height = 47;
+    Raster::Scene scene;
+    scene.AddDisc(30.0f, 20.0f, 12.5f, Raster::MakeColor(200, 40, 40, 180));
+    scene.AddCircle(18.0f, 30.0f, 15.0f, Raster::MakeColor(40, 200, 90), 2.0f);
+    scene.AddLine(-5.0f, 3.0f, 70.0f, 44.0f, Raster::MakeColor(250, 250, 250, 200), 1.5f);
+    scene.AddLine(10.0f, 45.0f, 50.0f, 1.0f, Raster::MakeColor(90, 90, 255), 0.4f);
+    Raster::ExportSettings settings;
+    settings.width = width;
+    settings.height = height;
+    settings.background = Raster::MakeColor(12, 16, 24);
+
+    std::vector<uint32_t> expected((size_t)width * height);
+    Raster::Target target{ expected.data(), width, height, width, 0, 0 };
+    Raster::Fill(target, settings.background);
+    Raster::Rasterizer().Draw(scene, target);
+
+    Core::ThreadPool pool(3);
+    for (Raster::ImageFormat format : { Raster::ImageFormat::Png, Raster::ImageFormat::Tiff })
+    {
+        std::vector<uint8_t> whole;
+        for (int band_rows : { 256, 5, 1 })
+        {
+            settings.band_rows = band_rows;
+            std::string path = TempPath(format == Raster::ImageFormat::Png ? "export.png" : "export.tif");
+            Raster::ImageWriter writer;
+            int progress_rows = 0;
+            CHECK(writer.Open(path.c_str(), format, width, height));
+            CHECK(Raster::ExportScene(scene, settings, writer, &pool, [&](int rows) { progress_rows = rows; return true; }));
+            CHECK(progress_rows == height);
+            std::vector<uint8_t> file = ReadFile(path);
+            std::filesystem::remove(path);
+            if (whole.empty())
+                whole = file;
+            CHECK(file == whole);
+            int w = 0, h = 0;
+            std::vector<uint32_t> read = format == Raster::ImageFormat::Png ? ReadPng(file, w, h) : ReadTiff(file, w, h);
+            CHECK(read == expected);
+        }
+    }
+}
+
+int main()
+{
+    TestChecksums();
+    TestKnownFiles();
+    TestRoundTrip();
+    TestExport();
+    if (failures != 0)
+    {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("image: all checks passed\n");
+    return 0;
+}
@@ -0,0 +1,146 @@
+// Checks the shared-memory sample ring within one process: lapped samples
+// are reported as dropped, overwritten indices cannot be read, and Create
+// refuses a live writer's object but replaces a dead writer's.
+
+#include "Core/SampleRing.h"
+
+#include "Check.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#define RING_TEST_POSIX 1
+#endif
+
+#if defined(RING_TEST_POSIX)
+
+static Core::RingSample Sample(uint64_t tick)
+{
+    Core::RingSample sample;
+    sample.tick = tick;
+    sample.time = (double)tick / 60.0;
+    sample.plot_y = (float)tick * 0.5f;
+    return sample;
+}
+
+// Publishes past the capacity between polls.
+static void TestOverrun(const char* name)
+{
+    Core::SampleRingWriter writer;
+    CHECK(writer.Create(name, 6));
+    Core::SampleRingReader reader;
+    CHECK(reader.Open(name));
+    CHECK(reader.Capacity() == 8);
+
+    uint64_t cursor = reader.Head();
+    uint64_t dropped = 0;
+    Core::RingSample out[64];
+    for (uint64_t i = 0; i < 5; i++)
+        writer.Publish(Sample(i));
+    CHECK(reader.Poll(cursor, out, 64, &dropped) == 5);
+    CHECK(dropped == 0 && cursor == 5 && out[4].tick == 4);
+
+    // 20 more: the 12 oldest of them are lapped before the next poll
+    for (uint64_t i = 5; i < 25; i++)
+        writer.Publish(Sample(i));
+    CHECK(writer.Published() == 25 && reader.Head() == 25);
+    size_t count = reader.Poll(cursor, out, 64, &dropped);
+    CHECK(count == 8);
+    CHECK(dropped == 12);
+    CHECK(cursor == 25);
+    for (size_t k = 0; k < count; k++)
+        CHECK(out[k].tick == 17 + k && out[k].plot_y == (float)(17 + k) * 0.5f);
+    CHECK(reader.Poll(cursor, out, 64, &dropped) == 0);
+
+    Core::RingSample sample;
+    CHECK(!reader.Read(16, sample));     // Overwritten by 24
+    CHECK(!reader.Read(3, sample));
+    CHECK(!reader.Read(25, sample));     // Not published yet
+    CHECK(reader.Read(17, sample) && sample.tick == 17);
+    CHECK(reader.Read(24, sample) && sample.tick == 24);
+}
+
+// Leaves an object named `name` whose header records writer `pid`.
+static bool PlantRing(const char* name, uint64_t pid)
+{
+    int fd = shm_open(name, O_CREAT | O_EXCL | O_RDWR, 0644);
+    if (fd < 0)
+        return false;
+    size_t size = Core::ring_slots_offset + sizeof(Core::RingSlot);
+    void* memory = MAP_FAILED;
+    if (ftruncate(fd, (off_t)size) == 0)
+        memory = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED)
+        return false;
+    Core::RingHeader* header = (Core::RingHeader*)memory;
+    header->version = Core::ring_version;
+    header->slot_size = sizeof(Core::RingSlot);
+    header->capacity = 1;
+    header->writer_pid = pid;
+    header->magic = Core::ring_magic;
+    munmap(memory, size);
+    return true;
+}
+
+static void TestOwnership(const char* name)
+{
+    // A live writer's object is left alone
+    Core::SampleRingWriter first, second;
+    CHECK(first.Create(name, 16));
+    first.Publish(Sample(1));
+    CHECK(!second.Create(name, 16));
+    CHECK(!second.IsOpen());
+    Core::SampleRingReader reader;
+    CHECK(reader.Open(name) && reader.Capacity() == 16 && reader.Head() == 1);
+    reader.Close();
+    first.Close();
+
+    // One from a process that has exited is replaced
+    pid_t child = fork();
+    if (child == 0)
+        _exit(0);
+    CHECK(child > 0 && waitpid(child, nullptr, 0) == child);
+    CHECK(PlantRing(name, (uint64_t)child));
+    CHECK(second.Create(name, 16));
+    CHECK(reader.Open(name) && reader.Capacity() == 16 && reader.Head() == 0);
+    reader.Close();
+    second.Close();
+
+    // One whose process is alive is not
+    CHECK(PlantRing(name, (uint64_t)getppid()));
+    CHECK(!second.Create(name, 16));
+    CHECK(reader.Open(name) && reader.Capacity() == 1);
+    reader.Close();
+    shm_unlink(name);
+}
+
+int main()
+{
+    std::string name = "/fourier-ring-test-" + std::to_string((long long)getpid());
+    TestOverrun(name.c_str());
+    TestOwnership(name.c_str());
+    if (failures != 0)
+    {
+        std::fprintf(stderr, "%d check(s) failed\n", failures);
+        return 1;
+    }
+    std::printf("ring: all checks passed\n");
+    return 0;
+}
+
+#else
+
+int main()
+{
+    std::printf("ring: skipped (needs POSIX shared memory)\n");
+    return 0;
+}
+
+#endif